@@ -16,11 +16,14 @@
 
 #include "paddle/cinn/hlir/dialect/operator/ir/cinn_op.h"
 #include "paddle/cinn/hlir/dialect/operator/ir/manual_op.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/pir/include/core/builtin_type_interfaces.h"
 #include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
 #include "paddle/pir/include/pattern_rewrite/pattern_rewrite_driver.h"
 
+COMMON_DECLARE_int32(pir_pattern_rewrite_num_threads);
+
 namespace cinn {
 namespace dialect {
 namespace ir {
@@ -61,17 +64,23 @@ class AddStoreInFusionOpPass : public pir::Pass {
     pir::GreedyRewriteConfig cfg;
     cfg.use_top_down_traversal = true;
     cfg.max_iterations = 1;
+    cfg.num_threads = FLAGS_pir_pattern_rewrite_num_threads;
+    std::vector<pir::Operation*> fusion_ops;
     for (uint32_t i = 0; i < op->num_regions(); ++i) {
       for (auto& block : op->region(i)) {
         for (auto& op : block) {
           if (op.isa<cinn::dialect::FusionOp>()) {
-            auto [_, num_rewrites] =
-                pir::ApplyPatternsGreedily(&op, patterns_, cfg);
-            AddStatistics(num_rewrites);
+            fusion_ops.push_back(&op);
+            // The store of a value defined outside the FusionOp is inserted
+            // outside of it, the FusionOps are rewritten sequentially then.
+            if (!YieldsInnerValues(&op)) cfg.num_threads = 1;
           }
         }
       }
     }
+    auto [_, num_rewrites] =
+        pir::ApplyPatternsGreedily(fusion_ops, patterns_, cfg);
+    AddStatistics(num_rewrites);
   }
 
   bool CanApplyOn(pir::Operation* op) const override {
@@ -79,6 +88,17 @@ class AddStoreInFusionOpPass : public pir::Pass {
   }
 
  private:
+  static bool YieldsInnerValues(pir::Operation* fusion_op) {
+    for (auto& block : fusion_op->region(0)) {
+      if (block.empty()) continue;
+      for (uint32_t i = 0; i < block.back().num_operands(); ++i) {
+        auto* def_op = block.back().operand_source(i).defining_op();
+        if (!def_op || def_op->GetParentOp() != fusion_op) return false;
+      }
+    }
+    return true;
+  }
+
   pir::FrozenRewritePatternSet patterns_;
 };
 
@@ -389,6 +389,37 @@ PHI_DEFINE_EXPORTED_int32(dist_threadpool_size,
                           0,
                           "number of threads used for distributed executed.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_tcp_store_server_threads
+ * Since Version: 3.0.0
+ * Value Range: int32, default=4
+ * Example: FLAGS_tcp_store_server_threads=16, serve the clients of the
+ * TCPStore master with 16 threads.
+ * Note: The connections of the clients are assigned round robin to the
+ *       threads, and the keys of the store are sharded by hash.
+ */
+PHI_DEFINE_EXPORTED_int32(tcp_store_server_threads,
+                          4,
+                          "number of threads of the TCPStore master serving "
+                          "the commands of the clients.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_gloo_allreduce_algo
+ * Since Version: 3.0.0
+ * Value Range: string, default="auto"
+ * Example: FLAGS_gloo_allreduce_algo="ring", allreduce the CPU tensors of
+ * ProcessGroupGloo with the chunked ring algorithm.
+ * Note: One of "auto", "gloo", "ring" and "halving_doubling". "auto" uses
+ *       gloo::allreduce for small tensors, halving-doubling for medium ones
+ *       and the ring once each rank holds a segment of at least 1MB.
+ */
+PHI_DEFINE_EXPORTED_string(gloo_allreduce_algo,
+                           "auto",
+                           "allreduce algorithm of ProcessGroupGloo, one of "
+                           "auto, gloo, ring and halving_doubling.");
+
 /**
  * Garbage collector related FLAG
  * Name: FLAGS_eager_delete_tensor_gb
@@ -1749,6 +1780,21 @@ PHI_DEFINE_EXPORTED_bool(pir_apply_shape_optimization_pass,
                          "Whether to apply shape_optimization pass "
                          "to infer symbolic shape");
 
+/**
+ * Parallel pattern rewrite FLAG
+ * Name: pir_pattern_rewrite_num_threads
+ * Since Version: 3.0.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_pir_pattern_rewrite_num_threads=4 rewrites with 4 threads.
+ * Note: Number of threads used by the passes that rewrite many independent
+ * sub-regions of a program, e.g. add_store_in_fusion_op. The default 1
+ * rewrites sequentially.
+ */
+PHI_DEFINE_EXPORTED_int32(pir_pattern_rewrite_num_threads,
+                          1,
+                          "Number of threads used to rewrite independent "
+                          "regions of a PIR program.");
+
 PHI_DEFINE_EXPORTED_int64(
     pir_broadcast_tree_limit,
     32,
@@ -2009,6 +2055,40 @@ PHI_DEFINE_EXPORTED_bool(save_cf_stack_op,
                          false,
                          "Save cf stack op for higher-order derivatives.");
 
+/**
+ * Eager backward related FLAG
+ * Name: FLAGS_eager_backward_num_threads
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_eager_backward_num_threads=8, run the ready grad nodes of a
+ * backward on CPU with 8 threads.
+ * Note: The grad nodes of independent branches of the backward graph, e.g. of
+ *       multi-tower models, run in parallel. Values less than 2 run the grad
+ *       nodes sequentially on the calling thread. It is read once, when the
+ *       first backward runs in parallel.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_backward_num_threads,
+                          0,
+                          "Number of threads running the grad nodes of a "
+                          "backward on CPU, less than 2 to run them "
+                          "sequentially.");
+
+/**
+ * JIT kernel related FLAG
+ * Name: FLAGS_jit_kernel_warmup_file
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_jit_kernel_warmup_file=/tmp/jit_kernels.txt, generate the
+ * jit code of the CPU kernels listed in /tmp/jit_kernels.txt when a predictor
+ * is created, and list there the kernels used when it is destroyed.
+ * Note: The list holds the kernel types and attributes, not the code, which
+ *       embeds addresses of the process that generated it. Empty to disable.
+ */
+PHI_DEFINE_EXPORTED_string(jit_kernel_warmup_file,
+                           "",
+                           "File listing the jit kernels an inference "
+                           "predictor generates ahead of its first run.");
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 /**
  * FlashAttention related FLAG
@@ -345,8 +345,20 @@ class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
 
   void _do_allreduce(std::vector<phi::DenseTensor>& ins,     // NOLINT
                      std::vector<phi::DenseTensor>& outs) {  // NOLINT
+    if (ins.size() == 1) {
+      _comm_context->AllReduce(
+          &(outs[0]), ins[0], static_cast<int>(_reduce_op), _tag);
+      return;
+    }
+    // the tensors are fused into buckets rather than reduced one by one
+    std::vector<phi::DenseTensor*> out_ptrs;
+    std::vector<const phi::DenseTensor*> in_ptrs;
+    for (size_t i = 0; i < ins.size(); ++i) {
+      in_ptrs.push_back(&ins[i]);
+      out_ptrs.push_back(&outs[i]);
+    }
     _comm_context->AllReduce(
-        &(outs[0]), ins[0], static_cast<int>(_reduce_op), _tag);
+        out_ptrs, in_ptrs, static_cast<int>(_reduce_op), _tag);
   }
 };
 
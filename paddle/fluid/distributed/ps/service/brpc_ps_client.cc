@@ -19,6 +19,7 @@
 #include <string>
 
 #include "paddle/fluid/distributed/ps/service/coordinator_client.h"
+#include "paddle/fluid/distributed/ps/service/sparse_value_codec.h"
 #include "paddle/fluid/framework/archive.h"
 #include "paddle/utils/string/split.h"
 
@@ -304,6 +305,7 @@ int32_t BrpcPsClient::Initialize() {
   // 获取server列表，并连接
   std::vector<PSHost> server_list = _env->GetPsServers();
   _server_channels.resize(server_list.size());
+  _server_wire_format = std::vector<std::atomic<bool>>(server_list.size());
   for (size_t i = 0; i < server_list.size(); ++i) {
     server_ip_port.assign(server_list[i].ip.c_str());
     server_ip_port.append(":");
@@ -679,6 +681,25 @@ std::future<int32_t> BrpcPsClient::CheckSavePrePatchDone() {
 
 std::future<int32_t> BrpcPsClient::Flush() {
   VLOG(0) << "BrpcPsClient::flush begin";
+  // push the gradients merged in the sparse value caches
+  for (auto &cache_itr : _sparse_value_caches) {
+    std::vector<uint64_t> push_keys;
+    std::vector<const float *> push_values;
+    std::vector<float> merged_values;
+    cache_itr.second->FilterPush(nullptr,
+                                 nullptr,
+                                 0,
+                                 true,
+                                 &push_keys,
+                                 &push_values,
+                                 &merged_values);
+    if (!push_keys.empty()) {
+      PushSparseToServer(cache_itr.first,
+                         push_keys.data(),
+                         push_values.data(),
+                         push_keys.size());
+    }
+  }
   _flushing = true;
   std::promise<int> promise;
   std::future<int32_t> fut = promise.get_future();
@@ -708,6 +729,10 @@ void BrpcPsClient::PrintQueueSize() {
     VLOG(0) << "BrpcPsClient::PrintQueueSize: table " << table_id
             << " size: " << queue_size;
   }
+
+  for (auto &cache_itr : _sparse_value_caches) {
+    cache_itr.second->PrintStat(cache_itr.first);
+  }
 }
 
 void BrpcPsClient::PrintQueueSizeThread() {
@@ -1138,6 +1163,36 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
                                               const uint64_t *keys,
                                               size_t num,
                                               bool is_training) {
+  auto *cache = GetSparseValueCache(table_id);
+  if (cache == nullptr) {
+    return PullSparseFromServer(
+        select_values, table_id, keys, num, is_training, nullptr);
+  }
+  // only the keys missing in the cache are pulled from the servers
+  cache->NewBatch();
+  std::vector<size_t> miss_index;
+  cache->Lookup(keys, num, select_values, &miss_index);
+  std::vector<uint64_t> miss_keys(miss_index.size());
+  std::vector<float *> miss_values(miss_index.size());
+  for (size_t i = 0; i < miss_index.size(); ++i) {
+    miss_keys[i] = keys[miss_index[i]];
+    miss_values[i] = select_values[miss_index[i]];
+  }
+  return PullSparseFromServer(miss_values.data(),
+                              table_id,
+                              miss_keys.data(),
+                              miss_keys.size(),
+                              is_training,
+                              cache);
+}
+
+std::future<int32_t> BrpcPsClient::PullSparseFromServer(
+    float **select_values,
+    size_t table_id,
+    const uint64_t *keys,
+    size_t num,
+    bool is_training,
+    SparseValueCache *cache) {
   auto timer = std::make_shared<CostTimer>("pserver_client_pull_sparse");
   auto local_timer =
       std::make_shared<CostTimer>("pserver_client_pull_sparse_local");
@@ -1149,10 +1204,17 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
 
   const auto &server_param = _config.server_param().downpour_server_param();
   uint64_t shard_num = FLAGS_pserver_sparse_table_shard_num;
+  SparseWireFormat pull_format;
+  // the format is also sent for a table which only encodes its pushes, so
+  // that the server echoes it
+  bool send_pull_format = false;
   for (int i = 0; i < server_param.downpour_table_param_size(); ++i) {
     const auto &table_param = server_param.downpour_table_param(i);
     if (table_param.table_id() == table_id) {
       shard_num = table_param.shard_num();
+      pull_format = GetPullWireFormat(table_param);
+      send_pull_format =
+          !pull_format.IsRaw() || !GetPushWireFormat(table_param).IsRaw();
       break;
     }
   }
@@ -1167,7 +1229,8 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
   size_t value_size = accessor->GetAccessorInfo().select_size;
 
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
-      request_call_num, [shard_sorted_kvs, value_size](void *done) {
+      request_call_num,
+      [this, shard_sorted_kvs, value_size, cache](void *done) {
         int ret = 0;
         auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
         for (size_t i = 0; i < shard_sorted_kvs->size(); ++i) {
@@ -1182,6 +1245,29 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
           uint64_t last_key = UINT64_MAX;
           float *last_value_data = NULL;
 
+          // the values are encoded if the server echoes the wire format,
+          // and are raw fp32 otherwise
+          SparseWireFormat format;
+          std::unique_ptr<SparseValueCodec> codec;
+          std::string encoded;
+          size_t encoded_offset = 0;
+          if (format.FromString(closure->response(i)->data())) {
+            _server_wire_format[i] = true;
+            codec = std::make_unique<SparseValueCodec>(
+                format, value_size / sizeof(float));
+            res_io_buffer.copy_to(&encoded);
+            if (format.compress) {
+              std::string uncompressed;
+              if (!UncompressSparseValues(
+                      encoded.data(), encoded.size(), &uncompressed)) {
+                LOG(WARNING) << "res data is not in compressed format";
+                ret = -1;
+                break;
+              }
+              encoded.swap(uncompressed);
+            }
+          }
+
           for (auto &kv_pair : request_kvs) {
             if (kv_pair.first == last_key) {
               memcpy(reinterpret_cast<void *>(kv_pair.second),
@@ -1190,9 +1276,20 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
             } else {
               last_key = kv_pair.first;
               last_value_data = kv_pair.second;
-              if (value_size !=
-                  io_buffer_itr.copy_and_forward(
-                      reinterpret_cast<void *>(last_value_data), value_size)) {
+              bool read_ok = false;
+              if (codec == nullptr) {
+                read_ok = value_size ==
+                          io_buffer_itr.copy_and_forward(
+                              reinterpret_cast<void *>(last_value_data),
+                              value_size);
+              } else if (encoded_offset + codec->EncodedSize() <=
+                         encoded.size()) {
+                codec->Decode(encoded.data() + encoded_offset,
+                              last_value_data);
+                encoded_offset += codec->EncodedSize();
+                read_ok = true;
+              }
+              if (!read_ok) {
                 LOG(WARNING) << "res data is lack or not in format";
                 ret = -1;
                 break;
@@ -1200,6 +1297,13 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
             }
           }
         }
+        if (ret == 0 && cache != nullptr) {
+          for (auto &request_kvs : *shard_sorted_kvs) {
+            for (auto &kv_pair : request_kvs) {
+              cache->Update(&kv_pair.first, &kv_pair.second, 1);
+            }
+          }
+        }
         closure->set_promise_value(ret);
       });
   closure->add_timer(timer);
@@ -1250,6 +1354,9 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       closure->request(i)->set_client_id(_client_id);
       closure->request(i)->add_params((char *)&kv_request_count,  // NOLINT
                                       sizeof(uint32_t));
+      if (send_pull_format) {
+        closure->request(i)->add_params(pull_format.ToString());
+      }
       PsService_Stub rpc_stub(GetCmdChannel(i));
       closure->cntl(i)->set_log_id(butil::gettimeofday_ms());
       rpc_stub.service(
@@ -1527,6 +1634,37 @@ std::future<int32_t> BrpcPsClient::PushSparse(size_t table_id,
                                               const uint64_t *keys,
                                               const float **update_values,
                                               size_t num) {
+  auto *cache = GetSparseValueCache(table_id);
+  if (cache == nullptr) {
+    return PushSparseToServer(table_id, keys, update_values, num);
+  }
+  // the gradients of the cached keys are merged locally and pushed once per
+  // staleness window
+  thread_local std::vector<uint64_t> push_keys;
+  thread_local std::vector<const float *> push_values;
+  thread_local std::vector<float> merged_values;
+  cache->FilterPush(keys,
+                    update_values,
+                    num,
+                    false,
+                    &push_keys,
+                    &push_values,
+                    &merged_values);
+  if (push_keys.empty()) {
+    std::promise<int32_t> promise;
+    std::future<int32_t> fut = promise.get_future();
+    promise.set_value(0);
+    return fut;
+  }
+  return PushSparseToServer(
+      table_id, push_keys.data(), push_values.data(), push_keys.size());
+}
+
+std::future<int32_t> BrpcPsClient::PushSparseToServer(
+    size_t table_id,
+    const uint64_t *keys,
+    const float **update_values,
+    size_t num) {
   auto push_timer = std::make_shared<CostTimer>("pserver_client_push_sparse");
   CostTimer parse_timer("pserver_client_push_sparse_parse");
   int push_sparse_async_num = _push_sparse_task_queue_map[table_id]->Size();
@@ -1856,19 +1994,48 @@ int BrpcPsClient::PushSparseAsyncShardPush(
                            sizeof(uint32_t));  // NOLINT
   auto *push_data = push_request->mutable_data();
   int update_size = accessor->GetAccessorInfo().update_size;
-  push_data->resize(merged_kv_count * (sizeof(uint64_t) + update_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
-  memcpy(push_data_ptr,
-         merged_key_list.data(),
-         merged_kv_count * sizeof(uint64_t));
-  push_data_ptr += merged_kv_count * sizeof(uint64_t);
-  for (size_t i = 0; i < merged_kv_count; ++i) {
-    const char *task_data_ptr = merged_value_list[i].data();
 
+  SparseWireFormat push_format;
+  const auto &server_param = _config.server_param().downpour_server_param();
+  for (int i = 0; i < server_param.downpour_table_param_size(); ++i) {
+    const auto &table_param = server_param.downpour_table_param(i);
+    if (table_param.table_id() == table_id) {
+      push_format = GetPushWireFormat(table_param);
+      break;
+    }
+  }
+  if (!push_format.IsRaw() && _server_wire_format[shard_idx]) {
+    // the values are encoded after the keys, and the server decodes them
+    // with the format in the params
+    push_request->add_params(push_format.ToString());
+    SparseValueCodec codec(push_format, update_size / sizeof(float));
+    push_data->resize(merged_kv_count *
+                      (sizeof(uint64_t) + codec.EncodedSize()));
+    char *push_data_ptr = const_cast<char *>(push_data->data());
+    memcpy(push_data_ptr,
+           merged_key_list.data(),
+           merged_kv_count * sizeof(uint64_t));
+    push_data_ptr += merged_kv_count * sizeof(uint64_t);
+    for (size_t i = 0; i < merged_kv_count; ++i) {
+      codec.Encode(reinterpret_cast<const float *>(merged_value_list[i].data()),
+                   push_data_ptr);
+      push_data_ptr += codec.EncodedSize();
+    }
+  } else {
+    push_data->resize(merged_kv_count * (sizeof(uint64_t) + update_size));
+    char *push_data_ptr = const_cast<char *>(push_data->data());
     memcpy(push_data_ptr,
-           (float *)(task_data_ptr),  // NOLINT
-           update_size);
-    push_data_ptr += update_size;
+           merged_key_list.data(),
+           merged_kv_count * sizeof(uint64_t));
+    push_data_ptr += merged_kv_count * sizeof(uint64_t);
+    for (size_t i = 0; i < merged_kv_count; ++i) {
+      const char *task_data_ptr = merged_value_list[i].data();
+
+      memcpy(push_data_ptr,
+             (float *)(task_data_ptr),  // NOLINT
+             update_size);
+      push_data_ptr += update_size;
+    }
   }
   PsService_Stub rpc_stub(GetSparseChannel(shard_idx));
   closure->cntl(shard_idx)->set_request_compress_type(
@@ -16,6 +16,7 @@
 
 #include <ThreadPool.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -347,6 +348,19 @@ class BrpcPsClient : public PSClient {
                                int cmd_id,
                                const std::vector<std::string> &param);
 
+  // Pulls the values of keys from the servers, and caches them in cache if
+  // it is not nullptr.
+  std::future<int32_t> PullSparseFromServer(float **select_values,
+                                            size_t table_id,
+                                            const uint64_t *keys,
+                                            size_t num,
+                                            bool is_training,
+                                            SparseValueCache *cache);
+  std::future<int32_t> PushSparseToServer(size_t table_id,
+                                          const uint64_t *keys,
+                                          const float **update_values,
+                                          size_t num);
+
   std::future<int32_t> SendSaveCmd(uint32_t table_id,
                                    int cmd_id,
                                    const std::vector<std::string> &param);
@@ -390,6 +404,10 @@ class BrpcPsClient : public PSClient {
       _client_channels;  // client2client
   std::vector<std::array<std::shared_ptr<brpc::Channel>, 3>>
       _server_channels;  // client2server
+  // whether each server has echoed the sparse wire format of a pull, the
+  // pushes to a server are only encoded after that since an older server
+  // reads the pushed values as fp32
+  std::vector<std::atomic<bool>> _server_wire_format;
   std::vector<std::array<std::shared_ptr<brpc::Channel>, 1>>
       _coordinator_channels;  // client2coordinator
   std::future<int32_t> PushDenseRawGradient(int table_id,
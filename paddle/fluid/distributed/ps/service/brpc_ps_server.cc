@@ -18,6 +18,7 @@
 
 #include "butil/object_pool.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
+#include "paddle/fluid/distributed/ps/service/sparse_value_codec.h"
 #include "paddle/fluid/distributed/ps/table/depends/sparse_utils.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/framework/archive.h"
@@ -546,8 +547,31 @@ int32_t BrpcPsService::PullSparse(Table *table,
   table->Pull(table_context);
   // table->PullSparse(res_data->data(), value);
 
-  cntl->response_attachment().append(reinterpret_cast<char *>(res_data->data()),
-                                     res_data->size() * sizeof(float));
+  SparseWireFormat format;
+  if (request.params_size() >= 2 && format.FromString(request.params(1))) {
+    // encodes the values in the wire format of the request, and echoes it
+    // so that the client decodes them
+    SparseValueCodec codec(format, dim);
+    thread_local std::string encoded;
+    encoded.resize(num * codec.EncodedSize());
+    for (uint32_t i = 0; i < num; ++i) {
+      codec.Encode(res_data->data() + i * dim,
+                   const_cast<char *>(encoded.data()) +
+                       i * codec.EncodedSize());
+    }
+    if (format.compress) {
+      thread_local std::string compressed;
+      compressed.clear();
+      CompressSparseValues(encoded.data(), encoded.size(), &compressed);
+      encoded.swap(compressed);
+    }
+    cntl->response_attachment().append(encoded.data(), encoded.size());
+    response.set_data(format.ToString());
+  } else {
+    cntl->response_attachment().append(
+        reinterpret_cast<char *>(res_data->data()),
+        res_data->size() * sizeof(float));
+  }
   butil::return_object(res_data);
   return 0;
 }
@@ -585,6 +609,24 @@ int32_t BrpcPsService::PushSparse(Table *table,
   table_context.push_context.values =
       (const float *)(push_data.data() + sizeof(uint64_t) * num);
   table_context.num = num;
+
+  // the values are encoded if the request has a wire format
+  SparseWireFormat format;
+  thread_local std::vector<float> decoded;
+  if (request.params_size() >= 2 && format.FromString(request.params(1))) {
+    auto dim = table->GetValueAccessor()->GetAccessorInfo().update_dim;
+    SparseValueCodec codec(format, dim);
+    if (push_data.size() < num * (sizeof(uint64_t) + codec.EncodedSize())) {
+      set_response_code(response, -1, "push sparse data is not in format");
+      return 0;
+    }
+    const char *encoded = push_data.data() + sizeof(uint64_t) * num;
+    decoded.resize(num * dim);
+    for (uint32_t i = 0; i < num; ++i) {
+      codec.Decode(encoded + i * codec.EncodedSize(), decoded.data() + i * dim);
+    }
+    table_context.push_context.values = decoded.data();
+  }
   // const uint64_t *keys = (const uint64_t *)push_data.data();
   // const float *values = (const float *)(push_data.data() + sizeof(uint64_t) *
   // num);
@@ -16,6 +16,8 @@ limitations under the License. */
 
 #include <google/protobuf/text_format.h>
 
+#include <sstream>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
 #include "paddle/fluid/distributed/ps/wrapper/fleet.h"
@@ -23,6 +25,17 @@ limitations under the License. */
 #include "paddle/phi/core/platform/profiler.h"
 #include "paddle/utils/string/string_helper.h"
 
+PD_DEFINE_int32(communicator_sparse_push_window_ms,
+                0,
+                "the sparse gradients pushed by the async communicator are "
+                "aggregated for this time before being sent, 0 to send them "
+                "as they are merged");
+
+PD_DEFINE_int32(communicator_sparse_push_window_keys,
+                1000000,
+                "the aggregated sparse gradients of a table are sent once "
+                "they have this number of keys");
+
 #define LEARNING_RATE_DECAY_COUNTER "@LR_DECAY_COUNTER@"
 #define STEP_COUNTER "@PS_STEP_COUNTER@"
 
@@ -39,6 +52,90 @@ inline double GetCurrentUS() {
   return 1e+6 * time.tv_sec + time.tv_usec;
 }
 
+SparsePushAggregator::SparsePushAggregator(size_t dim,
+                                           size_t keep_dim,
+                                           size_t max_key_num,
+                                           int64_t window_ms)
+    : dim_(dim),
+      keep_dim_(keep_dim),
+      max_key_num_(max_key_num),
+      window_ms_(window_ms) {
+  PADDLE_ENFORCE_LE(keep_dim,
+                    dim,
+                    common::errors::InvalidArgument(
+                        "The kept dim %d of the sparse push aggregator should "
+                        "not be greater than its dim %d.",
+                        keep_dim,
+                        dim));
+}
+
+void SparsePushAggregator::Add(const uint64_t *keys,
+                               const float *const *values,
+                               size_t num) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (keys_.empty()) {
+    window_begin_ms_ = static_cast<int64_t>(GetCurrentUS() / 1000);
+  }
+  for (size_t i = 0; i < num; ++i) {
+    auto itr = key_index_.find(keys[i]);
+    if (itr == key_index_.end()) {
+      key_index_.emplace(keys[i], keys_.size());
+      keys_.push_back(keys[i]);
+      values_.insert(values_.end(), values[i], values[i] + dim_);
+      continue;
+    }
+    float *merged = values_.data() + itr->second * dim_;
+    for (size_t j = keep_dim_; j < dim_; ++j) {
+      merged[j] += values[i][j];
+    }
+  }
+  added_key_num_ += num;
+  ++added_batch_num_;
+}
+
+bool SparsePushAggregator::Full() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return keys_.size() >= max_key_num_;
+}
+
+bool SparsePushAggregator::Expired() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !keys_.empty() &&
+         static_cast<int64_t>(GetCurrentUS() / 1000) - window_begin_ms_ >=
+             window_ms_;
+}
+
+size_t SparsePushAggregator::Take(std::vector<uint64_t> *keys,
+                                  std::vector<float> *values) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  keys->swap(keys_);
+  values->swap(values_);
+  keys_.clear();
+  values_.clear();
+  key_index_.clear();
+  if (!keys->empty()) {
+    pushed_key_num_ += keys->size();
+    ++pushed_batch_num_;
+  }
+  return keys->size();
+}
+
+double SparsePushAggregator::MergeRatio() const {
+  uint64_t added = added_key_num_.load();
+  return added == 0 ? 0.0
+                    : 1.0 - static_cast<double>(pushed_key_num_.load()) / added;
+}
+
+std::string SparsePushAggregator::StatString() const {
+  std::stringstream ss;
+  ss << "added keys: " << added_key_num_.load()
+     << ", pushed keys: " << pushed_key_num_.load()
+     << ", merge ratio: " << MergeRatio()
+     << ", added batches: " << added_batch_num_.load()
+     << ", pushes: " << pushed_batch_num_.load();
+  return ss.str();
+}
+
 Communicator::Communicator()
     : envs(),
       trainers_(0),
@@ -292,7 +389,6 @@ void Communicator::RpcSendSparse(const std::string &var_name,
                                  const Scope &scope) {
   phi::RecordEvent record_event(
       "Communicator->RpcSendSparse", phi::TracerEventType::Communication, 1);
-  size_t request_call_num = _worker_ptr->GetServerNums();
   std::vector<uint64_t> sparse_push_keys;
   std::vector<float *> push_g_vec;
 
@@ -320,6 +416,17 @@ void Communicator::RpcSendSparse(const std::string &var_name,
   }
   */
 
+  RpcSendSparseRows(table_id,
+                    sparse_push_keys.data(),
+                    (const float **)push_g_vec.data(),  // NOLINT
+                    sparse_push_keys.size());
+}
+
+void Communicator::RpcSendSparseRows(int table_id,
+                                     const uint64_t *keys,
+                                     const float **values,
+                                     size_t num) {
+  size_t request_call_num = _worker_ptr->GetServerNums();
   ++_async_call_num;
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
       request_call_num, [this, request_call_num](void *done) {
@@ -335,11 +442,7 @@ void Communicator::RpcSendSparse(const std::string &var_name,
         --_async_call_num;
       });
   auto status =
-      _worker_ptr->PushSparseRawGradient(table_id,
-                                         sparse_push_keys.data(),
-                                         (const float **)push_g_vec.data(),
-                                         sparse_push_keys.size(),
-                                         closure);
+      _worker_ptr->PushSparseRawGradient(table_id, keys, values, num, closure);
   status.wait();
   return;
 }
@@ -551,7 +654,23 @@ void AsyncCommunicator::SendByCommunicator() {
             1,
             common::errors::InvalidArgument(
                 "sparse variables can only be merged by one variables"));
-        RpcSendSparse(varnames[0], table_id, *send_scope_);
+        if (SparsePushAggregated()) {
+          auto *tensor =
+              send_scope_->FindVar(varnames[0])->GetMutable<SelectedRows>();
+          auto dim = tensor->value().dims()[1];
+          std::vector<uint64_t> keys(tensor->rows().begin(),
+                                     tensor->rows().end());
+          std::vector<const float *> values(keys.size());
+          for (size_t i = 0; i < keys.size(); ++i) {
+            values[i] = tensor->value().data<float>() + i * dim;
+          }
+          auto *aggregator =
+              GetSparsePushAggregator(table_id, dim, 0, /*raw_gradient=*/true);
+          aggregator->Add(keys.data(), values.data(), keys.size());
+          FlushSparsePush(table_id, false);
+        } else {
+          RpcSendSparse(varnames[0], table_id, *send_scope_);
+        }
       } else {
         RpcSendDense(ctx, *send_scope_);
         if (!independent_recv_ &&
@@ -589,11 +708,91 @@ void AsyncCommunicator::MainThread() {
 
   while (running_) {
     SendByCommunicator();
+    if (SparsePushAggregated()) {
+      FlushSparsePush(false);
+    }
     RpcProfilerControl();
   }
+  if (SparsePushAggregated()) {
+    FlushSparsePush(true);
+  }
   VLOG(1) << "communicator stopped, send thread exit";
 }
 
+SparsePushAggregator *AsyncCommunicator::GetSparsePushAggregator(
+    uint64_t table_id, size_t dim, size_t keep_dim, bool raw_gradient) {
+  std::lock_guard<std::mutex> lock(sparse_push_mutex_);
+  auto &aggregator = sparse_push_aggregators_[table_id];
+  if (aggregator == nullptr) {
+    aggregator = std::make_unique<SparsePushAggregator>(
+        dim,
+        keep_dim,
+        FLAGS_communicator_sparse_push_window_keys,
+        FLAGS_communicator_sparse_push_window_ms);
+    sparse_push_raw_gradient_[table_id] = raw_gradient;
+  }
+  PADDLE_ENFORCE_EQ(aggregator->Dim(),
+                    dim,
+                    common::errors::InvalidArgument(
+                        "The dim of the sparse gradients of table %d should "
+                        "be %d, but received %d.",
+                        table_id,
+                        aggregator->Dim(),
+                        dim));
+  return aggregator.get();
+}
+
+void AsyncCommunicator::FlushSparsePush(bool force) {
+  std::vector<uint64_t> table_ids;
+  {
+    std::lock_guard<std::mutex> lock(sparse_push_mutex_);
+    for (auto &iter : sparse_push_aggregators_) {
+      table_ids.push_back(iter.first);
+    }
+  }
+  for (auto table_id : table_ids) {
+    FlushSparsePush(table_id, force);
+  }
+}
+
+void AsyncCommunicator::FlushSparsePush(uint64_t table_id, bool force) {
+  SparsePushAggregator *aggregator = nullptr;
+  bool raw_gradient = false;
+  {
+    std::lock_guard<std::mutex> lock(sparse_push_mutex_);
+    auto iter = sparse_push_aggregators_.find(table_id);
+    if (iter == sparse_push_aggregators_.end()) {
+      return;
+    }
+    aggregator = iter->second.get();
+    raw_gradient = sparse_push_raw_gradient_[table_id];
+  }
+  if (!force && !aggregator->Full() && !aggregator->Expired()) {
+    return;
+  }
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  size_t num = aggregator->Take(&keys, &values);
+  if (num == 0) {
+    return;
+  }
+  std::vector<const float *> value_ptrs(num);
+  for (size_t i = 0; i < num; ++i) {
+    value_ptrs[i] = values.data() + i * aggregator->Dim();
+  }
+  if (raw_gradient) {
+    RpcSendSparseRows(table_id, keys.data(), value_ptrs.data(), num);
+  } else {
+    _worker_ptr->PushSparse(table_id, keys.data(), value_ptrs.data(), num);
+  }
+  VLOG(2) << "push aggregated sparse gradients of table " << table_id << ", "
+          << aggregator->StatString();
+  if (force) {
+    VLOG(0) << "sparse push aggregator of table " << table_id << ", "
+            << aggregator->StatString();
+  }
+}
+
 void AsyncCommunicator::PullSparseToTensorSync(
     const uint64_t table_id,
     int fea_dim,
@@ -816,6 +1015,14 @@ void AsyncCommunicator::PushSparseFromTensorAsync(
       true,
       common::errors::InvalidArgument(
           "can not find table: %s, please check your config", table_id));
+  if (SparsePushAggregated()) {
+    // slot is kept, show, click and the gradients are summed
+    auto *aggregator = GetSparsePushAggregator(
+        table_id, fea_dim + 1, 1, /*raw_gradient=*/false);
+    aggregator->Add(push_keys.data(), push_g_vec.data(), push_keys.size());
+    FlushSparsePush(table_id, false);
+    return;
+  }
   auto status = _worker_ptr->PushSparse(table_id,
                                         push_keys.data(),
                                         (const float **)push_g_vec.data(),
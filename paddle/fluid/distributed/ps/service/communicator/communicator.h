@@ -21,6 +21,7 @@ limitations under the License. */
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <numeric>
 #include <set>
 #include <string>
@@ -53,6 +54,8 @@ struct CommContext;
 }  // namespace paddle
 
 COMMON_DECLARE_bool(communicator_is_sgd_optimizer);
+PD_DECLARE_int32(communicator_sparse_push_window_ms);
+PD_DECLARE_int32(communicator_sparse_push_window_keys);
 
 namespace paddle {
 namespace distributed {
@@ -226,6 +229,53 @@ inline void MergeVars(const std::string &var_name,
   }
 }
 
+// Aggregates the sparse gradients pushed to a table over a window of
+// batches. The rows of duplicated keys are summed, except for the first
+// `keep_dim` fields (e.g. the slot of CtrCommonPushValue) which are kept
+// from the first row, so show and click are summed as well. A window is full
+// once it holds `max_key_num` keys, and expires `window_ms` milliseconds
+// after its first row.
+class SparsePushAggregator {
+ public:
+  SparsePushAggregator(size_t dim,
+                       size_t keep_dim,
+                       size_t max_key_num,
+                       int64_t window_ms);
+
+  // Adds num rows of dim floats.
+  void Add(const uint64_t *keys, const float *const *values, size_t num);
+
+  bool Full() const;
+  bool Expired() const;
+
+  // Moves the aggregated rows to keys and values and starts a new window,
+  // returns the number of rows.
+  size_t Take(std::vector<uint64_t> *keys, std::vector<float> *values);
+
+  size_t Dim() const { return dim_; }
+
+  // 1 - pushed keys / added keys, i.e. the fraction of the rows saved
+  double MergeRatio() const;
+  std::string StatString() const;
+
+ private:
+  size_t dim_;
+  size_t keep_dim_;
+  size_t max_key_num_;
+  int64_t window_ms_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, size_t> key_index_;
+  std::vector<uint64_t> keys_;
+  std::vector<float> values_;
+  int64_t window_begin_ms_ = 0;
+
+  std::atomic<uint64_t> added_key_num_{0};
+  std::atomic<uint64_t> added_batch_num_{0};
+  std::atomic<uint64_t> pushed_key_num_{0};
+  std::atomic<uint64_t> pushed_batch_num_{0};
+};
+
 using RpcCtxMap = std::unordered_map<std::string, CommContext>;
 using RecvCtxMap = std::unordered_map<uint64_t, std::vector<std::string>>;
 using SparseValue = std::unordered_map<int64_t, std::vector<float>>;
@@ -268,6 +318,10 @@ class Communicator {
   virtual void RpcSendSparse(const std::string &var_name,
                              int table_id,
                              const Scope &scope);
+  virtual void RpcSendSparseRows(int table_id,
+                                 const uint64_t *keys,
+                                 const float **values,
+                                 size_t num);
   // 5. send sparse param
   virtual void RpcSendSparseParam(const std::string &varname,
                                   int table_id,
@@ -496,6 +550,20 @@ class AsyncCommunicator : public Communicator {
                                  std::vector<phi::DenseTensor *> *outputs);
 
  protected:
+  // Whether the sparse pushes are aggregated over windows of batches, see
+  // FLAGS_communicator_sparse_push_window_ms.
+  virtual bool SparsePushAggregated() const {
+    return FLAGS_communicator_sparse_push_window_ms > 0;
+  }
+  SparsePushAggregator *GetSparsePushAggregator(uint64_t table_id,
+                                                size_t dim,
+                                                size_t keep_dim,
+                                                bool raw_gradient);
+  // Pushes the aggregated gradients of the full or expired windows, or of
+  // all the windows if force is true.
+  void FlushSparsePush(bool force);
+  void FlushSparsePush(uint64_t table_id, bool force);
+
   std::unordered_map<std::string,
                      std::shared_ptr<BlockingQueue<std::shared_ptr<Variable>>>>
       send_varname_to_queue_;
@@ -516,6 +584,13 @@ class AsyncCommunicator : public Communicator {
 
   std::unique_ptr<Scope> send_scope_;  // an independent scope
   std::atomic_uint grad_num_{0};  // the num of gradient sent since last recv
+
+  // table id -> aggregator, and whether the table is pushed with
+  // RpcSendSparseRows instead of PSClient::PushSparse
+  std::mutex sparse_push_mutex_;
+  std::unordered_map<uint64_t, std::unique_ptr<SparsePushAggregator>>
+      sparse_push_aggregators_;
+  std::unordered_map<uint64_t, bool> sparse_push_raw_gradient_;
 };
 
 class HalfAsyncCommunicator : public AsyncCommunicator {
@@ -556,6 +631,9 @@ class HalfAsyncCommunicator : public AsyncCommunicator {
   void BarrierWeakUp();
 
  protected:
+  // the gradients of a barrier are sent before it is released
+  bool SparsePushAggregated() const override { return false; }
+
   // mutex for Wait for barrier
   std::mutex barrier_mutex_;
   std::condition_variable barrier_cond_;
@@ -637,6 +715,8 @@ class GeoCommunicator : public AsyncCommunicator {
 
   void RecvByCommunicator() override { return; }
 
+  bool SparsePushAggregated() const override { return false; }
+
   inline std::string GradToParam(const std::string var_name) {
     std::string param_name = var_name.substr(0, var_name.size() - 5);
     return param_name;
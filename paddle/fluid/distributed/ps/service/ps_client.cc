@@ -63,6 +63,15 @@ int32_t PSClient::Configure(  // called in FleetWrapper::InitWorker
     accessor->Initialize();
     _table_accessors[work_param.downpour_table_param(i).table_id()].reset(
         accessor);
+    if (FLAGS_pserver_sparse_cache_capacity > 0 &&
+        work_param.downpour_table_param(i).type() == PS_SPARSE_TABLE) {
+      _sparse_value_caches[work_param.downpour_table_param(i).table_id()]
+          .reset(new SparseValueCache(
+              accessor,
+              FLAGS_pserver_sparse_cache_capacity,
+              FLAGS_pserver_sparse_cache_staleness_batches,
+              FLAGS_pserver_sparse_cache_staleness_ms));
+    }
   }
   return Initialize();
 }
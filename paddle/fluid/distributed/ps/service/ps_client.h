@@ -25,6 +25,7 @@
 #include "paddle/fluid/distributed/ps/service/env.h"
 #include "paddle/fluid/distributed/ps/service/sendrecv.pb.h"
 #include "paddle/fluid/distributed/ps/service/sparse_shard_value.h"
+#include "paddle/fluid/distributed/ps/service/sparse_value_cache.h"
 #include "paddle/fluid/distributed/ps/table/accessor.h"
 #include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
@@ -258,6 +259,16 @@ class PSClient {
     return itr->second.get();
   }
 
+  // Returns the cache of the values pulled from the sparse table, nullptr if
+  // the table is not cached, see FLAGS_pserver_sparse_cache_capacity.
+  SparseValueCache *GetSparseValueCache(size_t table_id) {
+    auto itr = _sparse_value_caches.find(table_id);
+    if (itr == _sparse_value_caches.end()) {
+      return nullptr;
+    }
+    return itr->second.get();
+  }
+
   virtual size_t GetServerNums() = 0;
 
   virtual std::future<int32_t> PushDenseRawGradient(int table_id,
@@ -373,6 +384,8 @@ class PSClient {
   std::map<uint64_t, std::vector<paddle::distributed::Region>>
       _dense_pull_regions;
   std::unordered_map<uint32_t, std::shared_ptr<ValueAccessor>> _table_accessors;
+  std::unordered_map<uint32_t, std::unique_ptr<SparseValueCache>>
+      _sparse_value_caches;
   std::unordered_map<int32_t, MsgHandlerFunc>
       _msg_handler_map;  // 处理client2client消息
 
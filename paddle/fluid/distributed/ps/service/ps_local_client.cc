@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/ps/service/ps_local_client.h"
+
+#include <cstring>
+
 #include "paddle/fluid/distributed/ps/table/table.h"
 
 namespace paddle::distributed {
@@ -75,7 +78,13 @@ int32_t PsLocalClient::Initialize() {
 }
 
 ::std::future<int32_t> PsLocalClient::Flush() {
-  // no need
+  // push the gradients merged in the sparse value caches
+  _flushing = true;
+  for (auto& cache_itr : _sparse_value_caches) {
+    PushSparse(cache_itr.first, nullptr, nullptr, 0);
+    cache_itr.second->PrintStat(cache_itr.first);
+  }
+  _flushing = false;
   return done();
 }
 
@@ -224,6 +233,57 @@ int32_t PsLocalClient::Initialize() {
   return done();
 }
 
+::std::future<int32_t> PsLocalClient::PullSparse(float** select_values,
+                                                 size_t table_id,
+                                                 const uint64_t* keys,
+                                                 size_t num,
+                                                 bool is_training) {
+  auto* table_ptr = GetTable(table_id);
+  auto* cache = GetSparseValueCache(table_id);
+  std::vector<uint64_t> pull_keys(keys, keys + num);
+  std::vector<float*> pull_values(select_values, select_values + num);
+  if (cache != nullptr) {
+    // only the keys missing in the cache are pulled from the table
+    cache->NewBatch();
+    std::vector<size_t> miss_index;
+    cache->Lookup(keys, num, select_values, &miss_index);
+    pull_keys.resize(miss_index.size());
+    pull_values.resize(miss_index.size());
+    for (size_t i = 0; i < miss_index.size(); ++i) {
+      pull_keys[i] = keys[miss_index[i]];
+      pull_values[i] = select_values[miss_index[i]];
+    }
+  }
+  if (pull_keys.empty()) {
+    return done();
+  }
+
+  size_t select_dim =
+      GetTableAccessor(table_id)->GetAccessorInfo().select_size /
+      sizeof(float);
+  std::vector<uint32_t> frequencies(pull_keys.size(), 1);
+  std::vector<float> values(pull_keys.size() * select_dim);
+  PullSparseValue pull_value(pull_keys, frequencies, select_dim);
+  pull_value.is_training_ = is_training;
+
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.pull_context.pull_value = pull_value;
+  table_context.pull_context.values = values.data();
+  table_context.num = pull_keys.size();
+  table_ptr->Pull(table_context);
+
+  for (size_t i = 0; i < pull_keys.size(); ++i) {
+    memcpy(pull_values[i],
+           values.data() + i * select_dim,
+           select_dim * sizeof(float));
+  }
+  if (cache != nullptr) {
+    cache->Update(pull_keys.data(), pull_values.data(), pull_keys.size());
+  }
+  return done();
+}
+
 ::std::future<int32_t> PsLocalClient::PullSparsePtr(
     int shard_id,
     char** select_values,
@@ -305,6 +365,27 @@ int32_t PsLocalClient::Initialize() {
                                                  const float** update_values,
                                                  size_t num) {
   auto* table_ptr = GetTable(table_id);
+  auto* cache = GetSparseValueCache(table_id);
+  std::vector<uint64_t> push_keys;
+  std::vector<const float*> push_values;
+  std::vector<float> merged_values;
+  if (cache != nullptr) {
+    // the gradients of the cached keys are merged locally and pushed once per
+    // staleness window
+    cache->FilterPush(keys,
+                      update_values,
+                      num,
+                      _flushing,
+                      &push_keys,
+                      &push_values,
+                      &merged_values);
+    keys = push_keys.data();
+    update_values = push_values.data();
+    num = push_keys.size();
+  }
+  if (num == 0) {
+    return done();
+  }
 
   TableContext table_context;
   table_context.value_type = Sparse;
@@ -0,0 +1,259 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/sparse_value_cache.h"
+
+#include <chrono>  // NOLINT
+#include <cstring>
+
+#include "glog/logging.h"
+#include "paddle/common/enforce.h"
+
+PD_DEFINE_int32(pserver_sparse_cache_capacity,
+                0,
+                "max number of pulled sparse values cached by a client for "
+                "each sparse table, 0 to disable the cache");
+
+PD_DEFINE_int32(pserver_sparse_cache_staleness_batches,
+                8,
+                "a cached sparse value is pulled again after this number of "
+                "pulls of the table");
+
+PD_DEFINE_int32(pserver_sparse_cache_staleness_ms,
+                1000,
+                "a cached sparse value is pulled again after this time, 0 to "
+                "bound the staleness by the number of pulls only");
+
+namespace paddle::distributed {
+
+namespace {
+
+inline int64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+SparseValueCache::SparseValueCache(ValueAccessor* accessor,
+                                   size_t capacity,
+                                   int staleness_batches,
+                                   int staleness_ms,
+                                   size_t shard_num)
+    : _accessor(accessor),
+      _staleness_batches(staleness_batches),
+      _staleness_ms(staleness_ms) {
+  PADDLE_ENFORCE_NOT_NULL(
+      accessor,
+      common::errors::InvalidArgument(
+          "The accessor of the sparse table to cache should not be null."));
+  PADDLE_ENFORCE_GT(
+      staleness_batches,
+      0,
+      common::errors::InvalidArgument(
+          "The staleness of the sparse value cache should be at least 1 "
+          "batch, but received %d.",
+          staleness_batches));
+  PADDLE_ENFORCE_GT(shard_num,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The shard num of the sparse value cache should be "
+                        "positive, but received %d.",
+                        shard_num));
+  auto info = accessor->GetAccessorInfo();
+  _select_dim = info.select_size / sizeof(float);
+  _update_dim = info.update_size / sizeof(float);
+  _shard_capacity = (capacity + shard_num - 1) / shard_num;
+  _shards.resize(shard_num);
+  for (auto& shard : _shards) {
+    shard = std::make_unique<Shard>();
+  }
+  _merge_time_ms = NowMs();
+}
+
+void SparseValueCache::NewBatch() { _batch.fetch_add(1); }
+
+void SparseValueCache::Lookup(const uint64_t* keys,
+                              size_t num,
+                              float** select_values,
+                              std::vector<size_t>* miss_index) {
+  uint64_t batch = _batch.load();
+  int64_t now = NowMs();
+  uint64_t hit_num = 0;
+  uint64_t stale_num = 0;
+  for (size_t i = 0; i < num; ++i) {
+    auto& shard = GetShard(keys[i]);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto itr = shard.entries.find(keys[i]);
+    if (itr == shard.entries.end()) {
+      miss_index->push_back(i);
+    } else if (!IsFresh(itr->second, batch, now)) {
+      ++stale_num;
+      miss_index->push_back(i);
+    } else {
+      ++hit_num;
+      memcpy(select_values[i],
+             itr->second.value.data(),
+             _select_dim * sizeof(float));
+    }
+  }
+  _lookup_num.fetch_add(num);
+  _hit_num.fetch_add(hit_num);
+  _stale_num.fetch_add(stale_num);
+}
+
+void SparseValueCache::Sweep(Shard* shard, uint64_t batch, int64_t now) {
+  shard->sweep_batch = batch;
+  uint64_t evict_num = 0;
+  for (auto itr = shard->entries.begin(); itr != shard->entries.end();) {
+    if (itr->second.grad.empty() && !IsFresh(itr->second, batch, now)) {
+      itr = shard->entries.erase(itr);
+      ++evict_num;
+    } else {
+      ++itr;
+    }
+  }
+  _evict_num.fetch_add(evict_num);
+}
+
+void SparseValueCache::Update(const uint64_t* keys,
+                              const float* const* values,
+                              size_t num) {
+  uint64_t batch = _batch.load();
+  int64_t now = NowMs();
+  uint64_t reject_num = 0;
+  for (size_t i = 0; i < num; ++i) {
+    auto& shard = GetShard(keys[i]);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto itr = shard.entries.find(keys[i]);
+    if (itr == shard.entries.end()) {
+      if (shard.entries.size() >= _shard_capacity &&
+          shard.sweep_batch != batch) {
+        Sweep(&shard, batch, now);
+      }
+      if (shard.entries.size() >= _shard_capacity) {
+        ++reject_num;
+        continue;
+      }
+      itr = shard.entries.emplace(keys[i], Entry()).first;
+    }
+    auto& entry = itr->second;
+    entry.batch = batch;
+    entry.time_ms = now;
+    entry.value.assign(values[i], values[i] + _select_dim);
+  }
+  _reject_num.fetch_add(reject_num);
+}
+
+void SparseValueCache::TakeMergedGrads(bool force,
+                                       std::vector<uint64_t>* keys,
+                                       std::vector<float>* values) {
+  {
+    std::lock_guard<std::mutex> lock(_merge_mutex);
+    uint64_t batch = _batch.load();
+    int64_t now = NowMs();
+    if (!force && batch < _merge_batch + _staleness_batches &&
+        (_staleness_ms <= 0 || now - _merge_time_ms < _staleness_ms)) {
+      return;
+    }
+    _merge_batch = batch;
+    _merge_time_ms = now;
+  }
+  for (auto& shard : _shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (auto& item : shard->entries) {
+      auto& grad = item.second.grad;
+      if (grad.empty()) {
+        continue;
+      }
+      keys->push_back(item.first);
+      values->insert(values->end(), grad.begin(), grad.end());
+      grad.clear();
+    }
+  }
+}
+
+void SparseValueCache::FilterPush(const uint64_t* keys,
+                                  const float** update_values,
+                                  size_t num,
+                                  bool force_merged,
+                                  std::vector<uint64_t>* push_keys,
+                                  std::vector<const float*>* push_values,
+                                  std::vector<float>* merged_values) {
+  push_keys->clear();
+  push_values->clear();
+  merged_values->clear();
+  uint64_t merged_grad_num = 0;
+  for (size_t i = 0; i < num; ++i) {
+    auto& shard = GetShard(keys[i]);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto itr = shard.entries.find(keys[i]);
+    if (itr == shard.entries.end()) {
+      push_keys->push_back(keys[i]);
+      push_values->push_back(update_values[i]);
+      continue;
+    }
+    auto& grad = itr->second.grad;
+    if (grad.empty()) {
+      grad.assign(update_values[i], update_values[i] + _update_dim);
+    } else {
+      float* grad_data = grad.data();
+      _accessor->Merge(&grad_data, &update_values[i], 1);
+      ++merged_grad_num;
+    }
+  }
+
+  size_t merged_begin = push_keys->size();
+  TakeMergedGrads(force_merged, push_keys, merged_values);
+  for (size_t i = merged_begin; i < push_keys->size(); ++i) {
+    push_values->push_back(merged_values->data() +
+                           (i - merged_begin) * _update_dim);
+  }
+  _merged_grad_num.fetch_add(merged_grad_num);
+  _pushed_grad_num.fetch_add(push_keys->size());
+}
+
+SparseValueCache::Stat SparseValueCache::GetStat() const {
+  Stat stat;
+  stat.lookup_num = _lookup_num.load();
+  stat.hit_num = _hit_num.load();
+  stat.stale_num = _stale_num.load();
+  stat.evict_num = _evict_num.load();
+  stat.reject_num = _reject_num.load();
+  stat.merged_grad_num = _merged_grad_num.load();
+  stat.pushed_grad_num = _pushed_grad_num.load();
+  return stat;
+}
+
+void SparseValueCache::PrintStat(size_t table_id) const {
+  auto stat = GetStat();
+  VLOG(0) << "SparseValueCache: table " << table_id << " size: " << Size()
+          << ", lookup: " << stat.lookup_num << ", hit: " << stat.hit_num
+          << ", hit rate: " << stat.HitRate() << ", stale: " << stat.stale_num
+          << ", evict: " << stat.evict_num << ", reject: " << stat.reject_num
+          << ", merged grad: " << stat.merged_grad_num
+          << ", pushed grad: " << stat.pushed_grad_num;
+}
+
+size_t SparseValueCache::Size() const {
+  size_t size = 0;
+  for (auto& shard : _shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    size += shard->entries.size();
+  }
+  return size;
+}
+
+}  // namespace paddle::distributed
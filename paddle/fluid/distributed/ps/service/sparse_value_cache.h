@@ -0,0 +1,157 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/distributed/ps/table/accessor.h"
+
+PD_DECLARE_int32(pserver_sparse_cache_capacity);
+PD_DECLARE_int32(pserver_sparse_cache_staleness_batches);
+PD_DECLARE_int32(pserver_sparse_cache_staleness_ms);
+
+namespace paddle {
+namespace distributed {
+
+// Client side cache of the values pulled from a sparse table.
+//
+// On skewed feature distributions a few head keys appear in nearly every
+// batch, and pulling them again and again costs most of the pull bandwidth
+// and pserver cpu. A cached value is served for at most
+// `staleness_batches` pulls of the table (counted over all the threads
+// pulling it) or `staleness_ms` milliseconds, whichever comes first, and is
+// pulled again afterwards.
+//
+// The gradients of the cached keys are merged locally by the accessor and
+// pushed once per staleness window, so a cached value misses the local
+// updates of at most one window as well.
+class SparseValueCache {
+ public:
+  struct Stat {
+    uint64_t lookup_num = 0;
+    uint64_t hit_num = 0;
+    // keys which are cached but had to be pulled again
+    uint64_t stale_num = 0;
+    uint64_t evict_num = 0;
+    // keys which are not cached since the cache is full
+    uint64_t reject_num = 0;
+    // gradients merged into a pending one, i.e. not pushed
+    uint64_t merged_grad_num = 0;
+    uint64_t pushed_grad_num = 0;
+
+    double HitRate() const {
+      return lookup_num == 0 ? 0.0 : static_cast<double>(hit_num) / lookup_num;
+    }
+  };
+
+  SparseValueCache(ValueAccessor* accessor,
+                   size_t capacity,
+                   int staleness_batches,
+                   int staleness_ms,
+                   size_t shard_num = 64);
+
+  // Starts a pull of the table, the entries cached `staleness_batches`
+  // pulls ago become stale.
+  void NewBatch();
+
+  // Copies the fresh cached values of keys to select_values, the indices of
+  // the other keys are appended to miss_index.
+  void Lookup(const uint64_t* keys,
+              size_t num,
+              float** select_values,
+              std::vector<size_t>* miss_index);
+
+  // Caches the values pulled for keys.
+  void Update(const uint64_t* keys, const float* const* values, size_t num);
+
+  // Merges the gradients of the cached keys into their pending gradients.
+  // Returns in push_keys and push_values the gradients to push now, which are
+  // those of the keys not cached and, once per staleness window or if
+  // force_merged is true, all the pending gradients. The latter are stored in
+  // merged_values which must outlive push_values.
+  void FilterPush(const uint64_t* keys,
+                  const float** update_values,
+                  size_t num,
+                  bool force_merged,
+                  std::vector<uint64_t>* push_keys,
+                  std::vector<const float*>* push_values,
+                  std::vector<float>* merged_values);
+
+  Stat GetStat() const;
+  void PrintStat(size_t table_id) const;
+  size_t Size() const;
+
+ private:
+  struct Entry {
+    // the batch and the time when the value is pulled
+    uint64_t batch = 0;
+    int64_t time_ms = 0;
+    std::vector<float> value;
+    // pending gradient, empty if there is none
+    std::vector<float> grad;
+  };
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, Entry> entries;
+    // the batch of the last eviction, a full shard is swept once per batch
+    uint64_t sweep_batch = UINT64_MAX;
+  };
+
+  inline Shard& GetShard(uint64_t key) {
+    return *_shards[key % _shards.size()];
+  }
+  inline bool IsFresh(const Entry& entry, uint64_t batch, int64_t now) const {
+    return batch < entry.batch + _staleness_batches &&
+           (_staleness_ms <= 0 || now - entry.time_ms < _staleness_ms);
+  }
+  // Evicts the stale entries without pending gradients.
+  void Sweep(Shard* shard, uint64_t batch, int64_t now);
+  // Takes the pending gradients if the staleness window elapsed.
+  void TakeMergedGrads(bool force,
+                       std::vector<uint64_t>* keys,
+                       std::vector<float>* values);
+
+  ValueAccessor* _accessor;
+  size_t _select_dim;
+  size_t _update_dim;
+  size_t _shard_capacity;
+  int _staleness_batches;
+  int _staleness_ms;
+  std::vector<std::unique_ptr<Shard>> _shards;
+
+  std::atomic<uint64_t> _batch{0};
+  // the batch and the time when the pending gradients are last taken
+  std::mutex _merge_mutex;
+  uint64_t _merge_batch = 0;
+  int64_t _merge_time_ms = 0;
+
+  std::atomic<uint64_t> _lookup_num{0};
+  std::atomic<uint64_t> _hit_num{0};
+  std::atomic<uint64_t> _stale_num{0};
+  std::atomic<uint64_t> _evict_num{0};
+  std::atomic<uint64_t> _reject_num{0};
+  std::atomic<uint64_t> _merged_grad_num{0};
+  std::atomic<uint64_t> _pushed_grad_num{0};
+};
+
+}  // namespace distributed
+}  // namespace paddle
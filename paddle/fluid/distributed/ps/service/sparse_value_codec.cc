@@ -0,0 +1,267 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/sparse_value_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "paddle/common/enforce.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/common/float16.h"
+#include "snappy.h"
+
+namespace paddle::distributed {
+
+std::string SparseWireFormat::ToString() const {
+  return std::string(reinterpret_cast<const char*>(this), sizeof(*this));
+}
+
+bool SparseWireFormat::FromString(const std::string& data) {
+  if (data.size() != sizeof(*this)) {
+    return false;
+  }
+  memcpy(reinterpret_cast<void*>(this), data.data(), sizeof(*this));
+  return true;
+}
+
+SparseWireFormat GetPullWireFormat(const TableParameter& table_param) {
+  const auto& wire_param = table_param.wire_param();
+  PADDLE_ENFORCE_NE(
+      wire_param.pull_encoding(),
+      SPARSE_VALUE_TOPK,
+      common::errors::InvalidArgument(
+          "SPARSE_VALUE_TOPK is only supported for the pushed values of "
+          "table %d.",
+          table_param.table_id()));
+  SparseWireFormat format;
+  format.encoding = static_cast<uint8_t>(wire_param.pull_encoding());
+  format.compress = wire_param.compress_pull() ? 1 : 0;
+  format.encoded_dim =
+      static_cast<uint16_t>(table_param.accessor().embedx_dim());
+  return format;
+}
+
+SparseWireFormat GetPushWireFormat(const TableParameter& table_param) {
+  const auto& wire_param = table_param.wire_param();
+  SparseWireFormat format;
+  format.encoding = static_cast<uint8_t>(wire_param.push_encoding());
+  format.encoded_dim =
+      static_cast<uint16_t>(table_param.accessor().embedx_dim());
+  if (format.encoding == SPARSE_VALUE_TOPK) {
+    PADDLE_ENFORCE_EQ(
+        wire_param.push_topk_ratio() > 0 && wire_param.push_topk_ratio() <= 1,
+        true,
+        common::errors::InvalidArgument(
+            "The push_topk_ratio of table %d should be in (0, 1], but "
+            "received %f.",
+            table_param.table_id(),
+            wire_param.push_topk_ratio()));
+    format.topk = static_cast<uint16_t>(
+        std::ceil(wire_param.push_topk_ratio() * format.encoded_dim));
+  }
+  return format;
+}
+
+SparseValueCodec::SparseValueCodec(const SparseWireFormat& format, size_t dim)
+    : _format(format), _dim(dim) {
+  _format.encoded_dim =
+      static_cast<uint16_t>(std::min<size_t>(format.encoded_dim, dim));
+  _format.topk = std::min(format.topk, _format.encoded_dim);
+  _raw_dim = dim - _format.encoded_dim;
+  size_t encoded_dim = _format.encoded_dim;
+  switch (_format.encoding) {
+    case SPARSE_VALUE_FP32:
+      _encoded_size = encoded_dim * sizeof(float);
+      break;
+    case SPARSE_VALUE_FP16:
+    case SPARSE_VALUE_BF16:
+      _encoded_size = encoded_dim * sizeof(uint16_t);
+      break;
+    case SPARSE_VALUE_INT8:
+      _encoded_size = sizeof(float) + encoded_dim * sizeof(int8_t);
+      break;
+    case SPARSE_VALUE_TOPK:
+      _encoded_size = _format.topk * (sizeof(uint16_t) + sizeof(float));
+      break;
+    default:
+      PADDLE_THROW(common::errors::InvalidArgument(
+          "Unknown sparse value encoding %d.", _format.encoding));
+  }
+  _encoded_size += _raw_dim * sizeof(float);
+}
+
+void SparseValueCodec::Encode(const float* value, char* out) const {
+  memcpy(out, value, _raw_dim * sizeof(float));
+  out += _raw_dim * sizeof(float);
+  const float* x = value + _raw_dim;
+  size_t n = _format.encoded_dim;
+  // out may not be aligned, the values are encoded into a local buffer
+  thread_local std::vector<uint16_t> buffer;
+  switch (_format.encoding) {
+    case SPARSE_VALUE_FP32:
+      memcpy(out, x, n * sizeof(float));
+      break;
+    case SPARSE_VALUE_FP16:
+    case SPARSE_VALUE_BF16:
+      buffer.resize(n);
+      if (_format.encoding == SPARSE_VALUE_FP16) {
+        FloatToFp16(x, buffer.data(), n);
+      } else {
+        FloatToBf16(x, buffer.data(), n);
+      }
+      memcpy(out, buffer.data(), n * sizeof(uint16_t));
+      break;
+    case SPARSE_VALUE_INT8: {
+      float scale = FloatToInt8(x, reinterpret_cast<int8_t*>(out + 4), n);
+      memcpy(out, &scale, sizeof(float));
+      break;
+    }
+    case SPARSE_VALUE_TOPK: {
+      size_t k = _format.topk;
+      buffer.resize(n);
+      std::iota(buffer.begin(), buffer.end(), 0);
+      std::nth_element(buffer.begin(),
+                       buffer.begin() + k,
+                       buffer.end(),
+                       [x](uint16_t a, uint16_t b) {
+                         return std::fabs(x[a]) > std::fabs(x[b]);
+                       });
+      memcpy(out, buffer.data(), k * sizeof(uint16_t));
+      out += k * sizeof(uint16_t);
+      for (size_t i = 0; i < k; ++i) {
+        memcpy(out + i * sizeof(float), x + buffer[i], sizeof(float));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void SparseValueCodec::Decode(const char* in, float* value) const {
+  memcpy(value, in, _raw_dim * sizeof(float));
+  in += _raw_dim * sizeof(float);
+  float* y = value + _raw_dim;
+  size_t n = _format.encoded_dim;
+  thread_local std::vector<uint16_t> buffer;
+  switch (_format.encoding) {
+    case SPARSE_VALUE_FP32:
+      memcpy(y, in, n * sizeof(float));
+      break;
+    case SPARSE_VALUE_FP16:
+    case SPARSE_VALUE_BF16:
+      buffer.resize(n);
+      memcpy(buffer.data(), in, n * sizeof(uint16_t));
+      if (_format.encoding == SPARSE_VALUE_FP16) {
+        Fp16ToFloat(buffer.data(), y, n);
+      } else {
+        Bf16ToFloat(buffer.data(), y, n);
+      }
+      break;
+    case SPARSE_VALUE_INT8: {
+      float scale = 0;
+      memcpy(&scale, in, sizeof(float));
+      Int8ToFloat(reinterpret_cast<const int8_t*>(in + 4), scale, y, n);
+      break;
+    }
+    case SPARSE_VALUE_TOPK: {
+      size_t k = _format.topk;
+      buffer.resize(k);
+      memcpy(buffer.data(), in, k * sizeof(uint16_t));
+      in += k * sizeof(uint16_t);
+      std::fill(y, y + n, 0.0f);
+      for (size_t i = 0; i < k; ++i) {
+        memcpy(y + buffer[i], in + i * sizeof(float), sizeof(float));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+namespace {
+bool UseF16C() {
+  static const bool use_f16c =
+      phi::backends::cpu::MayIUse(phi::backends::cpu::avx) &&
+      phi::backends::cpu::MayIUse(phi::backends::cpu::f16c);
+  return use_f16c;
+}
+}  // namespace
+
+void FloatToFp16(const float* x, uint16_t* y, size_t n) {
+  size_t i = UseF16C() ? FloatToFp16F16C(x, y, n) : 0;
+  for (; i < n; ++i) {
+    y[i] = phi::dtype::float16(x[i]).x;
+  }
+}
+
+void Fp16ToFloat(const uint16_t* x, float* y, size_t n) {
+  size_t i = UseF16C() ? Fp16ToFloatF16C(x, y, n) : 0;
+  for (; i < n; ++i) {
+    y[i] = static_cast<float>(phi::dtype::raw_uint16_to_float16(x[i]));
+  }
+}
+
+// The bf16 conversions are plain integer arithmetic which the compiler
+// vectorizes. Rounds to nearest even, the values are assumed to be finite.
+void FloatToBf16(const float* x, uint16_t* y, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t bits;
+    memcpy(&bits, x + i, sizeof(bits));
+    bits += 0x7FFFu + ((bits >> 16) & 1u);
+    y[i] = static_cast<uint16_t>(bits >> 16);
+  }
+}
+
+void Bf16ToFloat(const uint16_t* x, float* y, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t bits = static_cast<uint32_t>(x[i]) << 16;
+    memcpy(y + i, &bits, sizeof(bits));
+  }
+}
+
+float FloatToInt8(const float* x, int8_t* y, size_t n) {
+  float max_abs = 0;
+  for (size_t i = 0; i < n; ++i) {
+    max_abs = std::max(max_abs, std::fabs(x[i]));
+  }
+  float scale = max_abs / 127.0f;
+  float inv_scale = max_abs > 0 ? 127.0f / max_abs : 0.0f;
+  for (size_t i = 0; i < n; ++i) {
+    float q = x[i] * inv_scale;
+    y[i] = static_cast<int8_t>(q + (q >= 0 ? 0.5f : -0.5f));
+  }
+  return scale;
+}
+
+void Int8ToFloat(const int8_t* x, float scale, float* y, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    y[i] = static_cast<float>(x[i]) * scale;
+  }
+}
+
+void CompressSparseValues(const char* data, size_t size, std::string* out) {
+  snappy::Compress(data, size, out);
+}
+
+bool UncompressSparseValues(const char* data, size_t size, std::string* out) {
+  return snappy::Uncompress(data, size, out);
+}
+
+}  // namespace paddle::distributed
@@ -0,0 +1,89 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle {
+namespace distributed {
+
+// Wire format of the sparse values of a pull or push request, sent in the
+// request params by the client. A server which supports it encodes the
+// pulled values accordingly and echoes it in the response data, so that the
+// client falls back to fp32 with an older server.
+struct SparseWireFormat {
+  uint8_t encoding = SPARSE_VALUE_FP32;
+  // whether the encoded values are compressed with snappy
+  uint8_t compress = 0;
+  // number of trailing dims of a value which are encoded, i.e. embedx, the
+  // leading ones (show, click, embed) are kept in fp32
+  uint16_t encoded_dim = 0;
+  // number of the encoded dims kept by SPARSE_VALUE_TOPK
+  uint16_t topk = 0;
+  uint16_t reserved = 0;
+
+  bool IsRaw() const { return encoding == SPARSE_VALUE_FP32 && !compress; }
+  std::string ToString() const;
+  // Returns false if data is not a wire format.
+  bool FromString(const std::string& data);
+};
+
+// The wire formats of the pulled and pushed values of a sparse table, as
+// configured by its SparseWireParameter.
+SparseWireFormat GetPullWireFormat(const TableParameter& table_param);
+SparseWireFormat GetPushWireFormat(const TableParameter& table_param);
+
+// Encodes and decodes sparse values of dim floats with a wire format.
+class SparseValueCodec {
+ public:
+  SparseValueCodec(const SparseWireFormat& format, size_t dim);
+
+  // bytes of an encoded value
+  size_t EncodedSize() const { return _encoded_size; }
+  void Encode(const float* value, char* out) const;
+  void Decode(const char* in, float* value) const;
+
+ private:
+  SparseWireFormat _format;
+  size_t _dim;
+  size_t _raw_dim;
+  size_t _encoded_size;
+};
+
+// Converts n floats to fp16, bf16 and int8 and back. The int8 conversion
+// scales by the max magnitude, which is returned.
+void FloatToFp16(const float* x, uint16_t* y, size_t n);
+void Fp16ToFloat(const uint16_t* x, float* y, size_t n);
+void FloatToBf16(const float* x, uint16_t* y, size_t n);
+void Bf16ToFloat(const uint16_t* x, float* y, size_t n);
+float FloatToInt8(const float* x, int8_t* y, size_t n);
+void Int8ToFloat(const int8_t* x, float scale, float* y, size_t n);
+
+// F16C versions of FloatToFp16 and Fp16ToFloat, which convert the leading
+// multiple of 8 floats and return how many are converted, 0 if they are not
+// built with F16C. Only call them if the CPU supports F16C.
+size_t FloatToFp16F16C(const float* x, uint16_t* y, size_t n);
+size_t Fp16ToFloatF16C(const uint16_t* x, float* y, size_t n);
+
+// Block compression of the encoded values.
+void CompressSparseValues(const char* data, size_t size, std::string* out);
+bool UncompressSparseValues(const char* data, size_t size, std::string* out);
+
+}  // namespace distributed
+}  // namespace paddle
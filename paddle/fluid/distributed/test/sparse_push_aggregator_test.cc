@@ -0,0 +1,149 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/service/communicator/communicator.h"
+
+namespace paddle::distributed {
+
+// [slot, show, click, embed_g]
+constexpr size_t kDim = 4;
+
+void AddRows(SparsePushAggregator* aggregator,
+             const std::vector<uint64_t>& keys,
+             const std::vector<std::vector<float>>& rows) {
+  std::vector<const float*> values;
+  for (auto& row : rows) {
+    values.push_back(row.data());
+  }
+  aggregator->Add(keys.data(), values.data(), keys.size());
+}
+
+TEST(SparsePushAggregator, MergeDuplicatedKeys) {
+  SparsePushAggregator aggregator(kDim, 1, 1024, 1000000);
+  AddRows(&aggregator,
+          {7, 3, 7},
+          {{1, 1, 0, 0.5f}, {2, 1, 1, 0.25f}, {5, 1, 1, 1.5f}});
+  AddRows(&aggregator, {3}, {{9, 2, 0, -0.25f}});
+
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  ASSERT_EQ(aggregator.Take(&keys, &values), 2UL);
+  // The rows keep the order of the first appearance of their keys
+  EXPECT_EQ(keys, (std::vector<uint64_t>{7, 3}));
+  // The slot is kept from the first row, the other fields are summed
+  EXPECT_EQ(values, (std::vector<float>{1, 2, 1, 2, 2, 3, 1, 0}));
+}
+
+TEST(SparsePushAggregator, SumAllFields) {
+  SparsePushAggregator aggregator(kDim, 0, 1024, 1000000);
+  AddRows(&aggregator, {1, 1}, {{1, 2, 3, 4}, {10, 20, 30, 40}});
+
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  ASSERT_EQ(aggregator.Take(&keys, &values), 1UL);
+  EXPECT_EQ(values, (std::vector<float>{11, 22, 33, 44}));
+}
+
+TEST(SparsePushAggregator, FullAndTake) {
+  SparsePushAggregator aggregator(kDim, 1, 3, 1000000);
+  std::vector<float> row{0, 1, 0, 1};
+  AddRows(&aggregator, {1, 2}, {row, row});
+  EXPECT_FALSE(aggregator.Full());
+  // A duplicated key does not fill the window
+  AddRows(&aggregator, {2}, {row});
+  EXPECT_FALSE(aggregator.Full());
+  AddRows(&aggregator, {3}, {row});
+  EXPECT_TRUE(aggregator.Full());
+
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  EXPECT_EQ(aggregator.Take(&keys, &values), 3UL);
+  EXPECT_EQ(values.size(), 3 * kDim);
+  EXPECT_FALSE(aggregator.Full());
+
+  // The next window starts empty, also for the keys taken before
+  AddRows(&aggregator, {1}, {row});
+  EXPECT_EQ(aggregator.Take(&keys, &values), 1UL);
+  EXPECT_EQ(values, row);
+  EXPECT_EQ(aggregator.Take(&keys, &values), 0UL);
+  EXPECT_TRUE(keys.empty());
+}
+
+TEST(SparsePushAggregator, Expired) {
+  std::vector<float> row{0, 1, 0, 1};
+  SparsePushAggregator expiring_aggregator(kDim, 1, 1024, 0);
+  // An empty window never expires
+  EXPECT_FALSE(expiring_aggregator.Expired());
+  AddRows(&expiring_aggregator, {1}, {row});
+  EXPECT_TRUE(expiring_aggregator.Expired());
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  expiring_aggregator.Take(&keys, &values);
+  EXPECT_FALSE(expiring_aggregator.Expired());
+
+  SparsePushAggregator aggregator(kDim, 1, 1024, 1000000);
+  AddRows(&aggregator, {1}, {row});
+  EXPECT_FALSE(aggregator.Expired());
+}
+
+TEST(SparsePushAggregator, MergeRatio) {
+  SparsePushAggregator aggregator(kDim, 1, 1024, 1000000);
+  EXPECT_EQ(aggregator.MergeRatio(), 0.0);
+
+  std::vector<float> row{0, 1, 0, 1};
+  AddRows(&aggregator, {1, 2, 1}, {row, row, row});
+  AddRows(&aggregator, {2, 3}, {row, row});
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  ASSERT_EQ(aggregator.Take(&keys, &values), 3UL);
+  // 3 of the 5 added rows are pushed
+  EXPECT_DOUBLE_EQ(aggregator.MergeRatio(), 0.4);
+  EXPECT_FALSE(aggregator.StatString().empty());
+}
+
+TEST(SparsePushAggregator, ConcurrentAdd) {
+  constexpr int kThreadNum = 4;
+  constexpr int kBatchNum = 100;
+  SparsePushAggregator aggregator(kDim, 1, 1 << 20, 1000000);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&aggregator] {
+      std::vector<float> row{0, 1, 0, 0.5f};
+      for (int i = 0; i < kBatchNum; ++i) {
+        AddRows(&aggregator, {1, 2}, {row, row});
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  ASSERT_EQ(aggregator.Take(&keys, &values), 2UL);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(values[i * kDim + 1], kThreadNum * kBatchNum);
+    EXPECT_EQ(values[i * kDim + 3], kThreadNum * kBatchNum * 0.5f);
+  }
+}
+
+TEST(SparsePushAggregator, InvalidKeepDim) {
+  EXPECT_ANY_THROW(SparsePushAggregator(kDim, kDim + 1, 1024, 1000));
+}
+
+}  // namespace paddle::distributed
@@ -0,0 +1,195 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/service/sparse_value_cache.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/service/env.h"
+#include "paddle/fluid/distributed/ps/service/ps_client.h"
+#include "paddle/fluid/distributed/ps/service/ps_local_server.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle::distributed {
+
+// CtrCommonAccessor with embedx_dim 8: the pull value is
+// [show, click, embed_w, embedx_w * 8] and the push value is
+// [slot, show, click, embed_g, embedx_g * 8].
+constexpr int kEmbedxDim = 8;
+constexpr int kSelectDim = 3 + kEmbedxDim;
+constexpr int kUpdateDim = 4 + kEmbedxDim;
+
+PSParameter GetLocalPsProto() {
+  PSParameter ps_param;
+  auto* server_proto = ps_param.mutable_server_param();
+  auto* downpour_server_proto = server_proto->mutable_downpour_server_param();
+  auto* service_proto = downpour_server_proto->mutable_service_param();
+  service_proto->set_server_class("PsLocalServer");
+  service_proto->set_client_class("PsLocalClient");
+
+  auto* table_proto = downpour_server_proto->add_downpour_table_param();
+  table_proto->set_table_id(0);
+  table_proto->set_table_class("MemorySparseTable");
+  table_proto->set_shard_num(10);
+  table_proto->set_type(PS_SPARSE_TABLE);
+
+  auto* accessor_config = table_proto->mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(kSelectDim);
+  accessor_config->set_embedx_dim(kEmbedxDim);
+  // embedx is never created, only embed_w is updated
+  accessor_config->set_embedx_threshold(1e9);
+  accessor_config->mutable_ctr_accessor_param()->set_nonclk_coeff(0.2);
+  accessor_config->mutable_ctr_accessor_param()->set_click_coeff(1);
+  accessor_config->mutable_ctr_accessor_param()->set_base_threshold(0.5);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_threshold(0.2);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_keep_days(16);
+  accessor_config->mutable_ctr_accessor_param()->set_show_click_decay_rate(
+      0.99);
+  for (auto* sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    auto* naive_param = sgd_param->mutable_naive();
+    naive_param->set_learning_rate(0.1);
+    naive_param->set_initial_range(0);
+    naive_param->add_weight_bounds(-10.0);
+    naive_param->add_weight_bounds(10.0);
+  }
+  ps_param.mutable_worker_param()
+      ->mutable_downpour_worker_param()
+      ->add_downpour_table_param()
+      ->CopyFrom(*table_proto);
+  return ps_param;
+}
+
+// A PsLocalClient with its own tables, the sparse table is cached if
+// cache_capacity > 0.
+std::unique_ptr<PSClient> CreateLocalClient(const PSParameter& ps_param,
+                                            PSEnvironment* env,
+                                            int cache_capacity) {
+  FLAGS_pserver_sparse_cache_capacity = cache_capacity;
+  FLAGS_pserver_sparse_cache_staleness_batches = 3;
+  FLAGS_pserver_sparse_cache_staleness_ms = 0;
+  std::unique_ptr<PSClient> client(PSClientFactory::Create(ps_param));
+  EXPECT_NE(client, nullptr);
+  std::map<uint64_t, std::vector<Region>> regions;
+  EXPECT_EQ(client->Configure(ps_param, regions, *env, 0), 0);
+  FLAGS_pserver_sparse_cache_capacity = 0;
+  return client;
+}
+
+std::vector<float> Pull(PSClient* client, const std::vector<uint64_t>& keys) {
+  std::vector<float> values(keys.size() * kSelectDim, -1);
+  std::vector<float*> value_ptrs;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    value_ptrs.push_back(values.data() + i * kSelectDim);
+  }
+  EXPECT_EQ(
+      client->PullSparse(value_ptrs.data(), 0, keys.data(), keys.size(), true)
+          .get(),
+      0);
+  return values;
+}
+
+void Push(PSClient* client, const std::vector<uint64_t>& keys, float grad) {
+  std::vector<float> values(keys.size() * kUpdateDim);
+  std::vector<const float*> value_ptrs;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    float* value = values.data() + i * kUpdateDim;
+    value[0] = 1;  // slot
+    value[1] = 1;  // show
+    value[2] = 1;  // click, which makes the table create the key on push
+    for (int j = 3; j < kUpdateDim; ++j) {
+      value[j] = grad * (keys[i] + j);
+    }
+    value_ptrs.push_back(value);
+  }
+  EXPECT_EQ(
+      client->PushSparse(0, keys.data(), value_ptrs.data(), keys.size()).get(),
+      0);
+}
+
+TEST(SparseValueCache, BoundedStaleness) {
+  auto ps_param = GetLocalPsProto();
+  PaddlePSEnvironment env;
+  PsLocalServer server;
+  ASSERT_EQ(server.Configure(ps_param, env, 0), 0);
+  auto client = CreateLocalClient(ps_param, &env, 1000);
+  auto* cache = client->GetSparseValueCache(0);
+  ASSERT_NE(cache, nullptr);
+
+  std::vector<uint64_t> keys = {1, 2, 3, 4, 5, 3};
+  auto first = Pull(client.get(), keys);
+  EXPECT_EQ(cache->Size(), 5U);
+  EXPECT_EQ(cache->GetStat().hit_num, 0U);
+
+  // served by the cache for 3 pulls, the gradients of the cached keys are
+  // merged in the cache
+  Push(client.get(), {1, 2}, 1.0);
+  for (int batch = 1; batch < 3; ++batch) {
+    EXPECT_EQ(Pull(client.get(), keys), first);
+  }
+  auto stat = cache->GetStat();
+  EXPECT_EQ(stat.lookup_num, 18U);
+  EXPECT_EQ(stat.hit_num, 12U);
+  EXPECT_NEAR(stat.HitRate(), 2.0 / 3, 1e-6);
+
+  // stale and pulled again
+  Pull(client.get(), keys);
+  stat = cache->GetStat();
+  EXPECT_EQ(stat.hit_num, 12U);
+  EXPECT_EQ(stat.stale_num, 6U);
+}
+
+TEST(SparseValueCache, MergeGradient) {
+  auto ps_param = GetLocalPsProto();
+  PaddlePSEnvironment env;
+  auto cached_client = CreateLocalClient(ps_param, &env, 1000);
+  auto client = CreateLocalClient(ps_param, &env, 0);
+  ASSERT_NE(cached_client->GetSparseValueCache(0), nullptr);
+  ASSERT_EQ(client->GetSparseValueCache(0), nullptr);
+
+  // keys 1 and 2 are cached, key 7 is pushed without being pulled
+  std::vector<uint64_t> keys = {1, 2};
+  Pull(cached_client.get(), keys);
+  Pull(client.get(), keys);
+  for (int step = 0; step < 2; ++step) {
+    Push(cached_client.get(), {1, 2, 7}, 0.5);
+    Push(client.get(), {1, 2, 7}, 0.5);
+  }
+  auto stat = cached_client->GetSparseValueCache(0)->GetStat();
+  EXPECT_EQ(stat.merged_grad_num, 2U);
+  EXPECT_EQ(stat.pushed_grad_num, 2U);
+
+  // the merged gradients are pushed by the flush, and the next pulls after
+  // the staleness window see the same values as pushing every gradient
+  cached_client->Flush();
+  for (int batch = 0; batch < 3; ++batch) {
+    Pull(cached_client.get(), keys);
+  }
+  std::vector<uint64_t> all_keys = {1, 2, 7};
+  auto cached_values = Pull(cached_client.get(), all_keys);
+  auto values = Pull(client.get(), all_keys);
+  ASSERT_EQ(cached_values.size(), values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(cached_values[i], values[i], 1e-5);
+  }
+  // embed_w of key 1
+  EXPECT_NE(values[2], 0);
+}
+
+}  // namespace paddle::distributed
@@ -0,0 +1,186 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/service/sparse_value_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle::distributed {
+
+// [show, click, embed_w, embedx_w * 16]
+constexpr int kEmbedxDim = 16;
+constexpr int kDim = 3 + kEmbedxDim;
+
+std::vector<float> MakeValue() {
+  std::vector<float> value(kDim);
+  value[0] = 123;
+  value[1] = 4;
+  value[2] = 0.123456789f;
+  for (int i = 3; i < kDim; ++i) {
+    value[i] = std::sin(i * 0.7f) * (i % 5 + 1) * 0.1f;
+  }
+  return value;
+}
+
+std::vector<float> RoundTrip(const SparseWireFormat& format,
+                             const std::vector<float>& value,
+                             size_t expected_size) {
+  SparseValueCodec codec(format, value.size());
+  EXPECT_EQ(codec.EncodedSize(), expected_size);
+  // encodes at an odd offset as the values are packed in a buffer
+  std::vector<char> buffer(codec.EncodedSize() + 1);
+  codec.Encode(value.data(), buffer.data() + 1);
+  std::vector<float> decoded(value.size(), -1);
+  codec.Decode(buffer.data() + 1, decoded.data());
+  // show, click and embed_w are kept in fp32
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(decoded[i], value[i]);
+  }
+  return decoded;
+}
+
+SparseWireFormat MakeFormat(SparseValueEncoding encoding, int topk = 0) {
+  SparseWireFormat format;
+  format.encoding = encoding;
+  format.encoded_dim = kEmbedxDim;
+  format.topk = topk;
+  return format;
+}
+
+TEST(SparseValueCodec, HalfPrecision) {
+  auto value = MakeValue();
+  auto fp16 = RoundTrip(MakeFormat(SPARSE_VALUE_FP16), value, 3 * 4 + 16 * 2);
+  auto bf16 = RoundTrip(MakeFormat(SPARSE_VALUE_BF16), value, 3 * 4 + 16 * 2);
+  for (int i = 3; i < kDim; ++i) {
+    EXPECT_NEAR(fp16[i], value[i], std::fabs(value[i]) * 1e-3 + 1e-6);
+    EXPECT_NEAR(bf16[i], value[i], std::fabs(value[i]) * 8e-3 + 1e-6);
+  }
+}
+
+TEST(SparseValueCodec, F16C) {
+  if (!phi::backends::cpu::MayIUse(phi::backends::cpu::avx) ||
+      !phi::backends::cpu::MayIUse(phi::backends::cpu::f16c)) {
+    return;
+  }
+  // the F16C conversions round like the scalar ones, and leave the tail
+  std::vector<float> x(37);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = std::sin(i * 1.3f) * static_cast<float>(1 << (i % 12));
+  }
+  std::vector<uint16_t> expected(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    expected[i] = phi::dtype::float16(x[i]).x;
+  }
+  std::vector<uint16_t> y(x.size(), 0);
+  size_t converted = FloatToFp16F16C(x.data(), y.data(), x.size());
+  EXPECT_TRUE(converted == 0 || converted == 32);
+  for (size_t i = 0; i < converted; ++i) {
+    EXPECT_EQ(y[i], expected[i]);
+  }
+  std::vector<float> back(x.size(), 0);
+  converted = Fp16ToFloatF16C(expected.data(), back.data(), x.size());
+  for (size_t i = 0; i < converted; ++i) {
+    auto half = phi::dtype::raw_uint16_to_float16(expected[i]);
+    EXPECT_EQ(back[i], static_cast<float>(half));
+  }
+}
+
+TEST(SparseValueCodec, Int8) {
+  auto value = MakeValue();
+  auto int8 = RoundTrip(MakeFormat(SPARSE_VALUE_INT8), value, 3 * 4 + 4 + 16);
+  float max_abs = 0;
+  for (int i = 3; i < kDim; ++i) {
+    max_abs = std::max(max_abs, std::fabs(value[i]));
+  }
+  for (int i = 3; i < kDim; ++i) {
+    EXPECT_NEAR(int8[i], value[i], max_abs / 127 / 2 + 1e-6);
+  }
+
+  // all zeros
+  std::vector<float> zeros(kDim, 0);
+  auto decoded =
+      RoundTrip(MakeFormat(SPARSE_VALUE_INT8), zeros, 3 * 4 + 4 + 16);
+  EXPECT_EQ(decoded, zeros);
+}
+
+TEST(SparseValueCodec, TopK) {
+  auto value = MakeValue();
+  constexpr int kTopK = 4;
+  auto topk = RoundTrip(
+      MakeFormat(SPARSE_VALUE_TOPK, kTopK), value, 3 * 4 + kTopK * (2 + 4));
+  std::vector<float> magnitudes;
+  for (int i = 3; i < kDim; ++i) {
+    magnitudes.push_back(std::fabs(value[i]));
+  }
+  std::sort(magnitudes.begin(), magnitudes.end(), std::greater<float>());
+  int kept = 0;
+  for (int i = 3; i < kDim; ++i) {
+    if (topk[i] != 0) {
+      // the kept entries are exact and are the largest ones
+      EXPECT_EQ(topk[i], value[i]);
+      EXPECT_GE(std::fabs(value[i]), magnitudes[kTopK - 1]);
+      ++kept;
+    }
+  }
+  EXPECT_EQ(kept, kTopK);
+}
+
+TEST(SparseValueCodec, WireFormat) {
+  TableParameter table_param;
+  table_param.mutable_accessor()->set_embedx_dim(kEmbedxDim);
+  auto* wire_param = table_param.mutable_wire_param();
+  EXPECT_TRUE(GetPullWireFormat(table_param).IsRaw());
+  EXPECT_TRUE(GetPushWireFormat(table_param).IsRaw());
+
+  wire_param->set_pull_encoding(SPARSE_VALUE_BF16);
+  wire_param->set_compress_pull(true);
+  wire_param->set_push_encoding(SPARSE_VALUE_TOPK);
+  auto pull_format = GetPullWireFormat(table_param);
+  auto push_format = GetPushWireFormat(table_param);
+  EXPECT_EQ(push_format.topk, kEmbedxDim / 4);
+
+  SparseWireFormat format;
+  EXPECT_FALSE(format.FromString(""));
+  ASSERT_TRUE(format.FromString(pull_format.ToString()));
+  EXPECT_EQ(format.encoding, SPARSE_VALUE_BF16);
+  EXPECT_EQ(format.compress, 1);
+  EXPECT_EQ(format.encoded_dim, kEmbedxDim);
+
+  wire_param->set_pull_encoding(SPARSE_VALUE_TOPK);
+  EXPECT_ANY_THROW(GetPullWireFormat(table_param));
+}
+
+TEST(SparseValueCodec, Compress) {
+  std::vector<float> values(1024, 0.5f);
+  const char* data = reinterpret_cast<const char*>(values.data());
+  size_t size = values.size() * sizeof(float);
+  std::string compressed;
+  CompressSparseValues(data, size, &compressed);
+  EXPECT_LT(compressed.size(), size);
+  std::string uncompressed;
+  ASSERT_TRUE(UncompressSparseValues(
+      compressed.data(), compressed.size(), &uncompressed));
+  EXPECT_EQ(uncompressed, std::string(data, size));
+  EXPECT_FALSE(UncompressSparseValues("bad", 3, &uncompressed));
+}
+
+}  // namespace paddle::distributed
@@ -14,38 +14,108 @@
 
 #include "paddle/fluid/eager/backward.h"
 
+#include <ThreadPool.h>
+
+#include <condition_variable>  // NOLINT
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <mutex>  // NOLINT
+
+#include "paddle/common/flags.h"
 #include "paddle/fluid/eager/general_grad.h"
 #include "paddle/phi/core/memory/stats.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
 
+COMMON_DECLARE_int32(eager_backward_num_threads);
+
 namespace egr {
 
-std::unordered_map<GradNodeBase*, int> getInDegreeMap(
-    const std::deque<GradNodeBase*>& init_queue) {
-  // Calculate in_degree for each node
-  // We can completely remove this pass, if in_degree were set during forward
-  // pass
-  std::unordered_map<GradNodeBase*, int> node_in_degree_map;
+namespace {
 
-  // Copy nodes
-  std::deque<GradNodeBase*> queue = init_queue;
-  std::unordered_set<GradNodeBase*> visited;
+// GradTensorHolders reused by the backwards of a thread. The holders are
+// taken in stack order, a backward started by a grad node takes the ones
+// above those of the running backward and releases them when it finishes.
+class GradTensorHolderPool {
+ public:
+  static GradTensorHolderPool* Instance() {
+    thread_local GradTensorHolderPool pool;
+    return &pool;
+  }
 
-  // Visit each node exactly once in any order
-  while (!queue.empty()) {
-    GradNodeBase* node = queue.front();
-    queue.pop_front();
+  size_t Size() const { return size_; }
 
-    if (visited.count(node)) {
-      continue;
+  GradTensorHolder* Get(
+      const paddle::small_vector<std::vector<GradSlotMeta>,
+                                 kSlotSmallVectorSize>& metas) {
+    if (size_ == holders_.size()) {
+      holders_.emplace_back(std::make_unique<GradTensorHolder>(metas));
+    } else {
+      holders_[size_]->Reset(metas);
+    }
+    return holders_[size_++].get();
+  }
+
+  // Release the holders taken after the pool had size holders.
+  void Release(size_t size) {
+    for (size_t i = size; i < size_; ++i) {
+      holders_[i]->Clear();
+    }
+    size_ = size;
+    if (size_ == 0 && holders_.size() > kMaxCachedHolderNum) {
+      holders_.resize(kMaxCachedHolderNum);
     }
-    visited.insert(node);
+  }
+
+ private:
+  static constexpr size_t kMaxCachedHolderNum = 4096;
 
+  std::vector<std::unique_ptr<GradTensorHolder>> holders_;
+  size_t size_ = 0;
+};
+
+class GradTensorHolderPoolGuard {
+ public:
+  explicit GradTensorHolderPoolGuard(GradTensorHolderPool* pool)
+      : pool_(pool), size_(pool->Size()) {}
+  ~GradTensorHolderPoolGuard() { pool_->Release(size_); }
+
+ private:
+  GradTensorHolderPool* pool_;
+  size_t size_;
+};
+
+// Calculate in_degree for each node into its backward state
+void ComputeInDegree(const std::deque<GradNodeBase*>& init_queue,
+                     GradNodeBackwardStates* backward_states) {
+  // We can completely remove this pass, if in_degree were set during forward
+  // pass
+  thread_local std::vector<GradNodeBase*> stack;
+  // Left over if the last pass failed
+  stack.clear();
+
+  // Visit each node exactly once in any order
+  auto visit = [&stack, backward_states](GradNodeBase* node) {
     PADDLE_ENFORCE_NOT_NULL(
         node,
         common::errors::Fatal(
             "We got null node when we traverse the backward graph, and this "
             "should not happened please check your code and contact us."));
+    auto* state = backward_states->Get(node);
+    if (!state->visited) {
+      state->visited = true;
+      stack.push_back(node);
+    }
+    return state;
+  };
+  for (auto* node : init_queue) {
+    visit(node);
+  }
+  while (!stack.empty()) {
+    GradNodeBase* node = stack.back();
+    stack.pop_back();
+
     // Find and append next nodes
     const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
         metas = node->OutputMeta();
@@ -59,17 +129,14 @@ std::unordered_map<GradNodeBase*, int> getInDegreeMap(
         if (!next_node) continue;
 
         // Update in_degree
-        if (!node_in_degree_map.count(next_node))
-          node_in_degree_map[next_node] = 0;
-        node_in_degree_map[next_node]++;
-        queue.push_back(next_node);
+        visit(next_node)->in_degree++;
       }
     }
   }
-
-  return node_in_degree_map;
 }
 
+}  // namespace
+
 // Enforce GradNode has TensorWrappers as Input
 void EnforceGradNodeHasInput(GradNodeBase* node) {
   PADDLE_ENFORCE_NE(
@@ -100,6 +167,276 @@ void DuplicateCheck(const std::vector<paddle::Tensor>& inputs, bool is_input) {
   }
 }
 
+namespace {
+
+// Whether the current thread runs grad nodes for a parallel backward, a
+// backward started by a grad node (e.g. of a PyLayer) runs sequentially so
+// that it never waits for the threads of the pool.
+thread_local bool is_parallel_backward_thread = false;
+
+::ThreadPool* GetBackwardThreadPool() {
+  static std::unique_ptr<::ThreadPool> pool(
+      new ::ThreadPool(FLAGS_eager_backward_num_threads));
+  return pool.get();
+}
+
+// The thread local dygraph states of the thread calling backward, which the
+// grad nodes read on the threads of the pool.
+struct DygraphThreadState {
+  std::shared_ptr<paddle::imperative::Tracer> tracer;
+  bool has_grad;
+  paddle::imperative::AmpLevel amp_level;
+  std::string amp_dtype;
+  bool use_promote;
+
+  DygraphThreadState() {
+    auto& controller = egr::Controller::Instance();
+    tracer = controller.GetCurrentTracer();
+    has_grad = controller.HasGrad();
+    amp_level = controller.GetAMPLevel();
+    amp_dtype = tracer->GetAmpDtype();
+    use_promote = controller.GetUsePromote();
+  }
+
+  void Apply() const {
+    auto& controller = egr::Controller::Instance();
+    paddle::imperative::SetCurrentTracer(tracer);
+    controller.SetCurrentTracer(tracer);
+    controller.SetHasGrad(has_grad);
+    controller.SetAMPLevel(amp_level);
+    tracer->SetAmpDtype(amp_dtype);
+    controller.SetUsePromote(use_promote);
+  }
+};
+
+// Runs the grad nodes of a backward on the backward thread pool, a node is
+// dispatched once its in-degree drops to 0. The gradients sent to a node are
+// summed under the lock of its GradTensorHolder, and the force sequential
+// nodes run one after another in their order. The nodes never create graph,
+// see UseParallelBackward.
+class ParallelGradNodeRunner {
+ public:
+  ParallelGradNodeRunner(
+      GradNodeBackwardStates* backward_states,
+      GradTensorHolderPool* holder_pool,
+      std::deque<GradNodeBase*>* force_sequential_nodes_queue,
+      const std::set<GradNodeBase*>& force_sequential_nodes_set,
+      bool retain_graph,
+      const phi::Place& place)
+      : backward_states_(backward_states),
+        holder_pool_(holder_pool),
+        force_sequential_nodes_queue_(force_sequential_nodes_queue),
+        force_sequential_nodes_set_(force_sequential_nodes_set),
+        retain_graph_(retain_graph),
+        place_(place) {}
+
+  void Run(const std::deque<GradNodeBase*>& startup_nodes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto* node : startup_nodes) {
+      Schedule(node);
+    }
+    finished_cond_.wait(lock, [this] { return pending_num_ == 0; });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+ private:
+  static constexpr size_t kBufferMutexNum = 64;
+
+  std::mutex& BufferMutex(GradNodeBase* node) {
+    return buffer_mutexes_[std::hash<GradNodeBase*>()(node) % kBufferMutexNum];
+  }
+
+  // Must hold mutex_.
+  void Schedule(GradNodeBase* node) {
+    if (error_) {
+      return;
+    }
+    ++pending_num_;
+    GetBackwardThreadPool()->enqueue([this, node] { RunNode(node); });
+  }
+
+  // Must hold mutex_.
+  void ScheduleForceSequential() {
+    if (force_sequential_running_ || force_sequential_nodes_queue_->empty()) {
+      return;
+    }
+    auto* node = force_sequential_nodes_queue_->front();
+    if (ready_force_sequential_nodes_.erase(node)) {
+      force_sequential_nodes_queue_->pop_front();
+      force_sequential_running_ = true;
+      Schedule(node);
+    }
+  }
+
+  void RunNode(GradNodeBase* node) {
+    is_parallel_backward_thread = true;
+    thread_state_.Apply();
+    try {
+      RunNodeImpl(node);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (force_sequential_nodes_set_.count(node)) {
+      force_sequential_running_ = false;
+      ScheduleForceSequential();
+    }
+    if (--pending_num_ == 0) {
+      finished_cond_.notify_all();
+    }
+  }
+
+  void RunNodeImpl(GradNodeBase* node) {
+    VLOG(3) << "Preparing GradNode:" << node->name() << " addr:" << node;
+    GradTensorHolder* node_input_buffer = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto* state = backward_states_->Get(node);
+      node_input_buffer = state->input_buffer;
+      PADDLE_ENFORCE_NOT_NULL(
+          node_input_buffer,
+          common::errors::Fatal(
+              "Unable to find next node in the GradTensorHolder \n"
+              "Trying to run Node without configuring its GradTensorHolder."));
+      state->input_buffer = nullptr;
+    }
+
+    EnforceGradNodeHasInput(node);
+
+    phi::RecordEvent grad_node_record_event(
+        "Global_" + std::string((*node).name()),
+        phi::TracerEventType::Operator,
+        1);
+
+    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
+        grad_output_tensors = (*node)(node_input_buffer->Buffers());
+
+    if (!retain_graph_) {
+      node->ClearTensorWrappers();
+    }
+    node_input_buffer->Clear();
+
+    const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
+        metas = node->OutputMeta();
+    PADDLE_ENFORCE(metas.size() == grad_output_tensors.size() || metas.empty(),
+                   common::errors::Fatal(
+                       "Number of edges should be either empty ( for leaf node "
+                       ") or the same as number of output grad tensors, but we "
+                       "got edges size is: %d, grad_output size is: %d",
+                       metas.size(),
+                       grad_output_tensors.size()));
+
+    for (size_t i = 0; i < metas.size(); i++) {
+      for (size_t j = 0; j < metas[i].size(); j++) {
+        const Edge& edge = metas[i][j].GetEdge();
+        if (!edge.IsInitialized()) {
+          continue;
+        }
+        auto edge_rank = edge.GetEdgeRankInfo();
+        auto next_node_shared = edge.GetMutableGradNode();
+        if (!next_node_shared || !next_node_shared.get() ||
+            grad_output_tensors[i].empty()) {
+          continue;
+        }
+        PADDLE_ENFORCE_LT(
+            j,
+            grad_output_tensors[i].size(),
+            common::errors::Fatal(
+                "Rank of grad_output_tensors should be less than "
+                "grad_output_tensors[i].size(), which is: %d. This error may "
+                "indicate autoprune or autograd api error. ",
+                grad_output_tensors.size()));
+        paddle::Tensor& grad_output_tensor = grad_output_tensors[i][j];
+        auto* next_node = next_node_shared.get();
+
+        GradTensorHolder* next_buffer = nullptr;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          auto* state = backward_states_->Get(next_node);
+          if (state->input_buffer == nullptr) {
+            state->input_buffer = holder_pool_->Get(next_node->InputMeta());
+          }
+          next_buffer = state->input_buffer;
+        }
+        {
+          std::lock_guard<std::mutex> lock(BufferMutex(next_node));
+          next_buffer->add(edge_rank.first,
+                           edge_rank.second,
+                           grad_output_tensor,
+                           /*create_graph=*/false);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        int in_degree = --backward_states_->Get(next_node)->in_degree;
+        PADDLE_ENFORCE(
+            in_degree >= 0,
+            common::errors::Fatal(
+                "Detected in-degree value smaller than zero. For Node: %s"
+                "Node's in-degree cannot be negative.",
+                next_node->name()));
+        if (in_degree == 0) {
+          if (force_sequential_nodes_set_.count(next_node)) {
+            ready_force_sequential_nodes_.insert(next_node);
+            ScheduleForceSequential();
+          } else {
+            Schedule(next_node);
+          }
+        }
+      }
+    }
+    paddle::memory::LogDeviceMemoryStats(place_, std::string((*node).name()));
+  }
+
+  std::mutex mutex_;
+  std::condition_variable finished_cond_;
+  // Striped locks of the GradTensorHolders, as the holders are summed into
+  // out of mutex_
+  std::array<std::mutex, kBufferMutexNum> buffer_mutexes_;
+  // The states are created and the holders are taken under mutex_
+  GradNodeBackwardStates* backward_states_;
+  GradTensorHolderPool* holder_pool_;
+  std::deque<GradNodeBase*>* force_sequential_nodes_queue_;
+  const std::set<GradNodeBase*>& force_sequential_nodes_set_;
+  std::set<GradNodeBase*> ready_force_sequential_nodes_;
+  bool force_sequential_running_ = false;
+  size_t pending_num_ = 0;
+  std::exception_ptr error_;
+
+  bool retain_graph_;
+  phi::Place place_;
+  DygraphThreadState thread_state_;
+};
+
+// The grad nodes run in parallel for the backward of CPU tensors, if every
+// startup node is ready. GeneralGrad prunes the graph while running, so it
+// always runs sequentially. A backward with create_graph also runs
+// sequentially, since its grad nodes would trace new grad nodes on several
+// threads, which registers them in the global dygraph states (e.g. the force
+// sequential nodes of the Controller) without any lock.
+bool UseParallelBackward(const phi::Place& place,
+                         bool is_general_grad,
+                         bool create_graph,
+                         const std::deque<GradNodeBase*>& startup_nodes,
+                         GradNodeBackwardStates* backward_states) {
+  if (FLAGS_eager_backward_num_threads < 2 || is_parallel_backward_thread ||
+      is_general_grad || create_graph || !phi::is_cpu_place(place)) {
+    return false;
+  }
+  for (auto* node : startup_nodes) {
+    if (backward_states->Get(node)->in_degree != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 GeneralGrad* GeneralGrad::general_grad_ = new GeneralGrad();
 
 std::vector<paddle::Tensor> RunBackward(
@@ -115,6 +452,13 @@ std::vector<paddle::Tensor> RunBackward(
   egr::EagerBackwardStateGuard guard;
   auto place = egr::Controller::Instance().GetExpectedPlace();
 
+  // The in-degrees and GradTensorHolders of the grad nodes are kept in the
+  // backward states of this backward, and the holders are taken from the
+  // pool of this thread, which are released when the backward finishes.
+  GradNodeBackwardStates backward_states;
+  GradTensorHolderPool* holder_pool = GradTensorHolderPool::Instance();
+  GradTensorHolderPoolGuard holder_pool_guard(holder_pool);
+
   // *Gradient Hook should happen at node-level
   // *Inplace version check should perform at node-level
   // *Cross-batch accumulation happens at forward pass
@@ -128,9 +472,6 @@ std::vector<paddle::Tensor> RunBackward(
   // 2. Prepare initial input buffers
   std::deque<GradNodeBase*> queue;
   std::deque<GradNodeBase*> orig_queue;
-  std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>
-      node_input_buffers_dict;
-  std::unordered_set<GradNodeBase*> visited;
   for (size_t i = 0; i < tensors.size(); i++) {
     const paddle::Tensor& tensor = tensors[i];
 
@@ -171,11 +512,11 @@ std::vector<paddle::Tensor> RunBackward(
     }
 
     // Prepare GradTensorHolder
-    if (!node_input_buffers_dict.count(grad_node)) {
+    auto* grad_node_state = backward_states.Get(grad_node);
+    if (grad_node_state->input_buffer == nullptr) {
       VLOG(5) << "Create Value for grad input tensor " << i
               << " of grad node: " << grad_node->name();
-      node_input_buffers_dict[grad_node] =
-          std::make_unique<GradTensorHolder>(grad_node->InputMeta());
+      grad_node_state->input_buffer = holder_pool->Get(grad_node->InputMeta());
     }
 
     // copy grad tensor since we should totally run grad without affect forward
@@ -191,7 +532,7 @@ std::vector<paddle::Tensor> RunBackward(
       VLOG(3) << "Fill grad input tensor " << i << "with give grad tensor";
 
       // Deep copy
-      node_input_buffers_dict[grad_node]->CopyValueFromTensor(
+      grad_node_state->input_buffer->CopyValueFromTensor(
           input_info.first, input_info.second, grad_tensors[i]);
     } else {
       VLOG(3) << "Fill grad input tensor " << i << " with 1.0";
@@ -200,28 +541,27 @@ std::vector<paddle::Tensor> RunBackward(
       // dims
       // GradTensorHolder will initialize another tensor with same tensortype,
       // datatype and dims but filled with 1.0
-      node_input_buffers_dict[grad_node]->CopyValueFromTensor(
+      grad_node_state->input_buffer->CopyValueFromTensor(
           input_info.first, input_info.second, tensor, /*fill_one=*/true);
     }
 
     // Prepare queue, potential startup_nodes
-    if (visited.count(grad_node)) {
+    if (grad_node_state->queued) {
       continue;
     }
-    visited.insert(grad_node);
+    grad_node_state->queued = true;
     queue.push_back(grad_node);
   }
 
   if (is_general_grad) {
     // Prepare several vital preprocess for GeneralGrad
     GeneralGrad::Instance().PreparedForGeneralGrad(
-        inputs, no_grad_vars, orig_queue, &queue, node_input_buffers_dict);
+        inputs, no_grad_vars, orig_queue, &queue, &backward_states);
   }
 
   VLOG(5) << "Update In degree Map for backward";
   // 3. Compute in_degree for each node
-  std::unordered_map<GradNodeBase*, int> node_in_degree_map =
-      getInDegreeMap(queue);
+  ComputeInDegree(queue, &backward_states);
 
   std::queue<GradNodeBase*> force_sequential_nodes_forward_queue =
       egr::Controller::Instance().GetForceSequentialNodes();
@@ -231,8 +571,13 @@ std::vector<paddle::Tensor> RunBackward(
   auto force_sequential_nodes_size =
       force_sequential_nodes_forward_queue.size();
   for (size_t i = 0; i < force_sequential_nodes_size; ++i) {
-    if (node_in_degree_map.count(
-            force_sequential_nodes_forward_queue.front())) {
+    // Only the nodes waiting for grads in this backward
+    GradNodeBase* force_sequential_node =
+        force_sequential_nodes_forward_queue.front();
+    auto* force_sequential_node_state =
+        backward_states.Find(force_sequential_node);
+    if (force_sequential_node_state != nullptr &&
+        force_sequential_node_state->in_degree > 0) {
       force_sequential_nodes_set.insert(
           force_sequential_nodes_forward_queue.front());
       force_sequential_nodes_queue.push_front(
@@ -243,6 +588,21 @@ std::vector<paddle::Tensor> RunBackward(
 
   VLOG(5) << "Startup_ops's size is " << queue.size();
 
+  bool run_parallel =
+      UseParallelBackward(
+          place, is_general_grad, create_graph, queue, &backward_states);
+  if (run_parallel) {
+    VLOG(3) << "Run grad nodes with " << FLAGS_eager_backward_num_threads
+            << " threads";
+    ParallelGradNodeRunner runner(&backward_states,
+                                  holder_pool,
+                                  &force_sequential_nodes_queue,
+                                  force_sequential_nodes_set,
+                                  retain_graph,
+                                  place);
+    runner.Run(queue);
+  }
+
   /* --- Topological Visit --- */
   // 1. Pop queue
   // 2. Run node
@@ -250,28 +610,25 @@ std::vector<paddle::Tensor> RunBackward(
   //    |- node(grads)
   //    |- Prepare for next node
   // 3. Update queue
-  while (!queue.empty()) {
+  while (!run_parallel && !queue.empty()) {
     GradNodeBase* node = queue.front();
     VLOG(3) << "Preparing GradNode:" << node->name() << " addr:" << node;
+    auto* node_state = backward_states.Get(node);
 
-    if (queue.size() > 1 && node_in_degree_map[node] != 0) {
+    if (queue.size() > 1 && node_state->in_degree != 0) {
       queue.pop_front();
       continue;
     }
     queue.pop_front();
 
     // Run node: This is where Hook happens
-    auto node_input_buffer_iter = node_input_buffers_dict.find(node);
-    PADDLE_ENFORCE_NE(
-        node_input_buffer_iter,
-        node_input_buffers_dict.end(),
+    GradTensorHolder* node_input_buffer = node_state->input_buffer;
+    PADDLE_ENFORCE_NOT_NULL(
+        node_input_buffer,
         common::errors::Fatal(
             "Unable to find next node in the GradTensorHolder \n"
             "Trying to run Node without configuring its GradTensorHolder."));
 
-    std::unique_ptr<GradTensorHolder> node_input_buffer =
-        std::move(node_input_buffer_iter->second);
-
     // Check input
     EnforceGradNodeHasInput(node);
 
@@ -308,8 +665,9 @@ std::vector<paddle::Tensor> RunBackward(
       node->ClearTensorWrappers();
     }
 
-    // TODO(jiabin): Should we erase it or find a more efficient way.
-    node_input_buffers_dict.erase(node_input_buffer_iter);
+    // Release the grads of the node, the holder is reused after the backward
+    node_state->input_buffer = nullptr;
+    node_input_buffer->Clear();
 
     // Prepare GradTensorHolder for next node
     const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
@@ -364,30 +722,29 @@ std::vector<paddle::Tensor> RunBackward(
                 << " 's name is: " << grad_output_tensor.name();
 
         auto* next_node = next_node_shared.get();
-        if (!node_input_buffers_dict.count(next_node)) {
-          const auto& input_meta = next_node->InputMeta();
-          auto grad_tensor_holder =
-              std::make_unique<GradTensorHolder>(input_meta);
+        auto* next_node_state = backward_states.Get(next_node);
+        if (next_node_state->input_buffer == nullptr) {
           VLOG(7) << "Construct GradTensorHolder for grad node: "
                   << next_node->name();
-          node_input_buffers_dict[next_node] = std::move(grad_tensor_holder);
+          next_node_state->input_buffer =
+              holder_pool->Get(next_node->InputMeta());
         }
 
         VLOG(3) << "Sum or Move grad inputs for edge slot: " << edge_rank.first
                 << ", rank: " << edge_rank.second;
 
-        node_input_buffers_dict[next_node]->add(edge_rank.first,
-                                                edge_rank.second,
-                                                grad_output_tensor,
-                                                create_graph);
+        next_node_state->input_buffer->add(edge_rank.first,
+                                           edge_rank.second,
+                                           grad_output_tensor,
+                                           create_graph);
 
         // Update queue
-        node_in_degree_map[next_node]--;
+        next_node_state->in_degree--;
         VLOG(7) << next_node->name()
-                << " ref_cnt is: " << node_in_degree_map[next_node];
+                << " ref_cnt is: " << next_node_state->in_degree;
 
         PADDLE_ENFORCE(
-            node_in_degree_map[next_node] >= 0,
+            next_node_state->in_degree >= 0,
             common::errors::Fatal(
                 "Detected in-degree value smaller than zero. For Node: %s"
                 "Node's in-degree cannot be negative.",
@@ -400,7 +757,7 @@ std::vector<paddle::Tensor> RunBackward(
             queue.push_back(next_node);
           }
         };
-        if (node_in_degree_map[next_node] == 0) {
+        if (next_node_state->in_degree == 0) {
           if (force_sequential_nodes_set.count(next_node)) {
             if (force_sequential_nodes_queue.front() == next_node) {
               force_sequential_nodes_queue.pop_front();
@@ -424,6 +781,9 @@ std::vector<paddle::Tensor> RunBackward(
     }
     paddle::memory::LogDeviceMemoryStats(place, std::string((*node).name()));
   }
+  // GetResults frees the grad nodes copied by GeneralGrad, so their states
+  // are released before that
+  backward_states.Release();
 
   VLOG(7) << "Run Backward Final hook size: "
           << egr::Controller::Instance().FinalBackwardHooks().size();
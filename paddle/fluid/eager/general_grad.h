@@ -216,18 +216,17 @@ class GeneralGrad {
   }
 
   // Set result for input target grad_var when potential_startup_nodes_ is empty
-  void SetResultForInputTargetVar(
-      const std::unordered_map<GradNodeBase*,
-                               std::unique_ptr<GradTensorHolder>>&
-          node_input_buffers_dict) {
+  void SetResultForInputTargetVar(GradNodeBackwardStates* backward_states) {
     if (potential_startup_nodes_.size() == 0) {
       for (auto input_target_node : *GetInputTargetNodesInputMetaMap()) {
         // out rank_info of forward op
         auto rank_info = input_target_node.second->OutRankInfo();
-        auto iter = node_input_buffers_dict.find(input_target_node.first);
-        if (iter != node_input_buffers_dict.end()) {
+        auto* state = backward_states->Find(input_target_node.first);
+        GradTensorHolder* input_buffer =
+            state != nullptr ? state->input_buffer : nullptr;
+        if (input_buffer != nullptr) {
           auto& target_result =
-              (iter->second)->Buffers()[rank_info.first][rank_info.second];
+              input_buffer->Buffers()[rank_info.first][rank_info.second];
           // save the target result
           results_map_[input_target_node.first] =
               std::make_shared<paddle::Tensor>(target_result);
@@ -580,9 +579,7 @@ class GeneralGrad {
       const std::vector<paddle::Tensor>& no_grad_vars,
       const std::deque<GradNodeBase*>& orig_queue,
       std::deque<GradNodeBase*>* queue,
-      const std::unordered_map<GradNodeBase*,
-                               std::unique_ptr<GradTensorHolder>>&
-          node_input_buffers_dict) {
+      GradNodeBackwardStates* backward_states) {
     // Copy Backward Graph
     CopyBackwardGraph(orig_queue);
     // Get no_grad_vars's GradNodes and InputMeta Info
@@ -603,7 +600,7 @@ class GeneralGrad {
     ModifyReadyQueue(queue);
     // Set result for input target grad_var when queue is empty
     if (queue->empty()) {
-      SetResultForInputTargetVar(node_input_buffers_dict);
+      SetResultForInputTargetVar(backward_states);
     } else {
       // TODO(wuweilong): Find a better design here.
       ModifyBackwardGraph(queue);
@@ -867,4 +867,22 @@ uintptr_t GradNodeBase::GetPtr() const {
   return reinterpret_cast<uintptr_t>(this);
 }
 
+namespace {
+// 0 is never used, it marks a free backward state
+std::atomic<uint64_t> backward_epoch_counter{0};
+}  // namespace
+
+GradNodeBackwardStates::GradNodeBackwardStates()
+    : epoch_(++backward_epoch_counter) {}
+
+GradNodeBackwardStates::~GradNodeBackwardStates() { Release(); }
+
+void GradNodeBackwardStates::Release() {
+  for (auto* node : acquired_nodes_) {
+    node->ReleaseBackwardState(epoch_);
+  }
+  acquired_nodes_.clear();
+  table_states_.clear();
+}
+
 }  // namespace egr
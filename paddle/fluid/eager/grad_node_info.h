@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "paddle/fluid/eager/api/utils/global_utils.h"
 #include "paddle/fluid/eager/eager_tensor.h"
@@ -194,6 +197,34 @@ class GradSlotMeta {
   bool is_dist_meta_{false};
 };
 
+class GradTensorHolder;
+
+/**
+ * GradNodeBackwardState is the scratch state of a grad node kept by
+ * RunBackward, so that the backward needs no hash maps keyed by the grad
+ * nodes. The state in a grad node is held by at most one running backward,
+ * whose epoch it is stamped with, see GradNodeBackwardStates. It is not
+ * copied with the grad node.
+ * **/
+struct GradNodeBackwardState {
+  // Epoch of the backward holding the state, 0 if it is free
+  std::atomic<uint64_t> epoch{0};
+  // Number of the grad nodes which have not sent their grads to this node
+  int in_degree{0};
+  // Whether this node is visited when computing the in-degrees
+  bool visited{false};
+  // Whether this node is pushed to the queue as a startup node
+  bool queued{false};
+  // Holder of the grads sent to this node, owned by the backward
+  GradTensorHolder* input_buffer{nullptr};
+
+  GradNodeBackwardState() = default;
+  GradNodeBackwardState(const GradNodeBackwardState&) {}
+  GradNodeBackwardState& operator=(const GradNodeBackwardState&) {
+    return *this;
+  }
+};
+
 class GradNodeBase {
  public:
   GradNodeBase() { VLOG(7) << "Construct GradNodeBase"; }
@@ -340,6 +371,38 @@ class GradNodeBase {
     is_run_auto_parallel_ = is_run_auto_parallel;
   }
 
+  /**
+   * The following interfaces are designed for GradNodeBackwardStates
+   * **/
+  // The scratch state if the backward with epoch holds it, nullptr otherwise
+  GradNodeBackwardState* FindBackwardState(uint64_t epoch) {
+    return backward_state_.epoch.load(std::memory_order_acquire) == epoch
+               ? &backward_state_
+               : nullptr;
+  }
+
+  // Take the reset scratch state for the backward with epoch, nullptr if
+  // another running backward holds it
+  GradNodeBackwardState* AcquireBackwardState(uint64_t epoch) {
+    uint64_t free_epoch = 0;
+    if (!backward_state_.epoch.compare_exchange_strong(
+            free_epoch, epoch, std::memory_order_acquire)) {
+      return nullptr;
+    }
+    backward_state_.in_degree = 0;
+    backward_state_.visited = false;
+    backward_state_.queued = false;
+    backward_state_.input_buffer = nullptr;
+    return &backward_state_;
+  }
+
+  void ReleaseBackwardState(uint64_t epoch) {
+    if (FindBackwardState(epoch) != nullptr) {
+      backward_state_.input_buffer = nullptr;
+      backward_state_.epoch.store(0, std::memory_order_release);
+    }
+  }
+
  private:
   // bwd_out_meta_ is used to record Grad output info for backward
   paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>
@@ -371,6 +434,63 @@ class GradNodeBase {
   // With this flag, short-circuit the backward traversal of Tensor and
   // set the DistAttr to reduce the impact on scheduling performance
   bool is_run_auto_parallel_{false};
+
+  GradNodeBackwardState backward_state_;
+};
+
+/**
+ * GradNodeBackwardStates are the states of the grad nodes reached by one
+ * backward. A grad node holds the state of one running backward inline, if
+ * another running backward holds it, e.g. an outer backward of a backward
+ * started by a hook or a PyLayer, or a backward of an overlapping graph on
+ * another thread, the state is kept in a table of this backward instead. So
+ * nested and concurrent backwards never share states.
+ * **/
+class GradNodeBackwardStates {
+ public:
+  TEST_API GradNodeBackwardStates();
+  TEST_API ~GradNodeBackwardStates();
+
+  GradNodeBackwardStates(const GradNodeBackwardStates&) = delete;
+  GradNodeBackwardStates& operator=(const GradNodeBackwardStates&) = delete;
+
+  // Get the state of node, which is created if the node was not reached
+  GradNodeBackwardState* Get(GradNodeBase* node) {
+    if (auto* state = node->FindBackwardState(epoch_)) {
+      return state;
+    }
+    if (!table_states_.empty()) {
+      auto iter = table_states_.find(node);
+      if (iter != table_states_.end()) {
+        return &iter->second;
+      }
+    }
+    if (auto* state = node->AcquireBackwardState(epoch_)) {
+      acquired_nodes_.push_back(node);
+      return state;
+    }
+    return &table_states_[node];
+  }
+
+  // Get the state of node, nullptr if the node was not reached
+  GradNodeBackwardState* Find(GradNodeBase* node) {
+    if (auto* state = node->FindBackwardState(epoch_)) {
+      return state;
+    }
+    auto iter = table_states_.find(node);
+    return iter != table_states_.end() ? &iter->second : nullptr;
+  }
+
+  // Release the inline states of the reached nodes, which must still be
+  // alive, e.g. before GeneralGrad frees its copied nodes. Also called on
+  // destruction.
+  TEST_API void Release();
+
+ private:
+  uint64_t epoch_;
+  // The grad nodes whose inline states are held, released on destruction
+  std::vector<GradNodeBase*> acquired_nodes_;
+  std::unordered_map<GradNodeBase*, GradNodeBackwardState> table_states_;
 };
 
 }  // namespace egr
@@ -31,6 +31,25 @@ void GradTensorHolder::SetBufferSlotRankZeros(size_t slot_id, size_t rank) {
       paddle::experimental::zeros_like(buffer_[slot_id][rank]);
 }
 
+void GradTensorHolder::Reset(
+    const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
+        metas) {
+  VLOG(7) << "Reset GradTensorHolder with meta size: " << metas.size();
+  buffer_.resize(metas.size());
+  for (size_t i = 0; i < buffer_.size(); i++) {
+    buffer_[i].clear();
+    buffer_[i].resize(metas[i].size());
+  }
+}
+
+void GradTensorHolder::Clear() {
+  for (auto& slot : buffer_) {
+    for (auto& tensor : slot) {
+      tensor.reset();
+    }
+  }
+}
+
 void GradTensorHolder::CopyValueFromTensor(size_t slot_id,
                                            size_t rank,
                                            const paddle::Tensor& t,
@@ -66,6 +66,13 @@ class GradTensorHolder {
 
   void SetBufferSlotRankZeros(size_t slot_id, size_t rank);
 
+  // Reset to the empty grads of metas, so that a holder is reused by another
+  // grad node without reallocating the buffers of its slots.
+  void Reset(const paddle::small_vector<std::vector<GradSlotMeta>,
+                                        kSlotSmallVectorSize>& metas);
+  // Release the grads held but keep the slots.
+  void Clear();
+
  private:
   paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
       buffer_;
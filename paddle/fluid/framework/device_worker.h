@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <atomic>
 #include <fstream>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -363,7 +364,39 @@ class DownpourWorker : public HogwildWorker {
   void CopyDenseTable();
   void CopyDenseVars();
 
+  // A batch read ahead of the one being trained, with its sparse pulls in
+  // flight. The feed variables are read into a scope of its own, which is not
+  // a kid of thread_scope_ since the kids are dropped after every batch.
+  struct PrefetchBatch {
+    std::unique_ptr<Scope> scope;
+    int batch_size = 0;
+    std::map<uint64_t, std::vector<uint64_t>> features;
+    // only the unique keys of features are pulled, key_index maps every
+    // feasign to the pulled value of its key
+    std::map<uint64_t, std::vector<uint64_t>> unique_keys;
+    std::map<uint64_t, std::vector<size_t>> key_index;
+    std::map<uint64_t, std::vector<std::vector<float>>> unique_values;
+    std::vector<::std::future<int32_t>> pull_sparse_status;
+  };
+  // Returns the size of the next batch to train, 0 if there is none. With
+  // prefetching, the feed variables and the pulled sparse values of the
+  // batch are moved to thread_scope_, features_ and feature_values_.
+  int NextBatch();
+  bool PrefetchNextBatch(PrefetchBatch* batch);
+  std::future<int32_t> PullPrefetchedSparse(PrefetchBatch* batch,
+                                            uint64_t table_id);
+  void WaitPrefetchedBatch(PrefetchBatch* batch);
+
   DownpourWorkerParameter param_;
+  // number of batches whose sparse pull is issued ahead of training
+  int pull_sparse_prefetch_depth_ = 0;
+  // ring buffer of pull_sparse_prefetch_depth_ + 1 prefetched batches
+  std::vector<PrefetchBatch> prefetch_batches_;
+  size_t prefetch_head_ = 0;
+  size_t prefetch_num_ = 0;
+  bool prefetch_drained_ = false;
+  // sparse key names of the slots which have embedding, see PullSparseVarsSync
+  std::map<uint64_t, std::vector<std::string>> prefetch_key_names_;
   // copy table
   CopyTableConfig copy_table_config_;
   std::vector<std::pair<uint64_t, uint64_t>> copy_sparse_tables_;
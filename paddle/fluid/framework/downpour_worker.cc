@@ -84,6 +84,7 @@ void DownpourWorker::Initialize(const TrainerDesc& desc) {
 
   need_to_push_sparse_ = param_.push_sparse();
   need_to_push_dense_ = param_.push_dense();
+  pull_sparse_prefetch_depth_ = param_.pull_sparse_prefetch_depth();
 
   fleet_ptr_ = FleetWrapper::GetInstance();
   fetch_config_ = desc.fetch_config();
@@ -99,6 +100,13 @@ void DownpourWorker::Initialize(const TrainerDesc& desc) {
     check_nan_var_names_.push_back(desc.check_nan_var_names(i));
   }
   copy_table_config_ = desc.copy_table_config();
+  if (pull_sparse_prefetch_depth_ > 0 && copy_table_config_.need_copy()) {
+    // tables are copied right before the pull of a batch, which can not be
+    // done ahead of the batch.
+    LOG(WARNING) << "pull_sparse_prefetch_depth is ignored since copy table "
+                    "is enabled";
+    pull_sparse_prefetch_depth_ = 0;
+  }
   for (int i = 0; i < copy_table_config_.src_sparse_tables_size(); ++i) {
     uint64_t src_table = copy_table_config_.src_sparse_tables(i);
     uint64_t dest_table = copy_table_config_.dest_sparse_tables(i);
@@ -822,13 +830,183 @@ inline void AddAucMonitor(const Scope* scope, const phi::Place& place) {
 }
 #endif
 
+bool DownpourWorker::PrefetchNextBatch(PrefetchBatch* batch) {
+  if (batch->scope == nullptr) {
+    batch->scope = std::make_unique<Scope>();
+    for (auto& name : device_reader_->GetUseSlotAlias()) {
+      batch->scope->Var(name)->GetMutable<phi::DenseTensor>();
+    }
+  }
+  device_reader_->AssignFeedVar(*batch->scope);
+  batch->batch_size = device_reader_->Next();
+  if (batch->batch_size <= 0) {
+    return false;
+  }
+  int pull_sparse_table_num =
+      param_.program_config(0).pull_sparse_table_id_size();
+  batch->pull_sparse_status.resize(pull_sparse_table_num);
+  for (int i = 0; i < pull_sparse_table_num; ++i) {
+    uint64_t tid = static_cast<uint64_t>(
+        param_.program_config(0).pull_sparse_table_id(i));
+    batch->pull_sparse_status[i] = PullPrefetchedSparse(batch, tid);
+  }
+  return true;
+}
+
+std::future<int32_t> DownpourWorker::PullPrefetchedSparse(PrefetchBatch* batch,
+                                                          uint64_t tid) {
+  TableParameter table;
+  for (auto const& j : param_.sparse_table()) {
+    if (j.table_id() == tid) {
+      table = j;
+      break;
+    }
+  }
+  auto iter = prefetch_key_names_.find(tid);
+  if (iter == prefetch_key_names_.end()) {
+    // skip slots which do not have embedding, the embedding variables are
+    // only created in thread_scope_
+    auto& key_names = prefetch_key_names_[tid];
+    for (size_t i = 0; i < sparse_key_names_[tid].size(); ++i) {
+      if (thread_scope_->FindVar(sparse_value_names_[tid][i]) != nullptr) {
+        key_names.push_back(sparse_key_names_[tid][i]);
+      }
+    }
+    iter = prefetch_key_names_.find(tid);
+  }
+  // A key is usually shared by many instances of a batch, so only its first
+  // occurrence is pulled and the value is scattered back when waiting.
+  auto& features = batch->features[tid];
+  auto& unique_keys = batch->unique_keys[tid];
+  auto& key_index = batch->key_index[tid];
+  features.clear();
+  unique_keys.clear();
+  key_index.clear();
+  std::unordered_map<uint64_t, size_t> key_to_index;
+  for (auto& name : iter->second) {
+    Variable* var = batch->scope->FindVar(name);
+    if (var == nullptr) {
+      continue;
+    }
+    phi::DenseTensor* tensor = var->GetMutable<phi::DenseTensor>();
+    int64_t* ids = tensor->data<int64_t>();
+    size_t len = tensor->numel();
+    for (size_t i = 0; i < len; ++i) {
+      if (ids[i] == 0u) {
+        continue;
+      }
+      uint64_t key = static_cast<uint64_t>(ids[i]);
+      auto inserted = key_to_index.emplace(key, unique_keys.size());
+      if (inserted.second) {
+        unique_keys.push_back(key);
+      }
+      features.push_back(key);
+      key_index.push_back(inserted.first->second);
+    }
+  }
+  return fleet_ptr_->PullSparseKeysAsync(
+      tid, unique_keys, &batch->unique_values[tid], table.fea_dim());
+}
+
+void DownpourWorker::WaitPrefetchedBatch(PrefetchBatch* batch) {
+  for (size_t i = 0; i < batch->pull_sparse_status.size(); ++i) {
+    uint64_t tid = static_cast<uint64_t>(
+        param_.program_config(0).pull_sparse_table_id(static_cast<int>(i)));
+    auto& status = batch->pull_sparse_status[i];
+    int32_t cnt = 0;
+    while (true) {
+      int32_t ret = -1;
+      if (status.valid()) {
+        try {
+          ret = status.get();
+        } catch (const std::future_error& e) {
+          VLOG(0) << "Caught a future_error with code" << e.code()
+                  << ", Message:" << e.what();
+        }
+      }
+#ifndef PADDLE_WITH_PSLIB
+      // nothing is pulled without pslib, as in PullSparseVarsSync
+      ret = 0;
+#endif
+      if (ret == 0) {
+        break;
+      }
+      VLOG(0) << "fleet prefetch pull sparse failed, status[" << ret << "]";
+      if (++cnt > 3) {
+        VLOG(0) << "fleet prefetch pull sparse failed, retry 3 times";
+        exit(-1);
+      }
+      status = PullPrefetchedSparse(batch, tid);
+    }
+    features_[tid].swap(batch->features[tid]);
+    auto& key_index = batch->key_index[tid];
+    auto& unique_values = batch->unique_values[tid];
+    auto& values = feature_values_[tid];
+    values.resize(key_index.size() + 1);
+    for (size_t j = 0; j < key_index.size(); ++j) {
+      values[j] = unique_values[key_index[j]];
+    }
+    values.back() = unique_values.back();
+  }
+  // the ops read the batch from thread_scope_
+  for (auto& name : device_reader_->GetUseSlotAlias()) {
+    auto* src =
+        batch->scope->FindLocalVar(name)->GetMutable<phi::DenseTensor>();
+    auto* dst = thread_scope_->FindVar(name)->GetMutable<phi::DenseTensor>();
+    dst->ShareDataWith(*src);
+    dst->set_lod(src->lod());
+  }
+}
+
+int DownpourWorker::NextBatch() {
+  if (pull_sparse_prefetch_depth_ <= 0) {
+    return device_reader_->Next();
+  }
+  size_t capacity = static_cast<size_t>(pull_sparse_prefetch_depth_) + 1;
+  if (prefetch_batches_.size() != capacity) {
+    prefetch_batches_.resize(capacity);
+    prefetch_head_ = 0;
+    prefetch_num_ = 0;
+    prefetch_drained_ = false;
+  }
+  // The batch returned last time has been trained, so its slot can be reused
+  // and pull_sparse_prefetch_depth_ batches stay in flight while training.
+  while (!prefetch_drained_ && prefetch_num_ < capacity) {
+    auto* batch =
+        &prefetch_batches_[(prefetch_head_ + prefetch_num_) % capacity];
+    if (!PrefetchNextBatch(batch)) {
+      prefetch_drained_ = true;
+      break;
+    }
+    ++prefetch_num_;
+  }
+  if (prefetch_num_ == 0) {
+    // the next pass starts with an empty pipeline
+    prefetch_drained_ = false;
+    device_reader_->AssignFeedVar(*thread_scope_);
+    return 0;
+  }
+  auto* batch = &prefetch_batches_[prefetch_head_];
+  prefetch_head_ = (prefetch_head_ + 1) % capacity;
+  --prefetch_num_;
+  WaitPrefetchedBatch(batch);
+  return batch->batch_size;
+}
+
 void DownpourWorker::TrainFiles() {
   VLOG(3) << "Begin to train files";
   platform::SetNumThreads(1);
   device_reader_->Start();
+  if (pull_sparse_prefetch_depth_ > 0 && need_dump_field_) {
+    // the dumped ins ids are read from the reader, which is ahead of the
+    // trained batch with prefetching
+    LOG(WARNING) << "pull_sparse_prefetch_depth is ignored since dump field "
+                    "is enabled";
+    pull_sparse_prefetch_depth_ = 0;
+  }
   int batch_cnt = 0;
   int cur_batch = 0;
-  while ((cur_batch = device_reader_->Next()) > 0) {
+  while ((cur_batch = NextBatch()) > 0) {
     if (copy_table_config_.need_copy()) {
       if (batch_cnt % copy_table_config_.batch_num() == 0) {
         CopySparseTable();
@@ -848,13 +1026,16 @@ void DownpourWorker::TrainFiles() {
           break;
         }
       }
-      fleet_ptr_->PullSparseVarsSync(*thread_scope_,
-                                     tid,
-                                     sparse_key_names_[tid],
-                                     &features_[tid],
-                                     &feature_values_[tid],
-                                     table.fea_dim(),
-                                     sparse_value_names_[tid]);
+      // prefetched batches are pulled in NextBatch
+      if (pull_sparse_prefetch_depth_ <= 0) {
+        fleet_ptr_->PullSparseVarsSync(*thread_scope_,
+                                       tid,
+                                       sparse_key_names_[tid],
+                                       &features_[tid],
+                                       &feature_values_[tid],
+                                       table.fea_dim(),
+                                       sparse_value_names_[tid]);
+      }
       CollectLabelInfo(i);
       FillSparseValue(i);
       auto nid_iter = std::find(sparse_value_names_[tid].begin(),
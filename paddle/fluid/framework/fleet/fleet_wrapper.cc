@@ -588,6 +588,26 @@ std::future<int32_t> FleetWrapper::PullSparseVarsAsync(
   return std::future<int32_t>();
 }
 
+std::future<int32_t> FleetWrapper::PullSparseKeysAsync(
+    const uint64_t table_id,
+    const std::vector<uint64_t>& fea_keys,
+    std::vector<std::vector<float>>* fea_values,
+    int fea_value_dim) {
+  fea_values->resize(fea_keys.size() + 1);
+  for (auto& t : *fea_values) {
+    t.resize(fea_value_dim);
+  }
+#ifdef PADDLE_WITH_PSLIB
+  std::vector<float*> pull_result_ptr;
+  for (auto& t : *fea_values) {
+    pull_result_ptr.push_back(t.data());
+  }
+  return pslib_ptr_->_worker_ptr->pull_sparse(
+      pull_result_ptr.data(), table_id, fea_keys.data(), fea_keys.size());
+#endif
+  return std::future<int32_t>();
+}
+
 void FleetWrapper::PullSparseVarsSync(
     const Scope& scope,
     const uint64_t table_id,
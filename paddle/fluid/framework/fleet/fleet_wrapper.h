@@ -140,6 +140,15 @@ class FleetWrapper {
       std::vector<std::vector<float>>* fea_values,
       int fea_dim);
 
+  // Pull sparse values of the given keys from server in async mode
+  // Param<in>: table_id, fea_keys, fea_dim
+  // Param<out>: fea_values std::future
+  std::future<int32_t> PullSparseKeysAsync(
+      const uint64_t table_id,
+      const std::vector<uint64_t>& fea_keys,
+      std::vector<std::vector<float>>* fea_values,
+      int fea_dim);
+
   // Pull sparse variables from server in sync mode
   // pull immediately to tensors
   void PullSparseToTensorSync(
@@ -87,7 +87,7 @@ OpSupportedInfos(const std::string& place,
     }
   }
 
-  auto phi_kernels = phi::KernelFactory::Instance().kernels();
+  const auto& phi_kernels = phi::KernelFactory::Instance().kernels();
   for (auto& kernel_pair : phi_kernels) {
     auto op_type = phi::TransToFluidOpName(kernel_pair.first);
     for (auto& info_pair : kernel_pair.second) {
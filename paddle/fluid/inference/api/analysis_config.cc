@@ -474,6 +474,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
                                   // params_file_ fields.
   CP_MEMBER(save_optimized_model_);
   CP_MEMBER(opt_cache_dir_);
+  CP_MEMBER(optimized_model_cache_);
   CP_MEMBER(prog_file_);
   CP_MEMBER(params_file_);
 
@@ -1069,6 +1070,7 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << prog_file_;
   ss << params_file_;
   ss << save_optimized_model_;
+  ss << optimized_model_cache_;
 
   ss << use_gpu_;
   ss << enable_gpu_mixed_;
@@ -1420,6 +1422,8 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow({"ir_debug", ir_debug_ ? "true" : "false"});
   os.InsertRow(
       {"use_optimized_model", use_optimized_model_ ? "true" : "false"});
+  os.InsertRow({"optimized_model_cache",
+                optimized_model_cache_ ? "true" : "false"});
   os.InsertRow({"memory_optim", enable_memory_optim_ ? "true" : "false"});
   os.InsertRow({"enable_profile", with_profile_ ? "true" : "false"});
   os.InsertRow({"enable_log", with_glog_info_ ? "true" : "false"});
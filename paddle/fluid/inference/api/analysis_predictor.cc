@@ -16,11 +16,19 @@
 
 #include <glog/logging.h>
 
+extern "C" {
+#include <xxhash.h>
+}
+
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -66,9 +74,11 @@
 #include "paddle/phi/core/platform/device/gpu/gpu_types.h"
 #include "paddle/phi/core/platform/device_context.h"
 #include "paddle/phi/core/platform/profiler.h"
+#include "paddle/phi/core/scope_guard.h"
 
 #include "paddle/phi/core/generator.h"
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
+#include "paddle/phi/kernels/funcs/jit/helper.h"
 #include "paddle/utils/string/split.h"
 
 #ifdef PADDLE_WITH_MKLML
@@ -132,6 +142,7 @@
 
 COMMON_DECLARE_bool(pir_apply_inplace_pass);
 COMMON_DECLARE_bool(enable_auto_layout_pass);
+COMMON_DECLARE_string(jit_kernel_warmup_file);
 namespace paddle {
 namespace {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -187,6 +198,47 @@ void UpdatePrivateDeviceContext(InferGPUContext *gpu_context,
                      .get());
 }
 #endif
+
+// Generates the jit code of the CPU kernels listed in the warmup file, so
+// that the first runs of the predictor do not pay for it.
+void LoadJitKernelWarmupList() {
+  const std::string &path = FLAGS_jit_kernel_warmup_file;
+  std::ifstream fin(path);
+  if (!fin.is_open()) {
+    VLOG(3) << "The jit kernel warmup file " << path << " is not found";
+    return;
+  }
+  std::stringstream buffer;
+  buffer << fin.rdbuf();
+  phi::jit::LoadKernelWarmupList(buffer.str());
+}
+
+// Writes the jit kernels looked up in this process to the warmup file. The
+// list is written aside and renamed over the file, so that processes that
+// exit together never leave a partial list.
+void SaveJitKernelWarmupList() {
+  const std::string &path = FLAGS_jit_kernel_warmup_file;
+  std::string staging_path =
+      path + ".tmp." +
+      std::to_string(
+          std::chrono::system_clock::now().time_since_epoch().count());
+  {
+    std::ofstream fout(staging_path, std::ios::out | std::ios::trunc);
+    if (!fout.is_open()) {
+      LOG(WARNING) << "Can not write the jit kernel warmup file "
+                   << staging_path;
+      return;
+    }
+    fout << phi::jit::SerializeKernelWarmupList();
+  }
+  std::error_code ec;
+  std::filesystem::rename(staging_path, path, ec);
+  if (ec) {
+    VLOG(3) << "Failed to publish the jit kernel warmup file " << path << ": "
+            << ec.message();
+    std::filesystem::remove(staging_path, ec);
+  }
+}
 }  // namespace
 
 #ifdef PADDLE_WITH_TENSORRT
@@ -436,6 +488,10 @@ bool AnalysisPredictor::Init(
   // no matter with or without OneDNN
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
 
+  if (!FLAGS_jit_kernel_warmup_file.empty() && !status_is_cloned_) {
+    LoadJitKernelWarmupList();
+  }
+
   std::string model_path = config_.prog_file();
   load_pir_model_ =
       model_path.substr(model_path.find_last_of(".") + 1) == "json";
@@ -444,6 +500,19 @@ bool AnalysisPredictor::Init(
     config_.use_new_executor_ = true;
   }
 
+  if (config_.optimized_model_cache_enabled() && !status_is_cloned_) {
+    PrepareOptimizedModelCache();
+  }
+  // Remove the staging directory if Init fails before it is committed.
+  DEFINE_PADDLE_SCOPE_GUARD([this] {
+    if (!optimized_model_cache_commit_path_.empty()) {
+      std::error_code ec;
+      std::filesystem::remove_all(optimized_model_cache_path_, ec);
+      optimized_model_cache_path_.clear();
+      optimized_model_cache_commit_path_.clear();
+    }
+  });
+
   // Use Optimized model to inference
   if (config_.use_optimized_model_) {
     std::string optimized_model_path = GetOptimizedModelPath();
@@ -492,6 +561,10 @@ bool AnalysisPredictor::Init(
     }
   }
 
+  if (!optimized_model_cache_commit_path_.empty()) {
+    CommitOptimizedModelCache();
+  }
+
   // Get the feed_target_names and fetch_target_names
 
   PrepareFeedFetch();
@@ -590,6 +663,9 @@ void AnalysisPredictor::InitPlace() {
 }
 
 std::string AnalysisPredictor::GetOptimizedModelPath() {
+  if (!optimized_model_cache_path_.empty()) {
+    return optimized_model_cache_path_;
+  }
   std::string model_opt_cache_dir = config_.opt_cache_dir_;
   if (!model_opt_cache_dir.empty()) {
     if (!PathExists(model_opt_cache_dir)) {
@@ -610,6 +686,153 @@ std::string AnalysisPredictor::GetOptimizedModelPath() {
   return model_opt_cache_dir;
 }
 
+std::string AnalysisPredictor::GetOptimizedModelCacheKey() {
+  XXH64_state_t *state = XXH64_createState();
+  XXH64_reset(state, 0);
+  auto update = [state](const std::string &data) {
+    uint64_t size = data.size();
+    XXH64_update(state, &size, sizeof(size));
+    XXH64_update(state, data.data(), data.size());
+  };
+  auto update_file = [state, &update](const std::string &path) {
+    std::ifstream fin(path, std::ios::in | std::ios::binary);
+    PADDLE_ENFORCE_EQ(
+        fin.is_open(),
+        true,
+        common::errors::NotFound("Cannot open file %s, please confirm "
+                                 "whether the file is normal.",
+                                 path));
+    update(path);
+    std::vector<char> buffer(1 << 20);
+    while (fin) {
+      fin.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      XXH64_update(state, buffer.data(), static_cast<size_t>(fin.gcount()));
+    }
+  };
+
+  // The model. The contents of a model loaded from memory are already part of
+  // the serialized config.
+  if (!config_.model_from_memory()) {
+    if (!config_.model_dir().empty()) {
+      std::vector<std::string> files;
+      for (const auto &entry :
+           std::filesystem::directory_iterator(config_.model_dir())) {
+        std::string name = entry.path().filename().string();
+        // Skip the optimized model and the cache entries saved in the model
+        // directory.
+        if (!entry.is_regular_file() || name.rfind("_optimized", 0) == 0) {
+          continue;
+        }
+        files.push_back(entry.path().string());
+      }
+      std::sort(files.begin(), files.end());
+      for (const auto &file : files) {
+        update_file(file);
+      }
+    } else {
+      update_file(config_.prog_file());
+      if (!config_.params_file().empty()) {
+        update_file(config_.params_file());
+      }
+    }
+  }
+
+  // The config and the passes which will be applied.
+  update(config_.SerializeInfoCache());
+  update(std::to_string(config_.new_ir_enabled()));
+  for (const auto &pass : config_.pass_builder()->AllPasses()) {
+    update(pass);
+  }
+  for (const auto *passes :
+       {&kPirGpuPasses, &kPirCpuPasses, &kPirXpuPasses, &kPirMkldnnPasses}) {
+    for (const auto &pass : *passes) {
+      update(pass);
+    }
+  }
+  for (const auto &pass : config_.custom_passes_) {
+    update(pass);
+  }
+  update(std::to_string(config_.custom_pass_only_));
+  for (const auto &pass : config_.deleted_passes_) {
+    update(pass);
+  }
+  update(paddle::get_version());
+
+  uint64_t hash = XXH64_digest(state);
+  XXH64_freeState(state);
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return ss.str();
+}
+
+void AnalysisPredictor::PrepareOptimizedModelCache() {
+  if (config_.model_from_memory() && config_.opt_cache_dir_.empty()) {
+    LOG(WARNING) << "The optimized model cache is disabled, since the model "
+                    "is loaded from memory and the optimization cache "
+                    "directory is not set.";
+    return;
+  }
+
+  std::string cache_path =
+      GetOptimizedModelPath() + "/_optimized_" + GetOptimizedModelCacheKey();
+  std::string optimized_model =
+      cache_path + (config_.new_ir_enabled() ? "/_optimized.json"
+                                             : "/_optimized.pdmodel");
+  std::string optimized_params = cache_path + "/_optimized.pdiparams";
+  if (FileExists(optimized_model) && FileExists(optimized_params)) {
+    optimized_model_cache_path_ = cache_path;
+    config_.UseOptimizedModel(true);
+    return;
+  }
+
+  // Save the optimized model to a staging directory owned by this predictor,
+  // it is published by CommitOptimizedModelCache once completely saved.
+  auto now = std::chrono::system_clock::now().time_since_epoch().count();
+  optimized_model_cache_path_ = cache_path + ".tmp." + std::to_string(now) +
+                                "." + std::to_string(predictor_id_);
+  optimized_model_cache_commit_path_ = cache_path;
+  PADDLE_ENFORCE_NE(
+      MKDIR(optimized_model_cache_path_.c_str()),
+      -1,
+      common::errors::PreconditionNotMet(
+          "Can not create optimized model cache directory: %s, Make sure you "
+          "have permission to write",
+          optimized_model_cache_path_));
+  LOG(INFO) << "The optimized model cache is not found, the optimized model "
+               "will be saved to "
+            << cache_path;
+  config_.EnableSaveOptimModel(true);
+  config_.UseOptimizedModel(false);
+}
+
+void AnalysisPredictor::CommitOptimizedModelCache() {
+  std::string staging_path = optimized_model_cache_path_;
+  optimized_model_cache_path_ = optimized_model_cache_commit_path_;
+  optimized_model_cache_commit_path_.clear();
+
+  std::string optimized_model =
+      staging_path + (config_.new_ir_enabled() ? "/_optimized.json"
+                                               : "/_optimized.pdmodel");
+  std::string optimized_params = staging_path + "/_optimized.pdiparams";
+  std::error_code ec;
+  if (FileExists(optimized_model) && FileExists(optimized_params)) {
+    // Renaming fails if another predictor has published the same entry first,
+    // which is kept since it holds the same optimized model.
+    std::filesystem::rename(staging_path, optimized_model_cache_path_, ec);
+    if (!ec) {
+      LOG(INFO) << "Optimized model cache saved to "
+                << optimized_model_cache_path_;
+      return;
+    }
+    VLOG(3) << "Failed to publish the optimized model cache "
+            << optimized_model_cache_path_ << ": " << ec.message();
+  } else {
+    LOG(WARNING) << "The optimized model is not saved, the optimized model "
+                    "cache is not updated.";
+  }
+  std::filesystem::remove_all(staging_path, ec);
+}
+
 void AnalysisPredictor::ClearExtraParams() {
   auto var_names = scope_->LocalVarNames();
   std::vector<std::string> trt_repetitive_params;
@@ -3018,6 +3241,9 @@ AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
   if (config_.shape_range_info_collected()) {
     StatisticShapeRangeInfo();
   }
+  if (!FLAGS_jit_kernel_warmup_file.empty() && !status_is_cloned_) {
+    SaveJitKernelWarmupList();
+  }
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   if (predictor_stream_ != nullptr) {
     ResourceManager::Instance().DestroyGPUResource(predictor_stream_);
@@ -507,6 +507,9 @@ class AnalysisPredictor : public PaddlePredictor {
   void InitDeviceContexts();
   void InitResourceManager(void *stream);
   std::string GetOptimizedModelPath();
+  std::string GetOptimizedModelCacheKey();
+  void PrepareOptimizedModelCache();
+  void CommitOptimizedModelCache();
   void ClearExtraParams();
 
  private:
@@ -520,6 +523,12 @@ class AnalysisPredictor : public PaddlePredictor {
   std::shared_ptr<framework::ProgramDesc> inference_program_;
   std::shared_ptr<pir::Program> pir_program_;
   bool load_pir_model_{false};
+  // The directory the optimized model is loaded from or saved to when the
+  // optimized model cache is enabled. On a cache miss it is a staging
+  // directory, which is renamed to optimized_model_cache_commit_path_ once the
+  // optimized model is saved.
+  std::string optimized_model_cache_path_;
+  std::string optimized_model_cache_commit_path_;
   std::vector<framework::OpDesc *> feeds_;
   std::vector<pir::Operation *> pir_feeds_;
   std::map<std::string, size_t> feed_names_;
@@ -216,6 +216,25 @@ struct PD_INFER_DECL AnalysisConfig {
     opt_cache_dir_ = opt_cache_dir;
   }
   ///
+  /// \brief Cache the optimized model automatically. The cache entry is keyed
+  /// by the hash of the model files, the config and the enabled passes, and
+  /// lives in a sub directory of the optimization cache directory (or of the
+  /// model directory if it is not set). An existing entry is loaded directly,
+  /// otherwise the optimized model is saved to a staging directory which is
+  /// renamed to the entry once complete, so a partially written entry is
+  /// never loaded.
+  ///
+  /// \param x whether to enable the optimized model cache.
+  ///
+  void EnableOptimizedModelCache(bool x = true) { optimized_model_cache_ = x; }
+  ///
+  /// \brief A boolean state telling whether the optimized model cache is
+  /// enabled.
+  ///
+  /// \return bool Whether the optimized model cache is enabled.
+  ///
+  bool optimized_model_cache_enabled() const { return optimized_model_cache_; }
+  ///
   /// \brief Get the model directory path.
   ///
   /// \return const std::string& The model directory path.
@@ -1309,6 +1328,7 @@ struct PD_INFER_DECL AnalysisConfig {
   mutable bool is_valid_{true};
   bool save_optimized_model_{false};
   std::string opt_cache_dir_;
+  bool optimized_model_cache_{false};
   friend class paddle_infer::experimental::InternalUtils;
 
   // jit engine related
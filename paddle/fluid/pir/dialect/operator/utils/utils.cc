@@ -271,7 +271,7 @@ std::set<std::string> GetRegisterDataType(const std::string& op_name) {
   }
 
   std::set<std::string> data_type;
-  auto& phi_kernels = phi::KernelFactory::Instance().kernels();
+  const auto& phi_kernels = phi::KernelFactory::Instance().kernels();
   for (auto& kernel_pair : phi_kernels) {
     auto fluid_op_name = phi::TransToFluidOpName(kernel_pair.first);
     if (kernel_pair.first != op_name && fluid_op_name != op_name &&
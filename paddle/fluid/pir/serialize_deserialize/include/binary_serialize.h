@@ -0,0 +1,136 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/pir/serialize_deserialize/include/third_party.h"
+#include "paddle/pir/include/core/dll_decl.h"
+
+namespace pir {
+/**
+ * Binary encoding of the program json object produced by ProgramWriter.
+ *
+ * Layout of the buffer:
+ *   "PIRB" | format version | pir version | flags | section index | sections
+ *
+ * The section index holds the raw and stored size of every section, all
+ * integers are varint-encoded. Section 0 holds the string table, the type
+ * table and the program json whose top level block has no ops. The ops of the
+ * top level block are split into the following sections, each one is zlib
+ * compressed when that makes it smaller, so that they can be located without
+ * decoding the previous ones and decoded only when needed.
+ *
+ * Every string (keys, op names, attribute contents...) is stored once in the
+ * string table and every value type (TYPE_TYPE) once in the type table, the
+ * json objects only refer to them by index.
+ */
+
+/** BinaryProgramWriter is used to encode pir program json to binary.*/
+class BinaryProgramWriter {
+ public:
+  BinaryProgramWriter(const uint64_t pir_version,
+                      const bool trainable,
+                      const bool compress = true,
+                      const size_t ops_per_section = 1024)
+      : pir_version_(pir_version),
+        trainable_(trainable),
+        compress_(compress),
+        ops_per_section_(ops_per_section) {}
+
+  BinaryProgramWriter(BinaryProgramWriter&&) = delete;
+  BinaryProgramWriter(const BinaryProgramWriter&) = delete;
+  BinaryProgramWriter& operator=(const BinaryProgramWriter&) = delete;
+  BinaryProgramWriter& operator=(BinaryProgramWriter&&) = delete;
+
+  /** Encode is used by WriteModule api. The ops of the top level block are
+   * moved out of program_json during encoding and moved back afterwards.*/
+  std::string IR_API Encode(Json* program_json);
+
+  ~BinaryProgramWriter() = default;
+
+ private:
+  uint64_t pir_version_;
+  bool trainable_;
+  bool compress_;
+  size_t ops_per_section_;
+
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint64_t> string_ids_;
+  std::vector<Json> types_;
+  std::unordered_map<Json, uint64_t> type_ids_;
+
+  uint64_t InternString(const std::string& str);
+  uint64_t InternType(const Json& type_json);
+  void EncodeJson(const Json& json, std::string* out);
+  void AppendSection(const std::string& raw,
+                     std::string* index,
+                     std::string* body);
+};
+
+/** BinaryProgramReader is used to decode binary buffer to pir program json.
+ * Only the section index and section 0 are decoded on construction, the op
+ * sections are decoded on demand.*/
+class BinaryProgramReader {
+ public:
+  explicit IR_API BinaryProgramReader(std::string buffer);
+
+  BinaryProgramReader(BinaryProgramReader&&) = delete;
+  BinaryProgramReader(const BinaryProgramReader&) = delete;
+  BinaryProgramReader& operator=(const BinaryProgramReader&) = delete;
+  BinaryProgramReader& operator=(BinaryProgramReader&&) = delete;
+
+  /** Whether the file at file_path starts with the binary program magic.*/
+  static bool IR_API IsBinaryProgram(const std::string& file_path);
+
+  uint64_t pir_version() const { return pir_version_; }
+  bool trainable() const { return trainable_; }
+
+  /** Number of sections holding the ops of the top level block.*/
+  size_t num_op_sections() const { return sections_.size() - 1; }
+
+  /** Decode the json array of the ops stored in the index-th op section.*/
+  Json IR_API ReadOpSection(size_t index);
+
+  /** The program json whose top level block has no ops, the ops are read
+   * from the op sections.*/
+  Json* mutable_program_json() { return &program_json_; }
+
+  /** Decode the whole program json, which can be read by ProgramReader.*/
+  Json IR_API ReadProgramJson();
+
+  ~BinaryProgramReader() = default;
+
+ private:
+  struct Section {
+    size_t offset;
+    uint64_t raw_size;
+    uint64_t stored_size;
+  };
+
+  std::string buffer_;
+  uint64_t pir_version_ = 0;
+  bool trainable_ = true;
+  std::vector<Section> sections_;
+
+  std::vector<std::string> strings_;
+  std::vector<Json> types_;
+  Json program_json_;
+
+  std::string LoadSection(size_t index);
+};
+
+}  // namespace pir
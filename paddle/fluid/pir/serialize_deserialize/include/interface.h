@@ -32,6 +32,9 @@ namespace pir {
  * @param[in] trainable    (Optional parameter, default to true) If true,
  * operation has opresult_attrs for training like stop_gradient,persistable;
  * Otherwise, it may only has opinfo attrs.
+ * @param[in] binary       (Optional parameter, default to false) If true, the
+ * program is written in the compact binary format of binary_serialize.h
+ * instead of json, readable is ignored.
  *
  * @return void。
  *
@@ -43,7 +46,8 @@ void IR_API WriteModule(const pir::Program& program,
                         uint64_t pir_version,
                         bool overwrite,
                         bool readable = false,
-                        bool trainable = true);
+                        bool trainable = true,
+                        bool binary = false);
 
 /**
  * @brief Gets a PIR program from the specified file path.
@@ -59,7 +63,8 @@ void IR_API WriteModule(const pir::Program& program,
  * funtune.
  *
  * @note If 'pir_version' is larger than the version of file, will trigger
- * version compatibility modification rule.
+ * version compatibility modification rule. Both json and binary files are
+ * accepted, the format is detected from the file header.
  */
 bool IR_API ReadModule(const std::string& file_path,
                        pir::Program* program,
@@ -23,6 +23,8 @@
 
 namespace pir {
 
+class BinaryProgramReader;
+
 class ProgramReader {
  public:
   explicit ProgramReader(const uint64_t version) : current_version(version) {}
@@ -37,6 +39,11 @@ class ProgramReader {
   void IR_API RecoverProgram(Json* program_json,
                              pir::Program* recover_program,
                              pir::PatchBuilder* builder);
+  // Recover the program section by section, the ops of an op section are
+  // released once they are read into the program.
+  void IR_API RecoverProgram(BinaryProgramReader* binary_reader,
+                             pir::Program* recover_program,
+                             pir::PatchBuilder* builder);
   pir::Type RecoverType(Json* type_json);
   pir::AttributeMap RecoverOpAttributesMap(Json* attrs_json);
   ~ProgramReader() = default;
@@ -49,6 +56,8 @@ class ProgramReader {
   void ReadProgram(Json* program_json, pir::Program* program);
   void ReadRegion(Json* region_json, pir::Region* region);
   void ReadBlock(Json* block_json, pir::Block* block);
+  void ReadBlockArgs(Json* block_json, pir::Block* block);
+  int64_t GetMaxValueId(Json* ops_json);
   pir::Operation* ReadOp(Json* op_json);
   pir::AttributeMap ReadAttributesMap(
       Json* attrs_json,
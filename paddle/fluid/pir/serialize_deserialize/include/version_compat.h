@@ -22,6 +22,13 @@
 #include "paddle/pir/include/core/dll_decl.h"
 
 namespace pir {
+/* Version of the binary program encoding, see binary_serialize.h. It is
+ * independent of pir_version: a binary file still carries its pir_version and
+ * goes through the same patches as a json file once decoded. Increase it
+ * whenever the binary layout changes, files with a newer format version are
+ * rejected by BinaryProgramReader. */
+constexpr uint64_t kBinaryFormatVersion = 1;
+
 /* PatchBuilder is used to build patch for IR. */
 class PatchBuilder {
  public:
@@ -45,6 +52,7 @@ class PatchBuilder {
   bool HasOpPatch(const std::string& name) const {
     return op_patches_.count(name) != 0;
   }
+  bool HasOpPairPatch() const { return !op_pair_patches_.empty(); }
   bool HasTypePatch(const std::string& name) const {
     VLOG(8) << "Type patches: " << type_patches_;
     return type_patches_.count(name) != 0;
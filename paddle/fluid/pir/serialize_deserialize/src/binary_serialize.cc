@@ -0,0 +1,464 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_serialize.h"
+
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/schema.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/version_compat.h"
+
+namespace pir {
+namespace {
+constexpr char kBinaryMagic[] = "PIRB";
+constexpr size_t kBinaryMagicSize = 4;
+constexpr uint8_t kTrainableFlag = 1;
+
+enum JsonTag : uint8_t {
+  kNull = 0,
+  kFalse,
+  kTrue,
+  kInt,
+  kUInt,
+  kFloat,
+  kString,
+  kArray,
+  kObject,
+  kType,
+};
+
+void WriteVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+class ByteReader {
+ public:
+  ByteReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  uint8_t ReadByte() {
+    CheckRemaining(1);
+    return static_cast<uint8_t>(data_[pos_++]);
+  }
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = ReadByte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) return value;
+    }
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "Invalid binary program: varint is too long."));
+  }
+
+  std::string ReadBytes(size_t size) {
+    CheckRemaining(size);
+    std::string bytes(data_ + pos_, size);
+    pos_ += size;
+    return bytes;
+  }
+
+  double ReadDouble() {
+    CheckRemaining(sizeof(double));
+    double value;
+    std::memcpy(&value, data_ + pos_, sizeof(double));
+    pos_ += sizeof(double);
+    return value;
+  }
+
+  size_t pos() const { return pos_; }
+
+ private:
+  void CheckRemaining(size_t size) const {
+    PADDLE_ENFORCE_LE(size,
+                      size_ - pos_,
+                      common::errors::InvalidArgument(
+                          "Invalid binary program: unexpected end of data."));
+  }
+
+  const char* data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+const std::string& GetIndexed(const std::vector<std::string>& table,
+                              uint64_t index) {
+  PADDLE_ENFORCE_LT(index,
+                    table.size(),
+                    common::errors::InvalidArgument(
+                        "Invalid binary program: string index %d is out of "
+                        "range of the string table with size %d.",
+                        index,
+                        table.size()));
+  return table[index];
+}
+
+Json DecodeJson(ByteReader* reader,
+                const std::vector<std::string>& strings,
+                const std::vector<Json>& types) {
+  auto tag = reader->ReadByte();
+  switch (tag) {
+    case kNull:
+      return Json();
+    case kFalse:
+      return Json(false);
+    case kTrue:
+      return Json(true);
+    case kInt:
+      return Json(ZigZagDecode(reader->ReadVarint()));
+    case kUInt:
+      return Json(reader->ReadVarint());
+    case kFloat:
+      return Json(reader->ReadDouble());
+    case kString:
+      return Json(GetIndexed(strings, reader->ReadVarint()));
+    case kArray: {
+      uint64_t size = reader->ReadVarint();
+      Json array = Json::array();
+      for (uint64_t i = 0; i < size; ++i) {
+        array.emplace_back(DecodeJson(reader, strings, types));
+      }
+      return array;
+    }
+    case kObject: {
+      uint64_t size = reader->ReadVarint();
+      Json object = Json::object();
+      for (uint64_t i = 0; i < size; ++i) {
+        const auto& key = GetIndexed(strings, reader->ReadVarint());
+        object[key] = DecodeJson(reader, strings, types);
+      }
+      return object;
+    }
+    case kType: {
+      uint64_t index = reader->ReadVarint();
+      PADDLE_ENFORCE_LT(
+          index,
+          types.size(),
+          common::errors::InvalidArgument(
+              "Invalid binary program: type index %d is out of range of the "
+              "type table with size %d.",
+              index,
+              types.size()));
+      return types[index];
+    }
+    default:
+      PADDLE_THROW(common::errors::InvalidArgument(
+          "Invalid binary program: unknown json tag %d.", tag));
+  }
+}
+
+Json& TopLevelOpsJson(Json* program_json) {
+  return program_json->at(REGIONS).at(0).at(BLOCKS).at(0).at(BLOCKOPS);
+}
+}  // namespace
+
+uint64_t BinaryProgramWriter::InternString(const std::string& str) {
+  auto it = string_ids_.find(str);
+  if (it != string_ids_.end()) return it->second;
+  uint64_t id = strings_.size();
+  strings_.push_back(str);
+  string_ids_.emplace(str, id);
+  return id;
+}
+
+uint64_t BinaryProgramWriter::InternType(const Json& type_json) {
+  auto it = type_ids_.find(type_json);
+  if (it != type_ids_.end()) return it->second;
+  uint64_t id = types_.size();
+  types_.push_back(type_json);
+  type_ids_.emplace(type_json, id);
+  return id;
+}
+
+void BinaryProgramWriter::EncodeJson(const Json& json, std::string* out) {
+  switch (json.type()) {
+    case Json::value_t::null:
+      out->push_back(kNull);
+      break;
+    case Json::value_t::boolean:
+      out->push_back(json.get<bool>() ? kTrue : kFalse);
+      break;
+    case Json::value_t::number_integer:
+      out->push_back(kInt);
+      WriteVarint(ZigZagEncode(json.get<int64_t>()), out);
+      break;
+    case Json::value_t::number_unsigned:
+      out->push_back(kUInt);
+      WriteVarint(json.get<uint64_t>(), out);
+      break;
+    case Json::value_t::number_float: {
+      out->push_back(kFloat);
+      double value = json.get<double>();
+      char bytes[sizeof(double)];
+      std::memcpy(bytes, &value, sizeof(double));
+      out->append(bytes, sizeof(double));
+      break;
+    }
+    case Json::value_t::string:
+      out->push_back(kString);
+      WriteVarint(InternString(json.get_ref<const std::string&>()), out);
+      break;
+    case Json::value_t::array:
+      out->push_back(kArray);
+      WriteVarint(json.size(), out);
+      for (const auto& item : json) {
+        EncodeJson(item, out);
+      }
+      break;
+    case Json::value_t::object:
+      out->push_back(kObject);
+      WriteVarint(json.size(), out);
+      for (const auto& item : json.items()) {
+        WriteVarint(InternString(item.key()), out);
+        if (item.key() == TYPE_TYPE && item.value().is_object()) {
+          out->push_back(kType);
+          WriteVarint(InternType(item.value()), out);
+        } else {
+          EncodeJson(item.value(), out);
+        }
+      }
+      break;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Json type %s can not be encoded to binary program.",
+          json.type_name()));
+  }
+}
+
+void BinaryProgramWriter::AppendSection(const std::string& raw,
+                                        std::string* index,
+                                        std::string* body) {
+  if (compress_ && !raw.empty()) {
+    uLongf stored_size = compressBound(raw.size());
+    std::string stored(stored_size, '\0');
+    int ret = compress2(reinterpret_cast<Bytef*>(&stored[0]),
+                        &stored_size,
+                        reinterpret_cast<const Bytef*>(raw.data()),
+                        raw.size(),
+                        Z_DEFAULT_COMPRESSION);
+    PADDLE_ENFORCE_EQ(ret,
+                      Z_OK,
+                      common::errors::External(
+                          "Failed to compress binary program section."));
+    // Keep the raw bytes if compression does not pay off, the reader tells
+    // the two cases apart by comparing raw and stored size.
+    if (stored_size < raw.size()) {
+      WriteVarint(raw.size(), index);
+      WriteVarint(stored_size, index);
+      body->append(stored.data(), stored_size);
+      return;
+    }
+  }
+  WriteVarint(raw.size(), index);
+  WriteVarint(raw.size(), index);
+  body->append(raw);
+}
+
+std::string BinaryProgramWriter::Encode(Json* program_json) {
+  strings_.clear();
+  string_ids_.clear();
+  types_.clear();
+  type_ids_.clear();
+
+  Json ops_json = Json::array();
+  ops_json.swap(TopLevelOpsJson(program_json));
+
+  std::vector<std::string> op_sections;
+  size_t ops_per_section = std::max<size_t>(ops_per_section_, 1);
+  for (size_t begin = 0; begin < ops_json.size(); begin += ops_per_section) {
+    size_t end = std::min(begin + ops_per_section, ops_json.size());
+    std::string raw;
+    WriteVarint(end - begin, &raw);
+    for (size_t i = begin; i < end; ++i) {
+      EncodeJson(ops_json[i], &raw);
+    }
+    op_sections.emplace_back(std::move(raw));
+  }
+
+  std::string skeleton;
+  EncodeJson(*program_json, &skeleton);
+  ops_json.swap(TopLevelOpsJson(program_json));
+
+  // Types may intern new strings, so the string table goes after them.
+  std::string type_table;
+  WriteVarint(types_.size(), &type_table);
+  for (size_t i = 0; i < types_.size(); ++i) {
+    // Encoding a type may intern the types nested in it and reallocate
+    // types_, so encode a copy of it.
+    Json type_json = types_[i];
+    EncodeJson(type_json, &type_table);
+  }
+  std::string head;
+  WriteVarint(strings_.size(), &head);
+  for (const auto& str : strings_) {
+    WriteVarint(str.size(), &head);
+    head.append(str);
+  }
+  head.append(type_table);
+  head.append(skeleton);
+
+  std::string index;
+  std::string body;
+  WriteVarint(op_sections.size() + 1, &index);
+  AppendSection(head, &index, &body);
+  for (const auto& section : op_sections) {
+    AppendSection(section, &index, &body);
+  }
+
+  std::string out(kBinaryMagic, kBinaryMagicSize);
+  WriteVarint(kBinaryFormatVersion, &out);
+  WriteVarint(pir_version_, &out);
+  out.push_back(trainable_ ? kTrainableFlag : 0);
+  out.append(index);
+  out.append(body);
+  VLOG(6) << "Encode program to binary: " << strings_.size() << " strings, "
+          << types_.size() << " types, " << op_sections.size()
+          << " op sections, " << out.size() << " bytes.";
+  return out;
+}
+
+BinaryProgramReader::BinaryProgramReader(std::string buffer)
+    : buffer_(std::move(buffer)) {
+  PADDLE_ENFORCE_EQ(
+      buffer_.compare(0, kBinaryMagicSize, kBinaryMagic),
+      0,
+      common::errors::InvalidArgument("Invalid binary program: bad magic."));
+  ByteReader reader(buffer_.data() + kBinaryMagicSize,
+                    buffer_.size() - kBinaryMagicSize);
+  uint64_t format_version = reader.ReadVarint();
+  PADDLE_ENFORCE_LE(
+      format_version,
+      kBinaryFormatVersion,
+      common::errors::InvalidArgument(
+          "The binary program format version %d is newer than the supported "
+          "version %d, please upgrade paddle to load it.",
+          format_version,
+          kBinaryFormatVersion));
+  pir_version_ = reader.ReadVarint();
+  trainable_ = reader.ReadByte() & kTrainableFlag;
+
+  uint64_t num_sections = reader.ReadVarint();
+  PADDLE_ENFORCE_GE(num_sections,
+                    1,
+                    common::errors::InvalidArgument(
+                        "Invalid binary program: missing head section."));
+  std::vector<std::pair<uint64_t, uint64_t>> sizes;
+  for (uint64_t i = 0; i < num_sections; ++i) {
+    uint64_t raw_size = reader.ReadVarint();
+    uint64_t stored_size = reader.ReadVarint();
+    sizes.emplace_back(raw_size, stored_size);
+  }
+  size_t offset = kBinaryMagicSize + reader.pos();
+  for (auto& [raw_size, stored_size] : sizes) {
+    PADDLE_ENFORCE_LE(stored_size,
+                      buffer_.size() - offset,
+                      common::errors::InvalidArgument(
+                          "Invalid binary program: section exceeds the "
+                          "end of data."));
+    sections_.push_back({offset, raw_size, stored_size});
+    offset += stored_size;
+  }
+
+  std::string head = LoadSection(0);
+  ByteReader head_reader(head.data(), head.size());
+  uint64_t num_strings = head_reader.ReadVarint();
+  strings_.reserve(num_strings);
+  for (uint64_t i = 0; i < num_strings; ++i) {
+    strings_.emplace_back(head_reader.ReadBytes(head_reader.ReadVarint()));
+  }
+  uint64_t num_types = head_reader.ReadVarint();
+  types_.reserve(num_types);
+  for (uint64_t i = 0; i < num_types; ++i) {
+    types_.emplace_back(DecodeJson(&head_reader, strings_, types_));
+  }
+  program_json_ = DecodeJson(&head_reader, strings_, types_);
+  VLOG(6) << "Decode binary program head: " << strings_.size()
+          << " strings, " << types_.size() << " types, "
+          << num_op_sections() << " op sections.";
+}
+
+bool BinaryProgramReader::IsBinaryProgram(const std::string& file_path) {
+  std::ifstream fin(file_path, std::ios::binary);
+  char magic[kBinaryMagicSize];
+  if (!fin.read(magic, kBinaryMagicSize)) return false;
+  return std::memcmp(magic, kBinaryMagic, kBinaryMagicSize) == 0;
+}
+
+std::string BinaryProgramReader::LoadSection(size_t index) {
+  const Section& section = sections_[index];
+  if (section.stored_size == section.raw_size) {
+    return buffer_.substr(section.offset, section.stored_size);
+  }
+  std::string raw(section.raw_size, '\0');
+  uLongf raw_size = section.raw_size;
+  int ret = uncompress(reinterpret_cast<Bytef*>(&raw[0]),
+                       &raw_size,
+                       reinterpret_cast<const Bytef*>(&buffer_[section.offset]),
+                       section.stored_size);
+  PADDLE_ENFORCE_EQ(
+      ret == Z_OK && raw_size == section.raw_size,
+      true,
+      common::errors::InvalidArgument(
+          "Invalid binary program: failed to uncompress section %d.", index));
+  return raw;
+}
+
+Json BinaryProgramReader::ReadOpSection(size_t index) {
+  PADDLE_ENFORCE_LT(index,
+                    num_op_sections(),
+                    common::errors::OutOfRange(
+                        "Op section index %d is out of range, the binary "
+                        "program has %d op sections.",
+                        index,
+                        num_op_sections()));
+  std::string raw = LoadSection(index + 1);
+  ByteReader reader(raw.data(), raw.size());
+  uint64_t num_ops = reader.ReadVarint();
+  Json ops_json = Json::array();
+  for (uint64_t i = 0; i < num_ops; ++i) {
+    ops_json.emplace_back(DecodeJson(&reader, strings_, types_));
+  }
+  return ops_json;
+}
+
+Json BinaryProgramReader::ReadProgramJson() {
+  Json program_json = program_json_;
+  Json& ops_json = TopLevelOpsJson(&program_json);
+  for (size_t i = 0; i < num_op_sections(); ++i) {
+    for (auto& op_json : ReadOpSection(i)) {
+      ops_json.emplace_back(std::move(op_json));
+    }
+  }
+  return program_json;
+}
+
+}  // namespace pir
@@ -14,7 +14,11 @@
 
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
 #include <stdio.h>
+#include <iterator>
+#include <memory>
+#include <utility>
 #include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_serialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_deserialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_serialize.h"
 #include "paddle/phi/common/port.h"
@@ -31,7 +35,8 @@ void WriteModule(const pir::Program& program,
                  uint64_t pir_version,
                  bool overwrite,
                  bool readable,
-                 bool trainable) {
+                 bool trainable,
+                 bool binary) {
   PADDLE_ENFORCE_EQ(
       FileExists(file_path) && !overwrite,
       false,
@@ -40,20 +45,27 @@ void WriteModule(const pir::Program& program,
           file_path,
           overwrite));
 
-  // write base code
-  Json total;
-
-  total[BASE_CODE] = {
-      {MAGIC, PIR}, {PIRVERSION, pir_version}, {TRAINABLE, trainable}};
-
   ProgramWriter writer(pir_version, trainable);
-  // write program
-  total[PROGRAM] = writer.GetProgramJson(&program);
   std::string total_str;
-  if (readable) {
-    total_str = total.dump(4);
+  if (binary) {
+    // base code is stored in the binary header
+    Json program_json = writer.GetProgramJson(&program);
+    BinaryProgramWriter binary_writer(pir_version, trainable);
+    total_str = binary_writer.Encode(&program_json);
   } else {
-    total_str = total.dump();
+    // write base code
+    Json total;
+
+    total[BASE_CODE] = {
+        {MAGIC, PIR}, {PIRVERSION, pir_version}, {TRAINABLE, trainable}};
+
+    // write program
+    total[PROGRAM] = writer.GetProgramJson(&program);
+    if (readable) {
+      total_str = total.dump(4);
+    } else {
+      total_str = total.dump();
+    }
   }
 
   MkDirRecursively(DirName(file_path).c_str());
@@ -69,8 +81,22 @@ void WriteModule(const pir::Program& program,
 bool ReadModule(const std::string& file_path,
                 pir::Program* program,
                 int64_t pir_version) {
-  std::ifstream f(file_path);
-  Json data = Json::parse(f);
+  Json data;
+  // The ops of a binary program are read into the program section by section
+  // instead of being decoded to a whole program json first.
+  std::unique_ptr<BinaryProgramReader> binary_reader;
+  if (BinaryProgramReader::IsBinaryProgram(file_path)) {
+    std::ifstream fin(file_path, std::ios::binary);
+    std::string buffer((std::istreambuf_iterator<char>(fin)),
+                       std::istreambuf_iterator<char>());
+    binary_reader = std::make_unique<BinaryProgramReader>(std::move(buffer));
+    data[BASE_CODE] = {{MAGIC, PIR},
+                       {PIRVERSION, binary_reader->pir_version()},
+                       {TRAINABLE, binary_reader->trainable()}};
+  } else {
+    std::ifstream f(file_path);
+    data = Json::parse(f);
+  }
   if (pir_version < 0) {
     pir_version = DEVELOP_VERSION;
     VLOG(6) << "pir_version is null, get pir_version: " << pir_version;
@@ -100,7 +126,11 @@ bool ReadModule(const std::string& file_path,
   }
 
   ProgramReader reader(pir_version);
-  reader.RecoverProgram(&(data[PROGRAM]), program, &builder);
+  if (binary_reader) {
+    reader.RecoverProgram(binary_reader.get(), program, &builder);
+  } else {
+    reader.RecoverProgram(&(data[PROGRAM]), program, &builder);
+  }
 
   if (data[BASE_CODE].contains(TRAINABLE)) {
     return data[BASE_CODE][TRAINABLE].get<bool>();
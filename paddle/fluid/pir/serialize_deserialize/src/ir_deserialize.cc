@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_deserialize.h"
 #include <unordered_map>
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_serialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/deserialize_utils.h"
 namespace pir {
 void ProgramReader::RecoverProgram(Json* program_json,
@@ -26,6 +27,49 @@ void ProgramReader::RecoverProgram(Json* program_json,
   return;
 }
 
+void ProgramReader::RecoverProgram(BinaryProgramReader* binary_reader,
+                                   pir::Program* recover_program,
+                                   pir::PatchBuilder* builder) {
+  id_value_map[0] = pir::Value();
+  patch_builder = builder;
+
+  Json* program_json = binary_reader->mutable_program_json();
+  PADDLE_ENFORCE_EQ(
+      program_json->at(REGIONS).size(),
+      1,
+      common::errors::InvalidArgument(
+          "The regions size of program module should be 1 but got %d.",
+          program_json->at(REGIONS).size()));
+  auto& block_json = program_json->at(REGIONS).at(0).at(BLOCKS).at(0);
+  auto* block = recover_program->block();
+  ReadBlockArgs(&block_json, block);
+
+  size_t num_sections = binary_reader->num_op_sections();
+  if (num_sections > 0) {
+    // The max value id is only used by the op_pair patches, so the sections
+    // are only decoded twice when there are such patches to apply.
+    int64_t max_value_id = 0;
+    if (builder->HasOpPairPatch()) {
+      for (size_t i = 0; i < num_sections; ++i) {
+        Json ops_json = binary_reader->ReadOpSection(i);
+        max_value_id = std::max(max_value_id, GetMaxValueId(&ops_json));
+      }
+    }
+    max_value_id += id_value_map.size();
+    VLOG(6) << "max_value_id: " << max_value_id;
+    builder->ApplyOpPairPatches(&max_value_id);
+    for (size_t i = 0; i < num_sections; ++i) {
+      Json ops_json = binary_reader->ReadOpSection(i);
+      for (auto& op_json : ops_json) {
+        block->push_back(ReadOp(&op_json));
+      }
+    }
+    VLOG(6) << "read block size" << block->size() << ".";
+  }
+  VLOG(6) << "Finish binary to program.";
+  return;
+}
+
 pir::Type ProgramReader::RecoverType(Json* type_json) {
   return ReadType(type_json);
 }
@@ -65,7 +109,28 @@ void ProgramReader::ReadRegion(Json* region_json, pir::Region* region) {
 
 void ProgramReader::ReadBlock(Json* block_json, pir::Block* block) {
   auto block_name = block_json->at(ID).template get<std::string>();
+  ReadBlockArgs(block_json, block);
 
+  Json& ops_json = block_json->at(BLOCKOPS);
+  if (!ops_json.empty()) {
+    // get value id for op_pair io patch
+    VLOG(6) << "Begin to read value num ...";
+    int64_t max_value_id = GetMaxValueId(&ops_json);
+    max_value_id += id_value_map.size();
+    VLOG(6) << "max_value_id: " << max_value_id;
+    // Apply op_pair io patch
+    patch_builder->ApplyOpPairPatches(&max_value_id);
+    for (auto& op_json : ops_json) {
+      block->push_back(ReadOp(&op_json));
+    }
+    VLOG(6) << "read block size" << block->size() << ".";
+  }
+
+  VLOG(4) << "Finish Read " << block_name << ".";
+  return;
+}
+
+void ProgramReader::ReadBlockArgs(Json* block_json, pir::Block* block) {
   Json& args_json = block_json->at(BLOCKARGS);
   if (!args_json.empty()) {
     for (auto& arg_json : args_json) {
@@ -90,42 +155,30 @@ void ProgramReader::ReadBlock(Json* block_json, pir::Block* block) {
       VLOG(6) << "Finish Read keyword blockarguments. ";
     }
   }
+}
 
-  Json& ops_json = block_json->at(BLOCKOPS);
-  if (!ops_json.empty()) {
-    // get value id for op_pair io patch
-    VLOG(6) << "Begin to read value num ...";
-    int64_t max_value_id = 0;
-    for (auto& op_json : ops_json) {
-      if (op_json.at(ID).template get<std::string>() == PARAMETEROP) {
-        int64_t id = op_json.at(OPRESULTS).at(VALUE_ID).template get<int64_t>();
-        max_value_id = std::max(max_value_id, id);
-        continue;
-      }
-      Json& operands_json = op_json.at(OPOPERANDS);
-      for (auto& operand_json : operands_json) {
-        int64_t id = operand_json.at(VALUE_ID).template get<int64_t>();
-        max_value_id = std::max(max_value_id, id);
-      }
-      Json& opresults_json = op_json.at(OPRESULTS);
-      for (auto& opresult_json : opresults_json) {
-        int64_t id = opresult_json.at(VALUE_ID).template get<int64_t>();
-        max_value_id = std::max(max_value_id, id);
-      }
+int64_t ProgramReader::GetMaxValueId(Json* ops_json) {
+  int64_t max_value_id = 0;
+  for (auto& op_json : *ops_json) {
+    if (op_json.at(ID).template get<std::string>() == PARAMETEROP) {
+      int64_t id = op_json.at(OPRESULTS).at(VALUE_ID).template get<int64_t>();
+      max_value_id = std::max(max_value_id, id);
+      continue;
     }
-    max_value_id += id_value_map.size();
-    VLOG(6) << "max_value_id: " << max_value_id;
-    // Apply op_pair io patch
-    patch_builder->ApplyOpPairPatches(&max_value_id);
-    for (auto& op_json : ops_json) {
-      block->push_back(ReadOp(&op_json));
+    Json& operands_json = op_json.at(OPOPERANDS);
+    for (auto& operand_json : operands_json) {
+      int64_t id = operand_json.at(VALUE_ID).template get<int64_t>();
+      max_value_id = std::max(max_value_id, id);
+    }
+    Json& opresults_json = op_json.at(OPRESULTS);
+    for (auto& opresult_json : opresults_json) {
+      int64_t id = opresult_json.at(VALUE_ID).template get<int64_t>();
+      max_value_id = std::max(max_value_id, id);
     }
-    VLOG(6) << "read block size" << block->size() << ".";
   }
-
-  VLOG(4) << "Finish Read " << block_name << ".";
-  return;
+  return max_value_id;
 }
+
 pir::ArrayAttribute GetOneBoolArrayAttribute(pir::IrContext* ctx,
                                              Json* attr_json) {
   std::vector<pir::Attribute> val;
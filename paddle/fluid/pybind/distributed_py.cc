@@ -1393,7 +1393,27 @@ void BindDistributed(py::module *m) {
                   py::arg("group_id") = 0,
                   py::call_guard<py::gil_scoped_release>())
       .def_static("create_default_device",
-                  &ProcessGroupGloo::createDefaultDevice);
+                  &ProcessGroupGloo::createDefaultDevice)
+      .def(
+          "allreduce_coalesced",
+          [](ProcessGroupGloo &self,
+             py::handle py_tensors,
+             distributed::ReduceOp op) {
+            auto tensors = CastPyArg2VectorOfTensor(py_tensors.ptr(), 0);
+            // the outputs share the allocations of the tensors
+            std::vector<phi::DenseTensor> in_dense;
+            for (auto &tensor : tensors) {
+              in_dense.push_back(
+                  *std::dynamic_pointer_cast<phi::DenseTensor>(tensor.impl()));
+            }
+            std::vector<phi::DenseTensor> out_dense = in_dense;
+            distributed::AllreduceOptions opts{};
+            opts.reduce_op = op;
+            return self.AllReduce(in_dense, out_dense, opts);
+          },
+          py::arg("tensors"),
+          py::arg("op") = distributed::ReduceOp::SUM,
+          py::call_guard<py::gil_scoped_release>());
 #endif
 
   m->def(
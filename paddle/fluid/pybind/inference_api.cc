@@ -880,6 +880,11 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::EnableSaveOptimModel,
            py::arg("save_optimized_model") = false)
       .def("set_optim_cache_dir", &AnalysisConfig::SetOptimCacheDir)
+      .def("enable_optimized_model_cache",
+           &AnalysisConfig::EnableOptimizedModelCache,
+           py::arg("x") = true)
+      .def("optimized_model_cache_enabled",
+           &AnalysisConfig::optimized_model_cache_enabled)
       .def("switch_use_feed_fetch_ops",
            &AnalysisConfig::SwitchUseFeedFetchOps,
            py::arg("x") = true)
@@ -1336,7 +1336,7 @@ PYBIND11_MODULE(libpaddle, m) {
           }
         }
         if (lib == "phi" || lib == "all") {
-          auto phi_kernels = phi::KernelFactory::Instance().kernels();
+          const auto &phi_kernels = phi::KernelFactory::Instance().kernels();
           for (auto &kernel_pair : phi_kernels) {
             auto op_type = phi::TransToFluidOpName(kernel_pair.first);
             std::vector<std::string> kernel_types;
@@ -1376,7 +1376,7 @@ PYBIND11_MODULE(libpaddle, m) {
       [](const std::string &kernel_registered_type) {
         std::unordered_map<std::string, std::vector<std::string>>
             all_kernels_info;
-        auto phi_kernels = phi::KernelFactory::Instance().kernels();
+        const auto &phi_kernels = phi::KernelFactory::Instance().kernels();
         for (auto &kernel_pair : phi_kernels) {
           auto kernel_name = kernel_pair.first;
           std::vector<std::string> kernel_keys;
@@ -1428,7 +1428,7 @@ PYBIND11_MODULE(libpaddle, m) {
   // unloaded. We need manually clear symbols(may contain plugins' symbols)
   // stored in this static instance to avoid illegal memory access.
   m.def("clear_kernel_factory",
-        []() { phi::KernelFactory::Instance().kernels().clear(); });
+        []() { phi::KernelFactory::Instance().MutableKernels().clear(); });
   m.def("clear_device_manager", []() {
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
     platform::XCCLCommContext::Release();
@@ -305,7 +305,8 @@ INFER_GLOBAL_SHAPE_TEMPLATE = """
 # 4. Select Kernel
 KERNEL_SELECTION_TEMPLATE = """
       VLOG(6) << "{} API dist branch: kernel key: [" << kernel_backend << ", " << kernel_layout << ", "<< kernel_data_type << "]";
-      auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
+      static thread_local phi::KernelSelectionCache kernel_selection_cache;
+      auto kernel_result = kernel_selection_cache.SelectKernelOrThrowError(
           "{}", {{kernel_backend, kernel_layout, kernel_data_type}});
       const auto& kernel = kernel_result.kernel;
       VLOG(6) << "{} kernel: " << kernel;
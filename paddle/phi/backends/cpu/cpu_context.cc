@@ -12,8 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#define EIGEN_USE_THREADS
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <mutex>
+
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
 
@@ -21,9 +28,43 @@
 // without eigen.
 #include "paddle/phi/core/device_context.h"
 #include "unsupported/Eigen/CXX11/Tensor"
+#include "unsupported/Eigen/CXX11/ThreadPool"
 
 namespace phi {
 
+namespace {
+
+thread_local int intra_op_num_threads = 1;
+
+struct IntraOpThreadPool {
+  explicit IntraOpThreadPool(int num_threads)
+      : pool(num_threads), device(&pool, num_threads) {}
+
+  Eigen::ThreadPool pool;
+  Eigen::ThreadPoolDevice device;
+};
+
+// The pools live until the process exits, as the contexts of all threads
+// asking for the same number of threads share one.
+IntraOpThreadPool* GetIntraOpThreadPool(int num_threads) {
+  static std::mutex mutex;
+  static auto* pools = new std::map<int, IntraOpThreadPool*>();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& pool = (*pools)[num_threads];
+  if (pool == nullptr) {
+    pool = new IntraOpThreadPool(num_threads);
+  }
+  return pool;
+}
+
+}  // namespace
+
+void SetIntraOpNumThreads(int num_threads) {
+  intra_op_num_threads = std::max(num_threads, 1);
+}
+
+int GetIntraOpNumThreads() { return intra_op_num_threads; }
+
 struct CPUContext::Impl {
   Impl() : place_(CPUPlace()) {}
 
@@ -75,6 +116,67 @@ Eigen::DefaultDevice* CPUContext::eigen_device() const {
 
 const Place& CPUContext::GetPlace() const { return impl_->place_; }
 
+Eigen::ThreadPoolDevice* CPUContext::eigen_pool_device() const {
+  int num_threads = GetIntraOpNumThreads();
+  if (num_threads <= 1) {
+    return nullptr;
+  }
+  return &GetIntraOpThreadPool(num_threads)->device;
+}
+
+void CPUContext::ParallelFor(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    const std::function<void(int64_t, int64_t)>& fn) const {
+  if (begin >= end) {
+    return;
+  }
+  int64_t num_threads = GetIntraOpNumThreads();
+  grain_size = std::max<int64_t>(grain_size, 1);
+  int64_t num_tasks =
+      std::min(num_threads, (end - begin + grain_size - 1) / grain_size);
+  if (num_tasks <= 1) {
+    fn(begin, end);
+    return;
+  }
+
+  auto* pool = &GetIntraOpThreadPool(static_cast<int>(num_threads))->pool;
+  int64_t task_size = (end - begin + num_tasks - 1) / num_tasks;
+  num_tasks = (end - begin + task_size - 1) / task_size;
+  std::mutex mutex;
+  std::exception_ptr error;
+  auto run_task = [&](int64_t task) {
+    int64_t task_begin = begin + task * task_size;
+    int64_t task_end = std::min(task_begin + task_size, end);
+    // the nested parallel loops of a task run inline
+    int saved_num_threads = intra_op_num_threads;
+    intra_op_num_threads = 1;
+    try {
+      fn(task_begin, task_end);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    intra_op_num_threads = saved_num_threads;
+  };
+  // the calling thread runs the first task
+  Eigen::Barrier barrier(static_cast<unsigned int>(num_tasks - 1));
+  for (int64_t task = 1; task < num_tasks; ++task) {
+    pool->Schedule([&, task] {
+      run_task(task);
+      barrier.Notify();
+    });
+  }
+  run_task(0);
+  barrier.Wait();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 void CPUContext::SetEigenDevice(Eigen::DefaultDevice* device) {
   impl_->eigen_device_ = device;
 }
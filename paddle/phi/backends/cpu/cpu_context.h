@@ -14,6 +14,8 @@ limitations under the License. */
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 
 #include "paddle/phi/backends/cpu/forwards.h"
@@ -35,6 +37,21 @@ class PADDLE_API CPUContext : public DeviceContext,
   Eigen::DefaultDevice* eigen_device() const;
   const Place& GetPlace() const override;
 
+  // The Eigen device of the intra-op thread pool of the calling thread, or
+  // nullptr if the thread runs single threaded. The kernels using it should
+  // define EIGEN_USE_THREADS before including Eigen.
+  Eigen::ThreadPoolDevice* eigen_pool_device() const;
+
+  // Splits [begin, end) into ranges of at least grain_size elements and runs
+  // fn(range_begin, range_end) on them with the intra-op thread pool, then
+  // waits for them. fn runs inline on the whole range if it is not larger
+  // than grain_size or the calling thread runs single threaded, which is
+  // always the case in a task of the pool.
+  void ParallelFor(int64_t begin,
+                   int64_t end,
+                   int64_t grain_size,
+                   const std::function<void(int64_t, int64_t)>& fn) const;
+
   static const char* name() { return "CPUContext"; }
 
  protected:
@@ -48,4 +65,12 @@ class PADDLE_API CPUContext : public DeviceContext,
   std::unique_ptr<Impl> impl_;
 };
 
+// Sets the number of threads of the intra-op parallelism of the CPU kernels
+// run by the calling thread, 1 by default. Like omp_set_num_threads it only
+// affects the calling thread, so that each predictor or executor thread runs
+// with its own setting. The threads are shared by the callers asking for the
+// same number.
+PADDLE_API void SetIntraOpNumThreads(int num_threads);
+PADDLE_API int GetIntraOpNumThreads();
+
 }  // namespace phi
@@ -139,6 +139,8 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
              cpu.has(Cpu::tAVX512_4VNNIW);
     case avx512_bf16:
       return true && cpu.has(Cpu::tAVX512_BF16);
+    case f16c:
+      return cpu.has(Cpu::tF16C);
     case isa_any:
       return true;
   }
@@ -162,6 +164,10 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
       if (cpu_isa == avx) {
         int avx_mask = (1 << 28);
         return (reg[2] & avx_mask) != 0;
+      } else if (cpu_isa == f16c) {
+        // F16C: ECX Bit 29
+        int f16c_mask = (1 << 29);
+        return (reg[2] & f16c_mask) != 0;
       }
     }
     if (nIds >= 0x00000007) {
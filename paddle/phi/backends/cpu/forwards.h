@@ -15,7 +15,8 @@ limitations under the License. */
 // Forward-declares.
 #pragma once
 
-// Forward declaration of Eigen DefaultDevice types.
+// Forward declaration of Eigen DefaultDevice and ThreadPoolDevice types.
 namespace Eigen {
 struct DefaultDevice;
+struct ThreadPoolDevice;
 }  // namespace Eigen
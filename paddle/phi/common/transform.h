@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <type_traits>
 
 #include "paddle/common/hostdevice.h"
@@ -67,28 +68,49 @@ struct Transform {
 
 // NOTE: After the phi kernel is migrated, it needs to be deleted.
 
+// The CPU transform of pointers runs on the intra-op thread pool of the
+// context in ranges of kTransformGrainSize elements.
+constexpr int64_t kTransformGrainSize = 32768;
+
 template <>
 struct Transform<phi::CPUContext> {
   template <typename InputIter, typename OutputIter, typename UnaryOperation>
-  void operator()(const phi::CPUContext& context UNUSED,
+  void operator()(const phi::CPUContext& context,
                   InputIter first,
                   InputIter last,
                   OutputIter result,
                   UnaryOperation op) {
-    std::transform(first, last, result, op);
+    if constexpr (std::is_pointer<InputIter>::value &&
+                  std::is_pointer<OutputIter>::value) {
+      context.ParallelFor(
+          0, last - first, kTransformGrainSize, [&](int64_t b, int64_t e) {
+            std::transform(first + b, first + e, result + b, op);
+          });
+    } else {
+      std::transform(first, last, result, op);
+    }
   }
 
   template <typename InputIter1,
             typename InputIter2,
             typename OutputIter,
             typename BinaryOperation>
-  void operator()(const phi::CPUContext& context UNUSED,
+  void operator()(const phi::CPUContext& context,
                   InputIter1 first1,
                   InputIter1 last1,
                   InputIter2 first2,
                   OutputIter result,
                   BinaryOperation op) {
-    std::transform(first1, last1, first2, result, op);
+    if constexpr (std::is_pointer<InputIter1>::value &&
+                  std::is_pointer<InputIter2>::value &&
+                  std::is_pointer<OutputIter>::value) {
+      context.ParallelFor(
+          0, last1 - first1, kTransformGrainSize, [&](int64_t b, int64_t e) {
+            std::transform(first1 + b, first1 + e, first2 + b, result + b, op);
+          });
+    } else {
+      std::transform(first1, last1, first2, result, op);
+    }
   }
 };
 
@@ -0,0 +1,427 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/gloo_allreduce.h"
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+#include <gloo/math.h>
+#include <gloo/transport/unbound_buffer.h>
+#include <gloo/types.h>
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/reduce_type.h"
+#include "paddle/phi/core/enforce.h"
+
+COMMON_DECLARE_string(gloo_allreduce_algo);
+
+namespace phi::distributed {
+
+namespace {
+
+// Below it the allreduce is latency bound, and left to gloo.
+constexpr size_t kHalvingDoublingMinBytes = 64 << 10;
+// The ring is used once the segment of each rank is large enough to be split
+// into several chunks.
+constexpr size_t kRingMinSegmentBytes = 1 << 20;
+constexpr size_t kRingChunkBytes = 256 << 10;
+
+template <typename T>
+void GlooReduceInto(T* dst, const T* src, size_t count, int reduce_type) {
+  switch (static_cast<ReduceType>(reduce_type)) {
+    case ReduceType::kRedSum:
+      gloo::sum<T>(dst, dst, src, count);
+      break;
+    case ReduceType::kRedMax:
+      gloo::max<T>(dst, dst, src, count);
+      break;
+    case ReduceType::kRedMin:
+    // There is no reduce_all math function for gloo, min is used instead, as
+    // in SetReduceFunc.
+    case ReduceType::kRedAll:
+      gloo::min<T>(dst, dst, src, count);
+      break;
+    case ReduceType::kRedProd:
+      gloo::product<T>(dst, dst, src, count);
+      break;
+    default:
+      PADDLE_THROW(
+          errors::InvalidArgument("Unsupport reduce type: %d.", reduce_type));
+  }
+}
+
+#ifdef __AVX__
+template <typename T>
+struct AVXReduceTraits;
+
+template <>
+struct AVXReduceTraits<float> {
+  using Vec = __m256;
+  static constexpr size_t kWidth = 8;
+  static Vec Load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+  static void Store(float* ptr, Vec v) { _mm256_storeu_ps(ptr, v); }
+  static Vec Add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+  static Vec Mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+  static Vec Max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+  static Vec Min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+};
+
+template <>
+struct AVXReduceTraits<double> {
+  using Vec = __m256d;
+  static constexpr size_t kWidth = 4;
+  static Vec Load(const double* ptr) { return _mm256_loadu_pd(ptr); }
+  static void Store(double* ptr, Vec v) { _mm256_storeu_pd(ptr, v); }
+  static Vec Add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+  static Vec Mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+  static Vec Max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+  static Vec Min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+};
+
+template <typename T, typename VecOp, typename Op>
+void AVXReduceInto(T* dst, const T* src, size_t count, VecOp vec_op, Op op) {
+  using Traits = AVXReduceTraits<T>;
+  size_t i = 0;
+  for (; i + Traits::kWidth <= count; i += Traits::kWidth) {
+    Traits::Store(dst + i,
+                  vec_op(Traits::Load(dst + i), Traits::Load(src + i)));
+  }
+  for (; i < count; ++i) {
+    dst[i] = op(dst[i], src[i]);
+  }
+}
+
+template <typename T>
+void AVXReduceInto(T* dst, const T* src, size_t count, int reduce_type) {
+  using Traits = AVXReduceTraits<T>;
+  switch (static_cast<ReduceType>(reduce_type)) {
+    case ReduceType::kRedSum:
+      AVXReduceInto(
+          dst, src, count, Traits::Add, [](T a, T b) { return a + b; });
+      break;
+    case ReduceType::kRedMax:
+      AVXReduceInto(
+          dst, src, count, Traits::Max, [](T a, T b) { return a > b ? a : b; });
+      break;
+    case ReduceType::kRedMin:
+    case ReduceType::kRedAll:
+      AVXReduceInto(
+          dst, src, count, Traits::Min, [](T a, T b) { return a < b ? a : b; });
+      break;
+    case ReduceType::kRedProd:
+      AVXReduceInto(
+          dst, src, count, Traits::Mul, [](T a, T b) { return a * b; });
+      break;
+    default:
+      PADDLE_THROW(
+          errors::InvalidArgument("Unsupport reduce type: %d.", reduce_type));
+  }
+}
+#endif
+
+// Returns the offset and the size of part i of [0, count) split into
+// num_parts, the leading parts being larger by one element.
+std::pair<size_t, size_t> SplitRange(size_t count,
+                                     size_t num_parts,
+                                     size_t i) {
+  size_t base = count / num_parts;
+  size_t rest = count % num_parts;
+  return {i * base + std::min(i, rest), base + (i < rest ? 1 : 0)};
+}
+
+}  // namespace
+
+template <typename T>
+void ReduceInto(T* dst, const T* src, size_t count, int reduce_type) {
+  GlooReduceInto(dst, src, count, reduce_type);
+}
+
+#ifdef __AVX__
+template <>
+void ReduceInto<float>(float* dst,
+                       const float* src,
+                       size_t count,
+                       int reduce_type) {
+  AVXReduceInto(dst, src, count, reduce_type);
+}
+
+template <>
+void ReduceInto<double>(double* dst,
+                        const double* src,
+                        size_t count,
+                        int reduce_type) {
+  AVXReduceInto(dst, src, count, reduce_type);
+}
+#endif
+
+GlooAllreduceAlgo SelectGlooAllreduceAlgo(size_t bytes, int world_size) {
+  const std::string& algo = FLAGS_gloo_allreduce_algo;
+  if (algo == "gloo") {
+    return GlooAllreduceAlgo::kGloo;
+  } else if (algo == "ring") {
+    return GlooAllreduceAlgo::kRing;
+  } else if (algo == "halving_doubling") {
+    return GlooAllreduceAlgo::kHalvingDoubling;
+  }
+  PADDLE_ENFORCE_EQ(algo,
+                    "auto",
+                    errors::InvalidArgument(
+                        "FLAGS_gloo_allreduce_algo should be one of auto, "
+                        "gloo, ring and halving_doubling, but received %s.",
+                        algo));
+  if (world_size < 2 || bytes < kHalvingDoublingMinBytes) {
+    return GlooAllreduceAlgo::kGloo;
+  }
+  if (bytes / world_size >= kRingMinSegmentBytes) {
+    return GlooAllreduceAlgo::kRing;
+  }
+  return GlooAllreduceAlgo::kHalvingDoubling;
+}
+
+// At step s, rank r sends segment r - s to its right neighbor and receives
+// segment r - s - 1 from its left one. The received segments are reduced in
+// the first size - 1 steps, after which rank r holds the result of segment
+// r + 1, and are copied in the last size - 1 steps. A chunk is sent on at the
+// next step as soon as it is received, so the chunks flow through the ring
+// without waiting for whole segments.
+template <typename T>
+void RingAllReduce(const std::shared_ptr<gloo::Context>& context,
+                   T* data,
+                   size_t count,
+                   int reduce_type,
+                   uint32_t tag) {
+  const int rank = context->rank;
+  const int size = context->size;
+  if (size == 1 || count == 0) {
+    return;
+  }
+  const auto slot = gloo::Slot::build(kAllreduceSlotPrefix, tag);
+  const auto timeout = context->getTimeout();
+  const int left = (rank + size - 1) % size;
+  const int right = (rank + 1) % size;
+  const int num_steps = 2 * (size - 1);
+
+  const size_t max_segment = SplitRange(count, size, 0).second;
+  const size_t num_chunks = std::max<size_t>(
+      1, (max_segment * sizeof(T) + kRingChunkBytes - 1) / kRingChunkBytes);
+  // Chunk c of every segment is received at the same offset of buffer, so
+  // that it can be received again once reduced.
+  std::unique_ptr<T[]> buffer(new T[max_segment]);
+  auto data_buffer = context->createUnboundBuffer(data, count * sizeof(T));
+  auto recv_buffer =
+      context->createUnboundBuffer(buffer.get(), max_segment * sizeof(T));
+
+  auto segment_of = [rank, size](int step) {
+    return ((rank - step) % size + size) % size;
+  };
+  // offset in data, offset in buffer and size of chunk c of segment
+  auto chunk_of = [&](int segment, size_t c) {
+    auto segment_range = SplitRange(count, size, segment);
+    auto chunk = SplitRange(segment_range.second, num_chunks, c);
+    return std::make_tuple(segment_range.first + chunk.first,
+                           SplitRange(max_segment, num_chunks, c).first,
+                           chunk.second);
+  };
+  size_t num_sends = 0;
+  auto send_chunk = [&](int step, size_t c) {
+    auto [offset, buffer_offset, chunk_size] = chunk_of(segment_of(step), c);
+    if (chunk_size > 0) {
+      data_buffer->send(
+          right, slot, offset * sizeof(T), chunk_size * sizeof(T));
+      ++num_sends;
+    }
+  };
+  auto recv_chunk = [&](int step, size_t c) {
+    auto [offset, buffer_offset, chunk_size] =
+        chunk_of(segment_of(step + 1), c);
+    if (chunk_size == 0) {
+      return;
+    }
+    if (step < size - 1) {
+      recv_buffer->recv(
+          left, slot, buffer_offset * sizeof(T), chunk_size * sizeof(T));
+    } else {
+      data_buffer->recv(
+          left, slot, offset * sizeof(T), chunk_size * sizeof(T));
+    }
+  };
+
+  for (size_t c = 0; c < num_chunks; ++c) {
+    send_chunk(0, c);
+    recv_chunk(0, c);
+  }
+  for (int step = 0; step < num_steps; ++step) {
+    for (size_t c = 0; c < num_chunks; ++c) {
+      auto [offset, buffer_offset, chunk_size] =
+          chunk_of(segment_of(step + 1), c);
+      if (chunk_size > 0) {
+        if (step < size - 1) {
+          recv_buffer->waitRecv(timeout);
+          ReduceInto(data + offset,
+                     buffer.get() + buffer_offset,
+                     chunk_size,
+                     reduce_type);
+        } else {
+          data_buffer->waitRecv(timeout);
+        }
+      }
+      if (step + 1 < num_steps) {
+        send_chunk(step + 1, c);
+        recv_chunk(step + 1, c);
+      }
+    }
+  }
+  for (size_t i = 0; i < num_sends; ++i) {
+    data_buffer->waitSend(timeout);
+  }
+}
+
+// With p the largest power of 2 not greater than size, the first
+// 2 * (size - p) ranks are paired first: the even ones send their data to the
+// next odd ones, and get the result back at the end. The remaining p ranks
+// exchange and reduce halves of their range with the rank at distance
+// p / 2, p / 4, ..., 1, then gather the reduced ranges back in reverse.
+template <typename T>
+void HalvingDoublingAllReduce(const std::shared_ptr<gloo::Context>& context,
+                              T* data,
+                              size_t count,
+                              int reduce_type,
+                              uint32_t tag) {
+  const int rank = context->rank;
+  const int size = context->size;
+  if (size == 1 || count == 0) {
+    return;
+  }
+  const auto slot = gloo::Slot::build(kAllreduceSlotPrefix, tag);
+  const auto timeout = context->getTimeout();
+  int p = 1;
+  while (p * 2 <= size) {
+    p *= 2;
+  }
+  const int extra = size - p;
+  std::unique_ptr<T[]> buffer(new T[count]);
+  auto data_buffer = context->createUnboundBuffer(data, count * sizeof(T));
+  auto recv_buffer =
+      context->createUnboundBuffer(buffer.get(), count * sizeof(T));
+
+  if (rank < 2 * extra) {
+    if (rank % 2 == 0) {
+      data_buffer->send(rank + 1, slot);
+      data_buffer->waitSend(timeout);
+      data_buffer->recv(rank + 1, slot);
+      data_buffer->waitRecv(timeout);
+      return;
+    }
+    recv_buffer->recv(rank - 1, slot);
+    recv_buffer->waitRecv(timeout);
+    ReduceInto(data, buffer.get(), count, reduce_type);
+  }
+  const int vrank = rank < 2 * extra ? rank / 2 : rank - extra;
+  auto rank_of = [extra](int v) { return v < extra ? 2 * v + 1 : v + extra; };
+
+  // the ranges before each halving, to gather back
+  std::vector<std::pair<size_t, size_t>> ranges;
+  size_t offset = 0;
+  size_t len = count;
+  for (int distance = p / 2; distance >= 1; distance /= 2) {
+    const int peer = rank_of(vrank ^ distance);
+    const bool upper = (vrank & distance) != 0;
+    const size_t lower_len = len / 2;
+    const size_t keep_offset = upper ? offset + lower_len : offset;
+    const size_t keep_len = upper ? len - lower_len : lower_len;
+    const size_t send_offset = upper ? offset : offset + lower_len;
+    const size_t send_len = len - keep_len;
+    ranges.emplace_back(offset, len);
+    if (keep_len > 0) {
+      recv_buffer->recv(
+          peer, slot, keep_offset * sizeof(T), keep_len * sizeof(T));
+    }
+    if (send_len > 0) {
+      data_buffer->send(
+          peer, slot, send_offset * sizeof(T), send_len * sizeof(T));
+    }
+    if (keep_len > 0) {
+      recv_buffer->waitRecv(timeout);
+      ReduceInto(data + keep_offset,
+                 buffer.get() + keep_offset,
+                 keep_len,
+                 reduce_type);
+    }
+    if (send_len > 0) {
+      data_buffer->waitSend(timeout);
+    }
+    offset = keep_offset;
+    len = keep_len;
+  }
+
+  for (int distance = 1; distance < p; distance *= 2) {
+    const int peer = rank_of(vrank ^ distance);
+    auto range = ranges.back();
+    ranges.pop_back();
+    // the peer holds the other half of range
+    const size_t other_offset =
+        offset == range.first ? offset + len : range.first;
+    const size_t other_len = range.second - len;
+    if (other_len > 0) {
+      data_buffer->recv(
+          peer, slot, other_offset * sizeof(T), other_len * sizeof(T));
+    }
+    if (len > 0) {
+      data_buffer->send(peer, slot, offset * sizeof(T), len * sizeof(T));
+    }
+    if (other_len > 0) {
+      data_buffer->waitRecv(timeout);
+    }
+    if (len > 0) {
+      data_buffer->waitSend(timeout);
+    }
+    offset = range.first;
+    len = range.second;
+  }
+
+  if (rank < 2 * extra) {
+    data_buffer->send(rank - 1, slot);
+    data_buffer->waitSend(timeout);
+  }
+}
+
+#define INSTANTIATE_GLOO_ALLREDUCE(T)                                        \
+  template void ReduceInto<T>(T*, const T*, size_t, int);                   \
+  template void RingAllReduce<T>(                                            \
+      const std::shared_ptr<gloo::Context>&, T*, size_t, int, uint32_t);     \
+  template void HalvingDoublingAllReduce<T>(                                 \
+      const std::shared_ptr<gloo::Context>&, T*, size_t, int, uint32_t);
+
+INSTANTIATE_GLOO_ALLREDUCE(float)
+INSTANTIATE_GLOO_ALLREDUCE(double)
+INSTANTIATE_GLOO_ALLREDUCE(gloo::float16)
+INSTANTIATE_GLOO_ALLREDUCE(int32_t)
+INSTANTIATE_GLOO_ALLREDUCE(int64_t)
+#ifndef _WIN32
+INSTANTIATE_GLOO_ALLREDUCE(int8_t)
+INSTANTIATE_GLOO_ALLREDUCE(uint8_t)
+INSTANTIATE_GLOO_ALLREDUCE(bool)
+INSTANTIATE_GLOO_ALLREDUCE(phi::dtype::bfloat16)
+#endif
+
+}  // namespace phi::distributed
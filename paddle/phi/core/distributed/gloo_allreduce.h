@@ -0,0 +1,62 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gloo/context.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace phi {
+namespace distributed {
+
+constexpr uint8_t kAllreduceSlotPrefix = 0x09;
+
+// The allreduce algorithms of GlooCommContext. kGloo calls gloo::allreduce,
+// the others run over the unbound buffers of the gloo context:
+// - kRing: reduce-scatter then allgather along the ring of ranks. Each
+//   segment is split into chunks, so that the transfer of a chunk overlaps
+//   the reduction of the previous one. Bandwidth optimal, for large tensors.
+// - kHalvingDoubling: recursive halving reduce-scatter then recursive
+//   doubling allgather, in 2 * log2(world_size) steps, for medium tensors.
+enum class GlooAllreduceAlgo { kGloo, kRing, kHalvingDoubling };
+
+// Selects the algorithm by FLAGS_gloo_allreduce_algo, or by the bytes of the
+// tensor and the world size if the flag is "auto".
+GlooAllreduceAlgo SelectGlooAllreduceAlgo(size_t bytes, int world_size);
+
+// Reduce the count elements of data in place with those of the other ranks,
+// reduce_type is a phi::ReduceType.
+template <typename T>
+void RingAllReduce(const std::shared_ptr<gloo::Context>& context,
+                   T* data,
+                   size_t count,
+                   int reduce_type,
+                   uint32_t tag);
+
+template <typename T>
+void HalvingDoublingAllReduce(const std::shared_ptr<gloo::Context>& context,
+                              T* data,
+                              size_t count,
+                              int reduce_type,
+                              uint32_t tag);
+
+// dst[i] = reduce(dst[i], src[i]), with AVX for float and double.
+template <typename T>
+void ReduceInto(T* dst, const T* src, size_t count, int reduce_type);
+
+}  // namespace distributed
+}  // namespace phi
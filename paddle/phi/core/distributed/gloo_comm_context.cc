@@ -24,13 +24,50 @@
 #include <gloo/scatter.h>
 #include <gloo/types.h>
 
+#include <cstring>
+#include <vector>
+
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/distributed/check/static_check.h"
+#include "paddle/phi/core/distributed/gloo_allreduce.h"
 #include "paddle/phi/core/enforce.h"
 
 namespace phi::distributed {
 
+namespace {
+
+// max bytes of a bucket of the fused allreduce
+constexpr size_t kAllreduceFusionBytes = 16 << 20;
+
+template <typename T>
+void AllReduceBuffer(const std::shared_ptr<gloo::Context>& context,
+                     GlooAllreduceAlgo algo,
+                     void* data,
+                     size_t count,
+                     int reduce_type,
+                     uint32_t tag) {
+  T* ptr = static_cast<T*>(data);
+  switch (algo) {
+    case GlooAllreduceAlgo::kRing:
+      RingAllReduce<T>(context, ptr, count, reduce_type, tag);
+      break;
+    case GlooAllreduceAlgo::kHalvingDoubling:
+      HalvingDoublingAllReduce<T>(context, ptr, count, reduce_type, tag);
+      break;
+    default: {
+      gloo::AllreduceOptions opts(context);
+      opts.setTag(tag);
+      opts.setOutput(ptr, count);
+      SetReduceFunc<T>(&opts, reduce_type);
+      gloo::allreduce(opts);
+      break;
+    }
+  }
+}
+
+}  // namespace
+
 GlooCommContext::GlooCommContext(
     int rank,
     int size,
@@ -80,13 +117,99 @@ void GlooCommContext::AllReduce(phi::DenseTensor* out_tensor,
                                 const phi::DenseTensor& in_tensor,
                                 int reduce_type,
                                 uint32_t tag) {
-  gloo::AllreduceOptions opts(gloo_context_);
-  opts.setTag(tag);
   const auto& dtype = in_tensor.dtype();
-  GENERATE_FUNC(dtype, SetInput, &opts, in_tensor);
-  GENERATE_FUNC(dtype, SetOutput, &opts, out_tensor);
-  GENERATE_FUNC(dtype, SetReduceFunc, &opts, reduce_type);
-  gloo::allreduce(opts);
+  size_t bytes = in_tensor.numel() * phi::SizeOf(dtype);
+  auto algo = SelectGlooAllreduceAlgo(bytes, size_);
+  if (algo == GlooAllreduceAlgo::kGloo) {
+    gloo::AllreduceOptions opts(gloo_context_);
+    opts.setTag(tag);
+    GENERATE_FUNC(dtype, SetInput, &opts, in_tensor);
+    GENERATE_FUNC(dtype, SetOutput, &opts, out_tensor);
+    GENERATE_FUNC(dtype, SetReduceFunc, &opts, reduce_type);
+    gloo::allreduce(opts);
+    return;
+  }
+  // the ring and halving-doubling allreduce run in place on the output
+  if (out_tensor->data() != in_tensor.data()) {
+    std::memcpy(out_tensor->data(), in_tensor.data(), bytes);
+  }
+  GENERATE_FUNC(dtype,
+                AllReduceBuffer,
+                gloo_context_,
+                algo,
+                out_tensor->data(),
+                in_tensor.numel(),
+                reduce_type,
+                tag);
+}
+
+void GlooCommContext::AllReduce(
+    const std::vector<phi::DenseTensor*>& out_tensors,
+    const std::vector<const phi::DenseTensor*>& in_tensors,
+    int reduce_type,
+    uint32_t tag) {
+  PADDLE_ENFORCE_EQ(
+      out_tensors.size(),
+      in_tensors.size(),
+      common::errors::InvalidArgument(
+          "The number of output tensors (%d) of the allreduce should be equal "
+          "to the number of input tensors (%d).",
+          out_tensors.size(),
+          in_tensors.size()));
+  std::vector<uint8_t> buffer;
+  size_t begin = 0;
+  while (begin < in_tensors.size()) {
+    const auto dtype = in_tensors[begin]->dtype();
+    const size_t elem_size = phi::SizeOf(dtype);
+    // [begin, end) is a bucket of tensors of the same dtype
+    size_t end = begin;
+    size_t bytes = 0;
+    while (end < in_tensors.size() && in_tensors[end]->dtype() == dtype) {
+      size_t tensor_bytes = in_tensors[end]->numel() * elem_size;
+      if (end > begin && bytes + tensor_bytes > kAllreduceFusionBytes) {
+        break;
+      }
+      bytes += tensor_bytes;
+      ++end;
+    }
+    if (end - begin == 1) {
+      AllReduce(out_tensors[begin], *in_tensors[begin], reduce_type, tag);
+      begin = end;
+      continue;
+    }
+
+    buffer.resize(bytes);
+    size_t offset = 0;
+    for (size_t i = begin; i < end; ++i) {
+      size_t tensor_bytes = in_tensors[i]->numel() * elem_size;
+      if (tensor_bytes > 0) {
+        std::memcpy(
+            buffer.data() + offset, in_tensors[i]->data(), tensor_bytes);
+      }
+      offset += tensor_bytes;
+    }
+    if (bytes > 0) {
+      auto algo = SelectGlooAllreduceAlgo(bytes, size_);
+      GENERATE_FUNC(dtype,
+                    AllReduceBuffer,
+                    gloo_context_,
+                    algo,
+                    buffer.data(),
+                    bytes / elem_size,
+                    reduce_type,
+                    tag);
+    }
+    offset = 0;
+    for (size_t i = begin; i < end; ++i) {
+      size_t tensor_bytes = in_tensors[i]->numel() * elem_size;
+      if (tensor_bytes > 0) {
+        std::memcpy(
+            out_tensors[i]->data(), buffer.data() + offset, tensor_bytes);
+      }
+      offset += tensor_bytes;
+    }
+    begin = end;
+  }
 }
 
 void GlooCommContext::Reduce(phi::DenseTensor* out_tensor,
@@ -18,6 +18,7 @@
 #include <gloo/transport/tcp/device.h>
 
 #include <memory>
+#include <vector>
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/core/distributed/comm_context.h"
@@ -43,6 +44,13 @@ class GlooCommContext final : public CommContext {
                  int reduce_type,
                  uint32_t tag = 0);
 
+  // Allreduces many tensors at once. Consecutive tensors of the same dtype
+  // are fused into buckets of up to 16MB, which are reduced as one buffer.
+  void AllReduce(const std::vector<phi::DenseTensor*>& out_tensors,
+                 const std::vector<const phi::DenseTensor*>& in_tensors,
+                 int reduce_type,
+                 uint32_t tag = 0);
+
   void Reduce(phi::DenseTensor* out_tensor,
               const phi::DenseTensor& in_tensor,
               int reduce_type,
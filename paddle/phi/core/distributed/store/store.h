@@ -33,6 +33,19 @@ class Store {
   virtual void wait(const std::string& key);
   virtual void set(const std::string& key, const std::vector<uint8_t>& value);
 
+  // Gets and sets several keys at once, by one key at a time unless the store
+  // implements them.
+  virtual std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys);
+  virtual void multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values);
+  // Sets key to desired if its value is expected, or if it is not set and
+  // expected is empty. Returns the value of key after the comparison, which is
+  // empty if it is still not set.
+  virtual std::vector<uint8_t> compare_set(const std::string& key,
+                                           const std::vector<uint8_t>& expected,
+                                           const std::vector<uint8_t>& desired);
+
   virtual int timeout() { return _timeout; }
 
  protected:
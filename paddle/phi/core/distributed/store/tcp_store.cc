@@ -14,7 +14,9 @@
 
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
 #include <iostream>
 #include <thread>
 
@@ -23,9 +25,16 @@
 #include "paddle/common/flags.h"
 #include "paddle/phi/core/distributed/store/tcp_utils.h"
 
+COMMON_DECLARE_int32(tcp_store_server_threads);
+
 namespace phi::distributed::detail {
 
 constexpr int INFTIME = 10000;  // 10 seconds
+constexpr size_t kStoreShardNum = 64;
+#ifdef _WIN32
+// The workers have no pipe to wake up on new connections or stop.
+constexpr int kWorkerPollTime = 100;
+#endif
 
 std::unique_ptr<MasterDaemon> MasterDaemon::start(SocketType socket,
                                                   int nranks,
@@ -35,8 +44,27 @@ std::unique_ptr<MasterDaemon> MasterDaemon::start(SocketType socket,
 }
 
 MasterDaemon::MasterDaemon(SocketType socket, int nranks, int timeout)
-    : _listen_socket(socket), _nranks(nranks), _timeout(timeout) {
+    : _listen_socket(socket),
+      _shards(kStoreShardNum),
+      _nranks(nranks),
+      _timeout(timeout) {
   InitControlFd();
+  int num_workers = std::max(FLAGS_tcp_store_server_threads, 1);
+  for (int i = 0; i < num_workers; ++i) {
+    auto worker = std::make_unique<Worker>();
+#ifndef _WIN32
+    PADDLE_ENFORCE_NE(
+        pipe(worker->wake_fd.data()),
+        -1,
+        common::errors::Fatal("failed to create wake pipe errno:%d", errno));
+    worker->fds.push_back(
+        {.fd = worker->wake_fd[0], .events = POLLIN, .revents = 0});
+#endif
+    _workers.emplace_back(std::move(worker));
+  }
+  for (auto& worker : _workers) {
+    worker->thread = std::thread{&MasterDaemon::RunWorker, this, worker.get()};
+  }
   _background_thread = std::thread{&MasterDaemon::run, this};
 }
 
@@ -44,33 +72,63 @@ MasterDaemon::~MasterDaemon() {  // NOLINT
   VLOG(8) << ("begin to destruct MasterDaemon");
   StopByControlFd();
   _background_thread.join();
+  StopWorkers();
   tcputils::close_socket(_listen_socket);
-  for (SocketType socket : _sockets) {
-    tcputils::close_socket(socket);
+  // The sockets are closed after all the workers stop, as any of them may
+  // notify a waiting socket.
+  for (auto& worker : _workers) {
+#ifdef _WIN32
+    size_t first_socket = 0;
+#else
+    size_t first_socket = 1;
+    for (int fd : worker->wake_fd) {
+      ::close(fd);
+    }
+#endif
+    for (size_t i = first_socket; i < worker->fds.size(); ++i) {
+      tcputils::close_socket(worker->fds[i].fd);
+    }
+    for (SocketType socket : worker->new_sockets) {
+      tcputils::close_socket(socket);
+    }
   }
   CloseControlFd();
 }
 
+StoreShard& MasterDaemon::GetShard(const std::string& key) {
+  return _shards[std::hash<std::string>()(key) % _shards.size()];
+}
+
+void MasterDaemon::SetValue(const std::string& key,
+                            std::vector<uint8_t>&& value) {
+  auto& shard = GetShard(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.values[key] = std::move(value);
+  _notify_waiting_sockets(&shard, key);
+}
+
 void MasterDaemon::_do_add(SocketType socket) {
   int64_t new_value{};
   std::string key = tcputils::receive_string(socket);
   new_value = tcputils::receive_value<int64_t>(socket);
-  std::vector<uint8_t> old_value;
-  auto it = _store.find(key);
-  if (it != _store.end()) {
-    old_value = it->second;
-    char* buffer = reinterpret_cast<char*>(it->second.data());
-    size_t len = old_value.size();
-    new_value += std::stoll(std::string(buffer, len));
-  }
-
-  std::string new_value_str = std::to_string(new_value);
-  _store[key] =
-      std::vector<uint8_t>(new_value_str.begin(), new_value_str.end());
+  {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.values.find(key);
+    if (it != shard.values.end()) {
+      char* buffer = reinterpret_cast<char*>(it->second.data());
+      size_t len = it->second.size();
+      new_value += std::stoll(std::string(buffer, len));
+    }
+
+    std::string new_value_str = std::to_string(new_value);
+    shard.values[key] =
+        std::vector<uint8_t>(new_value_str.begin(), new_value_str.end());
+    _notify_waiting_sockets(&shard, key);
+  }
   VLOG(8) << "TCPStore: new value (" << new_value << ") for key (" << key
           << ") " << GetSockName(socket);
   tcputils::send_value<int64_t>(socket, new_value);
-  _notify_waiting_sockets(key);
 }
 
 void MasterDaemon::_do_set(SocketType socket) {
@@ -78,42 +136,117 @@ void MasterDaemon::_do_set(SocketType socket) {
   VLOG(8) << "MasterDaemon::_do_set key(" << key << ") " << GetSockName(socket);
 
   auto value = tcputils::receive_vector<uint8_t>(socket);
-  _store[key] = value;
-  _notify_waiting_sockets(key);
+  SetValue(key, std::move(value));
+}
+
+void MasterDaemon::_do_multi_set(SocketType socket) {
+  auto num = tcputils::receive_value<size_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_multi_set " << num << " keys "
+          << GetSockName(socket);
+  for (size_t i = 0; i < num; ++i) {
+    std::string key = tcputils::receive_string(socket);
+    auto value = tcputils::receive_vector<uint8_t>(socket);
+    SetValue(key, std::move(value));
+  }
 }
 
-void MasterDaemon::_notify_waiting_sockets(const std::string& key) {
-  if (_waiting_sockets.find(key) != _waiting_sockets.end()) {
-    for (auto waiting_socket : _waiting_sockets.at(key)) {
-      auto reply = ReplyType::STOP_WAIT;
-      VLOG(7) << "TCPStore: notify the socket: " << GetSockName(waiting_socket)
-              << " that key: " << key << " is ready.";
-      tcputils::send_value<ReplyType>(waiting_socket, reply);
+void MasterDaemon::_do_compare_set(SocketType socket) {
+  std::string key = tcputils::receive_string(socket);
+  auto expected = tcputils::receive_vector<uint8_t>(socket);
+  auto desired = tcputils::receive_vector<uint8_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_compare_set key(" << key << ") "
+          << GetSockName(socket);
+
+  std::vector<uint8_t> current;
+  {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.values.find(key);
+    if (iter == shard.values.end() ? expected.empty()
+                                   : iter->second == expected) {
+      shard.values[key] = desired;
+      _notify_waiting_sockets(&shard, key);
+      current = std::move(desired);
+    } else if (iter != shard.values.end()) {
+      current = iter->second;
     }
-    _waiting_sockets.erase(key);
   }
+  tcputils::send_vector<uint8_t>(socket, current);
+}
+
+void MasterDaemon::_notify_waiting_sockets(StoreShard* shard,
+                                           const std::string& key) {
+  auto iter = shard->waiters.find(key);
+  if (iter == shard->waiters.end()) {
+    return;
+  }
+  for (auto& waiter : iter->second) {
+    // replied once the last of its keys is set
+    if (waiter->pending.fetch_sub(1) != 1) {
+      continue;
+    }
+    VLOG(7) << "TCPStore: notify the socket: " << GetSockName(waiter->socket)
+            << " that key: " << key << " is ready.";
+    try {
+      tcputils::send_value<ReplyType>(waiter->socket, ReplyType::STOP_WAIT);
+    } catch (const std::exception& ex) {
+      // The worker of the waiting socket closes it.
+      VLOG(5) << "Failed to notify the waiting socket: " << ex.what();
+    }
+  }
+  shard->waiters.erase(iter);
 }
 
 void MasterDaemon::_do_get(SocketType socket) {
   std::string key = tcputils::receive_string(socket);
   VLOG(8) << "MasterDaemon::_do_get key(" << key << ") " << GetSockName(socket);
 
-  auto iter = _store.find(key);
-  PADDLE_ENFORCE_NE(
-      iter,
-      _store.end(),
-      common::errors::InvalidArgument("Key %s not found in TCPStore.", key));
-  std::vector<uint8_t> value = iter->second;
+  std::vector<uint8_t> value;
+  {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.values.find(key);
+    PADDLE_ENFORCE_NE(
+        iter,
+        shard.values.end(),
+        common::errors::InvalidArgument("Key %s not found in TCPStore.", key));
+    value = iter->second;
+  }
   tcputils::send_vector<uint8_t>(socket, value);
 }
 
+void MasterDaemon::_do_multi_get(SocketType socket) {
+  auto num = tcputils::receive_value<size_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_multi_get " << num << " keys "
+          << GetSockName(socket);
+
+  std::vector<uint8_t> buffer;
+  for (size_t i = 0; i < num; ++i) {
+    std::string key = tcputils::receive_string(socket);
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.values.find(key);
+    PADDLE_ENFORCE_NE(
+        iter,
+        shard.values.end(),
+        common::errors::InvalidArgument("Key %s not found in TCPStore.", key));
+    tcputils::append_vector<uint8_t>(&buffer, iter->second);
+  }
+  tcputils::send_bytes<uint8_t>(socket, buffer.data(), buffer.size());
+}
+
 void MasterDaemon::_do_check(SocketType socket) {
   std::string key = tcputils::receive_string(socket);
   VLOG(4) << "MasterDaemon::_do_check key(" << key << ") "
           << GetSockName(socket);
 
-  auto iter = _store.find(key);
-  if (iter != _store.end()) {
+  bool found = false;
+  {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    found = shard.values.find(key) != shard.values.end();
+  }
+  if (found) {
     tcputils::send_value<ReplyType>(socket, ReplyType::READY);
   } else {
     tcputils::send_value<ReplyType>(socket, ReplyType::NOT_READY);
@@ -157,87 +290,140 @@ void MasterDaemon::CloseControlFd() { CloseHandle(ghStopEvent_); }
 void MasterDaemon::StopByControlFd() { SetEvent(ghStopEvent_); }
 #endif
 
-void MasterDaemon::_do_wait(SocketType socket) {
+void MasterDaemon::WaitKeys(SocketType socket,
+                            const std::vector<std::string>& keys,
+                            std::vector<std::string>* waiting_keys) {
+  // The extra pending count is released after all the keys are checked, so
+  // that the reply is sent exactly once, either here or by the command which
+  // sets the last missing key.
+  auto waiter = std::make_shared<StoreWaiter>(socket, 1);
+  for (const auto& key : keys) {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.values.find(key) == shard.values.end()) {
+      // The key can not be found in store currently. Record and notify later.
+      waiter->pending.fetch_add(1);
+      shard.waiters[key].emplace_back(waiter);
+      waiting_keys->push_back(key);
+    }
+  }
+  if (waiter->pending.fetch_sub(1) == 1) {
+    VLOG(7) << "TCPStore: wait reply ("
+            << static_cast<int>(ReplyType::STOP_WAIT) << ") for "
+            << keys.size() << " keys.";
+    tcputils::send_value<ReplyType>(socket, ReplyType::STOP_WAIT);
+  }
+}
+
+void MasterDaemon::RemoveWaitingSocket(
+    SocketType socket, const std::vector<std::string>& waiting_keys) {
+  for (const auto& key : waiting_keys) {
+    auto& shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.waiters.find(key);
+    if (iter == shard.waiters.end()) {
+      continue;
+    }
+    auto& waiters = iter->second;
+    waiters.erase(std::remove_if(waiters.begin(),
+                                 waiters.end(),
+                                 [socket](const auto& waiter) {
+                                   return waiter->socket == socket;
+                                 }),
+                  waiters.end());
+    if (waiters.empty()) {
+      shard.waiters.erase(iter);
+    }
+  }
+}
+
+void MasterDaemon::_do_wait(SocketType socket,
+                            std::vector<std::string>* waiting_keys) {
   std::string key = tcputils::receive_string(socket);
   VLOG(8) << "MasterDaemon::_do_wait key(" << key << ") "
           << GetSockName(socket);
+  WaitKeys(socket, {key}, waiting_keys);
+}
 
-  auto iter = _store.find(key);
-  if (iter == _store.end()) {
-    // The key can not be found in store currently. Record and check later.
-    _waiting_sockets[key].emplace_back(socket);
-  } else {
-    auto reply = ReplyType::STOP_WAIT;
-    VLOG(7) << "TCPStore: wait reply (" << static_cast<int>(reply)
-            << ") for key (" << key << ").";
-    tcputils::send_value<ReplyType>(socket, reply);
+void MasterDaemon::_do_multi_wait(SocketType socket,
+                                  std::vector<std::string>* waiting_keys) {
+  auto num = tcputils::receive_value<size_t>(socket);
+  std::vector<std::string> keys;
+  keys.reserve(num);
+  for (size_t i = 0; i < num; ++i) {
+    keys.emplace_back(tcputils::receive_string(socket));
   }
+  VLOG(8) << "MasterDaemon::_do_multi_wait " << num << " keys "
+          << GetSockName(socket);
+  WaitKeys(socket, keys, waiting_keys);
 }
 
-void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
-  std::vector<struct pollfd>& fds = *p_fds;
-  // FIXME(gongwb): Don't loop all fds of set just the fds who have event.
+void MasterDaemon::ProcessCommand(SocketType socket,
+                                  std::vector<std::string>* waiting_keys) {
+  VLOG(8) << "Plan to receive command from " << GetSockName(socket);
+  Command command = tcputils::receive_value<Command>(socket);
+  VLOG(7) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
+
+  switch (command) {
+    case Command::ADD:
+      _do_add(socket);
+      break;
+    case Command::GET:
+      _do_get(socket);
+      break;
+    case Command::CHECK:
+      _do_check(socket);
+      break;
+    case Command::SET:
+      _do_set(socket);
+      break;
+    case Command::WAIT:
+      _do_wait(socket, waiting_keys);
+      break;
+    case Command::MULTI_GET:
+      _do_multi_get(socket);
+      break;
+    case Command::MULTI_SET:
+      _do_multi_set(socket);
+      break;
+    case Command::MULTI_WAIT:
+      _do_multi_wait(socket, waiting_keys);
+      break;
+    case Command::COMPARE_SET:
+      _do_compare_set(socket);
+      break;
+    default:
+      VLOG(8) << "Unknown command: " << static_cast<int>(command)
+              << " from addr info:" << GetSockName(socket);
+  }
+}
+
+void MasterDaemon::ProcessCommands(Worker* worker) {
+  std::vector<struct pollfd>& fds = worker->fds;
 #ifdef _WIN32
-  // 0: listen socket, so loop from 1.
-  for (size_t i = 1; i < fds.size(); i++) {
+  size_t i = 0;
 #else
-  // 0: listen socket, 1:controller pipe, so loop from 2.
-  for (uint i = 2; i < fds.size(); i++) {
+  // 0: wake pipe, so loop from 1.
+  size_t i = 1;
 #endif
+  while (i < fds.size()) {
+    if (fds[i].revents == 0) {
+      ++i;
+      continue;
+    }
+    SocketType socket = fds[i].fd;
+    auto& waiting_keys = worker->waiting_keys[socket];
     try {
-      if (fds[i].revents == 0) {
-        continue;
-      }
-
-      VLOG(8) << "Plan to receive command from " << GetSockName(fds[i].fd);
-      Command command = tcputils::receive_value<Command>(fds[i].fd);
-      VLOG(7) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
-
-      switch (command) {
-        case Command::ADD:
-          _do_add(fds[i].fd);
-          break;
-        case Command::GET:
-          _do_get(fds[i].fd);
-          break;
-        case Command::CHECK:
-          _do_check(fds[i].fd);
-          break;
-        case Command::SET:
-          _do_set(fds[i].fd);
-          break;
-        case Command::WAIT:
-          _do_wait(fds[i].fd);
-          break;
-        default:
-          VLOG(8) << "Unknown command: " << static_cast<int>(command)
-                  << " from addr info:" << GetSockName(fds[i].fd);
-      }
+      // A client sends its next command only after the reply of its wait, so
+      // none of its keys is waited on anymore.
+      waiting_keys.clear();
+      ProcessCommand(socket, &waiting_keys);
+      ++i;
     } catch (const std::exception& ex) {
-      auto map_iter = _waiting_sockets.begin();
-      while (map_iter != _waiting_sockets.end()) {
-        auto vec_iter = map_iter->second.begin();
-        while (vec_iter != map_iter->second.end()) {
-          if (*vec_iter == fds[i].fd) {
-            vec_iter = map_iter->second.erase(vec_iter);
-          } else {
-            ++vec_iter;
-          }
-        }
-        if (map_iter->second.empty()) {
-          map_iter = _waiting_sockets.erase(map_iter);
-        } else {
-          ++map_iter;
-        }
-      }
-
-      tcputils::close_socket(fds[i].fd);
+      RemoveWaitingSocket(socket, waiting_keys);
+      worker->waiting_keys.erase(socket);
+      tcputils::close_socket(socket);
       fds.erase(fds.begin() + i);
-#ifdef _WIN32
-      _sockets.erase(_sockets.begin() + i - 1);
-#else
-      _sockets.erase(_sockets.begin() + i - 2);
-#endif
       std::string s(ex.what());
       if (s.find("TCP connection reset by peer") != std::string::npos) {
         VLOG(5) << "TCP connection reset by peer";
@@ -248,6 +434,70 @@ void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
   }
 }
 
+void MasterDaemon::AddSocket(Worker* worker, SocketType socket) {
+  {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->new_sockets.emplace_back(socket);
+  }
+#ifndef _WIN32
+  PADDLE_ENFORCE_NE(
+      ::write(worker->wake_fd[1], "\0", 1),
+      -1,
+      common::errors::Fatal("failed to write wake pipe errno:%d", errno));
+#endif
+}
+
+void MasterDaemon::StopWorkers() {
+  _stopped.store(true);
+  for (auto& worker : _workers) {
+#ifndef _WIN32
+    PADDLE_ENFORCE_NE(
+        ::write(worker->wake_fd[1], "\0", 1),
+        -1,
+        common::errors::Fatal("failed to write wake pipe errno:%d", errno));
+#endif
+    worker->thread.join();
+  }
+}
+
+void MasterDaemon::RunWorker(Worker* worker) {
+  std::vector<struct pollfd>& fds = worker->fds;
+  while (!_stopped.load()) {
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      for (SocketType socket : worker->new_sockets) {
+#ifdef _WIN32
+        fds.push_back({socket, POLLIN});
+#else
+        fds.push_back({.fd = socket, .events = POLLIN, .revents = 0});
+#endif
+      }
+      worker->new_sockets.clear();
+    }
+    for (auto& item : fds) {
+      item.revents = 0;
+    }
+
+#ifdef _WIN32
+    if (fds.empty()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(kWorkerPollTime));
+      continue;
+    }
+    ::WSAPoll(fds.data(), fds.size(), kWorkerPollTime);
+#else
+    ::poll(fds.data(), fds.size(), INFTIME);
+    if (fds[0].revents != 0) {
+      char buffer[1024];
+      PADDLE_ENFORCE_NE(
+          ::read(worker->wake_fd[0], buffer, sizeof(buffer)),
+          -1,
+          common::errors::Fatal("failed to read wake pipe errno:%d", errno));
+    }
+#endif
+    ProcessCommands(worker);
+  }
+}
+
 void MasterDaemon::run() {
   std::vector<struct pollfd> fds;
 #ifdef _WIN32
@@ -294,18 +544,12 @@ void MasterDaemon::run() {
     }
 #endif
 
-    // accept connect request.
+    // accept connect request, which is served by one of the workers.
     if (fds[0].revents != 0) {
       auto socket = tcputils::tcp_accept(_listen_socket);
-      _sockets.emplace_back(socket);
-#ifdef _WIN32
-      fds.push_back({socket, POLLIN});
-#else
-      fds.push_back({.fd = socket, .events = POLLIN, .revents = 0});
-#endif
+      AddSocket(_workers[_next_worker].get(), socket);
+      _next_worker = (_next_worker + 1) % _workers.size();
     }
-
-    ProcessCommands(&fds);
   }
 }
 
@@ -333,6 +577,35 @@ void TCPClient::send_command_for_key(Command type, const std::string& key) {
   tcputils::send_string(_socket, key);
 }
 
+void TCPClient::send_command_for_key_values(
+    Command type,
+    const std::string& key,
+    const std::vector<std::vector<uint8_t>>& values) {
+  std::vector<uint8_t> buffer;
+  tcputils::append_value<Command>(&buffer, type);
+  tcputils::append_string(&buffer, key);
+  for (const auto& value : values) {
+    tcputils::append_vector<uint8_t>(&buffer, value);
+  }
+  tcputils::send_bytes<uint8_t>(_socket, buffer.data(), buffer.size());
+}
+
+void TCPClient::send_command_for_keys(
+    Command type,
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>* values) {
+  std::vector<uint8_t> buffer;
+  tcputils::append_value<Command>(&buffer, type);
+  tcputils::append_value<size_t>(&buffer, keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    tcputils::append_string(&buffer, keys[i]);
+    if (values != nullptr) {
+      tcputils::append_vector<uint8_t>(&buffer, (*values)[i]);
+    }
+  }
+  tcputils::send_bytes<uint8_t>(_socket, buffer.data(), buffer.size());
+}
+
 template <typename T>
 void TCPClient::send_value(const T& value) {
   tcputils::send_bytes<T>(_socket, &value, 1);
@@ -462,6 +735,63 @@ void TCPStore::wait(const std::string& key) {
       common::errors::InvalidArgument("Stop_waiting response is expected"));
 }
 
+std::vector<std::string> TCPStore::PrefixKeys(
+    const std::vector<std::string>& keys) const {
+  std::vector<std::string> prefixed_keys;
+  prefixed_keys.reserve(keys.size());
+  for (const auto& key : keys) {
+    prefixed_keys.emplace_back(_key_prefix + key);
+  }
+  return prefixed_keys;
+}
+
+void TCPStore::multi_wait(const std::vector<std::string>& keys) {
+  VLOG(7) << "TCPStore multi_wait.";
+  _client->send_command_for_keys(Command::MULTI_WAIT, PrefixKeys(keys));
+  auto reply = _client->receive_value<ReplyType>();
+  PADDLE_ENFORCE_EQ(
+      reply == ReplyType::STOP_WAIT,
+      true,
+      common::errors::InvalidArgument("Stop_waiting response is expected"));
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multi_get(
+    const std::vector<std::string>& keys) {
+  multi_wait(keys);
+  _client->send_command_for_keys(Command::MULTI_GET, PrefixKeys(keys));
+  VLOG(7) << "TCPStore multi_get.";
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values.emplace_back(_client->receive_vector<uint8_t>());
+  }
+  return values;
+}
+
+void TCPStore::multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values) {
+  VLOG(7) << "TCPStore multi_set.";
+  PADDLE_ENFORCE_EQ(keys.size(),
+                    values.size(),
+                    common::errors::InvalidArgument(
+                        "The number of keys (%d) and values (%d) to set should "
+                        "be equal.",
+                        keys.size(),
+                        values.size()));
+  _client->send_command_for_keys(
+      Command::MULTI_SET, PrefixKeys(keys), &values);
+}
+
+std::vector<uint8_t> TCPStore::compare_set(
+    const std::string& key,
+    const std::vector<uint8_t>& expected,
+    const std::vector<uint8_t>& desired) {
+  VLOG(7) << "TCPStore compare_set.";
+  _client->send_command_for_key_values(
+      Command::COMPARE_SET, _key_prefix + key, {expected, desired});
+  return _client->receive_vector<uint8_t>();
+}
+
 TCPStore::~TCPStore() { VLOG(7) << "TCPStore destructure"; }
 
 }  // namespace phi::distributed
@@ -24,11 +24,14 @@
 #endif
 
 #include <array>
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/phi/core/distributed/store/socket.h"
 #include "paddle/phi/core/distributed/store/store.h"
@@ -38,10 +41,39 @@ namespace phi {
 namespace distributed {
 
 enum class ReplyType { WAITING, STOP_WAIT, READY, NOT_READY };
-enum class Command { ADD, GET, CHECK, SET, WAIT, STOP };
+enum class Command {
+  ADD,
+  GET,
+  CHECK,
+  SET,
+  WAIT,
+  STOP,
+  MULTI_GET,
+  MULTI_SET,
+  MULTI_WAIT,
+  COMPARE_SET
+};
 
 namespace detail {
 
+// A client blocked in a WAIT or MULTI_WAIT command, which is replied by the
+// command setting the last of its keys.
+struct StoreWaiter {
+  StoreWaiter(SocketType socket, int pending)
+      : socket(socket), pending(pending) {}
+  SocketType socket;
+  std::atomic<int> pending;
+};
+
+// The keys of the store are sharded by hash, so that the commands served by
+// different threads only contend on the same shard.
+struct StoreShard {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::vector<uint8_t>> values;
+  std::unordered_map<std::string, std::vector<std::shared_ptr<StoreWaiter>>>
+      waiters;
+};
+
 class MasterDaemon {
  public:
   static std::unique_ptr<MasterDaemon> start(SocketType listen_socket,
@@ -54,22 +86,55 @@ class MasterDaemon {
   ~MasterDaemon();
 
  private:
+  // The connections accepted by the daemon are assigned round robin to the
+  // workers, each of which polls its own connections in a thread.
+  struct Worker {
+    std::thread thread;
+    std::mutex mutex;
+    std::vector<SocketType> new_sockets;
+    std::vector<struct pollfd> fds;
+    // socket -> keys of its pending WAIT or MULTI_WAIT
+    std::unordered_map<SocketType, std::vector<std::string>> waiting_keys;
+#ifndef _WIN32
+    std::array<int, 2> wake_fd{{-1, -1}};
+#endif
+  };
+
   void run();
-  void ProcessCommands(std::vector<struct pollfd>* p_fds);
+  void RunWorker(Worker* worker);
+  void AddSocket(Worker* worker, SocketType socket);
+  void StopWorkers();
+  void ProcessCommands(Worker* worker);
+  void ProcessCommand(SocketType socket, std::vector<std::string>* keys);
   void _do_add(SocketType socket);
-  void _do_wait(SocketType socket);
+  void _do_wait(SocketType socket, std::vector<std::string>* waiting_keys);
   void _do_get(SocketType socket);
   void _do_check(SocketType socket);
   void _do_set(SocketType socket);
-  void _notify_waiting_sockets(const std::string&);
+  void _do_multi_get(SocketType socket);
+  void _do_multi_set(SocketType socket);
+  void _do_multi_wait(SocketType socket,
+                      std::vector<std::string>* waiting_keys);
+  void _do_compare_set(SocketType socket);
+
+  StoreShard& GetShard(const std::string& key);
+  void SetValue(const std::string& key, std::vector<uint8_t>&& value);
+  void WaitKeys(SocketType socket,
+                const std::vector<std::string>& keys,
+                std::vector<std::string>* waiting_keys);
+  // Called with the lock of the shard of key held.
+  void _notify_waiting_sockets(StoreShard* shard, const std::string& key);
+  void RemoveWaitingSocket(SocketType socket,
+                           const std::vector<std::string>& waiting_keys);
+
   SocketType _listen_socket;
-  std::vector<SocketType> _sockets;
-  std::unordered_map<std::string, std::vector<uint8_t>> _store;
+  std::vector<StoreShard> _shards;
+  std::vector<std::unique_ptr<Worker>> _workers;
+  size_t _next_worker = 0;
+  std::atomic<bool> _stopped{false};
   std::thread _background_thread{};
   int _nranks = -1;
   int _timeout = 0;
-  std::unordered_map<std::string, std::vector<SocketType>>
-      _waiting_sockets;  // key -> list of waiting sockets
 
   void InitControlFd();
   void CloseControlFd();
@@ -99,6 +164,16 @@ class TCPClient {
                                             uint16_t port);
   ~TCPClient() { tcputils::close_socket(_socket); }
   void send_command_for_key(Command type, const std::string& key);
+  // Send the command and its arguments in one buffer, either a key with
+  // values, or keys with an optional value for each of them.
+  void send_command_for_key_values(
+      Command type,
+      const std::string& key,
+      const std::vector<std::vector<uint8_t>>& values);
+  void send_command_for_keys(
+      Command type,
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>* values = nullptr);
 
   template <typename T>
   void send_value(const T& value);
@@ -135,8 +210,22 @@ class TCPStore : public Store {
   void wait(const std::string& key) override;
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
 
+  // Each of the multi-key commands takes one round trip to the master for all
+  // the keys, multi_get waits for all of them to be set.
+  std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys) override;
+  void multi_set(const std::vector<std::string>& keys,
+                 const std::vector<std::vector<uint8_t>>& values) override;
+  std::vector<uint8_t> compare_set(
+      const std::string& key,
+      const std::vector<uint8_t>& expected,
+      const std::vector<uint8_t>& desired) override;
+
  private:
   void waitWorkers();
+  void multi_wait(const std::vector<std::string>& keys);
+  std::vector<std::string> PrefixKeys(
+      const std::vector<std::string>& keys) const;
   std::unique_ptr<detail::TCPServer> _server;
   std::unique_ptr<detail::TCPClient> _client;
 
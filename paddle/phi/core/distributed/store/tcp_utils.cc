@@ -101,6 +101,18 @@ SocketType tcp_connect(const std::string host,
                             socket_error().message()));
 
       if (::connect(sockfd, cur->ai_addr, cur->ai_addrlen) == 0) {
+        // The commands are sent in several small writes, which would wait
+        // for the delayed ack of the server with Nagle's algorithm.
+        int value = 1;
+#ifdef _WIN32
+        ::setsockopt(sockfd,
+                     IPPROTO_TCP,
+                     TCP_NODELAY,
+                     reinterpret_cast<const char*>(&value),
+                     sizeof(value));
+#else
+        ::setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+#endif
         retry = false;
         break;
       }
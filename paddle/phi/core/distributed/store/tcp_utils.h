@@ -29,6 +29,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "paddle/phi/core/enforce.h"
@@ -131,6 +132,26 @@ std::vector<T> receive_vector(SocketType socket) {
   return res;
 }
 
+// Appends to buffer the bytes sent by send_value, send_vector and
+// send_string, to send many of them at once.
+template <typename T>
+void append_value(std::vector<uint8_t>* buffer, const T& v) {
+  auto ptr = reinterpret_cast<const uint8_t*>(&v);
+  buffer->insert(buffer->end(), ptr, ptr + sizeof(T));
+}
+
+template <typename T>
+void append_vector(std::vector<uint8_t>* buffer, const std::vector<T>& v) {
+  append_value<size_t>(buffer, v.size());
+  auto ptr = reinterpret_cast<const uint8_t*>(v.data());
+  buffer->insert(buffer->end(), ptr, ptr + v.size() * sizeof(T));
+}
+
+inline void append_string(std::vector<uint8_t>* buffer, const std::string& s) {
+  append_value<std::string::size_type>(buffer, s.size());
+  buffer->insert(buffer->end(), s.begin(), s.end());
+}
+
 template <typename T>
 void send_value(SocketType socket, const T& v) {
   send_bytes<T>(socket, &v, 1);
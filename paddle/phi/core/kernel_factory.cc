@@ -408,6 +408,42 @@ KernelResult KernelFactory::SelectKernelOrThrowError(
   return {kernel_iter->second, false, false};
 }
 
+namespace {
+
+// The flags changing the kernel selected by SelectKernelOrThrowError
+uint32_t KernelSelectionFlags(bool use_strided_kernel) {
+  uint32_t flags = 0;
+  flags |= (FLAGS_use_stride_kernel && use_strided_kernel) ? 1 : 0;
+  flags |= FLAGS_enable_api_kernel_fallback ? 2 : 0;
+#if defined(PADDLE_WITH_XPU_KP)
+  flags |= FLAGS_run_kp_kernel ? 4 : 0;
+#endif
+  return flags;
+}
+
+}  // namespace
+
+KernelResult KernelSelectionCache::SelectKernelOrThrowError(
+    const char* kernel_name,
+    const KernelKey& kernel_key,
+    bool use_strided_kernel) {
+  auto& factory = KernelFactory::Instance();
+  uint64_t generation = factory.Generation();
+  uint32_t flags = KernelSelectionFlags(use_strided_kernel);
+  if (kernel_ == nullptr || generation_ != generation || flags_ != flags ||
+      kernel_key_ != kernel_key) {
+    auto result = factory.SelectKernelOrThrowError(
+        kernel_name, kernel_key, use_strided_kernel);
+    generation_ = generation;
+    flags_ = flags;
+    kernel_key_ = kernel_key;
+    kernel_ = &result.kernel;
+    has_fallback_cpu_ = result.has_fallback_cpu;
+    is_stride_kernel_ = result.is_stride_kernel;
+  }
+  return {*kernel_, has_fallback_cpu_, is_stride_kernel_};
+}
+
 const KernelArgsDef& KernelFactory::GetFirstKernelArgsDef(
     const std::string& kernel_name) const {
   auto iter = kernels_.find(kernel_name);
@@ -591,7 +627,8 @@ std::string KernelSelectionErrorMessage(const std::string& kernel_name,
   std::unordered_set<std::string> dtype_set;
 
   // Record all kernel information of kernel_name
-  for (auto const& iter : KernelFactory::Instance().kernels()[kernel_name]) {
+  for (auto const& iter :
+       KernelFactory::Instance().kernels().at(kernel_name)) {
     KernelKey kernel_key = iter.first;
     if (kernel_key.backend() == target_key.backend()) {
       support_backend = true;
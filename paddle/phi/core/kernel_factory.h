@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <ostream>
 #include <unordered_map>
@@ -317,7 +318,22 @@ class KernelFactory {
  public:
   static KernelFactory& Instance();
 
-  KernelNameMap& kernels() { return kernels_; }
+  const KernelNameMap& kernels() const { return kernels_; }
+
+  // For the registration paths only. The kernels may be changed by the
+  // caller, which invalidates the kernels cached by KernelSelectionCache.
+  // The generation is bumped before the caller changes the kernels, so the
+  // kernels must be registered before any kernel is selected concurrently,
+  // as the kernel maps are not guarded against concurrent changes anyway.
+  KernelNameMap& MutableKernels() {
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    return kernels_;
+  }
+
+  // Changed whenever the kernels may be changed
+  uint64_t Generation() const {
+    return generation_.load(std::memory_order_relaxed);
+  }
 
   bool HasCompatiblePhiKernel(const std::string& op_type) const;
 
@@ -352,11 +368,34 @@ class KernelFactory {
   KernelFactory() = default;
 
   KernelNameMap kernels_;
+  std::atomic<uint64_t> generation_{1};
 
   // Get the low precision kernel list of current module.
   std::map<const std::string, OpCount> low_precision_kernels_;
 };
 
+/**
+ * KernelSelectionCache is the inline cache of a call site selecting kernels,
+ * such as a phi API. It remembers the kernel selected for the last kernel key,
+ * so that the calls with the same kernel key skip looking up the kernel maps
+ * by name. The cache of a call site should be thread local.
+ */
+class KernelSelectionCache {
+ public:
+  KernelResult SelectKernelOrThrowError(const char* kernel_name,
+                                        const KernelKey& kernel_key,
+                                        bool use_strided_kernel = false);
+
+ private:
+  // The generation of KernelFactory and the flags the kernel is selected with
+  uint64_t generation_{0};
+  uint32_t flags_{0};
+  KernelKey kernel_key_;
+  const Kernel* kernel_{nullptr};
+  bool has_fallback_cpu_{false};
+  bool is_stride_kernel_{false};
+};
+
 inline std::ostream& operator<<(std::ostream& os, const KernelKey& kernel_key) {
   os << "(" << kernel_key.backend() << ", " << kernel_key.layout() << ", "
      << kernel_key.dtype() << ")";
@@ -145,7 +145,8 @@ struct KernelRegistrar {
     }
     args_def_fn(kernel_key, &kernel);
     if (reg_type == RegType::INNER) {
-      KernelFactory::Instance().kernels()[kernel_name][kernel_key] = kernel;
+      KernelFactory::Instance().MutableKernels()[kernel_name][kernel_key] =
+          kernel;
     } else {
       CustomKernelMap::Instance().RegisterCustomKernel(
           kernel_name, kernel_key, kernel);
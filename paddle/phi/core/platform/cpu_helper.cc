@@ -14,6 +14,8 @@ limitations under the License. */
 
 #include "paddle/phi/core/platform/cpu_helper.h"
 
+#include "paddle/phi/backends/cpu/cpu_context.h"
+
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 
@@ -29,6 +31,8 @@ limitations under the License. */
 namespace paddle::platform {
 
 void SetNumThreads(int num_threads) {
+  // the intra-op thread pool of the CPU kernels follows the math library
+  phi::SetIntraOpNumThreads(num_threads);
 #ifdef PADDLE_USE_OPENBLAS
 // windows has no support for openblas multi-thread
 // please refer to: https://github.com/PaddlePaddle/Paddle/issues/7234
@@ -14,13 +14,16 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/cross_entropy_kernel.h"
 
+#include <algorithm>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/core/utils/data_type.h"
 #include "paddle/phi/kernels/funcs/axis_utils.h"
 #include "paddle/phi/kernels/funcs/cross_entropy.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
-#include "paddle/phi/kernels/softmax_kernel.h"
+#include "paddle/phi/kernels/funcs/softmax_cpu.h"
 
 namespace phi {
 
@@ -68,6 +71,75 @@ void CrossEntropy(const CPUContext& dev_ctx,
       dev_ctx, &out_2d, &x_2d, &label_2d, soft_label, ignore_index, axis_dim);
 }
 
+// The cross entropy of the softmax of the logits, -log(softmax(x)[label]),
+// equals log_sum_exp - x[label], so the loss is read off the logits and the
+// log(sum(exp(x))) of the softmax rows instead of the log of the softmax.
+template <typename T>
+struct HardLabelCrossEntropyFromLogitsFunctor {
+  HardLabelCrossEntropyFromLogitsFunctor(const T* logits,
+                                         const T* log_sum_exp,
+                                         const DenseTensor* labels,
+                                         int64_t batch_size,
+                                         int axis_dim,
+                                         int64_t num_remain,
+                                         int ignore_index,
+                                         T* loss)
+      : logits_(logits),
+        log_sum_exp_(log_sum_exp),
+        labels_(labels),
+        batch_size_(batch_size),
+        axis_dim_(axis_dim),
+        num_remain_(num_remain),
+        ignore_index_(ignore_index),
+        loss_(loss) {}
+
+  template <typename U>
+  void apply() const {
+    const auto* label_data = labels_->template data<U>();
+    for (int64_t i = 0; i < batch_size_; ++i) {
+      for (int64_t j = 0; j < num_remain_; ++j) {
+        const int64_t idx = i * num_remain_ + j;
+        int lbl = static_cast<int>(label_data[idx]);  // NOLINT
+        if (lbl == ignore_index_) {
+          loss_[idx] = 0;
+          continue;
+        }
+        PADDLE_ENFORCE_GE(lbl,
+                          0,
+                          common::errors::OutOfRange(
+                              "label value should >= 0 when label "
+                              "value(%f) not equal to ignore_index(%f)",
+                              lbl,
+                              ignore_index_));
+        PADDLE_ENFORCE_LT(
+            lbl,
+            axis_dim_,
+            common::errors::OutOfRange(
+                "label value should less than the shape of axis dimension "
+                "when label value(%f) not equal to ignore_index(%f), But "
+                "received label value as %ld and shape of axis dimension "
+                "is %d",
+                lbl,
+                ignore_index_,
+                lbl,
+                axis_dim_));
+        const T x = logits_[(i * axis_dim_ + lbl) * num_remain_ + j];
+        loss_[idx] = phi::funcs::TolerableValue<T>()(log_sum_exp_[idx] - x);
+      }
+    }
+  }
+
+ private:
+  const T* logits_;
+  const T* log_sum_exp_;
+  const DenseTensor* labels_;
+  const int64_t batch_size_;
+  const int axis_dim_;
+  const int64_t num_remain_;
+  const int ignore_index_;
+  T* loss_;
+};
+
 template <typename T, typename Context>
 void CrossEntropyWithSoftmaxKernel(const Context& dev_ctx,
                                    const DenseTensor& logits,
@@ -88,9 +160,76 @@ void CrossEntropyWithSoftmaxKernel(const Context& dev_ctx,
     return;
   }
 
-  phi::SoftmaxKernel<T, Context>(dev_ctx, logits, axis, softmax);
-  CrossEntropy<T>(
-      dev_ctx, *softmax, label, soft_label, ignore_index, axis, loss);
+  const int rank = logits.dims().size();
+  const int axis_v = phi::funcs::CanonicalAxis(axis, rank);
+  T* softmax_data = dev_ctx.template Alloc<T>(softmax);
+  T* loss_data = dev_ctx.template Alloc<T>(loss);
+
+  const int axis_dim = static_cast<int>(logits.dims()[axis_v]);
+  PADDLE_ENFORCE_GT(
+      axis_dim,
+      0,
+      common::errors::InvalidArgument(
+          "The axis dimension should be larger than 0, but received "
+          "axis dimension is %d.",
+          axis_dim));
+  const int64_t n = phi::funcs::SizeToAxis<int64_t>(axis_v, logits.dims());
+  PADDLE_ENFORCE_GT(
+      n,
+      0,
+      common::errors::InvalidArgument(
+          "The size of axis should be larger than 0, but received "
+          "SizeToAxis of softmax is %ld.",
+          n));
+  const int64_t num_remain = phi::funcs::SizeOutAxis(axis_v, logits.dims());
+  if (num_remain == 0) {
+    return;
+  }
+  const T* logits_data = logits.data<T>();
+  DenseTensor log_sum_exp;
+  log_sum_exp.Resize({n, num_remain});
+  T* lse_data = dev_ctx.template Alloc<T>(&log_sum_exp);
+  phi::funcs::SoftmaxForwardCPU<T>(dev_ctx,
+                                   logits_data,
+                                   n,
+                                   axis_dim,
+                                   num_remain,
+                                   /*log=*/false,
+                                   softmax_data,
+                                   lse_data);
+
+  if (soft_label) {
+    const T* label_data = label.data<T>();
+    const int64_t grain = std::max<int64_t>(1, 16384 / (axis_dim * num_remain));
+    dev_ctx.ParallelFor(0, n, grain, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        T* loss_row = loss_data + i * num_remain;
+        const T* lse_row = lse_data + i * num_remain;
+        std::fill(loss_row, loss_row + num_remain, static_cast<T>(0));
+        for (int a = 0; a < axis_dim; ++a) {
+          const int64_t offset = (i * axis_dim + a) * num_remain;
+          for (int64_t j = 0; j < num_remain; ++j) {
+            loss_row[j] += label_data[offset + j] *
+                           phi::funcs::TolerableValue<T>()(
+                               logits_data[offset + j] - lse_row[j]);
+          }
+        }
+        for (int64_t j = 0; j < num_remain; ++j) {
+          loss_row[j] = -loss_row[j];
+        }
+      }
+    });
+  } else {
+    HardLabelCrossEntropyFromLogitsFunctor<T> functor(logits_data,
+                                                      lse_data,
+                                                      &label,
+                                                      n,
+                                                      axis_dim,
+                                                      num_remain,
+                                                      ignore_index,
+                                                      loss_data);
+    phi::VisitDataType(label.dtype(), functor);
+  }
 }
 
 }  // namespace phi
@@ -17,6 +17,7 @@
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/scan_cpu.h"
 
 namespace phi {
 
@@ -36,77 +37,47 @@ bool isnan_(T x) {
 }
 #endif
 
-template <typename T>
-T compute_stride(T axis, phi::DDim dims) {
-  T size = 1;
-  for (T i = axis + 1; i < dims.size(); i++) {
-    size *= dims[i];
-  }
-  return size;
-}
-
+// The scan op of cummax and cummin. The state is the running extremum and
+// its index, a later element takes over when it compares true with
+// BinaryFunction or is NaN, and a NaN is only replaced by a later NaN.
 template <typename T1, typename T2, typename BinaryFunction>
-void ComputeImp(const DenseTensor& x,
-                DenseTensor* out,
-                DenseTensor* indices,
-                int64_t axis) {
-  int ndims = x.dims().size();
-  int finished = 0;
-  std::vector<int64_t> counter(ndims, 0);
-  const T1* x_data = x.data<T1>();
-  T1* values_data = out->data<T1>();
-  T2* indices_data = indices->data<T2>();
-  int64_t x_stride = compute_stride<int64_t>(axis, x.dims());
-  int64_t values_stride = compute_stride<int64_t>(axis, out->dims());
-  int64_t indices_stride = compute_stride<int64_t>(axis, indices->dims());
-  auto x_dim_vec = common::vectorize<int>(x.dims());
-  int x_dim_size = x_dim_vec[axis];
-  BinaryFunction op;
-
-  while (!finished) {
-    T1 max = *reinterpret_cast<const T1*>(x_data);
-    int idx = 0;
-    for (int i = 0; i < x_dim_size; i++) {
-      T1 curr_elem = *reinterpret_cast<const T1*>(&x_data[i * x_stride]);
-      if (isnan_(curr_elem) || (!isnan_(max) && op(curr_elem, max))) {
-        max = curr_elem;
-        idx = i;
-      }
-      values_data[i * values_stride] = max;
-      indices_data[i * indices_stride] = idx;
+struct CumExtremumScanOp {
+  struct State {
+    T1 value;
+    T2 index;
+  };
+
+  CumExtremumScanOp(const T1* x, T1* values, T2* indices)
+      : x_(x), values_(values), indices_(indices) {}
+
+  // An index of -1 marks the state of an empty range.
+  State Identity() const { return {T1(), static_cast<T2>(-1)}; }
+  State Load(int64_t offset, int64_t j) const {
+    return {x_[offset], static_cast<T2>(j)};
+  }
+  State Merge(const State& a, const State& b) const {
+    if (a.index < 0) {
+      return b;
+    }
+    if (b.index < 0) {
+      return a;
     }
-    if (ndims == 1) break;
-    for (int dim_i = 0; dim_i < ndims; dim_i++) {
-      if (dim_i == axis) {
-        if (dim_i == (ndims - 1)) {
-          finished = 1;
-          break;
-        }
-        continue;
-      }
-      int64_t x_stride_ = compute_stride<int64_t>(dim_i, x.dims());
-      int64_t values_stride_ = compute_stride<int64_t>(dim_i, out->dims());
-      int64_t indices_stride_ = compute_stride<int64_t>(dim_i, indices->dims());
-      counter[dim_i]++;
-      x_data += x_stride_;
-      values_data += values_stride_;
-      indices_data += indices_stride_;
-      if (counter[dim_i] == x_dim_vec[dim_i]) {
-        if (dim_i == ndims - 1) {
-          finished = 1;
-          break;
-        } else {
-          x_data -= counter[dim_i] * x_stride_;
-          values_data -= counter[dim_i] * values_stride_;
-          indices_data -= counter[dim_i] * indices_stride_;
-          counter[dim_i] = 0;
-        }
-      } else {
-        break;
-      }
+    if (isnan_(b.value) || (!isnan_(a.value) && op_(b.value, a.value))) {
+      return b;
     }
+    return a;
   }
-}
+  void Store(const State& acc, int64_t offset) const {
+    values_[offset] = acc.value;
+    indices_[offset] = acc.index;
+  }
+
+ private:
+  const T1* x_;
+  T1* values_;
+  T2* indices_;
+  BinaryFunction op_;
+};
 
 template <typename T1, typename T2, typename BinaryFunction, typename Context>
 void ScanWithIndicesKernel(const Context& dev_ctx,
@@ -142,7 +113,22 @@ void ScanWithIndicesKernel(const Context& dev_ctx,
   if (axis < 0) {
     axis = axis + out_dims.size();
   }
-  ComputeImp<T1, T2, BinaryFunction>(x, out, indices, axis);
+  int64_t outer = 1;
+  int64_t inner = 1;
+  for (int i = 0; i < axis; ++i) {
+    outer *= out_dims[i];
+  }
+  for (int i = axis + 1; i < out_dims.size(); ++i) {
+    inner *= out_dims[i];
+  }
+  funcs::ScanCPU(dev_ctx,
+                 CumExtremumScanOp<T1, T2, BinaryFunction>(
+                     x.data<T1>(), out->data<T1>(), indices->data<T2>()),
+                 outer,
+                 out_dims[axis],
+                 inner,
+                 /*exclusive=*/false,
+                 /*reverse=*/false);
 }
 
 template <typename T, typename Context>
@@ -15,12 +15,14 @@
 #include "paddle/phi/kernels/cumprod_kernel.h"
 
 #include <cstdint>
+#include <functional>
 #include <type_traits>
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/complex_functors.h"
 #include "paddle/phi/kernels/funcs/cumprod.h"
+#include "paddle/phi/kernels/funcs/scan_cpu.h"
 
 namespace phi {
 template <typename T, typename Context>
@@ -30,18 +32,9 @@ void CumprodKernel(const Context& dev_ctx,
                    bool exclusive,
                    bool reverse,
                    DenseTensor* out) {
-  const DenseTensor* x = &input;
-  auto* x_data = x->data<T>();
-  auto* out_ptr = dev_ctx.template Alloc<T>(out);
-  DDim shape = x->dims();
-  DenseTensor out_tmp;
-  T* out_data = nullptr;
-  if (x_data == out_ptr) {
-    out_tmp.Resize(shape);
-    out_data = dev_ctx.template Alloc<T>(&out_tmp);
-  } else {
-    out_data = out_ptr;
-  }
+  DDim shape = input.dims();
+  const T* x_data = input.data<T>();
+  auto* out_data = dev_ctx.template Alloc<T>(out);
 
   size_t outer_dim = 1;
   size_t mid_dim = 1;
@@ -51,54 +44,18 @@ void CumprodKernel(const Context& dev_ctx,
     phi::Copy<Context>(dev_ctx, input, dev_ctx.GetPlace(), false, out);
     return;
   }
-  if (reverse == false) {
-    for (size_t i = 0; i < outer_dim; i++) {
-      for (size_t j = 0; j < mid_dim; j++) {
-        for (size_t k = 0; k < inner_dim; k++) {
-          size_t pos = i * mid_dim * inner_dim + j * inner_dim + k;
-          if (j == 0) {
-            if (exclusive) {
-              out_data[pos] = static_cast<T>(1.0);
-            } else {
-              out_data[pos] = x_data[pos];
-            }
-          } else {
-            if (exclusive) {
-              out_data[pos] =
-                  out_data[pos - inner_dim] * x_data[pos - inner_dim];
-            } else {
-              out_data[pos] = out_data[pos - inner_dim] * x_data[pos];
-            }
-          }
-        }
-      }
-    }
-  } else {
-    for (size_t i = 0; i < outer_dim; i++) {
-      for (size_t j = mid_dim; j > 0; j--) {
-        for (size_t k = 0; k < inner_dim; k++) {
-          size_t pos = i * mid_dim * inner_dim + (j - 1) * inner_dim + k;
-          if (j == mid_dim) {
-            if (exclusive) {
-              out_data[pos] = static_cast<T>(1.0);
-            } else {
-              out_data[pos] = x_data[pos];
-            }
-          } else {
-            if (exclusive) {
-              out_data[pos] =
-                  out_data[pos + inner_dim] * x_data[pos + inner_dim];
-            } else {
-              out_data[pos] = out_data[pos + inner_dim] * x_data[pos];
-            }
-          }
-        }
-      }
-    }
-  }
-  if (x_data == out_ptr) {
-    memcpy(out_ptr, out_data, out->numel() * sizeof(T));
-  }
+  // The scan loads every element before storing its result, so it also
+  // runs in place.
+  funcs::ValueScanCPU<T>(dev_ctx,
+                         x_data,
+                         out_data,
+                         outer_dim,
+                         mid_dim,
+                         inner_dim,
+                         exclusive,
+                         reverse,
+                         static_cast<T>(1.0),
+                         std::multiplies<T>());
 }
 
 }  // namespace phi
@@ -15,90 +15,60 @@
 #include "paddle/phi/kernels/gelu_kernel.h"
 
 #include <algorithm>
-#include <cmath>
-
-#include "glog/logging.h"
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
-#include "paddle/phi/kernels/funcs/blas/blas.h"
-#include "paddle/phi/kernels/funcs/blas/blas_impl.h"
-#include "paddle/phi/kernels/funcs/eigen/common.h"
-#include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi {
 
-template <typename T>
-struct GeluFunctor {
-  template <typename Device, typename X, typename Out>
-  void operator()(Device d, X x, Out out, bool approximate) const {
-    if (approximate) {
-      // gelu(x) = 0.5 * x * (1 + tanh(sqrt(2 / \pi) * (x + 0.044715 * x^{3})))
-      if (std::is_same<T, dtype::float16>::value) {
-        VLOG(4) << "cast from float16 to float before computing";
-        auto casted_x = x.template cast<float>();
-        auto temp =
-            (static_cast<float>(M_2_SQRTPI * M_SQRT1_2) *
-             (casted_x + static_cast<float>(GELU_CONSTANT) * casted_x.cube()))
-                .tanh();
-        out.device(d) = (casted_x * static_cast<float>(0.5) *
-                         (static_cast<float>(1) + temp))
-                            .template cast<T>();
-      } else {
-        auto temp = (static_cast<T>(M_2_SQRTPI * M_SQRT1_2) *
-                     (x + static_cast<T>(GELU_CONSTANT) * x.cube()))
-                        .tanh();
-        out.device(d) = x * static_cast<T>(0.5) * (static_cast<T>(1) + temp);
-      }
-    } else {
-#if defined(PADDLE_WITH_MKLML) && !defined(_WIN32) && !defined(__APPLE__) && \
-    !defined(__OSX__) && !defined(PADDLE_WITH_CUDA) &&                       \
-    !defined(PADDLE_WITH_HIP)
-      auto x_data = x.data();
-      auto out_data = out.data();
-      int n = std::min(x.size(), out.size());
+// Number of elements of the chunks the jit kernels run on, and number of
+// elements below which they run on the calling thread.
+constexpr int64_t kGeluChunkSize = 4096;
+constexpr int64_t kGeluGrainSize = 32768;
 
-      std::memset(out_data, 0, n * sizeof(T));
-      phi::funcs::CBlas<T>::AXPY(
-          n, static_cast<T>(M_SQRT1_2), x_data, 1, out_data, 1);
-      phi::funcs::CBlas<T>::VMERF(n, out_data, out_data, VML_LA);
-      for (int i = 0; i < n; i++) {
-        out_data[i] += static_cast<T>(1);
-      }
-      phi::funcs::CBlas<T>::VMUL(n, x_data, out_data, out_data);
-      for (int i = 0; i < n; i++) {
-        out_data[i] *= static_cast<T>(0.5);
-      }
-#else
-      // gelu(x) = 0.5 * x *  (1 + erf(x / sqrt(2)))
-      if (std::is_same<T, dtype::float16>::value) {
-        VLOG(4) << "cast from float16 to float before computing";
-        auto casted_x = x.template cast<float>();
-        auto temp = (casted_x * static_cast<float>(M_SQRT1_2)).erf();
-        out.device(d) = (casted_x * static_cast<float>(0.5) *
-                         (static_cast<float>(1) + temp))
-                            .template cast<T>();
-      } else {
-        auto temp = (x * static_cast<T>(M_SQRT1_2)).erf();
-        out.device(d) = x * static_cast<T>(0.5) * (static_cast<T>(1) + temp);
-      }
-#endif
-    }
+// Runs the jit kVGeluTanh or kVGeluErf kernel of KernelTuple over chunks of
+// x, split over the intra-op threads. The kernels of the full chunk and of
+// the tail are looked up once.
+template <typename KernelTuple, typename T>
+void GeluCPU(const CPUContext& dev_ctx, const T* x, T* out, int64_t numel) {
+  if (numel == 0) {
+    return;
   }
-};
+  auto& cache = jit::KernelFuncs<KernelTuple, CPUPlace>::Cache();
+  const int64_t chunk = std::min(numel, kGeluChunkSize);
+  const int64_t tail = numel % chunk;
+  auto full_func = cache.At(static_cast<int>(chunk));
+  auto tail_func = tail > 0 ? cache.At(static_cast<int>(tail)) : full_func;
+  const int64_t chunks = (numel + chunk - 1) / chunk;
+  dev_ctx.ParallelFor(
+      0,
+      chunks,
+      std::max<int64_t>(1, kGeluGrainSize / chunk),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t c = begin; c < end; ++c) {
+          const int64_t offset = c * chunk;
+          const int64_t len = std::min(chunk, numel - offset);
+          auto func = len == chunk ? full_func : tail_func;
+          func(x + offset, out + offset, static_cast<int>(len));
+        }
+      });
+}
 
 template <typename T, typename Context>
 void GeluKernel(const Context& dev_ctx,
                 const DenseTensor& x,
                 bool approximate,
                 DenseTensor* out) {
-  dev_ctx.template Alloc<T>(out);
-  auto eigen_out = EigenVector<T>::Flatten(*out);
-  auto eigen_x = EigenVector<T>::Flatten(x);
-  auto& dev = *dev_ctx.eigen_device();
-
-  GeluFunctor<T> functor;
-  functor(dev, eigen_x, eigen_out, approximate);
+  const T* x_data = x.data<T>();
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  if (approximate) {
+    // gelu(x) = 0.5 * x * (1 + tanh(sqrt(2 / \pi) * (x + 0.044715 * x^{3})))
+    GeluCPU<jit::VGeluTanhTuple<T>>(dev_ctx, x_data, out_data, x.numel());
+  } else {
+    // gelu(x) = 0.5 * x *  (1 + erf(x / sqrt(2)))
+    GeluCPU<jit::VGeluErfTuple<T>>(dev_ctx, x_data, out_data, x.numel());
+  }
 }
 
 }  // namespace phi
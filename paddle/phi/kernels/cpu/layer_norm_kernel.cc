@@ -14,17 +14,10 @@
 
 #include "paddle/phi/kernels/layer_norm_kernel.h"
 
-#include "paddle/phi/kernels/cpu/elementwise.h"
-#include "paddle/phi/kernels/funcs/layer_norm_util.h"
-#if !defined(PADDLE_WITH_CUDA) && !defined(_WIN32) && !defined(__APPLE__) && \
-    !defined(__OSX__)
-#include "paddle/phi/kernels/funcs/jit/kernels.h"
-#endif
 #include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/core/kernel_registry.h"
-#include "paddle/phi/kernels/funcs/elementwise_base.h"
-#include "paddle/phi/kernels/funcs/elementwise_functor.h"
-#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/layer_norm_cpu.h"
 
 namespace phi {
 
@@ -38,80 +31,30 @@ void LayerNormKernel(const Context& dev_ctx,
                      DenseTensor* y,
                      DenseTensor* mean,
                      DenseTensor* var) {
+  using U = typename phi::dtype::MPTypeTrait<T>::Type;
   const auto x_dims = x.dims();
   auto* scale = scale_opt.get_ptr();
   auto* bias = bias_opt.get_ptr();
 
-  dev_ctx.template Alloc<T>(y);
-  dev_ctx.template Alloc<T>(mean);
-  dev_ctx.template Alloc<T>(var);
+  T* y_data = dev_ctx.template Alloc<T>(y);
+  U* mean_data = dev_ctx.template Alloc<U>(mean);
+  U* var_data = dev_ctx.template Alloc<U>(var);
 
   auto matrix_dim = common::flatten_to_2d(x_dims, begin_norm_axis);
-  int left = static_cast<int>(matrix_dim[0]);
-  int right = static_cast<int>(matrix_dim[1]);
-  DDim matrix_shape({left, right});
-  DDim normalized_shape({left});
+  int64_t left = matrix_dim[0];
+  int64_t right = matrix_dim[1];
 
-  auto x_tmp = x;
-  x_tmp.Resize(matrix_shape);
-  DenseTensor out;
-  out.ShareDataWith(*y);
-  out.Resize(matrix_shape);
-  // resize mean and var to match the shape of resized x_tmp for broadcast
-  DenseTensor mean_tmp;
-  mean_tmp.ShareDataWith(*mean);
-  mean_tmp.Resize(normalized_shape);
-  DenseTensor var_tmp;
-  var_tmp.ShareDataWith(*var);
-  var_tmp.Resize(normalized_shape);
-
-#if defined(PADDLE_WITH_CUDA) || defined(_WIN32) || defined(__APPLE__) || \
-    defined(__OSX__)
-
-  funcs::RowwiseMean2D<phi::CPUContext, T> row_mean(left, right, dev_ctx);
-
-  // get mean
-  row_mean(dev_ctx, x_tmp, &mean_tmp);
-
-  // get variance
-
-  phi::funcs::ElementwiseCompute<funcs::SubAndSquareFunctor<T>, T>(
-      dev_ctx, x_tmp, mean_tmp, funcs::SubAndSquareFunctor<T>(), &out, 0);
-
-  row_mean(dev_ctx, out, &var_tmp);
-
-  // get x_norm
-  phi::funcs::ElementwiseCompute<funcs::SubtractFunctor<T>, T>(
-      dev_ctx, x_tmp, mean_tmp, funcs::SubtractFunctor<T>(), &out, 0);
-
-  phi::funcs::ElementwiseCompute<funcs::DivAndSqrtFunctor<T>, T>(
-      dev_ctx,
-      out,
-      var_tmp,
-      funcs::DivAndSqrtFunctor<T>(static_cast<T>(epsilon)),
-      &out,
-      0);
-
-  if (scale) {
-    phi::funcs::ElementwiseCompute<funcs::MultiplyFunctor<T>, T>(
-        dev_ctx, out, *scale, funcs::MultiplyFunctor<T>(), &out, 1);
-  }
-  if (bias) {
-    phi::funcs::ElementwiseCompute<funcs::AddFunctor<T>, T>(
-        dev_ctx, out, *bias, funcs::AddFunctor<T>(), &out, 1);
-  }
-#else
-  PADDLE_ENFORCE_EQ(mean_tmp.numel(),
+  PADDLE_ENFORCE_EQ(mean->numel(),
                     left,
                     common::errors::InvalidArgument(
                         "mean's length (%d) is not equal with expected (%d).",
-                        mean_tmp.numel(),
+                        mean->numel(),
                         left));
-  PADDLE_ENFORCE_EQ(var_tmp.numel(),
+  PADDLE_ENFORCE_EQ(var->numel(),
                     left,
                     common::errors::InvalidArgument(
                         "var's length (%d) is not equal with expected (%d).",
-                        var_tmp.numel(),
+                        var->numel(),
                         left));
   if (scale) {
     PADDLE_ENFORCE_EQ(
@@ -130,26 +73,55 @@ void LayerNormKernel(const Context& dev_ctx,
                           bias->numel(),
                           right));
   }
+  if (scale && bias) {
+    PADDLE_ENFORCE_EQ(scale->dtype(),
+                      bias->dtype(),
+                      common::errors::InvalidArgument(
+                          "This Scale and Bias of layer_norm op "
+                          "should have the same data type."));
+  }
+  if (left == 0 || right == 0) {
+    return;
+  }
 
-  auto ker =
-      phi::jit::KernelFuncs<phi::jit::LayerNormTuple<T>, phi::CPUPlace>::Cache()
-          .At(right);
-  ker(x_tmp.data<T>(),
-      out.data<T>(),
-      mean_tmp.data<T>(),
-      var_tmp.data<T>(),
-      scale ? scale->data<T>() : nullptr,
-      bias ? bias->data<T>() : nullptr,
-      static_cast<int>(left),
-      static_cast<float>(epsilon),
-      right);
-#endif
+  // scale and bias are either of the data type of x or, for float16 and
+  // bfloat16 inputs, of the float32 type the statistics are kept in.
+  const DenseTensor* param = scale ? scale : bias;
+  if (param == nullptr || param->dtype() == x.dtype()) {
+    funcs::LayerNormForwardCPU<T, T>(dev_ctx,
+                                     x.data<T>(),
+                                     scale ? scale->data<T>() : nullptr,
+                                     bias ? bias->data<T>() : nullptr,
+                                     left,
+                                     right,
+                                     epsilon,
+                                     y_data,
+                                     mean_data,
+                                     var_data);
+  } else {
+    funcs::LayerNormForwardCPU<T, U>(dev_ctx,
+                                     x.data<T>(),
+                                     scale ? scale->data<U>() : nullptr,
+                                     bias ? bias->data<U>() : nullptr,
+                                     left,
+                                     right,
+                                     epsilon,
+                                     y_data,
+                                     mean_data,
+                                     var_data);
+  }
 }
 
 }  // namespace phi
 
-PD_REGISTER_KERNEL(
-    layer_norm, CPU, ALL_LAYOUT, phi::LayerNormKernel, float, double) {
+PD_REGISTER_KERNEL(layer_norm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::LayerNormKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
   kernel->OutputAt(1).SetDataType(phi::DataType::UNDEFINED);
   kernel->OutputAt(2).SetDataType(phi::DataType::UNDEFINED);
 }
@@ -0,0 +1,88 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/rms_norm_kernel.h"
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/layer_norm_cpu.h"
+
+namespace phi {
+
+template <typename T, typename Context>
+void RmsNormKernel(const Context& dev_ctx,
+                   const DenseTensor& x,
+                   const paddle::optional<DenseTensor>& bias,
+                   const paddle::optional<DenseTensor>& residual,
+                   const DenseTensor& norm_weight,
+                   const paddle::optional<DenseTensor>& norm_bias,
+                   const float epsilon,
+                   const int begin_norm_axis,
+                   const float quant_scale,
+                   const int quant_round_type UNUSED,
+                   const float quant_max_bound UNUSED,
+                   const float quant_min_bound UNUSED,
+                   DenseTensor* out,
+                   DenseTensor* residual_out,
+                   DenseTensor* inv_var) {
+  if (quant_scale > 0.0f) {
+    PADDLE_THROW(common::errors::Unimplemented(
+        "Quantized output of rms_norm is not supported on CPU yet."));
+  }
+
+  auto matrix_dim = common::flatten_to_2d(x.dims(), begin_norm_axis);
+  int64_t rows = matrix_dim[0];
+  int64_t cols = matrix_dim[1];
+  PADDLE_ENFORCE_EQ(norm_weight.numel(),
+                    cols,
+                    common::errors::InvalidArgument(
+                        "norm_weight's length (%d) is not equal with "
+                        "expected (%d).",
+                        norm_weight.numel(),
+                        cols));
+
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  T* residual_out_data =
+      residual ? dev_ctx.template Alloc<T>(residual_out) : nullptr;
+  float* inv_var_data =
+      inv_var ? dev_ctx.template Alloc<float>(inv_var) : nullptr;
+  if (rows == 0 || cols == 0) {
+    return;
+  }
+
+  funcs::RmsNormForwardCPU<T>(
+      dev_ctx,
+      x.data<T>(),
+      bias ? bias->data<T>() : nullptr,
+      residual ? residual->data<T>() : nullptr,
+      norm_weight.data<T>(),
+      norm_bias ? norm_bias->data<T>() : nullptr,
+      rows,
+      cols,
+      epsilon,
+      out_data,
+      residual_out_data,
+      inv_var_data);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(rms_norm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::RmsNormKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
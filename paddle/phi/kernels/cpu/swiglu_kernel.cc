@@ -13,16 +13,23 @@
 // limitations under the License.
 
 #include "paddle/phi/kernels/swiglu_kernel.h"
+
+#include <algorithm>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
-#include "paddle/phi/kernels/funcs/activation_functor.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi {
 
+// Number of elements of the chunks the jit kVSwiGLU kernel runs on, and
+// number of elements below which they run on the calling thread.
+constexpr int64_t kSwiGLUChunkSize = 4096;
+constexpr int64_t kSwiGLUGrainSize = 32768;
+
 template <typename T, typename Context>
 void SwiGLUKernelImpl(
     const Context &ctx, const T *x, const T *y, T *z, int64_t m, int64_t n) {
-  funcs::SwiGLUFunctor<T> functor;
   int64_t stride;
   if (y) {
     stride = n;
@@ -30,12 +37,38 @@ void SwiGLUKernelImpl(
     stride = 2 * n;
     y = x + n;
   }
-
-  for (int64_t i = 0; i < m; ++i) {
-    for (int64_t j = 0; j < n; ++j) {
-      z[i * n + j] = functor(x[i * stride + j], y[i * stride + j]);
-    }
+  if (stride == n) {
+    // The rows of x, y and z are contiguous, so they run as a single row.
+    n *= m;
+    m = 1;
+  }
+  if (m == 0 || n == 0) {
+    return;
   }
+
+  // The rows are split into chunks, the kernels of the full chunk and of
+  // the tail of the rows are looked up once.
+  auto &cache = jit::KernelFuncs<jit::VSwiGLUTuple<T>, CPUPlace>::Cache();
+  const int64_t chunk = std::min(n, kSwiGLUChunkSize);
+  const int64_t tail = n % chunk;
+  auto full_func = cache.At(static_cast<int>(chunk));
+  auto tail_func = tail > 0 ? cache.At(static_cast<int>(tail)) : full_func;
+  const int64_t row_chunks = (n + chunk - 1) / chunk;
+  ctx.ParallelFor(0,
+                  m * row_chunks,
+                  std::max<int64_t>(1, kSwiGLUGrainSize / chunk),
+                  [&](int64_t begin, int64_t end) {
+                    for (int64_t t = begin; t < end; ++t) {
+                      const int64_t i = t / row_chunks;
+                      const int64_t j = t % row_chunks * chunk;
+                      const int64_t len = std::min(chunk, n - j);
+                      auto func = len == chunk ? full_func : tail_func;
+                      func(x + i * stride + j,
+                           y + i * stride + j,
+                           z + i * n + j,
+                           static_cast<int>(len));
+                    }
+                  });
 }
 
 }  // namespace phi
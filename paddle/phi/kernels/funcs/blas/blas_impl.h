@@ -24,6 +24,7 @@
 
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/complex.h"
+#include "paddle/phi/kernels/funcs/blas/small_gemm.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 namespace phi {
@@ -1401,6 +1402,21 @@ void Blas<phi::CPUContext>::BatchedGEMM(CBLAS_TRANSPOSE transA,
                        1 /* group_count */,
                        &batchCount);
 #else
+  if (UseSmallBatchedGEMM<T>(M, N, K, batchCount)) {
+    SmallBatchedGEMM<T>(
+        transA != CblasNoTrans,
+        transB != CblasNoTrans,
+        M,
+        N,
+        K,
+        alpha,
+        [&](int k) { return &A[k * strideA]; },
+        [&](int k) { return &B[k * strideB]; },
+        beta,
+        [&](int k) { return &C[static_cast<int64_t>(k) * M * N]; },
+        batchCount);
+    return;
+  }
   for (int k = 0; k < batchCount; ++k) {
     auto *Ak = &A[k * strideA];
     auto *Bk = &B[k * strideB];
@@ -1444,6 +1460,21 @@ void Blas<phi::CPUContext>::BatchedGEMM(CBLAS_TRANSPOSE transA,
                        1 /* group_count */,
                        &batchCount);
 #else
+  if (UseSmallBatchedGEMM<T>(M, N, K, batchCount)) {
+    SmallBatchedGEMM<T>(
+        transA != CblasNoTrans,
+        transB != CblasNoTrans,
+        M,
+        N,
+        K,
+        alpha,
+        [&](int k) { return A[k]; },
+        [&](int k) { return B[k]; },
+        beta,
+        [&](int k) { return C[k]; },
+        batchCount);
+    return;
+  }
   for (int k = 0; k < batchCount; ++k) {
     this->template GEMM<T>(
         transA, transB, M, N, K, alpha, A[k], B[k], beta, C[k]);
@@ -0,0 +1,173 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace phi {
+namespace funcs {
+
+// Batched gemm of small matrices, as in attention with short sequences and
+// bmm. Calling a blas gemm per matrix spends most of the time in the call
+// overhead and in packing, so the matrices are multiplied with register
+// blocked micro kernels instead and the batch is split among threads.
+
+namespace detail {
+
+// Rows and columns of C computed by a micro kernel.
+constexpr int kSmallGemmMr = 4;
+constexpr int kSmallGemmNr = 8;
+// Each of M, N and K must not exceed this to use the small gemm.
+constexpr int kSmallGemmMaxSize = 64;
+
+// Computes the mr x nr tile of C at c from the rows of A at a (element (i, k)
+// at a[i * a_rs + k * a_cs]) and the K x nr row major block of B at b.
+// mr and nr are compile time constants for full tiles so that the
+// accumulators are kept in registers.
+template <typename T, int kMr, int kNr>
+inline void SmallGemmTile(int mr,
+                          int nr,
+                          int K,
+                          T alpha,
+                          const T* a,
+                          int64_t a_rs,
+                          int64_t a_cs,
+                          const T* b,
+                          int ldb,
+                          T beta,
+                          T* c,
+                          int ldc) {
+  const int rows = kMr > 0 ? kMr : mr;
+  const int cols = kNr > 0 ? kNr : nr;
+  T acc[kSmallGemmMr][kSmallGemmNr] = {};
+  for (int k = 0; k < K; ++k) {
+    const T* b_row = b + static_cast<int64_t>(k) * ldb;
+    for (int i = 0; i < rows; ++i) {
+      T a_ik = a[i * a_rs + k * a_cs];
+      for (int j = 0; j < cols; ++j) {
+        acc[i][j] += a_ik * b_row[j];
+      }
+    }
+  }
+  for (int i = 0; i < rows; ++i) {
+    T* c_row = c + static_cast<int64_t>(i) * ldc;
+    if (beta == static_cast<T>(0)) {
+      for (int j = 0; j < cols; ++j) {
+        c_row[j] = alpha * acc[i][j];
+      }
+    } else {
+      for (int j = 0; j < cols; ++j) {
+        c_row[j] = alpha * acc[i][j] + beta * c_row[j];
+      }
+    }
+  }
+}
+
+// C (M x N, row major) = alpha * op(A) * op(B) + beta * C. b_buf holds at
+// least K * N elements and is used to transpose B if needed.
+template <typename T>
+void SmallGemm(bool trans_a,
+               bool trans_b,
+               int M,
+               int N,
+               int K,
+               T alpha,
+               const T* A,
+               const T* B,
+               T beta,
+               T* C,
+               T* b_buf) {
+  const T* b = B;
+  if (trans_b) {
+    for (int k = 0; k < K; ++k) {
+      for (int j = 0; j < N; ++j) {
+        b_buf[k * N + j] = B[j * K + k];
+      }
+    }
+    b = b_buf;
+  }
+  const int64_t a_rs = trans_a ? 1 : K;
+  const int64_t a_cs = trans_a ? M : 1;
+  for (int i = 0; i < M; i += kSmallGemmMr) {
+    const int mr = std::min(kSmallGemmMr, M - i);
+    const T* a = A + i * a_rs;
+    for (int j = 0; j < N; j += kSmallGemmNr) {
+      const int nr = std::min(kSmallGemmNr, N - j);
+      T* c = C + static_cast<int64_t>(i) * N + j;
+      if (mr == kSmallGemmMr && nr == kSmallGemmNr) {
+        SmallGemmTile<T, kSmallGemmMr, kSmallGemmNr>(
+            mr, nr, K, alpha, a, a_rs, a_cs, b + j, N, beta, c, N);
+      } else {
+        SmallGemmTile<T, 0, 0>(
+            mr, nr, K, alpha, a, a_rs, a_cs, b + j, N, beta, c, N);
+      }
+    }
+  }
+}
+
+}  // namespace detail
+
+// Whether SmallBatchedGEMM is expected to beat a blas gemm per matrix.
+template <typename T>
+inline bool UseSmallBatchedGEMM(int M, int N, int K, int batch_count) {
+  return std::is_floating_point<T>::value && batch_count > 1 && M > 0 &&
+         N > 0 && K > 0 && M <= detail::kSmallGemmMaxSize &&
+         N <= detail::kSmallGemmMaxSize && K <= detail::kSmallGemmMaxSize;
+}
+
+// C[i] = alpha * op(A[i]) * op(B[i]) + beta * C[i] for i in [0, batch_count),
+// where get_a(i), get_b(i) and get_c(i) return the pointers to the i-th
+// matrices. All matrices are row major and densely stored.
+template <typename T, typename GetA, typename GetB, typename GetC>
+void SmallBatchedGEMM(bool trans_a,
+                      bool trans_b,
+                      int M,
+                      int N,
+                      int K,
+                      T alpha,
+                      GetA get_a,
+                      GetB get_b,
+                      T beta,
+                      GetC get_c,
+                      int batch_count) {
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#pragma omp parallel
+#endif
+  {
+    std::vector<T> b_buf(trans_b ? static_cast<size_t>(K) * N : 0);
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#pragma omp for
+#endif
+    for (int i = 0; i < batch_count; ++i) {
+      detail::SmallGemm<T>(trans_a,
+                           trans_b,
+                           M,
+                           N,
+                           K,
+                           alpha,
+                           get_a(i),
+                           get_b(i),
+                           beta,
+                           get_c(i),
+                           b_buf.data());
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
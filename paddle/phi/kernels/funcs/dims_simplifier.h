@@ -14,6 +14,10 @@ limitations under the License. */
 
 #pragma once
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 #include "paddle/common/ddim.h"
 #include "paddle/phi/core/dense_tensor.h"
 
@@ -34,20 +38,27 @@ struct BroadcastDimsSimplifier {
 
  public:
   BroadcastDimsSimplifier(const std::vector<const DenseTensor *> &ins,
+                          const phi::DDim &dims,
+                          int axis)
+      : BroadcastDimsSimplifier(GetDims(ins), dims, axis) {}
+
+  // The dims of the inputs are given rather than the inputs, and the
+  // simplified dims are in reverse order, i.e. the innermost dim first.
+  BroadcastDimsSimplifier(const std::vector<phi::DDim> &ins_dims,
                           const phi::DDim &dims,
                           int axis) {
-    N = std::max(static_cast<int>(ins.size()), 2);
+    N = std::max(static_cast<int>(ins_dims.size()), 2);
     in_dims.resize(N);
     rank = dims.size();
     out_dims = common::vectorize<int64_t>(dims);
-    if (ins.size() == 1) {
+    if (ins_dims.size() == 1) {
       // When ins.size() = 1, broadcast input to output.
-      in_dims[0] = common::vectorize<int64_t>(ins[0]->dims());
+      in_dims[0] = common::vectorize<int64_t>(ins_dims[0]);
       // Add out_dims to in_dims to avoid errors in dims merging.
       in_dims[1] = out_dims;
     } else {
       for (int j = 0; j < N; ++j) {
-        in_dims[j] = common::vectorize<int64_t>(ins[j]->dims());
+        in_dims[j] = common::vectorize<int64_t>(ins_dims[j]);
       }
     }
     ExtendInputDimensions(axis);
@@ -102,6 +113,15 @@ struct BroadcastDimsSimplifier {
   }
 
  private:
+  static std::vector<phi::DDim> GetDims(
+      const std::vector<const DenseTensor *> &ins) {
+    std::vector<phi::DDim> dims;
+    for (auto *in : ins) {
+      dims.push_back(in->dims());
+    }
+    return dims;
+  }
+
   // To compensate the lackage of input_tensors' dimension with axis.
   void ExtendInputDimensions(int axis) {
     for (auto &in_dim : in_dims) {
@@ -152,7 +172,7 @@ struct BroadcastDimsSimplifier {
   // Merge sequential dimension to shrink calculation cost for
   // offset computation in CUDA Kernel.
   template <typename MergeFunctor>
-  __inline__ void MergeDimensions(MergeFunctor merge_func, int N) {
+  inline void MergeDimensions(MergeFunctor merge_func, int N) {
     auto VectorReorganise = [](DimVector *vec, int l_idx, int m_idx) {
       (*vec)[m_idx - 1] = std::accumulate(vec->begin() + l_idx,
                                           vec->begin() + m_idx,
@@ -0,0 +1,271 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/direct_conv.h"
+
+#include <algorithm>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+// Number of output channels accumulated together, the packed filter keeps
+// them contiguous.
+constexpr int kOcBlock = 8;
+// Number of output pixels of a row accumulated together.
+constexpr int kOwBlock = 4;
+// Reduction size up to which the direct convolution beats im2col + gemm.
+constexpr int64_t kMaxDirectReduceSize = 32;
+
+struct Conv2DShape {
+  // Channels of a single group.
+  int in_c;
+  int in_h;
+  int in_w;
+  int out_c;
+  int out_h;
+  int out_w;
+  int k_h;
+  int k_w;
+  int stride_h;
+  int stride_w;
+  int pad_t;
+  int pad_l;
+  int dilation_h;
+  int dilation_w;
+};
+
+// Packs the filter [out_c, k] of a group into [out_c / kOcBlock, k, kOcBlock],
+// the tail block is padded with zeros.
+template <typename T>
+void PackFilter(const T* filter, int out_c, int64_t k, T* packed) {
+  int oc_blocks = (out_c + kOcBlock - 1) / kOcBlock;
+  for (int ob = 0; ob < oc_blocks; ++ob) {
+    for (int64_t j = 0; j < k; ++j) {
+      for (int c = 0; c < kOcBlock; ++c) {
+        int oc = ob * kOcBlock + c;
+        packed[(ob * k + j) * kOcBlock + c] =
+            oc < out_c ? filter[oc * k + j] : static_cast<T>(0);
+      }
+    }
+  }
+}
+
+// Computes the row oh of oc_num (<= kOcBlock) output channels of a group.
+template <typename T>
+void ConvRowBlocked(const T* input,
+                    const T* packed_filter,
+                    const Conv2DShape& s,
+                    int oh,
+                    int oc_num,
+                    T* output) {
+  const int64_t out_plane = static_cast<int64_t>(s.out_h) * s.out_w;
+  for (int ow = 0; ow < s.out_w; ow += kOwBlock) {
+    int ow_num = std::min(kOwBlock, s.out_w - ow);
+    T acc[kOwBlock][kOcBlock] = {};
+    for (int ic = 0; ic < s.in_c; ++ic) {
+      for (int kh = 0; kh < s.k_h; ++kh) {
+        int ih = oh * s.stride_h - s.pad_t + kh * s.dilation_h;
+        if (ih < 0 || ih >= s.in_h) continue;
+        const T* in_row =
+            input + (static_cast<int64_t>(ic) * s.in_h + ih) * s.in_w;
+        const T* w =
+            packed_filter + (static_cast<int64_t>(ic) * s.k_h + kh) * s.k_w *
+                                kOcBlock;
+        for (int kw = 0; kw < s.k_w; ++kw, w += kOcBlock) {
+          int iw = ow * s.stride_w - s.pad_l + kw * s.dilation_w;
+          for (int t = 0; t < kOwBlock; ++t, iw += s.stride_w) {
+            T x = (t < ow_num && iw >= 0 && iw < s.in_w) ? in_row[iw]
+                                                         : static_cast<T>(0);
+            for (int c = 0; c < kOcBlock; ++c) {
+              acc[t][c] += x * w[c];
+            }
+          }
+        }
+      }
+    }
+    for (int c = 0; c < oc_num; ++c) {
+      T* out_row = output + c * out_plane + static_cast<int64_t>(oh) * s.out_w;
+      for (int t = 0; t < ow_num; ++t) {
+        out_row[ow + t] = acc[t][c];
+      }
+    }
+  }
+}
+
+// Computes a single channel of a depthwise convolution, every filter tap is
+// accumulated into a whole output row which stays in cache.
+template <typename T>
+void DepthwiseConvPlane(const T* input,
+                        const T* filter,
+                        const Conv2DShape& s,
+                        T* output) {
+  for (int oh = 0; oh < s.out_h; ++oh) {
+    T* out_row = output + static_cast<int64_t>(oh) * s.out_w;
+    std::fill(out_row, out_row + s.out_w, static_cast<T>(0));
+    for (int kh = 0; kh < s.k_h; ++kh) {
+      int ih = oh * s.stride_h - s.pad_t + kh * s.dilation_h;
+      if (ih < 0 || ih >= s.in_h) continue;
+      const T* in_row = input + static_cast<int64_t>(ih) * s.in_w;
+      for (int kw = 0; kw < s.k_w; ++kw) {
+        // Range of ow whose input column iw = ow * stride_w + offset is valid.
+        int offset = kw * s.dilation_w - s.pad_l;
+        int ow_begin =
+            offset >= 0 ? 0 : (-offset + s.stride_w - 1) / s.stride_w;
+        int last = s.in_w - 1 - offset;
+        int ow_end = last < 0 ? 0 : std::min(s.out_w, last / s.stride_w + 1);
+        T w = filter[kh * s.k_w + kw];
+        const T* in_ptr = in_row + ow_begin * s.stride_w + offset;
+        if (s.stride_w == 1) {
+          for (int ow = ow_begin; ow < ow_end; ++ow) {
+            out_row[ow] += w * in_ptr[ow - ow_begin];
+          }
+        } else {
+          for (int ow = ow_begin; ow < ow_end; ++ow) {
+            out_row[ow] += w * in_ptr[(ow - ow_begin) * s.stride_w];
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+bool UseDirectConv2D(const std::vector<int64_t>& filter_shape,
+                     int groups,
+                     bool is_expand) {
+  if (!is_expand || filter_shape.size() != 4U) {
+    return false;
+  }
+  int64_t out_c = filter_shape[0] / groups;
+  int64_t reduce_size = filter_shape[1] * filter_shape[2] * filter_shape[3];
+  bool is_depthwise = filter_shape[1] == 1 && out_c == 1;
+  return is_depthwise || reduce_size <= kMaxDirectReduceSize;
+}
+
+template <typename T>
+void DirectConv2D(const CPUContext& dev_ctx,
+                  const DenseTensor& input,
+                  const DenseTensor& filter,
+                  const std::vector<int>& strides,
+                  const std::vector<int>& paddings,
+                  const std::vector<int>& dilations,
+                  int groups,
+                  DenseTensor* output) {
+  const auto& in_dims = input.dims();
+  const auto& filter_dims = filter.dims();
+  const auto& out_dims = output->dims();
+  PADDLE_ENFORCE_EQ(
+      in_dims.size() == 4 && filter_dims.size() == 4 && out_dims.size() == 4,
+      true,
+      common::errors::InvalidArgument(
+          "DirectConv2D expects 4-D input, filter and output, but received "
+          "input dims %s, filter dims %s and output dims %s.",
+          in_dims,
+          filter_dims,
+          out_dims));
+
+  Conv2DShape s;
+  s.in_c = static_cast<int>(in_dims[1]) / groups;
+  s.in_h = static_cast<int>(in_dims[2]);
+  s.in_w = static_cast<int>(in_dims[3]);
+  s.out_c = static_cast<int>(out_dims[1]) / groups;
+  s.out_h = static_cast<int>(out_dims[2]);
+  s.out_w = static_cast<int>(out_dims[3]);
+  s.k_h = static_cast<int>(filter_dims[2]);
+  s.k_w = static_cast<int>(filter_dims[3]);
+  s.stride_h = strides[0];
+  s.stride_w = strides[1];
+  s.pad_t = paddings[0];
+  s.pad_l = paddings[2];
+  s.dilation_h = dilations[0];
+  s.dilation_w = dilations[1];
+
+  const T* in_data = input.data<T>();
+  const T* filter_data = filter.data<T>();
+  T* out_data = dev_ctx.template Alloc<T>(output);
+
+  const int64_t num_planes = in_dims[0] * groups;
+  const int64_t in_plane = static_cast<int64_t>(s.in_c) * s.in_h * s.in_w;
+  const int64_t out_plane = static_cast<int64_t>(s.out_c) * s.out_h * s.out_w;
+  const int64_t k = static_cast<int64_t>(s.in_c) * s.k_h * s.k_w;
+
+  if (s.in_c == 1 && s.out_c == 1) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int64_t i = 0; i < num_planes; ++i) {
+      DepthwiseConvPlane(in_data + i * in_plane,
+                         filter_data + (i % groups) * k,
+                         s,
+                         out_data + i * out_plane);
+    }
+    return;
+  }
+
+  const int oc_blocks = (s.out_c + kOcBlock - 1) / kOcBlock;
+  const int64_t packed_group_size = oc_blocks * k * kOcBlock;
+  DenseTensor packed_filter;
+  packed_filter.Resize({groups * packed_group_size});
+  T* packed_data = dev_ctx.template Alloc<T>(&packed_filter);
+  for (int g = 0; g < groups; ++g) {
+    PackFilter(filter_data + g * s.out_c * k,
+               s.out_c,
+               k,
+               packed_data + g * packed_group_size);
+  }
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num_planes * oc_blocks; ++i) {
+    int64_t plane = i / oc_blocks;
+    int ob = static_cast<int>(i % oc_blocks);
+    int64_t g = plane % groups;
+    int oc_num = std::min(kOcBlock, s.out_c - ob * kOcBlock);
+    const T* packed_block =
+        packed_data + g * packed_group_size + ob * k * kOcBlock;
+    T* out_block = out_data + plane * out_plane +
+                   static_cast<int64_t>(ob) * kOcBlock * s.out_h * s.out_w;
+    for (int oh = 0; oh < s.out_h; ++oh) {
+      ConvRowBlocked(
+          in_data + plane * in_plane, packed_block, s, oh, oc_num, out_block);
+    }
+  }
+}
+
+template void DirectConv2D<float>(const CPUContext& dev_ctx,
+                                  const DenseTensor& input,
+                                  const DenseTensor& filter,
+                                  const std::vector<int>& strides,
+                                  const std::vector<int>& paddings,
+                                  const std::vector<int>& dilations,
+                                  int groups,
+                                  DenseTensor* output);
+template void DirectConv2D<double>(const CPUContext& dev_ctx,
+                                   const DenseTensor& input,
+                                   const DenseTensor& filter,
+                                   const std::vector<int>& strides,
+                                   const std::vector<int>& paddings,
+                                   const std::vector<int>& dilations,
+                                   int groups,
+                                   DenseTensor* output);
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,71 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+class CPUContext;
+
+namespace funcs {
+
+/*
+ * \brief Whether DirectConv2D is expected to be faster than im2col + gemm.
+ *
+ * \param filter_shape  [output_channels, input_channels / groups,
+ *                       filter_height, filter_width].
+ * \param is_expand     Whether im2col would have to materialize the column
+ *                      buffer, 1x1 convolutions with stride 1 and no padding
+ *                      are a plain gemm and are left to it.
+ *
+ * The direct convolution is used for depthwise convolutions and convolutions
+ * whose reduction size (input_channels / groups * filter_height *
+ * filter_width) is too small for the gemm to amortize the column buffer, which
+ * is filter_height * filter_width times larger than the input.
+ */
+bool UseDirectConv2D(const std::vector<int64_t>& filter_shape,
+                     int groups,
+                     bool is_expand);
+
+/*
+ * \brief Computes a 2-D convolution of a NCHW input without the column buffer
+ *        of Im2ColFunctor.
+ *
+ * The filter of every group is packed into the blocked layout
+ * [output_channels / 8, input_channels / groups, filter_height, filter_width,
+ * 8], so that 8 output channels and 4 output pixels of a row are accumulated
+ * in registers while the input is read once per filter tap. Depthwise
+ * convolutions accumulate every filter tap into a whole output row instead.
+ *
+ * \param input     [batch, input_channels, input_height, input_width].
+ * \param filter    [output_channels, input_channels / groups,
+ *                   filter_height, filter_width].
+ * \param paddings  [up_pad, down_pad, left_pad, right_pad].
+ * \param output    [batch, output_channels, output_height, output_width].
+ */
+template <typename T>
+void DirectConv2D(const CPUContext& dev_ctx,
+                  const DenseTensor& input,
+                  const DenseTensor& filter,
+                  const std::vector<int>& strides,
+                  const std::vector<int>& paddings,
+                  const std::vector<int>& dilations,
+                  int groups,
+                  DenseTensor* output);
+
+}  // namespace funcs
+}  // namespace phi
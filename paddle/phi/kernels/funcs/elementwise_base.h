@@ -14,11 +14,14 @@ limitations under the License. */
 
 #pragma once
 
+#include <array>
+
 #include "paddle/phi/backends/all_context.h"
 #include "paddle/phi/common/transform.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/empty_kernel.h"
 #include "paddle/phi/kernels/funcs/common_shape.h"
+#include "paddle/phi/kernels/funcs/dims_simplifier.h"
 #include "paddle/phi/kernels/funcs/elementwise_utils.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
@@ -270,6 +273,88 @@ class TransformFunctor {
   bool is_xsize_larger_;
 };
 
+// elements of a range of the intra-op thread pool for the CPU broadcast
+constexpr int64_t kBroadcastGrainSize = 32768;
+
+// Broadcasts a and b to the output and computes out = func(a, b). The dims
+// are coalesced and in reverse order, i.e. dims[0] is the innermost dim,
+// and an input dim is either 1 or the output dim. The innermost dim runs as
+// a plain loop which the compiler vectorizes, with each input either
+// contiguous or a scalar along it: a row broadcast such as a bias add has
+// both contiguous, a column broadcast has one of them scalar. The output is
+// split into ranges for the intra-op thread pool, each range computes its
+// start index once and then carries it from dim to dim.
+template <typename Functor, typename T, typename OutType>
+void BroadcastForwardCPU(const CPUContext &ctx,
+                         const T *a_data,
+                         const std::vector<int64_t> &a_dims,
+                         const T *b_data,
+                         const std::vector<int64_t> &b_dims,
+                         const std::vector<int64_t> &out_dims,
+                         OutType *out_data,
+                         Functor func) {
+  const int rank = static_cast<int>(out_dims.size());
+  if (rank == 0) {
+    *out_data = func(*a_data, *b_data);
+    return;
+  }
+  std::array<int64_t, phi::DDim::kMaxRank> dims, a_strides, b_strides;
+  int64_t a_stride = 1, b_stride = 1, numel = 1;
+  for (int i = 0; i < rank; ++i) {
+    dims[i] = out_dims[i];
+    a_strides[i] = (a_dims[i] == 1 && dims[i] != 1) ? 0 : a_stride;
+    b_strides[i] = (b_dims[i] == 1 && dims[i] != 1) ? 0 : b_stride;
+    a_stride *= a_dims[i];
+    b_stride *= b_dims[i];
+    numel *= dims[i];
+  }
+
+  ctx.ParallelFor(
+      0, numel, kBroadcastGrainSize, [&](int64_t begin, int64_t end) {
+        std::array<int64_t, phi::DDim::kMaxRank> index;
+        int64_t a_offset = 0, b_offset = 0, rest = begin;
+        for (int i = 0; i < rank; ++i) {
+          index[i] = rest % dims[i];
+          rest /= dims[i];
+          a_offset += index[i] * a_strides[i];
+          b_offset += index[i] * b_strides[i];
+        }
+        for (int64_t pos = begin; pos < end;) {
+          int64_t len = std::min(dims[0] - index[0], end - pos);
+          const T *a = a_data + a_offset;
+          const T *b = b_data + b_offset;
+          OutType *out = out_data + pos;
+          if (a_strides[0] != 0 && b_strides[0] != 0) {
+            for (int64_t i = 0; i < len; ++i) {
+              out[i] = func(a[i], b[i]);
+            }
+          } else if (a_strides[0] != 0) {
+            const T b_value = *b;
+            for (int64_t i = 0; i < len; ++i) {
+              out[i] = func(a[i], b_value);
+            }
+          } else if (b_strides[0] != 0) {
+            const T a_value = *a;
+            for (int64_t i = 0; i < len; ++i) {
+              out[i] = func(a_value, b[i]);
+            }
+          } else {
+            std::fill(out, out + len, static_cast<OutType>(func(*a, *b)));
+          }
+          pos += len;
+          index[0] += len;
+          a_offset += len * a_strides[0];
+          b_offset += len * b_strides[0];
+          for (int i = 0; i + 1 < rank && index[i] == dims[i]; ++i) {
+            index[i] = 0;
+            a_offset += a_strides[i + 1] - dims[i] * a_strides[i];
+            b_offset += b_strides[i + 1] - dims[i] * b_strides[i];
+            ++index[i + 1];
+          }
+        }
+      });
+}
+
 template <typename Functor, typename T, typename OutType = T>
 void CommonForwardBroadcastCPU(const DenseTensor &x,
                                const DenseTensor &y,
@@ -281,7 +366,6 @@ void CommonForwardBroadcastCPU(const DenseTensor &x,
                                const CPUContext &ctx,
                                Functor func,
                                const bool is_xsize_larger = true) {
-  std::vector<int> index_array(max_dim, 0);
   const T *x_data = x.data<T>();
   const T *y_data = y.data<T>();
   PADDLE_ENFORCE_NOT_NULL(
@@ -290,19 +374,18 @@ void CommonForwardBroadcastCPU(const DenseTensor &x,
       y_data, errors::InvalidArgument("The input Y should not be empty."));
   OutType *out_data = ctx.Alloc<OutType>(z);
 
-  const int out_size = std::accumulate(
-      out_dims_array, out_dims_array + max_dim, 1, std::multiplies<int>());
-  int x_index, y_index;
-  for (int out_index = 0; out_index < out_size; ++out_index) {
-    x_index = GetElementwiseIndex(x_dims_array, max_dim, index_array.data());
-    y_index = GetElementwiseIndex(y_dims_array, max_dim, index_array.data());
-    if (is_xsize_larger) {
-      out_data[out_index] = func(x_data[x_index], y_data[y_index]);
-    } else {
-      out_data[out_index] = func(y_data[y_index], x_data[x_index]);
-    }
-
-    UpdateElementwiseIndexArray(out_dims_array, max_dim, index_array.data());
+  std::vector<int64_t> x_dims(x_dims_array, x_dims_array + max_dim);
+  std::vector<int64_t> y_dims(y_dims_array, y_dims_array + max_dim);
+  std::vector<int64_t> out_dims(out_dims_array, out_dims_array + max_dim);
+  std::reverse(x_dims.begin(), x_dims.end());
+  std::reverse(y_dims.begin(), y_dims.end());
+  std::reverse(out_dims.begin(), out_dims.end());
+  if (is_xsize_larger) {
+    BroadcastForwardCPU<Functor, T, OutType>(
+        ctx, x_data, x_dims, y_data, y_dims, out_dims, out_data, func);
+  } else {
+    BroadcastForwardCPU<Functor, T, OutType>(
+        ctx, y_data, y_dims, x_data, x_dims, out_dims, out_data, func);
   }
 }
 
@@ -342,16 +425,42 @@ void CommonElementwiseBroadcastForward(const CPUContext &dev_ctx,
                          max_dim,
                          axis);
 
-  CommonForwardBroadcastCPU<Functor, T, OutType>(x,
-                                                 y,
-                                                 z,
-                                                 x_dims_array.data(),
-                                                 y_dims_array.data(),
-                                                 out_dims_array.data(),
-                                                 max_dim,
-                                                 dev_ctx,
-                                                 func,
-                                                 is_xsize_larger);
+  OutType *out_data = dev_ctx.Alloc<OutType>(z);
+  if (z->numel() == 0) {
+    return;
+  }
+  const T *x_data = x.data<T>();
+  const T *y_data = y.data<T>();
+  PADDLE_ENFORCE_NOT_NULL(
+      x_data, errors::InvalidArgument("The input X should not be empty."));
+  PADDLE_ENFORCE_NOT_NULL(
+      y_data, errors::InvalidArgument("The input Y should not be empty."));
+
+  // coalesces the dims of the same broadcast pattern, e.g. x = [2, 3, 4, 5]
+  // and y = [1, 3, 4, 1] run as x = [2, 12, 5] and y = [1, 12, 1]
+  BroadcastDimsSimplifier simplifier(
+      {x_dims, y_dims}, common::make_ddim(out_dims_array), axis);
+  const auto &simple_x_dims = simplifier.in_dims[0];
+  const auto &simple_y_dims = simplifier.in_dims[1];
+  if (is_xsize_larger) {
+    BroadcastForwardCPU<Functor, T, OutType>(dev_ctx,
+                                             x_data,
+                                             simple_x_dims,
+                                             y_data,
+                                             simple_y_dims,
+                                             simplifier.out_dims,
+                                             out_data,
+                                             func);
+  } else {
+    BroadcastForwardCPU<Functor, T, OutType>(dev_ctx,
+                                             y_data,
+                                             simple_y_dims,
+                                             x_data,
+                                             simple_x_dims,
+                                             simplifier.out_dims,
+                                             out_data,
+                                             func);
+  }
 }
 
 // It is a common CPU implementation to compute binary calculation with the
@@ -374,10 +483,8 @@ void ElementwiseCompute(const CPUContext &dev_ctx,
   auto x_dims = x.dims();
   auto y_dims = y.dims();
   bool is_xsize_larger = true;
-  int max_dim = x_dims.size();
   if (x_dims.size() < y_dims.size()) {
     is_xsize_larger = false;
-    max_dim = y_dims.size();
   }
   TransformFunctor<Functor, T, CPUContext, OutType> functor(
       x, y, z, dev_ctx, func, is_xsize_larger);
@@ -386,59 +493,12 @@ void ElementwiseCompute(const CPUContext &dev_ctx,
     return;
   }
 
-  axis = (axis == -1 ? std::abs(x_dims.size() - y_dims.size()) : axis);
-  PADDLE_ENFORCE_GE(
-      axis,
-      0,
-      errors::InvalidArgument(
-          "Axis should be great than or equal to 0, but received axis is %d.",
-          axis));
-  PADDLE_ENFORCE_LE(
-      axis,
-      max_dim,
-      errors::InvalidArgument(
-          "Axis should be less than or equal to %d, but received axis is %d.",
-          max_dim,
-          axis));
-
-  int pre, n, post, is_run_common_broadcast, axis_trim = 0;
-  if (is_xsize_larger) {
-    auto y_dims_trimed = TrimTrailingSingularDims(y_dims);
-    axis_trim = (y_dims_trimed.size() == 0) ? x_dims.size() : axis;
-    GetMidDims(x_dims,
-               y_dims_trimed,
-               axis_trim,
-               &pre,
-               &n,
-               &post,
-               &is_run_common_broadcast);
-  } else {
-    auto x_dims_trimed = TrimTrailingSingularDims(x_dims);
-    axis_trim = (x_dims_trimed.size() == 0) ? y_dims.size() : axis;
-    GetMidDims(y_dims,
-               x_dims_trimed,
-               axis_trim,
-               &pre,
-               &n,
-               &post,
-               &is_run_common_broadcast);
-  }
-  // special case for common implementation.
-  // case 1: x=[2,3,1,5], y=[2,1,4,1]
-  // case 2: x=[2,3,4], y=[1,1,4]
-  if (is_run_common_broadcast == 1) {
-    CommonElementwiseBroadcastForward<Functor, T, OutType>(
-        dev_ctx, x, y, z, x_dims, y_dims, func, axis, is_xsize_larger);
-    return;
-  }
-
-  if (post == 1) {
-    functor.RunRowWise(n);
-    return;
-  } else {
-    functor.RunMidWise(n, post);
-    return;
-  }
+  // All the broadcast cases, e.g. the row wise x=[2,3,4], y=[4], the mid
+  // wise x=[2,3,4], y=[3] with axis 1, and the general x=[2,3,1,5],
+  // y=[2,1,4,1], run on the broadcast engine, which coalesces them into
+  // contiguous inner loops on the intra-op thread pool.
+  CommonElementwiseBroadcastForward<Functor, T, OutType>(
+      dev_ctx, x, y, z, x_dims, y_dims, func, axis, is_xsize_larger);
 }
 
 // for broadcast backwards
@@ -14,6 +14,9 @@ limitations under the License. */
 
 #pragma once
 
+#include <array>
+#include <vector>
+
 #include "glog/logging.h"
 
 #include "paddle/phi/backends/context_pool.h"
@@ -22,6 +25,7 @@ limitations under the License. */
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/funcs/common_shape.h"
+#include "paddle/phi/kernels/funcs/dims_simplifier.h"
 #include "paddle/phi/kernels/funcs/elementwise_utils.h"
 #include "paddle/phi/kernels/funcs/for_range.h"
 
@@ -49,6 +53,73 @@ namespace phi {
 namespace funcs {
 using DDim = phi::DDim;
 
+// elements of a range of the intra-op thread pool for the CPU broadcast
+// gradients
+constexpr int64_t kGradBroadcastGrainSize = 32768;
+
+// The gradients of a general broadcast, with the dims coalesced and in
+// reverse order as in BroadcastForwardCPU. The gradient of a broadcast input
+// sums over the output, so the output is walked in order on one thread,
+// carrying its index from dim to dim rather than recomputing the index of
+// the inputs for each element.
+template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
+void BroadcastGradCPU(const T *x_data,
+                      const std::vector<int64_t> &x_dims,
+                      const T *y_data,
+                      const std::vector<int64_t> &y_dims,
+                      const Tout *out_data,
+                      const Tout *dout_data,
+                      const std::vector<int64_t> &out_dims,
+                      DX_OP dx_op,
+                      DY_OP dy_op,
+                      T *dx_data,
+                      T *dy_data) {
+  const int rank = std::max(static_cast<int>(out_dims.size()), 1);
+  std::array<int64_t, phi::DDim::kMaxRank> dims, x_strides, y_strides, index;
+  int64_t x_stride = 1, y_stride = 1, numel = 1;
+  for (int i = 0; i < rank; ++i) {
+    dims[i] = out_dims.empty() ? 1 : out_dims[i];
+    int64_t x_dim = x_dims.empty() ? 1 : x_dims[i];
+    int64_t y_dim = y_dims.empty() ? 1 : y_dims[i];
+    x_strides[i] = (x_dim == 1 && dims[i] != 1) ? 0 : x_stride;
+    y_strides[i] = (y_dim == 1 && dims[i] != 1) ? 0 : y_stride;
+    x_stride *= x_dim;
+    y_stride *= y_dim;
+    numel *= dims[i];
+    index[i] = 0;
+  }
+
+  int64_t x_offset = 0, y_offset = 0;
+  for (int64_t pos = 0; pos < numel; pos += dims[0]) {
+    for (int64_t i = 0; i < dims[0]; ++i) {
+      int64_t x_index = x_offset + i * x_strides[0];
+      int64_t y_index = y_offset + i * y_strides[0];
+      if (dx_data != nullptr) {
+        dx_data[x_index] += dx_op(x_data[x_index],
+                                  y_data[y_index],
+                                  out_data[pos + i],
+                                  dout_data[pos + i]);
+      }
+      if (dy_data != nullptr) {
+        dy_data[y_index] += dy_op(x_data[x_index],
+                                  y_data[y_index],
+                                  out_data[pos + i],
+                                  dout_data[pos + i]);
+      }
+    }
+    for (int i = 1; i < rank; ++i) {
+      x_offset += x_strides[i];
+      y_offset += y_strides[i];
+      if (++index[i] < dims[i]) {
+        break;
+      }
+      index[i] = 0;
+      x_offset -= dims[i] * x_strides[i];
+      y_offset -= dims[i] * y_strides[i];
+    }
+  }
+}
+
 template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
 void CommonGradBroadcastCPU(const DenseTensor &x,
                             const DenseTensor &y,
@@ -63,11 +134,6 @@ void CommonGradBroadcastCPU(const DenseTensor &x,
                             const CPUContext &ctx,
                             DX_OP dx_op,
                             DY_OP dy_op) {
-  std::vector<int> index_array(max_dim, 0);
-  const T *x_data = x.data<T>();
-  const T *y_data = y.data<T>();
-  const Tout *out_data = out.data<Tout>();
-  const Tout *dout_data = dout.data<Tout>();
   T *dx_data = dx == nullptr ? nullptr : ctx.Alloc<T>(dx);
   T *dy_data = dy == nullptr ? nullptr : ctx.Alloc<T>(dy);
   if (dx_data != nullptr) {
@@ -76,31 +142,35 @@ void CommonGradBroadcastCPU(const DenseTensor &x,
   if (dy_data != nullptr) {
     memset(dy_data, 0, dy->numel() * sizeof(T));
   }
-  const int out_size = std::accumulate(
-      out_dims_array, out_dims_array + max_dim, 1, std::multiplies<int>());
-  int x_index, y_index;
-  for (int out_index = 0; out_index < out_size; ++out_index) {
-    x_index = GetElementwiseIndex(x_dims_array, max_dim, index_array.data());
-    y_index = GetElementwiseIndex(y_dims_array, max_dim, index_array.data());
-    if (dx_data != nullptr) {
-      dx_data[x_index] += dx_op(x_data[x_index],
-                                y_data[y_index],
-                                out_data[out_index],
-                                dout_data[out_index]);
-    }
-    if (dy_data != nullptr) {
-      dy_data[y_index] += dy_op(x_data[x_index],
-                                y_data[y_index],
-                                out_data[out_index],
-                                dout_data[out_index]);
-    }
 
-    UpdateElementwiseIndexArray(out_dims_array, max_dim, index_array.data());
-  }
+  // coalesces the dims of the same broadcast pattern
+  std::vector<DDim> ins_dims = {
+      common::make_ddim(std::vector<int>(x_dims_array, x_dims_array + max_dim)),
+      common::make_ddim(
+          std::vector<int>(y_dims_array, y_dims_array + max_dim))};
+  auto out_dims = common::make_ddim(
+      std::vector<int>(out_dims_array, out_dims_array + max_dim));
+  BroadcastDimsSimplifier simplifier(ins_dims, out_dims, 0);
+  BroadcastGradCPU<T, DX_OP, DY_OP, Tout>(x.data<T>(),
+                                          simplifier.in_dims[0],
+                                          y.data<T>(),
+                                          simplifier.in_dims[1],
+                                          out.data<Tout>(),
+                                          dout.data<Tout>(),
+                                          simplifier.out_dims,
+                                          dx_op,
+                                          dy_op,
+                                          dx_data,
+                                          dy_data);
 }
 
+// The gradients of x = [h, w] and y = [w] if is_xsize_larger, else of
+// x = [w] and y = [h, w]. The columns are split among the intra-op thread
+// pool, and each range walks the rows in order, so that the sums of the
+// smaller input are accumulated in the same order as on one thread.
 template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
-static void ElemwiseGradBroadcast1CPU(const T *x,
+static void ElemwiseGradBroadcast1CPU(const CPUContext &ctx,
+                                      const T *x,
                                       const T *y,
                                       const Tout *out,
                                       const Tout *dout,
@@ -113,47 +183,47 @@ static void ElemwiseGradBroadcast1CPU(const T *x,
                                       T *dy) {
   using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
 
-  if (is_xsize_larger) {
-    for (int j = 0; j < w; ++j) {
-      MPType sum_y = static_cast<MPType>(0);
-      for (int i = 0; i < h; ++i) {
-        int x_offset = i * w + j;
-        if (dx != nullptr) {
-          dx[x_offset] =
-              dx_op(x[x_offset], y[j], out[x_offset], dout[x_offset]);
-        }
-        if (dy != nullptr) {
-          sum_y += static_cast<MPType>(
-              dy_op(x[x_offset], y[j], out[x_offset], dout[x_offset]));
+  int64_t grain_size =
+      std::max<int64_t>(kGradBroadcastGrainSize / std::max(h, 1), 1);
+  ctx.ParallelFor(0, w, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<MPType> sum(end - begin, static_cast<MPType>(0));
+    for (int64_t i = 0; i < h; ++i) {
+      for (int64_t j = begin; j < end; ++j) {
+        int64_t offset = i * w + j;
+        if (is_xsize_larger) {
+          if (dx != nullptr) {
+            dx[offset] = dx_op(x[offset], y[j], out[offset], dout[offset]);
+          }
+          if (dy != nullptr) {
+            sum[j - begin] += static_cast<MPType>(
+                dy_op(x[offset], y[j], out[offset], dout[offset]));
+          }
+        } else {
+          if (dy != nullptr) {
+            dy[offset] = dy_op(x[j], y[offset], out[offset], dout[offset]);
+          }
+          if (dx != nullptr) {
+            sum[j - begin] += static_cast<MPType>(
+                dx_op(x[j], y[offset], out[offset], dout[offset]));
+          }
         }
       }
-      if (dy != nullptr) {
-        dy[j] = static_cast<T>(sum_y);
-      }
     }
-  } else {
-    for (int j = 0; j < w; ++j) {
-      MPType sum_x = static_cast<MPType>(0);
-      for (int i = 0; i < h; ++i) {
-        int y_offset = i * w + j;
-        if (dy != nullptr) {
-          dy[y_offset] =
-              dy_op(x[j], y[y_offset], out[y_offset], dout[y_offset]);
-        }
-        if (dx != nullptr) {
-          sum_x += static_cast<MPType>(
-              dx_op(x[j], y[y_offset], out[y_offset], dout[y_offset]));
-        }
-      }
-      if (dx != nullptr) {
-        dx[j] = static_cast<T>(sum_x);
+    T *reduced = is_xsize_larger ? dy : dx;
+    if (reduced != nullptr) {
+      for (int64_t j = begin; j < end; ++j) {
+        reduced[j] = static_cast<T>(sum[j - begin]);
       }
     }
-  }
+  });
 }
 
+// The gradients of x = [pre, n, post] and y = [n] if is_xsize_larger, else
+// of x = [n] and y = [pre, n, post], split by n as in
+// ElemwiseGradBroadcast1CPU.
 template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
-static void ElemwiseGradBroadcast2CPU(const T *x,
+static void ElemwiseGradBroadcast2CPU(const CPUContext &ctx,
+                                      const T *x,
                                       const T *y,
                                       const Tout *out,
                                       const Tout *dout,
@@ -167,47 +237,40 @@ static void ElemwiseGradBroadcast2CPU(const T *x,
                                       T *dy) {
   using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
 
-  if (is_xsize_larger) {
-    for (int j = 0; j < n; ++j) {
-      MPType sum_y = static_cast<MPType>(0);
-      for (int i = 0; i < pre; ++i) {
-        for (int k = 0; k < post; ++k) {
-          int x_offset = i * n * post + j * post + k;
-          if (dx != nullptr) {
-            dx[x_offset] =
-                dx_op(x[x_offset], y[j], out[x_offset], dout[x_offset]);
-          }
-          if (dy != nullptr) {
-            sum_y += static_cast<MPType>(
-                dy_op(x[x_offset], y[j], out[x_offset], dout[x_offset]));
+  int64_t grain_size = std::max<int64_t>(
+      kGradBroadcastGrainSize / std::max<int64_t>(int64_t{pre} * post, 1), 1);
+  ctx.ParallelFor(0, n, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<MPType> sum(end - begin, static_cast<MPType>(0));
+    for (int64_t i = 0; i < pre; ++i) {
+      for (int64_t j = begin; j < end; ++j) {
+        MPType &sum_j = sum[j - begin];
+        int64_t offset = (i * n + j) * post;
+        for (int64_t k = offset; k < offset + post; ++k) {
+          if (is_xsize_larger) {
+            if (dx != nullptr) {
+              dx[k] = dx_op(x[k], y[j], out[k], dout[k]);
+            }
+            if (dy != nullptr) {
+              sum_j += static_cast<MPType>(dy_op(x[k], y[j], out[k], dout[k]));
+            }
+          } else {
+            if (dy != nullptr) {
+              dy[k] = dy_op(x[j], y[k], out[k], dout[k]);
+            }
+            if (dx != nullptr) {
+              sum_j += static_cast<MPType>(dx_op(x[j], y[k], out[k], dout[k]));
+            }
           }
         }
       }
-      if (dy != nullptr) {
-        dy[j] = static_cast<T>(sum_y);
-      }
     }
-  } else {
-    for (int j = 0; j < n; ++j) {
-      MPType sum_x = static_cast<MPType>(0);
-      for (int i = 0; i < pre; ++i) {
-        for (int k = 0; k < post; ++k) {
-          int y_offset = i * n * post + j * post + k;
-          if (dy != nullptr) {
-            dy[y_offset] =
-                dy_op(x[j], y[y_offset], out[y_offset], dout[y_offset]);
-          }
-          if (dx != nullptr) {
-            sum_x += static_cast<MPType>(
-                dx_op(x[j], y[y_offset], out[y_offset], dout[y_offset]));
-          }
-        }
-      }
-      if (dx != nullptr) {
-        dx[j] = static_cast<T>(sum_x);
+    T *reduced = is_xsize_larger ? dy : dx;
+    if (reduced != nullptr) {
+      for (int64_t j = begin; j < end; ++j) {
+        reduced[j] = static_cast<T>(sum[j - begin]);
       }
     }
-  }
+  });
 }
 
 template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
@@ -327,7 +390,8 @@ void ElemwiseGradComputeWithBroadcast(const CPUContext &ctx,
     return;
   }
   if (post == 1) {
-    ElemwiseGradBroadcast1CPU(x.data<T>(),
+    ElemwiseGradBroadcast1CPU(ctx,
+                              x.data<T>(),
                               y.data<T>(),
                               out.data<Tout>(),
                               dout.data<Tout>(),
@@ -339,7 +403,8 @@ void ElemwiseGradComputeWithBroadcast(const CPUContext &ctx,
                               dx == nullptr ? nullptr : ctx.Alloc<T>(dx),
                               dy == nullptr ? nullptr : ctx.Alloc<T>(dy));
   } else {
-    ElemwiseGradBroadcast2CPU(x.data<T>(),
+    ElemwiseGradBroadcast2CPU(ctx,
+                              x.data<T>(),
                               y.data<T>(),
                               out.data<Tout>(),
                               dout.data<Tout>(),
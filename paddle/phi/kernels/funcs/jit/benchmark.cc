@@ -426,6 +426,63 @@ void BenchKernelLayerNorm() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelRMSNorm() {
+  using T = typename KernelTuple::data_type;
+  const float epsilon = 9.99999975e-06;
+  for (int left : {1, 9, 50}) {
+    for (int right : TestSizes()) {
+      int sz = left * right;
+      phi::DenseTensor x, scale, bias, out;
+      x.Resize({left, right});
+      out.Resize({left, right});
+      scale.Resize({right});
+      bias.Resize({right});
+
+      RandomVec<T>(sz, x.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      RandomVec<T>(right, scale.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      RandomVec<T>(right, bias.mutable_data<T>(PlaceType()), -2.f, 2.f);
+
+      const T* x_data = x.data<T>();
+      const T* scale_data = scale.data<T>();
+      const T* bias_data = bias.data<T>();
+      T* out_data = out.mutable_data<T>(PlaceType());
+
+      BenchAllImpls<KernelTuple, PlaceType>(right,
+                                            x_data,
+                                            out_data,
+                                            scale_data,
+                                            bias_data,
+                                            left,
+                                            epsilon,
+                                            right);
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelBiasAct() {
+  using T = typename KernelTuple::data_type;
+  for (auto act : {jit::kVRelu, jit::kVGeluErf, jit::kVGeluTanh, jit::kVSilu}) {
+    for (int h : {1, 16}) {
+      for (int w : TestSizes()) {
+        const jit::bias_act_attr_t attr(w, act);
+        phi::DenseTensor x, bias, y;
+        x.Resize({h, w});
+        bias.Resize({w});
+        y.Resize({h, w});
+        RandomVec<T>(h * w, x.mutable_data<T>(PlaceType()));
+        RandomVec<T>(w, bias.mutable_data<T>(PlaceType()));
+        const T* x_data = x.data<T>();
+        const T* bias_data = bias.data<T>();
+        T* y_data = y.mutable_data<T>(PlaceType());
+        BenchAllImpls<KernelTuple, PlaceType>(
+            attr, x_data, bias_data, y_data, h, &attr);
+      }
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelCRFDecoding() {
   using T = typename KernelTuple::data_type;
@@ -476,6 +533,7 @@ void BenchKernelVBroadcast() {
 #define BenchKernelVAdd BenchKernelXYZN
 #define BenchKernelVAddRelu BenchKernelXYZN
 #define BenchKernelVSub BenchKernelXYZN
+#define BenchKernelVSwiGLU BenchKernelXYZN
 
 #define BenchKernelVScal BenchKernelAXYN
 #define BenchKernelVAddBias BenchKernelAXYN
@@ -487,6 +545,9 @@ void BenchKernelVBroadcast() {
 #define BenchKernelVSigmoid BenchKernelXYN
 #define BenchKernelVTanh BenchKernelXYN
 #define BenchKernelVCopy BenchKernelXYN
+#define BenchKernelVGeluErf BenchKernelXYN
+#define BenchKernelVGeluTanh BenchKernelXYN
+#define BenchKernelVSilu BenchKernelXYN
 
 #define BenchKernelLSTMCtHt BenchKernelLSTM
 #define BenchKernelLSTMC1H1 BenchKernelLSTM
@@ -507,6 +568,7 @@ BENCH_FP32_CPU(VMul);
 BENCH_FP32_CPU(VAdd);
 BENCH_FP32_CPU(VAddRelu);
 BENCH_FP32_CPU(VSub);
+BENCH_FP32_CPU(VSwiGLU);
 
 // axyn
 BENCH_FP32_CPU(VScal);
@@ -520,6 +582,9 @@ BENCH_FP32_CPU(VExp);
 BENCH_FP32_CPU(VSigmoid);
 BENCH_FP32_CPU(VTanh);
 BENCH_FP32_CPU(VCopy);
+BENCH_FP32_CPU(VGeluErf);
+BENCH_FP32_CPU(VGeluTanh);
+BENCH_FP32_CPU(VSilu);
 
 // LSTM
 BENCH_FP32_CPU(LSTMCtHt);
@@ -531,6 +596,8 @@ BENCH_FP32_CPU(GRUHtPart1);
 BENCH_FP32_CPU(GRUHtPart2);
 
 BENCH_FP32_CPU(LayerNorm);
+BENCH_FP32_CPU(RMSNorm);
+BENCH_FP32_CPU(BiasAct);
 BENCH_FP32_CPU(CRFDecoding);
 
 BENCH_FP32_CPU(SeqPool);
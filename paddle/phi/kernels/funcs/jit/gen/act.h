@@ -26,7 +26,6 @@ namespace gen {
 
 extern const float exp_float_consts[];
 extern const int exp_int_0x7f[];
-extern int g_tmp_mem[];
 
 #define EXP_HIG 88.3762626647949f
 #define EXP_LOW -88.3762626647949f
@@ -150,23 +149,24 @@ class VActFunc : public JitCode {
     } else if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
       xmm_t xtmp1 = xmm_t(ymm_int.getIdx());
       xmm_t xtmp2 = xmm_t(jmm_tmp.getIdx());
-      reg64_t reg_ptr_tmp = reg_ptr_global;
-      mov(reg_ptr_tmp, reinterpret_cast<size_t>(g_tmp_mem));
-      vmovdqa(ptr[reg_ptr_tmp], ymm_int);
-      vmovdqa(ptr[reg_ptr_tmp + YMM_FLOAT_BLOCK * sizeof(float)], jmm_tmp);
+      // The halves are split through the stack, which is private to the
+      // calling thread, so the stack slots need not be aligned.
+      sub(rsp, 2 * YMM_FLOAT_BLOCK * sizeof(float));
+      vmovdqu(ptr[rsp], ymm_int);
+      vmovdqu(ptr[rsp + YMM_FLOAT_BLOCK * sizeof(float)], jmm_tmp);
       vpaddd(xtmp1, xtmp1, xtmp2);
       vpslld(xtmp1, xtmp1, 23);
-      vmovdqa(ptr[reg_ptr_tmp], xtmp1);
+      vmovdqu(ptr[rsp], xtmp1);
       // next 128bits
-      vmovdqa(xtmp1, ptr[reg_ptr_tmp + XMM_FLOAT_BLOCK * sizeof(float)]);
-      vmovdqa(xtmp2,
-              ptr[reg_ptr_tmp +
-                  (YMM_FLOAT_BLOCK + XMM_FLOAT_BLOCK) * sizeof(float)]);
+      vmovdqu(xtmp1, ptr[rsp + XMM_FLOAT_BLOCK * sizeof(float)]);
+      vmovdqu(xtmp2,
+              ptr[rsp + (YMM_FLOAT_BLOCK + XMM_FLOAT_BLOCK) * sizeof(float)]);
       vpaddd(xtmp1, xtmp1, xtmp2);
       vpslld(xtmp1, xtmp1, 23);
-      vmovdqa(ptr[reg_ptr_tmp + XMM_FLOAT_BLOCK * sizeof(float)], xtmp1);
+      vmovdqu(ptr[rsp + XMM_FLOAT_BLOCK * sizeof(float)], xtmp1);
       // load out
-      vmovdqa(ymm_int, ptr[reg_ptr_tmp]);
+      vmovdqu(ymm_int, ptr[rsp]);
+      add(rsp, 2 * YMM_FLOAT_BLOCK * sizeof(float));
     }
     vmulps(dst, dst, ymm_int);
     pop(reg_ptr_global);
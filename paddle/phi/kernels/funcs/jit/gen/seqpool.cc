@@ -28,17 +28,19 @@ void SeqPoolJitCode::genCode() {
   int rest_num_regs = num_block % max_num_regs;
   mov(reg32_int_h, dword[param_attr]);
   if (type_ == SeqPoolType::kAvg || type_ == SeqPoolType::kSqrt) {
+    // The scale of the pool is kept on the stack rather than in the code
+    // object, so that the code can run on several threads at once.
+    sub(rsp, XMM_FLOAT_BLOCK * sizeof(float));
     mov(reg_tmp, reinterpret_cast<size_t>(exp_float_consts));
     vmovups(xmm_t(1), ptr[reg_tmp + OFFSET_EXP_ONE]);
-    mov(reg_tmp, reinterpret_cast<size_t>(fp_h_));
     fild(dword[param_attr]);
-    fstp(dword[reg_tmp]);
-    vmovss(xmm_t(0), ptr[reg_tmp]);
+    fstp(dword[rsp]);
+    vmovss(xmm_t(0), ptr[rsp]);
     if (type_ == SeqPoolType::kSqrt) {
       vsqrtps(xmm_t(0), xmm_t(0));
     }
     vdivps(xmm_t(1), xmm_t(1), xmm_t(0));
-    vmovss(ptr[reg_tmp], xmm_t(1));
+    vmovss(ptr[rsp], xmm_t(1));
   }
   const int group_len = max_num_regs * block * sizeof(float);
   for (int g = 0; g < num_groups; ++g) {
@@ -51,6 +53,9 @@ void SeqPoolJitCode::genCode() {
   const int rest = w_ % block;
   pool_height_of_rest_width(
       rest, static_cast<int>((w_ - rest) * sizeof(float)), max_num_regs);
+  if (type_ == SeqPoolType::kAvg || type_ == SeqPoolType::kSqrt) {
+    add(rsp, XMM_FLOAT_BLOCK * sizeof(float));
+  }
   ret();
 }
 
@@ -35,7 +35,6 @@ class SeqPoolJitCode : public JitCode {
       PADDLE_THROW(common::errors::Unimplemented(
           "Only supports sum, average and sqrt pool type."));
     }
-    fp_h_[0] = 1.f;
     this->genCode();
   }
 
@@ -84,8 +83,7 @@ class SeqPoolJitCode : public JitCode {
     L(l_h_done);
     // save right now
     if (type_ == SeqPoolType::kAvg || type_ == SeqPoolType::kSqrt) {
-      mov(reg_tmp, reinterpret_cast<size_t>(fp_h_));
-      vbroadcastss(JMM(max_num_regs), ptr[reg_tmp]);
+      vbroadcastss(JMM(max_num_regs), ptr[rsp]);
     }
     offset = w_offset;
     for (int i = 0; i < max_num_regs; ++i) {
@@ -146,8 +144,7 @@ class SeqPoolJitCode : public JitCode {
     L(l_h_done);
     // save right now
     if (type_ == SeqPoolType::kAvg || type_ == SeqPoolType::kSqrt) {
-      mov(reg_tmp, reinterpret_cast<size_t>(fp_h_));
-      vbroadcastss(xmm_t(max_num_regs), ptr[reg_tmp]);
+      vbroadcastss(xmm_t(max_num_regs), ptr[rsp]);
       for (int i = 0; i < rest_used_num_regs; ++i) {
         vmulps(xmm_t(i), xmm_t(i), xmm_t(max_num_regs));
       }
@@ -203,7 +200,6 @@ class SeqPoolJitCode : public JitCode {
   }
 
  private:
-  float ALIGN32_BEG fp_h_[1] ALIGN32_END;
   int w_;
   SeqPoolType type_;
   reg64_t param_src{abi_param1};
@@ -15,16 +15,129 @@
 #include "paddle/phi/kernels/funcs/jit/helper.h"
 
 #include <numeric>
+#include <set>
+#include <sstream>
+#include <unordered_map>
 
+#include "glog/logging.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi::jit {
 
 std::map<size_t, std::shared_ptr<void>>& GetFuncCacheMap() {
-  static thread_local std::map<size_t, std::shared_ptr<void>> g_func_cache_map;
+  static std::map<size_t, std::shared_ptr<void>> g_func_cache_map;
   return g_func_cache_map;
 }
 
+std::mutex& GetFuncCacheMutex() {
+  static std::mutex g_func_cache_mutex;
+  return g_func_cache_mutex;
+}
+
+// The kernel types whose attribute is an integer, which WarmupKernels
+// accepts.
+static const KernelType kIntAttrKernelTypes[] = {kVMul,
+                                                 kVAdd,
+                                                 kVAddRelu,
+                                                 kVSub,
+                                                 kVScal,
+                                                 kVAddBias,
+                                                 kVRelu,
+                                                 kVIdentity,
+                                                 kVSquare,
+                                                 kVExp,
+                                                 kVSigmoid,
+                                                 kVTanh,
+                                                 kVGeluErf,
+                                                 kVGeluTanh,
+                                                 kVSilu,
+                                                 kVSwiGLU,
+                                                 kVCopy,
+                                                 kVBroadcast,
+                                                 kLayerNorm,
+                                                 kRMSNorm,
+                                                 kCRFDecoding};
+
+static std::mutex g_kernel_attrs_mutex;
+static std::set<std::pair<KernelType, int64_t>> g_kernel_attrs;
+
+void RecordKernelAttr(KernelType kt, int64_t attr) {
+  std::lock_guard<std::mutex> guard(g_kernel_attrs_mutex);
+  g_kernel_attrs.emplace(kt, attr);
+}
+
+void WarmupKernels(
+    const std::vector<std::pair<KernelType, int64_t>>& kernels) {
+  for (const auto& kernel : kernels) {
+    const int64_t attr = kernel.second;
+    switch (kernel.first) {
+#define WARMUP_CASE(type, attr_type)                                  \
+  case k##type:                                                       \
+    KernelFuncs<type##Tuple<float>, phi::CPUPlace>::Cache().At(       \
+        static_cast<attr_type>(attr));                                \
+    break
+      WARMUP_CASE(VMul, int);
+      WARMUP_CASE(VAdd, int);
+      WARMUP_CASE(VAddRelu, int);
+      WARMUP_CASE(VSub, int);
+      WARMUP_CASE(VScal, int);
+      WARMUP_CASE(VAddBias, int);
+      WARMUP_CASE(VRelu, int);
+      WARMUP_CASE(VIdentity, int);
+      WARMUP_CASE(VSquare, int);
+      WARMUP_CASE(VExp, int);
+      WARMUP_CASE(VSigmoid, int);
+      WARMUP_CASE(VTanh, int);
+      WARMUP_CASE(VGeluErf, int);
+      WARMUP_CASE(VGeluTanh, int);
+      WARMUP_CASE(VSilu, int);
+      WARMUP_CASE(VSwiGLU, int);
+      WARMUP_CASE(VCopy, int);
+      WARMUP_CASE(VBroadcast, int64_t);
+      WARMUP_CASE(LayerNorm, int);
+      WARMUP_CASE(RMSNorm, int);
+      WARMUP_CASE(CRFDecoding, int);
+#undef WARMUP_CASE
+      default:
+        PADDLE_THROW(common::errors::Unimplemented(
+            "The attribute of JIT kernel %s is not an integer, warm it up "
+            "with WarmupKernelFuncs.",
+            to_string(kernel.first)));
+    }
+  }
+}
+
+std::string SerializeKernelWarmupList() {
+  std::ostringstream os;
+  std::lock_guard<std::mutex> guard(g_kernel_attrs_mutex);
+  for (const auto& kernel : g_kernel_attrs) {
+    os << to_string(kernel.first) << " " << kernel.second << "\n";
+  }
+  return os.str();
+}
+
+void LoadKernelWarmupList(const std::string& warmup_list) {
+  std::unordered_map<std::string, KernelType> types;
+  for (KernelType kt : kIntAttrKernelTypes) {
+    types.emplace(to_string(kt), kt);
+  }
+  std::vector<std::pair<KernelType, int64_t>> kernels;
+  std::istringstream is(warmup_list);
+  std::string name;
+  int64_t attr = 0;
+  while (is >> name >> attr) {
+    auto iter = types.find(name);
+    if (iter == types.end()) {
+      VLOG(3) << "Skip the warmup of unknown JIT kernel " << name;
+      continue;
+    }
+    kernels.emplace_back(iter->second, attr);
+  }
+  VLOG(3) << "Warm up " << kernels.size() << " JIT kernels";
+  WarmupKernels(kernels);
+}
+
 #define ONE_CASE(key) \
   case key:           \
     return #key
@@ -46,6 +159,10 @@ const char* to_string(KernelType kt) {
     ONE_CASE(kVSquare);
     ONE_CASE(kVSigmoid);
     ONE_CASE(kVTanh);
+    ONE_CASE(kVGeluErf);
+    ONE_CASE(kVGeluTanh);
+    ONE_CASE(kVSilu);
+    ONE_CASE(kVSwiGLU);
     ONE_CASE(kLSTMCtHt);
     ONE_CASE(kLSTMC1H1);
     ONE_CASE(kGRUH1);
@@ -53,6 +170,8 @@ const char* to_string(KernelType kt) {
     ONE_CASE(kGRUHtPart2);
     ONE_CASE(kCRFDecoding);
     ONE_CASE(kLayerNorm);
+    ONE_CASE(kRMSNorm);
+    ONE_CASE(kBiasAct);
     ONE_CASE(kSeqPool);
     ONE_CASE(kMatMul);
     ONE_CASE(kAdam);
@@ -95,6 +214,12 @@ KernelType to_kerneltype(const std::string& act) {
     return kVSigmoid;
   } else if (lower == "tanh" || lower == "vtanh") {
     return kVTanh;
+  } else if (lower == "gelu" || lower == "vgeluerf") {
+    return kVGeluErf;
+  } else if (lower == "gelu_tanh" || lower == "vgelutanh") {
+    return kVGeluTanh;
+  } else if (lower == "silu" || lower == "swish" || lower == "vsilu") {
+    return kVSilu;
   }
   PADDLE_THROW(common::errors::Unimplemented(
       "Act JIT kernel do not support type: %s.", act));
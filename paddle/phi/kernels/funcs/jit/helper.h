@@ -18,6 +18,9 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>  // for std::move
 #include <vector>
@@ -43,8 +46,8 @@ GetJitCode(const typename KernelTuple::attr_type& attr) {
   using Attr = typename KernelTuple::attr_type;
   int64_t key = JitCodeKey<Attr>(attr);
   auto& codes = JitCodePool<KernelTuple::kernel_type>::Instance();
-  if (codes.Has(key)) {
-    return codes.AllKernels().at(key).get();
+  if (const GenBase* code = codes.Find(key)) {
+    return code;
   }
 
   // creator is not related with attr, so can use KernelKey as key
@@ -59,9 +62,7 @@ GetJitCode(const typename KernelTuple::attr_type& attr) {
       if (i && i->CanBeUsed(attr)) {
         auto p = i->CreateJitCode(attr);
         if (p) {
-          auto res = p.get();
-          codes.Insert(key, std::move(p));
-          return res;
+          return codes.Insert(key, std::move(p));
         }
       }
     }
@@ -197,37 +198,53 @@ typename KernelTuple::func_type GetDefaultBestFunc(
 }
 
 extern std::map<size_t, std::shared_ptr<void>>& GetFuncCacheMap();
+extern std::mutex& GetFuncCacheMutex();
+
+// Records that the kernel of type `kt` was looked up for the integer
+// attribute `attr`, see SerializeKernelWarmupList.
+void RecordKernelAttr(KernelType kt, int64_t attr);
 
 template <typename KernelTuple, typename PlaceType>
 class KernelFuncs {
  public:
   KernelFuncs() = default;
   static KernelFuncs& Cache() {
-    auto& func_cache_map = GetFuncCacheMap();
-    auto key = typeid(KernelFuncs<KernelTuple, PlaceType>).hash_code();
-    auto iter = func_cache_map.find(key);
-    if (iter != func_cache_map.end()) {
-      return *(KernelFuncs<KernelTuple, PlaceType>*)(iter->second.get());
-    } else {
-      std::shared_ptr<void> cache =
-          std::make_shared<KernelFuncs<KernelTuple, PlaceType>>();
-      func_cache_map.emplace(key, cache);
-      return *(KernelFuncs<KernelTuple, PlaceType>*)(cache.get());
-    }
+    // The cache is looked up once, in the map shared by all libraries.
+    static KernelFuncs* cache = [] {
+      std::lock_guard<std::mutex> guard(GetFuncCacheMutex());
+      auto& func_cache_map = GetFuncCacheMap();
+      auto key = typeid(KernelFuncs<KernelTuple, PlaceType>).hash_code();
+      auto iter = func_cache_map.find(key);
+      if (iter == func_cache_map.end()) {
+        iter = func_cache_map
+                   .emplace(key,
+                            std::make_shared<
+                                KernelFuncs<KernelTuple, PlaceType>>())
+                   .first;
+      }
+      return static_cast<KernelFuncs<KernelTuple, PlaceType>*>(
+          iter->second.get());
+    }();
+    return *cache;
   }
 
   // the exposed interface to use
   typename KernelTuple::func_type At(
       const typename KernelTuple::attr_type& attr) {
+    using Attr = typename KernelTuple::attr_type;
     // Maybe here is not good enough, not all kernels should have jitcode
-    int64_t key = JitCodeKey<typename KernelTuple::attr_type>(attr);
-    if (Has(key)) {
-      return funcs_.at(key);
+    int64_t key = JitCodeKey<Attr>(attr);
+    if (const auto* func = funcs_.Find(key)) {
+      return *func;
     }
     // If do not have this attr in cache then get the default best
-    auto func = GetDefaultBestFunc<KernelTuple, PlaceType>(attr);
-    Insert(key, func);
-    return func;
+    if constexpr (std::is_integral<Attr>::value &&
+                  std::is_same<typename KernelTuple::data_type,
+                               float>::value &&
+                  std::is_same<PlaceType, phi::CPUPlace>::value) {
+      RecordKernelAttr(KernelTuple::kernel_type, attr);
+    }
+    return funcs_.Insert(key, GetDefaultBestFunc<KernelTuple, PlaceType>(attr));
   }
 
   typename KernelTuple::func_type operator[](
@@ -235,17 +252,39 @@ class KernelFuncs {
     return At(attr);
   }
 
- protected:
-  bool Has(int64_t key) const { return funcs_.find(key) != funcs_.end(); }
-  void Insert(int64_t key, typename KernelTuple::func_type func) {
-    funcs_.emplace(key, func);
-  }
-
  private:
-  std::unordered_map<int64_t, typename KernelTuple::func_type> funcs_;
+  ConcurrentKernelCache<typename KernelTuple::func_type> funcs_;
   DISABLE_COPY_AND_ASSIGN(KernelFuncs);
 };
 
+// Looks up the kernels of `KernelTuple` for every attribute of `attrs`, so
+// that their jit code is generated ahead of their first use.
+template <typename KernelTuple, typename PlaceType = phi::CPUPlace>
+void WarmupKernelFuncs(
+    const std::vector<typename KernelTuple::attr_type>& attrs) {
+  auto& cache = KernelFuncs<KernelTuple, PlaceType>::Cache();
+  for (const auto& attr : attrs) {
+    cache.At(attr);
+  }
+}
+
+// Looks up the float kernels on CPU of the given types and integer
+// attributes, the vector kernels, kLayerNorm, kRMSNorm, kCRFDecoding and
+// kVBroadcast.
+// Other types throw, their attributes are structs that are warmed up with
+// WarmupKernelFuncs.
+void WarmupKernels(const std::vector<std::pair<KernelType, int64_t>>& kernels);
+
+// The float kernels on CPU with an integer attribute that were looked up in
+// this process so far, one "<kernel type> <attribute>" per line. The jit
+// code itself embeds the addresses of constants of this process, so a later
+// process regenerates it from the list with WarmupKernels.
+std::string SerializeKernelWarmupList();
+
+// Parses a list written by SerializeKernelWarmupList and warms up its
+// kernels. Kernel types that are unknown to this build are skipped.
+void LoadKernelWarmupList(const std::string& warmup_list);
+
 const char* to_string(KernelType kt);
 const char* to_string(SeqPoolType kt);
 
@@ -298,6 +337,12 @@ inline std::ostream& operator<<(std::ostream& os, const matmul_attr_t& attr) {
   return os;
 }
 
+inline std::ostream& operator<<(std::ostream& os, const bias_act_attr_t& attr) {
+  os << "width_size[" << attr.w << "],act_type[" << to_string(attr.act_type)
+     << "]";
+  return os;
+}
+
 // expose the method to pack matmul weight
 template <typename T>
 void pack_weights(const T* src, T* dst, int n, int k);
@@ -26,6 +26,7 @@ typedef enum {
   // sort by alphabet
   kAdam = 1,
   kAdamW,
+  kBiasAct,
   kCRFDecoding,
   kEmbSeqPool,
   kGRUH1,
@@ -35,6 +36,7 @@ typedef enum {
   kLSTMC1H1,
   kLayerNorm,
   kMatMul,
+  kRMSNorm,
   kSeqPool,
   kVAdd,
   kVAddBias,
@@ -42,14 +44,18 @@ typedef enum {
   kVBroadcast,
   kVCopy,
   kVExp,
+  kVGeluErf,
+  kVGeluTanh,
   kVIdentity,
   kVMul,
   kVRelu,
   kVScal,
   kSgd,
   kVSigmoid,
+  kVSilu,
   kVSquare,
   kVSub,
+  kVSwiGLU,
   kVTanh,
 } KernelType;
 
@@ -107,6 +113,7 @@ DECLARE_KERNELTUPLE(XYZNTuple, VMul);
 DECLARE_KERNELTUPLE(XYZNTuple, VAdd);
 DECLARE_KERNELTUPLE(XYZNTuple, VAddRelu);
 DECLARE_KERNELTUPLE(XYZNTuple, VSub);
+DECLARE_KERNELTUPLE(XYZNTuple, VSwiGLU);
 
 DECLARE_KERNELTUPLE(AXYNTuple, VScal);
 DECLARE_KERNELTUPLE(AXYNTuple, VAddBias);
@@ -118,6 +125,9 @@ DECLARE_KERNELTUPLE(XYNTuple, VExp);
 DECLARE_KERNELTUPLE(XYNTuple, VSigmoid);
 DECLARE_KERNELTUPLE(XYNTuple, VTanh);
 DECLARE_KERNELTUPLE(XYNTuple, VCopy);
+DECLARE_KERNELTUPLE(XYNTuple, VGeluErf);
+DECLARE_KERNELTUPLE(XYNTuple, VGeluTanh);
+DECLARE_KERNELTUPLE(XYNTuple, VSilu);
 
 typedef struct lstm_t {
   void* gates;  // gates: x_ch, x_ih, x_fh, x_oh
@@ -360,6 +370,33 @@ struct LayerNormTuple {
       T*, T*, T*, T*, const T*, const T*, int, const float, int);
 };
 
+template <typename T>
+struct RMSNormTuple {
+  static constexpr KernelType kernel_type = kRMSNorm;
+  typedef T data_type;
+  typedef int attr_type;
+  typedef void (*func_type)(
+      const T*, T*, const T*, const T*, int, const float, int);
+};
+
+typedef struct bias_act_attr_s {
+  int w;
+  KernelType act_type;
+  bias_act_attr_s() = default;
+  explicit bias_act_attr_s(int width, KernelType act)
+      : w(width), act_type(act) {}
+} bias_act_attr_t;
+
+// x, bias, y, height, attr
+template <typename T>
+struct BiasActTuple {
+  static constexpr KernelType kernel_type = kBiasAct;
+  typedef T data_type;
+  typedef bias_act_attr_t attr_type;
+  typedef void (*func_type)(
+      const T*, const T*, T*, int, const bias_act_attr_t*);
+};
+
 // Just for adding to kernel pool without template
 class Kernel {
  public:
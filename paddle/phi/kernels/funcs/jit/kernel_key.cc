@@ -79,4 +79,10 @@ int64_t JitCodeKey<adamw_attr_t>(const adamw_attr_t& attr) {
                               (attr.amsgrad ? 10 : 0));
 }
 
+template <>
+int64_t JitCodeKey<bias_act_attr_t>(const bias_act_attr_t& attr) {
+  std::array<int, 2> keys = {attr.w, static_cast<int>(attr.act_type)};
+  return static_cast<int64_t>(XXH64(keys.data(), sizeof(int) * 2, 0));
+}
+
 }  // namespace phi::jit
@@ -17,10 +17,15 @@
 namespace phi::jit {
 
 std::map<size_t, std::shared_ptr<void>>& GetJITCodesMap() {
-  static thread_local std::map<size_t, std::shared_ptr<void>> g_jit_codes_map;
+  static std::map<size_t, std::shared_ptr<void>> g_jit_codes_map;
   return g_jit_codes_map;
 }
 
+std::mutex& GetJITCodesMutex() {
+  static std::mutex g_jit_codes_mutex;
+  return g_jit_codes_mutex;
+}
+
 JitCodeCreatorPool& JitCodeCreatorPool::Instance() {
   static JitCodeCreatorPool g_creator_pool;
   return g_creator_pool;
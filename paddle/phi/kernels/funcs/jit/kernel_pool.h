@@ -14,8 +14,12 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <map>
 #include <memory>  // for unique_ptr
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>  // for move
@@ -32,37 +36,164 @@ namespace jit {
 struct KernelKey;
 
 extern std::map<size_t, std::shared_ptr<void>>& GetJITCodesMap();
+extern std::mutex& GetJITCodesMutex();
 
+// Number of shards of a ConcurrentKernelCache.
+constexpr int kKernelCacheShardBits = 4;
+
+// A map from the int64_t keys of kernel attributes to values, shared by all
+// threads and read far more often than written. Lookups take no lock: every
+// shard publishes an open addressing table through an atomic pointer, and a
+// slot is published by storing its value after its key. Inserts lock the
+// shard and fill a free slot of the table in place. When the table is half
+// full it is copied into one twice as large, which is then published in the
+// manner of RCU. The old tables are retired rather than freed, since readers
+// may still probe them, and are freed with the cache.
+template <typename Value>
+class ConcurrentKernelCache {
+ public:
+  ConcurrentKernelCache() = default;
+
+  const Value* Find(int64_t key) const {
+    const uint64_t hash = Hash(key);
+    const Table* table =
+        shards_[Shard(hash)].table.load(std::memory_order_acquire);
+    if (table == nullptr) {
+      return nullptr;
+    }
+    for (uint64_t i = hash;; ++i) {
+      const Slot& slot = table->slots[i & table->mask];
+      const Value* value = slot.value.load(std::memory_order_acquire);
+      if (value == nullptr) {
+        return nullptr;
+      }
+      if (slot.key == key) {
+        return value;
+      }
+    }
+  }
+
+  // Inserts `value` unless `key` is present already, and returns the value
+  // kept for `key`.
+  const Value& Insert(int64_t key, Value value) {
+    const uint64_t hash = Hash(key);
+    ShardData& shard = shards_[Shard(hash)];
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    if (const Value* found = Find(key)) {
+      return *found;
+    }
+    Table* table = shard.tables.empty() ? nullptr : shard.tables.back().get();
+    if (table == nullptr || 2 * (shard.size + 1) > table->mask + 1) {
+      auto grown = std::make_unique<Table>(table ? 2 * (table->mask + 1) : 16);
+      if (table != nullptr) {
+        for (uint64_t i = 0; i <= table->mask; ++i) {
+          const Slot& slot = table->slots[i];
+          const Value* v = slot.value.load(std::memory_order_relaxed);
+          if (v != nullptr) {
+            Place(grown.get(), slot.key, v);
+          }
+        }
+      }
+      table = grown.get();
+      shard.tables.emplace_back(std::move(grown));
+      shard.values.emplace_back(std::move(value));
+      Place(table, key, &shard.values.back());
+      shard.table.store(table, std::memory_order_release);
+    } else {
+      shard.values.emplace_back(std::move(value));
+      Place(table, key, &shard.values.back());
+    }
+    ++shard.size;
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return shard.values.back();
+  }
+
+  size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Slot {
+    int64_t key = 0;
+    std::atomic<const Value*> value{nullptr};
+  };
+  struct Table {
+    explicit Table(uint64_t capacity)
+        : mask(capacity - 1), slots(new Slot[capacity]) {}
+    const uint64_t mask;
+    const std::unique_ptr<Slot[]> slots;
+  };
+  struct ShardData {
+    std::mutex mutex;
+    std::atomic<const Table*> table{nullptr};
+    // All the tables of the shard, the last one is published.
+    std::vector<std::unique_ptr<Table>> tables;
+    // Values never move once inserted.
+    std::deque<Value> values;
+    size_t size = 0;
+  };
+
+  static uint64_t Hash(int64_t key) {
+    // Fibonacci hashing spreads the small sizes most kernels are keyed by.
+    return static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL;
+  }
+  static int Shard(uint64_t hash) {
+    return static_cast<int>(hash >> (64 - kKernelCacheShardBits));
+  }
+  static void Place(Table* table, int64_t key, const Value* value) {
+    uint64_t i = Hash(key);
+    while (table->slots[i & table->mask].value.load(
+               std::memory_order_relaxed) != nullptr) {
+      ++i;
+    }
+    Slot& slot = table->slots[i & table->mask];
+    slot.key = key;
+    slot.value.store(value, std::memory_order_release);
+  }
+
+  std::array<ShardData, 1 << kKernelCacheShardBits> shards_;
+  std::atomic<size_t> size_{0};
+  DISABLE_COPY_AND_ASSIGN(ConcurrentKernelCache);
+};
+
+// The jit codes of one kernel type generated in this process, keyed by the
+// JitCodeKey of their attribute and shared by all threads. The generated
+// code keeps no state of its own, so it runs on several threads at once.
 template <KernelType KT>
 class JitCodePool {
   typedef std::unique_ptr<GenBase> GenBasePtr;
-  typedef std::unordered_map<int64_t, GenBasePtr> JitCodeMap;
 
  public:
   JitCodePool() = default;
   static JitCodePool& Instance() {
-    auto& jit_codes_map = GetJITCodesMap();
-    auto key = typeid(JitCodePool<KT>).hash_code();
-    auto iter = jit_codes_map.find(key);
-    if (iter != jit_codes_map.end()) {
-      return *(JitCodePool<KT>*)(iter->second.get());
-    } else {
-      std::shared_ptr<void> cache = std::make_shared<JitCodePool<KT>>();
-      jit_codes_map.emplace(key, cache);
-      return *(JitCodePool<KT>*)(cache.get());
-    }
+    // The pool is looked up once, in the map shared by all libraries.
+    static JitCodePool* pool = [] {
+      std::lock_guard<std::mutex> guard(GetJITCodesMutex());
+      auto& jit_codes_map = GetJITCodesMap();
+      auto key = typeid(JitCodePool<KT>).hash_code();
+      auto iter = jit_codes_map.find(key);
+      if (iter == jit_codes_map.end()) {
+        iter = jit_codes_map.emplace(key, std::make_shared<JitCodePool<KT>>())
+                   .first;
+      }
+      return static_cast<JitCodePool<KT>*>(iter->second.get());
+    }();
+    return *pool;
   }
 
-  const JitCodeMap& AllKernels() { return codes_; }
+  size_t Size() const { return codes_.Size(); }
 
-  bool Has(int64_t key) const { return codes_.find(key) != codes_.end(); }
+  const GenBase* Find(int64_t key) const {
+    const GenBasePtr* code = codes_.Find(key);
+    return code ? code->get() : nullptr;
+  }
 
-  void Insert(int64_t key, GenBasePtr value) {
-    codes_.emplace(key, std::move(value));
+  // Keeps `value` unless another thread generated the code of `key` first,
+  // and returns the code kept.
+  const GenBase* Insert(int64_t key, GenBasePtr value) {
+    return codes_.Insert(key, std::move(value)).get();
   }
 
  private:
-  JitCodeMap codes_;
+  ConcurrentKernelCache<GenBasePtr> codes_;
   DISABLE_COPY_AND_ASSIGN(JitCodePool);
 };
 
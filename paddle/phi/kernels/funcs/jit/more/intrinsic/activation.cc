@@ -0,0 +1,291 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/jit/more/intrinsic/activation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/jit/helper.h"
+#include "paddle/phi/kernels/funcs/jit/registry.h"
+
+namespace phi::jit::more::intrinsic {
+
+namespace {
+
+// exp(x) as 2^n * exp(r) with r = x - n * ln2 in [-ln2 / 2, ln2 / 2], exp(r)
+// is the polynomial of Cephes. Only AVX is assumed, so 2^n is built on the
+// two 128-bit halves.
+inline __m256 Exp(__m256 x) {
+  x = _mm256_min_ps(x, _mm256_set1_ps(88.0f));
+  x = _mm256_max_ps(x, _mm256_set1_ps(-88.0f));
+  __m256 fx = _mm256_round_ps(
+      _mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(0.693359375f)));
+  x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(-2.12194440e-4f)));
+  __m256 y = _mm256_set1_ps(1.9875691500E-4f);
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.3981999507E-3f));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(8.3334519073E-3f));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(4.1665795894E-2f));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.6666665459E-1f));
+  y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(5.0000001201E-1f));
+  y = _mm256_add_ps(_mm256_mul_ps(y, _mm256_mul_ps(x, x)), x);
+  y = _mm256_add_ps(y, _mm256_set1_ps(1.0f));
+
+  __m256i n = _mm256_cvtps_epi32(fx);
+  const __m128i bias = _mm_set1_epi32(127);
+  __m128i lo = _mm_slli_epi32(
+      _mm_add_epi32(_mm256_castsi256_si128(n), bias), 23);
+  __m128i hi = _mm_slli_epi32(
+      _mm_add_epi32(_mm256_extractf128_si256(n, 1), bias), 23);
+  __m256 pow2n = _mm256_castsi256_ps(
+      _mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1));
+  return _mm256_mul_ps(y, pow2n);
+}
+
+// x / (1 + exp(-a * x))
+inline __m256 MulSigmoid(__m256 x, __m256 a) {
+  __m256 e = Exp(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(a, x)));
+  return _mm256_div_ps(x, _mm256_add_ps(_mm256_set1_ps(1.0f), e));
+}
+
+struct IdentityOp {
+  __m256 operator()(__m256 x) const { return x; }
+};
+
+struct ReluOp {
+  __m256 operator()(__m256 x) const {
+    return _mm256_max_ps(x, _mm256_setzero_ps());
+  }
+};
+
+// Clipped like the refer kVSigmoid.
+struct SigmoidOp {
+  __m256 operator()(__m256 x) const {
+    x = _mm256_max_ps(x, _mm256_set1_ps(SIGMOID_THRESHOLD_MIN));
+    x = _mm256_min_ps(x, _mm256_set1_ps(SIGMOID_THRESHOLD_MAX));
+    __m256 one = _mm256_set1_ps(1.0f);
+    return _mm256_div_ps(
+        one,
+        _mm256_add_ps(one, Exp(_mm256_sub_ps(_mm256_setzero_ps(), x))));
+  }
+};
+
+// 2 * sigmoid(2x) - 1 like the refer kVTanh.
+struct TanhOp {
+  __m256 operator()(__m256 x) const {
+    __m256 two = _mm256_set1_ps(2.0f);
+    return _mm256_sub_ps(_mm256_mul_ps(two, SigmoidOp()(_mm256_mul_ps(two, x))),
+                         _mm256_set1_ps(1.0f));
+  }
+};
+
+// 0.5 * x * (1 + erf(x / sqrt(2))), where erf is formula 7.1.26 of
+// Abramowitz and Stegun, of absolute error below 1.5e-7.
+struct GeluErfOp {
+  __m256 operator()(__m256 x) const {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    __m256 z = _mm256_mul_ps(x, _mm256_set1_ps(static_cast<float>(M_SQRT1_2)));
+    __m256 sign = _mm256_and_ps(z, sign_mask);
+    __m256 abs_z = _mm256_andnot_ps(sign_mask, z);
+    __m256 t = _mm256_div_ps(
+        one,
+        _mm256_add_ps(one,
+                      _mm256_mul_ps(abs_z, _mm256_set1_ps(0.3275911f))));
+    __m256 p = _mm256_set1_ps(1.061405429f);
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(-1.453152027f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.421413741f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(-0.284496736f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(0.254829592f));
+    p = _mm256_mul_ps(p, t);
+    __m256 e = Exp(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(z, z)));
+    __m256 erf = _mm256_or_ps(_mm256_sub_ps(one, _mm256_mul_ps(p, e)), sign);
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), x),
+                         _mm256_add_ps(one, erf));
+  }
+};
+
+// 0.5 * (1 + tanh(u)) is sigmoid(2u), so the tanh form of gelu is
+// x * sigmoid(2u) with u = sqrt(2 / pi) * (x + 0.044715 * x^3).
+struct GeluTanhOp {
+  __m256 operator()(__m256 x) const {
+    const float alpha = static_cast<float>(M_2_SQRTPI * M_SQRT1_2);
+    __m256 a = _mm256_add_ps(
+        _mm256_set1_ps(2.0f * alpha),
+        _mm256_mul_ps(_mm256_set1_ps(2.0f * alpha * 0.044715f),
+                      _mm256_mul_ps(x, x)));
+    return MulSigmoid(x, a);
+  }
+};
+
+struct SiluOp {
+  __m256 operator()(__m256 x) const {
+    return MulSigmoid(x, _mm256_set1_ps(1.0f));
+  }
+};
+
+// The rest of n that does not fill a register goes through a zero padded
+// buffer on the stack.
+template <typename Op>
+void VAct(const float* x, float* y, int n) {
+  constexpr int block = YMM_FLOAT_BLOCK;
+  const int end = n - n % block;
+  Op op;
+  for (int i = 0; i < end; i += block) {
+    _mm256_storeu_ps(y + i, op(_mm256_loadu_ps(x + i)));
+  }
+  if (end < n) {
+    float buf[block] = {0};
+    std::copy(x + end, x + n, buf);
+    _mm256_storeu_ps(buf, op(_mm256_loadu_ps(buf)));
+    std::copy(buf, buf + n - end, y + end);
+  }
+}
+
+template <typename Op>
+void VBiasAct(const float* x, const float* bias, float* y, int n) {
+  constexpr int block = YMM_FLOAT_BLOCK;
+  const int end = n - n % block;
+  Op op;
+  for (int i = 0; i < end; i += block) {
+    _mm256_storeu_ps(
+        y + i,
+        op(_mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(bias + i))));
+  }
+  if (end < n) {
+    float buf[block] = {0};
+    for (int i = end; i < n; ++i) {
+      buf[i - end] = x[i] + bias[i];
+    }
+    _mm256_storeu_ps(buf, op(_mm256_loadu_ps(buf)));
+    std::copy(buf, buf + n - end, y + end);
+  }
+}
+
+template <typename Op>
+void BiasActRows(
+    const float* x, const float* bias, float* y, int height, int w) {
+  for (int h = 0; h < height; ++h) {
+    const int64_t offset = static_cast<int64_t>(h) * w;
+    if (bias) {
+      VBiasAct<Op>(x + offset, bias, y + offset, w);
+    } else {
+      VAct<Op>(x + offset, y + offset, w);
+    }
+  }
+}
+
+}  // namespace
+
+void VGeluErf(const float* x, float* y, int n) { VAct<GeluErfOp>(x, y, n); }
+
+void VGeluTanh(const float* x, float* y, int n) {
+  VAct<GeluTanhOp>(x, y, n);
+}
+
+void VSilu(const float* x, float* y, int n) { VAct<SiluOp>(x, y, n); }
+
+void VSwiGLU(const float* x, const float* y, float* z, int n) {
+  constexpr int block = YMM_FLOAT_BLOCK;
+  const int end = n - n % block;
+  SiluOp silu;
+  for (int i = 0; i < end; i += block) {
+    _mm256_storeu_ps(z + i,
+                     _mm256_mul_ps(silu(_mm256_loadu_ps(x + i)),
+                                   _mm256_loadu_ps(y + i)));
+  }
+  if (end < n) {
+    float xbuf[block] = {0};
+    float ybuf[block] = {0};
+    std::copy(x + end, x + n, xbuf);
+    std::copy(y + end, y + n, ybuf);
+    _mm256_storeu_ps(
+        xbuf,
+        _mm256_mul_ps(silu(_mm256_loadu_ps(xbuf)), _mm256_loadu_ps(ybuf)));
+    std::copy(xbuf, xbuf + n - end, z + end);
+  }
+}
+
+void BiasAct(const float* x,
+             const float* bias,
+             float* y,
+             int height,
+             const bias_act_attr_t* attr) {
+  const int w = attr->w;
+  switch (attr->act_type) {
+    case kVIdentity:
+      BiasActRows<IdentityOp>(x, bias, y, height, w);
+      break;
+    case kVRelu:
+      BiasActRows<ReluOp>(x, bias, y, height, w);
+      break;
+    case kVSigmoid:
+      BiasActRows<SigmoidOp>(x, bias, y, height, w);
+      break;
+    case kVTanh:
+      BiasActRows<TanhOp>(x, bias, y, height, w);
+      break;
+    case kVGeluErf:
+      BiasActRows<GeluErfOp>(x, bias, y, height, w);
+      break;
+    case kVGeluTanh:
+      BiasActRows<GeluTanhOp>(x, bias, y, height, w);
+      break;
+    case kVSilu:
+      BiasActRows<SiluOp>(x, bias, y, height, w);
+      break;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Intrinsic BiasAct JIT kernel do not support type: %s.",
+          to_string(attr->act_type)));
+  }
+}
+
+bool VGeluErfKernel::CanBeUsed(const int& d UNUSED) const {
+  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+}
+
+bool VGeluTanhKernel::CanBeUsed(const int& d UNUSED) const {
+  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+}
+
+bool VSiluKernel::CanBeUsed(const int& d UNUSED) const {
+  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+}
+
+bool VSwiGLUKernel::CanBeUsed(const int& d UNUSED) const {
+  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+}
+
+bool BiasActKernel::CanBeUsed(const bias_act_attr_t& attr) const {
+  const KernelType act = attr.act_type;
+  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) &&
+         (act == kVIdentity || act == kVRelu || act == kVSigmoid ||
+          act == kVTanh || act == kVGeluErf || act == kVGeluTanh ||
+          act == kVSilu);
+}
+
+}  // namespace phi::jit::more::intrinsic
+
+namespace intrinsic = phi::jit::more::intrinsic;
+
+REGISTER_JITKERNEL_MORE(kVGeluErf, intrinsic, intrinsic::VGeluErfKernel);
+REGISTER_JITKERNEL_MORE(kVGeluTanh, intrinsic, intrinsic::VGeluTanhKernel);
+REGISTER_JITKERNEL_MORE(kVSilu, intrinsic, intrinsic::VSiluKernel);
+REGISTER_JITKERNEL_MORE(kVSwiGLU, intrinsic, intrinsic::VSwiGLUKernel);
+REGISTER_JITKERNEL_MORE(kBiasAct, intrinsic, intrinsic::BiasActKernel);
@@ -0,0 +1,60 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <type_traits>
+
+#include "paddle/phi/kernels/funcs/jit/kernel_base.h"
+
+namespace phi {
+namespace jit {
+namespace more {
+namespace intrinsic {
+
+void VGeluErf(const float* x, float* y, int n);
+void VGeluTanh(const float* x, float* y, int n);
+void VSilu(const float* x, float* y, int n);
+void VSwiGLU(const float* x, const float* y, float* z, int n);
+void BiasAct(const float* x,
+             const float* bias,
+             float* y,
+             int height,
+             const bias_act_attr_t* attr);
+
+#define DECLARE_MORE_KERNEL(name)                                      \
+  class name##Kernel : public KernelMore<name##Tuple<float>> {         \
+   public:                                                             \
+    name##Kernel() { this->func = name; }                              \
+    bool CanBeUsed(                                                    \
+        const typename name##Tuple<float>::attr_type&) const override; \
+    const char* ImplType() const override { return "Intrinsic"; }      \
+  }
+
+// XYN
+DECLARE_MORE_KERNEL(VGeluErf);
+DECLARE_MORE_KERNEL(VGeluTanh);
+DECLARE_MORE_KERNEL(VSilu);
+
+// XYZN
+DECLARE_MORE_KERNEL(VSwiGLU);
+
+DECLARE_MORE_KERNEL(BiasAct);
+
+#undef DECLARE_MORE_KERNEL
+
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace phi
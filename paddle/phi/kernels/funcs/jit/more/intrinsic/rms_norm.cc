@@ -0,0 +1,96 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/jit/more/intrinsic/rms_norm.h"
+
+#include <cmath>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/jit/registry.h"
+
+namespace phi::jit::more::intrinsic {
+
+void RMSNorm(const float* x,
+             float* out,
+             const float* scale,
+             const float* bias,
+             int height,
+             const float epsilon,
+             int right) {
+  constexpr int block = YMM_FLOAT_BLOCK;
+  const int end = right - right % block;
+  for (int i = 0; i < height; ++i) {
+    const float* src = x + static_cast<int64_t>(i) * right;
+    float* dst = out + static_cast<int64_t>(i) * right;
+
+    /* get the mean of squares, with two accumulators to hide latency */
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    int j = 0;
+    for (; j + 2 * block <= end; j += 2 * block) {
+      __m256 a = _mm256_loadu_ps(src + j);
+      __m256 b = _mm256_loadu_ps(src + j + block);
+      sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(a, a));
+      sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(b, b));
+    }
+    if (j < end) {
+      __m256 a = _mm256_loadu_ps(src + j);
+      sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(a, a));
+    }
+    sum0 = _mm256_add_ps(sum0, sum1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum0),
+                            _mm256_extractf128_ps(sum0, 1));
+    sum = _mm_hadd_ps(sum, sum);
+    sum = _mm_hadd_ps(sum, sum);
+    float square_sum = _mm_cvtss_f32(sum);
+    for (j = end; j < right; ++j) {
+      square_sum += src[j] * src[j];
+    }
+    const float inv_rms =
+        1.0f / std::sqrt(square_sum / static_cast<float>(right) + epsilon);
+
+    /* normalize, scale and shift */
+    const __m256 inv_rms_vec = _mm256_set1_ps(inv_rms);
+    for (j = 0; j < end; j += block) {
+      __m256 tmp = _mm256_mul_ps(_mm256_loadu_ps(src + j), inv_rms_vec);
+      if (scale) {
+        tmp = _mm256_mul_ps(tmp, _mm256_loadu_ps(scale + j));
+      }
+      if (bias) {
+        tmp = _mm256_add_ps(tmp, _mm256_loadu_ps(bias + j));
+      }
+      _mm256_storeu_ps(dst + j, tmp);
+    }
+    for (j = end; j < right; ++j) {
+      float tmp = src[j] * inv_rms;
+      if (scale) {
+        tmp *= scale[j];
+      }
+      if (bias) {
+        tmp += bias[j];
+      }
+      dst[j] = tmp;
+    }
+  }
+}
+
+bool RMSNormKernel::CanBeUsed(const int& d UNUSED) const {
+  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+}
+
+}  // namespace phi::jit::more::intrinsic
+
+namespace intrinsic = phi::jit::more::intrinsic;
+
+REGISTER_JITKERNEL_MORE(kRMSNorm, intrinsic, intrinsic::RMSNormKernel);
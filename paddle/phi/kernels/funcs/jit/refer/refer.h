@@ -135,6 +135,47 @@ void VTanh(const T* x, T* y, int n) {
   }
 }
 
+template <typename T>
+void VGeluErf(const T* x, T* y, int n) {
+  // y = 0.5 * x * (1 + erf(x / sqrt(2)))
+  const T half = static_cast<T>(0.5);
+  for (int i = 0; i < n; ++i) {
+    T tmp = x[i];
+    y[i] = half * tmp *
+           (static_cast<T>(1) + std::erf(tmp * static_cast<T>(M_SQRT1_2)));
+  }
+}
+
+template <typename T>
+void VGeluTanh(const T* x, T* y, int n) {
+  // y = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+  const T half = static_cast<T>(0.5);
+  const T alpha = static_cast<T>(M_2_SQRTPI * M_SQRT1_2);
+  const T beta = static_cast<T>(0.044715);
+  for (int i = 0; i < n; ++i) {
+    T tmp = x[i];
+    y[i] = half * tmp *
+           (static_cast<T>(1) +
+            std::tanh(alpha * (tmp + beta * tmp * tmp * tmp)));
+  }
+}
+
+template <typename T>
+void VSilu(const T* x, T* y, int n) {
+  // y = x * sigmoid(x)
+  for (int i = 0; i < n; ++i) {
+    y[i] = x[i] / (static_cast<T>(1) + std::exp(-x[i]));
+  }
+}
+
+template <typename T>
+void VSwiGLU(const T* x, const T* y, T* z, int n) {
+  // z = silu(x) * y
+  for (int i = 0; i < n; ++i) {
+    z[i] = x[i] / (static_cast<T>(1) + std::exp(-x[i])) * y[i];
+  }
+}
+
 template <typename T>
 void (*getActFunc(KernelType type))(const T*, T*, int) {  // NOLINT
   if (type == kVSigmoid) {
@@ -145,6 +186,12 @@ void (*getActFunc(KernelType type))(const T*, T*, int) {  // NOLINT
     return VTanh<T>;
   } else if (type == kVIdentity) {
     return VIdentity<T>;
+  } else if (type == kVGeluErf) {
+    return VGeluErf<T>;
+  } else if (type == kVGeluTanh) {
+    return VGeluTanh<T>;
+  } else if (type == kVSilu) {
+    return VSilu<T>;
   }
   PADDLE_THROW(common::errors::Unimplemented(
       "Act JIT kernel do not support type: %s.", type));
@@ -353,6 +400,54 @@ void LayerNorm(T* x,
   }
 }
 
+template <typename T>
+void RMSNorm(const T* x,
+             T* out,
+             const T* scale,
+             const T* bias,
+             int height,
+             const float epsilon,
+             int right) {
+  for (int i = 0; i < height; i++) {
+    int64_t offset = static_cast<int64_t>(i) * right;
+    T sum = 0.0;
+    for (int j = 0; j < right; j++) {
+      sum += x[offset + j] * x[offset + j];
+    }
+    T inv_rms = static_cast<T>(1) / std::sqrt(sum / right + (T)epsilon);
+    for (int j = 0; j < right; j++) {
+      T tmp = x[offset + j] * inv_rms;
+      if (scale) {
+        tmp *= scale[j];
+      }
+      if (bias) {
+        tmp += bias[j];
+      }
+      out[offset + j] = tmp;
+    }
+  }
+}
+
+// y = act(x + bias) on the rows of width attr->w of x, bias may be nullptr
+template <typename T>
+void BiasAct(const T* x,
+             const T* bias,
+             T* y,
+             int height,
+             const bias_act_attr_t* attr) {
+  auto act = getActFunc<T>(attr->act_type);
+  const int w = attr->w;
+  for (int h = 0; h < height; ++h) {
+    const T* src = x + static_cast<int64_t>(h) * w;
+    T* dst = y + static_cast<int64_t>(h) * w;
+    if (bias) {
+      VAdd(src, bias, dst, w);
+      src = dst;
+    }
+    act(src, dst, w);
+  }
+}
+
 template <typename T>
 void SeqPool(const T* x, T* y, const seq_pool_attr_t* attr) {
   for (int w = 0; w < attr->w; ++w) {
@@ -600,6 +695,7 @@ DECLARE_REFER_KERNEL(VMul);
 DECLARE_REFER_KERNEL(VAdd);
 DECLARE_REFER_KERNEL(VAddRelu);
 DECLARE_REFER_KERNEL(VSub);
+DECLARE_REFER_KERNEL(VSwiGLU);
 
 // const T* a, const T* x, T* y, int n
 DECLARE_REFER_KERNEL(VScal);
@@ -613,6 +709,9 @@ DECLARE_REFER_KERNEL(VSigmoid);
 DECLARE_REFER_KERNEL(VTanh);
 DECLARE_REFER_KERNEL(VSquare);
 DECLARE_REFER_KERNEL(VCopy);
+DECLARE_REFER_KERNEL(VGeluErf);
+DECLARE_REFER_KERNEL(VGeluTanh);
+DECLARE_REFER_KERNEL(VSilu);
 
 // lstm_t*, const lstm_attr_t*
 DECLARE_REFER_KERNEL(LSTMCtHt);
@@ -626,6 +725,8 @@ DECLARE_REFER_KERNEL(GRUHtPart2);
 // others
 DECLARE_REFER_KERNEL(CRFDecoding);
 DECLARE_REFER_KERNEL(LayerNorm);
+DECLARE_REFER_KERNEL(RMSNorm);
+DECLARE_REFER_KERNEL(BiasAct);
 DECLARE_REFER_KERNEL(SeqPool);
 DECLARE_REFER_KERNEL(MatMul);
 DECLARE_REFER_KERNEL(EmbSeqPool);
@@ -15,6 +15,8 @@ limitations under the License. */
 #include <array>
 #include <iostream>
 #include <random>
+#include <string>
+#include <thread>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
@@ -487,6 +489,127 @@ void TestKernelLayerNorm() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void TestKernelRMSNorm() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  const float epsilon = 9.99999975e-06;
+  for (int left : {1, 9, 50}) {
+    for (int right : TestSizes()) {
+      auto ref = jit::GetReferFunc<KernelTuple>();
+      EXPECT_TRUE(ref != nullptr);
+      int sz = left * right;
+      std::vector<T> x(sz), scale(right), bias(right), outref(sz),
+          outref_noaffine(sz);
+      RandomVec<T>(sz, x.data());
+      RandomVec<T>(right, scale.data());
+      RandomVec<T>(right, bias.data());
+      ref(x.data(),
+          outref.data(),
+          scale.data(),
+          bias.data(),
+          left,
+          epsilon,
+          right);
+      ref(x.data(),
+          outref_noaffine.data(),
+          nullptr,
+          nullptr,
+          left,
+          epsilon,
+          right);
+
+      auto verifier = [](const typename KernelTuple::func_type tgt,
+                         const std::vector<T>& x,
+                         const std::vector<T>& scale,
+                         const std::vector<T>& bias,
+                         const std::vector<T>& outref,
+                         const std::vector<T>& outref_noaffine,
+                         const int& left,
+                         const float& epsilon,
+                         const typename KernelTuple::attr_type& right) {
+        EXPECT_TRUE(tgt != nullptr);
+        EXPECT_EQ(x.size(), static_cast<size_t>(left * right));
+        std::vector<T> outtgt(x.size());
+        tgt(x.data(),
+            outtgt.data(),
+            scale.data(),
+            bias.data(),
+            left,
+            epsilon,
+            right);
+        ExpectEQ<T>(outtgt.data(), outref.data(), left * right);
+        // test inplace x without scale and bias
+        std::copy(x.begin(), x.end(), outtgt.begin());
+        tgt(outtgt.data(),
+            outtgt.data(),
+            nullptr,
+            nullptr,
+            left,
+            epsilon,
+            right);
+        ExpectEQ<T>(outtgt.data(), outref_noaffine.data(), left * right);
+      };
+      TestAllImpls<KernelTuple, PlaceType>(right,
+                                           verifier,
+                                           x,
+                                           scale,
+                                           bias,
+                                           outref,
+                                           outref_noaffine,
+                                           left,
+                                           epsilon,
+                                           right);
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void TestKernelBiasAct() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  const jit::KernelType all_acts[] = {jit::kVIdentity,
+                                      jit::kVRelu,
+                                      jit::kVSigmoid,
+                                      jit::kVTanh,
+                                      jit::kVGeluErf,
+                                      jit::kVGeluTanh,
+                                      jit::kVSilu};
+  for (auto act : all_acts) {
+    for (int h : {1, 3}) {
+      for (int w : TestSizes()) {
+        auto ref = jit::GetReferFunc<KernelTuple>();
+        EXPECT_TRUE(ref != nullptr);
+        const jit::bias_act_attr_t attr(w, act);
+        std::vector<T> x(h * w), bias(w), yref(h * w), yref_nobias(h * w);
+        RandomVec<T>(h * w, x.data());
+        RandomVec<T>(w, bias.data());
+        ref(x.data(), bias.data(), yref.data(), h, &attr);
+        ref(x.data(), nullptr, yref_nobias.data(), h, &attr);
+
+        auto verifier = [](const typename KernelTuple::func_type tgt,
+                           const std::vector<T>& x,
+                           const std::vector<T>& bias,
+                           const std::vector<T>& yref,
+                           const std::vector<T>& yref_nobias,
+                           const int& h,
+                           const typename KernelTuple::attr_type& attr) {
+          EXPECT_TRUE(tgt != nullptr);
+          std::vector<T> ytgt(x.size());
+          tgt(x.data(), bias.data(), ytgt.data(), h, &attr);
+          ExpectEQ<T>(ytgt.data(), yref.data(), x.size());
+          // test inplace x without bias
+          std::copy(x.begin(), x.end(), ytgt.begin());
+          tgt(ytgt.data(), nullptr, ytgt.data(), h, &attr);
+          ExpectEQ<T>(ytgt.data(), yref_nobias.data(), x.size());
+        };
+        TestAllImpls<KernelTuple, PlaceType>(
+            attr, verifier, x, bias, yref, yref_nobias, h, attr);
+      }
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void TestKernelCRFDecoding() {
   using T = typename KernelTuple::data_type;
@@ -1121,23 +1244,49 @@ TEST(JITKernel_pool, jitcreator) {
 
 TEST(JITKernel_pool, jitpool) {
   // jitpool is related with attr
-  const auto& kers = jit::JitCodePool<jit::kVAdd>().Instance().AllKernels();
-  EXPECT_EQ(kers.size(), 0UL);
-  jit::GetAllCandidateKernels<jit::VAddTuple<float>, CPUPlace>(3);
+  auto& pool = jit::JitCodePool<jit::kVAdd>::Instance();
+  const int64_t key = jit::JitCodeKey<int>(1031);
+  EXPECT_TRUE(pool.Find(key) == nullptr);
+  size_t size = pool.Size();
+  jit::GetAllCandidateKernels<jit::VAddTuple<float>, CPUPlace>(1031);
 // after call GetAllCandidateKernels, it will create jitcode Automatically
 #if defined(_WIN32) || defined(__APPLE__) || defined(__OSX__)
-  EXPECT_EQ(kers.size(), 0UL);
+  EXPECT_EQ(pool.Size(), size);
 #else
-  EXPECT_EQ(kers.size(), 1UL);
+  EXPECT_EQ(pool.Size(), size + 1);
+  EXPECT_TRUE(pool.Find(key) != nullptr);
 #endif
 }
 
+TEST(JITKernel_pool, jitpool_threads) {
+  // All threads share the pool, and so the code of every attr
+  std::vector<jit::VAddTuple<float>::func_type> funcs(4 * 64);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([t, &funcs] {
+      for (int d = 0; d < 64; ++d) {
+        funcs[t * 64 + d] =
+            jit::KernelFuncs<jit::VAddTuple<float>, CPUPlace>::Cache().At(
+                2000 + d);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 1; t < 4; ++t) {
+    for (int d = 0; d < 64; ++d) {
+      EXPECT_TRUE(funcs[t * 64 + d] == funcs[d]);
+    }
+  }
+}
+
 TEST(JITKernel_pool, more) {
   const auto& kers = jit::KernelPool::Instance().AllKernels();
   size_t target_num = 7;
 
 #ifdef __AVX__
-  target_num += 2;
+  target_num += 8;
 #endif
 
 #ifdef PADDLE_WITH_MKLML
@@ -1149,7 +1298,7 @@ TEST(JITKernel_pool, more) {
 
 TEST(JITKernel_pool, refer) {
   const auto& kers = jit::ReferKernelPool::Instance().AllKernels();
-  EXPECT_EQ(kers.size(), 27UL);
+  EXPECT_EQ(kers.size(), 33UL);
 }
 
 // test helper
@@ -1215,6 +1364,22 @@ TEST(JITKernel_helper, KernelFuncs) {
 #endif
 }
 
+TEST(JITKernel_helper, KernelWarmupList) {
+  jit::KernelFuncs<jit::VExpTuple<float>, CPUPlace>::Cache().At(1033);
+  jit::WarmupKernels({{jit::kVSigmoid, 1033}, {jit::kVBroadcast, 1033}});
+  std::string warmup_list = jit::SerializeKernelWarmupList();
+  EXPECT_NE(warmup_list.find("kVExp 1033\n"), std::string::npos);
+  EXPECT_NE(warmup_list.find("kVSigmoid 1033\n"), std::string::npos);
+  EXPECT_NE(warmup_list.find("kVBroadcast 1033\n"), std::string::npos);
+
+  // Unknown kernel types, say of a newer build, are skipped
+  jit::LoadKernelWarmupList("kVTanh 1033\nkUnknown 7\nkVRelu 1033\n");
+  warmup_list = jit::SerializeKernelWarmupList();
+  EXPECT_NE(warmup_list.find("kVTanh 1033\n"), std::string::npos);
+  EXPECT_NE(warmup_list.find("kVRelu 1033\n"), std::string::npos);
+  EXPECT_EQ(warmup_list.find("kUnknown"), std::string::npos);
+}
+
 TEST(JITKernel_helper, GetAllCandidateFuncs) {
   auto funcs = jit::GetAllCandidateFuncs<jit::VExpTuple<float>, CPUPlace>(10);
   auto kers = jit::GetAllCandidateKernels<jit::VExpTuple<float>, CPUPlace>(10);
@@ -1412,6 +1577,23 @@ TEST(JITKernel_key, matmul) {
   EXPECT_TRUE(key3 != key4);
 }
 
+TEST(JITKernel_key, bias_act) {
+  jit::bias_act_attr_t attr1(8, jit::kVGeluErf);
+  jit::bias_act_attr_t attr2(8, jit::kVGeluErf);
+  jit::bias_act_attr_t attr3(8, jit::kVGeluTanh);
+  jit::bias_act_attr_t attr4(16, jit::kVGeluErf);
+
+  auto key1 = jit::JitCodeKey<jit::bias_act_attr_t>(attr1);
+  auto key2 = jit::JitCodeKey<jit::bias_act_attr_t>(attr2);
+  auto key3 = jit::JitCodeKey<jit::bias_act_attr_t>(attr3);
+  auto key4 = jit::JitCodeKey<jit::bias_act_attr_t>(attr4);
+
+  EXPECT_TRUE(key1 == key2);
+  EXPECT_TRUE(key2 != key3);
+  EXPECT_TRUE(key2 != key4);
+  EXPECT_TRUE(key3 != key4);
+}
+
 TEST(JITKernel_key, emb_seq_pool) {
   jit::emb_seq_pool_attr_t attr1(1, 2, 3, 4, 5, jit::SeqPoolType::kSum);
   jit::emb_seq_pool_attr_t attr2(1, 2, 3, 4, 5, jit::SeqPoolType::kSum);
@@ -1489,6 +1671,7 @@ TEST(JITKernel_key, sgd) {
 #define TestKernelVAdd TestKernelXYZN
 #define TestKernelVAddRelu TestKernelXYZN
 #define TestKernelVSub TestKernelXYZN
+#define TestKernelVSwiGLU TestKernelXYZN
 
 #define TestKernelVScal TestKernelAXYN
 #define TestKernelVAddBias TestKernelAXYN
@@ -1500,6 +1683,9 @@ TEST(JITKernel_key, sgd) {
 #define TestKernelVSigmoid TestKernelXYN
 #define TestKernelVTanh TestKernelXYN
 #define TestKernelVCopy TestKernelXYN
+#define TestKernelVGeluErf TestKernelXYN
+#define TestKernelVGeluTanh TestKernelXYN
+#define TestKernelVSilu TestKernelXYN
 
 #define TestKernelLSTMCtHt TestKernelLSTM
 #define TestKernelLSTMC1H1 TestKernelLSTM
@@ -1518,6 +1704,7 @@ TEST_CPU_KERNEL(VMul);
 TEST_CPU_KERNEL(VAdd);
 TEST_CPU_KERNEL(VAddRelu);
 TEST_CPU_KERNEL(VSub);
+TEST_CPU_KERNEL(VSwiGLU);
 
 TEST_CPU_KERNEL(VScal);
 TEST_CPU_KERNEL(VAddBias);
@@ -1529,6 +1716,9 @@ TEST_CPU_KERNEL(VExp);
 TEST_CPU_KERNEL(VSigmoid);
 TEST_CPU_KERNEL(VTanh);
 TEST_CPU_KERNEL(VCopy);
+TEST_CPU_KERNEL(VGeluErf);
+TEST_CPU_KERNEL(VGeluTanh);
+TEST_CPU_KERNEL(VSilu);
 
 TEST_CPU_KERNEL(LSTMCtHt);
 TEST_CPU_KERNEL(LSTMC1H1);
@@ -1538,6 +1728,8 @@ TEST_CPU_KERNEL(GRUHtPart1);
 TEST_CPU_KERNEL(GRUHtPart2);
 
 TEST_CPU_KERNEL(LayerNorm);
+TEST_CPU_KERNEL(RMSNorm);
+TEST_CPU_KERNEL(BiasAct);
 TEST_CPU_KERNEL(CRFDecoding);
 
 TEST_CPU_KERNEL(SeqPool);
@@ -0,0 +1,392 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+
+namespace phi {
+namespace funcs {
+
+// Number of elements below which the rows of a norm run on one thread.
+constexpr int64_t kNormGrainSize = 16384;
+// Number of independent accumulators a row is reduced with, the lane loops
+// are plain enough for the compiler to keep them in one vector register.
+constexpr int kNormLanes = 16;
+
+// Count, mean and sum of squared deviations of a Welford reduction.
+template <typename U>
+struct WelfordState {
+  U count = 0;
+  U mean = 0;
+  U m2 = 0;
+
+  void Merge(U other_count, U other_mean, U other_m2) {
+    const U total = count + other_count;
+    if (other_count == 0) {
+      return;
+    }
+    const U delta = other_mean - mean;
+    mean += delta * other_count / total;
+    m2 += other_m2 + delta * delta * count * other_count / total;
+    count = total;
+  }
+};
+
+// Computes the mean and the biased variance of a row in a single pass. The
+// row is split over kNormLanes Welford accumulators that are merged at the
+// end, which keeps the update vectorizable and the variance free of the
+// cancellation of the sum of squares formula.
+template <typename T, typename U>
+inline void RowMeanAndVar(const T* x, int64_t cols, U* mean, U* var) {
+  std::array<U, kNormLanes> lane_mean{};
+  std::array<U, kNormLanes> lane_m2{};
+  const int64_t groups = cols / kNormLanes;
+  for (int64_t g = 0; g < groups; ++g) {
+    const U inv_count = static_cast<U>(1) / static_cast<U>(g + 1);
+    const T* px = x + g * kNormLanes;
+    for (int l = 0; l < kNormLanes; ++l) {
+      const U v = static_cast<U>(px[l]);
+      const U delta = v - lane_mean[l];
+      lane_mean[l] += delta * inv_count;
+      lane_m2[l] += delta * (v - lane_mean[l]);
+    }
+  }
+  WelfordState<U> state;
+  for (int l = 0; l < kNormLanes && groups > 0; ++l) {
+    state.Merge(static_cast<U>(groups), lane_mean[l], lane_m2[l]);
+  }
+  for (int64_t j = groups * kNormLanes; j < cols; ++j) {
+    const U v = static_cast<U>(x[j]);
+    state.count += 1;
+    const U delta = v - state.mean;
+    state.mean += delta / state.count;
+    state.m2 += delta * (v - state.mean);
+  }
+  *mean = state.mean;
+  *var = state.m2 / static_cast<U>(cols);
+}
+
+// Sums f(j) for j in [0, n) over kNormLanes accumulators.
+template <typename U, typename Func>
+inline U RowLaneSum(int64_t n, Func f) {
+  std::array<U, kNormLanes> lanes{};
+  int64_t j = 0;
+  for (; j + kNormLanes <= n; j += kNormLanes) {
+    for (int l = 0; l < kNormLanes; ++l) {
+      lanes[l] += f(j + l);
+    }
+  }
+  U sum = 0;
+  for (; j < n; ++j) {
+    sum += f(j);
+  }
+  for (int l = 0; l < kNormLanes; ++l) {
+    sum += lanes[l];
+  }
+  return sum;
+}
+
+// Rows per range of a row-parallel norm with `cols` columns.
+inline int64_t NormRowGrain(int64_t cols) {
+  return std::max<int64_t>(1, kNormGrainSize / std::max<int64_t>(cols, 1));
+}
+
+// Columns per range of the column reductions of a norm grad with `rows`
+// rows, at least a cache line of floats so that ranges do not share lines.
+inline int64_t NormColGrain(int64_t rows) {
+  return std::max<int64_t>(kNormLanes,
+                           kNormGrainSize / std::max<int64_t>(rows, 1));
+}
+
+// y = (x - mean) / sqrt(var + epsilon) * scale + bias over the rows of a
+// [rows, cols] matrix. mean and var are written per row in U, the
+// accumulation type of T, and scale and bias may be either T or U.
+template <typename T, typename P>
+void LayerNormForwardCPU(const CPUContext& dev_ctx,
+                         const T* x,
+                         const P* scale,
+                         const P* bias,
+                         int64_t rows,
+                         int64_t cols,
+                         float epsilon,
+                         T* y,
+                         typename phi::dtype::MPTypeTrait<T>::Type* mean,
+                         typename phi::dtype::MPTypeTrait<T>::Type* var) {
+  using U = typename phi::dtype::MPTypeTrait<T>::Type;
+  dev_ctx.ParallelFor(
+      0, rows, NormRowGrain(cols), [&](int64_t begin, int64_t end) {
+        for (int64_t r = begin; r < end; ++r) {
+          const T* px = x + r * cols;
+          T* py = y + r * cols;
+          U row_mean, row_var;
+          RowMeanAndVar(px, cols, &row_mean, &row_var);
+          mean[r] = row_mean;
+          var[r] = row_var;
+          const U rstd = static_cast<U>(1) /
+                         std::sqrt(row_var + static_cast<U>(epsilon));
+          if (scale && bias) {
+            for (int64_t j = 0; j < cols; ++j) {
+              py[j] = static_cast<T>(
+                  (static_cast<U>(px[j]) - row_mean) * rstd *
+                      static_cast<U>(scale[j]) +
+                  static_cast<U>(bias[j]));
+            }
+          } else if (scale) {
+            for (int64_t j = 0; j < cols; ++j) {
+              py[j] = static_cast<T>((static_cast<U>(px[j]) - row_mean) *
+                                     rstd * static_cast<U>(scale[j]));
+            }
+          } else if (bias) {
+            for (int64_t j = 0; j < cols; ++j) {
+              py[j] = static_cast<T>(
+                  (static_cast<U>(px[j]) - row_mean) * rstd +
+                  static_cast<U>(bias[j]));
+            }
+          } else {
+            for (int64_t j = 0; j < cols; ++j) {
+              py[j] = static_cast<T>((static_cast<U>(px[j]) - row_mean) *
+                                     rstd);
+            }
+          }
+        }
+      });
+}
+
+// The grad of LayerNormForwardCPU, any of dx, dscale and dbias may be null.
+// dx is computed row by row from two passes over the cached row, dscale and
+// dbias are reduced over the rows for disjoint column ranges.
+template <typename T, typename P>
+void LayerNormBackwardCPU(
+    const CPUContext& dev_ctx,
+    const T* x,
+    const T* dy,
+    const P* scale,
+    const typename phi::dtype::MPTypeTrait<T>::Type* mean,
+    const typename phi::dtype::MPTypeTrait<T>::Type* var,
+    int64_t rows,
+    int64_t cols,
+    float epsilon,
+    T* dx,
+    P* dscale,
+    P* dbias) {
+  using U = typename phi::dtype::MPTypeTrait<T>::Type;
+  const U eps = static_cast<U>(epsilon);
+  if (dx) {
+    const U inv_cols = static_cast<U>(1) / static_cast<U>(cols);
+    dev_ctx.ParallelFor(
+        0, rows, NormRowGrain(cols), [&](int64_t begin, int64_t end) {
+          for (int64_t r = begin; r < end; ++r) {
+            const T* px = x + r * cols;
+            const T* pdy = dy + r * cols;
+            T* pdx = dx + r * cols;
+            const U row_mean = mean[r];
+            const U rstd = static_cast<U>(1) / std::sqrt(var[r] + eps);
+            auto dyg = [&](int64_t j) {
+              return scale ? static_cast<U>(pdy[j]) * static_cast<U>(scale[j])
+                           : static_cast<U>(pdy[j]);
+            };
+            const U sum_dyg = RowLaneSum<U>(cols, dyg);
+            const U sum_dyg_xhat = RowLaneSum<U>(cols, [&](int64_t j) {
+              return dyg(j) * (static_cast<U>(px[j]) - row_mean);
+            });
+            const U mean_dyg = sum_dyg * inv_cols;
+            const U mean_dyg_xhat = sum_dyg_xhat * rstd * inv_cols;
+            for (int64_t j = 0; j < cols; ++j) {
+              const U xhat = (static_cast<U>(px[j]) - row_mean) * rstd;
+              pdx[j] = static_cast<T>(
+                  rstd * (dyg(j) - mean_dyg - xhat * mean_dyg_xhat));
+            }
+          }
+        });
+  }
+  if (dscale || dbias) {
+    dev_ctx.ParallelFor(
+        0, cols, NormColGrain(rows), [&](int64_t begin, int64_t end) {
+          std::vector<U> acc_scale(dscale ? end - begin : 0, 0);
+          std::vector<U> acc_bias(dbias ? end - begin : 0, 0);
+          for (int64_t r = 0; r < rows; ++r) {
+            const T* px = x + r * cols + begin;
+            const T* pdy = dy + r * cols + begin;
+            const U row_mean = mean[r];
+            const U rstd = static_cast<U>(1) / std::sqrt(var[r] + eps);
+            for (int64_t j = 0; j < end - begin; ++j) {
+              const U d = static_cast<U>(pdy[j]);
+              if (dbias) {
+                acc_bias[j] += d;
+              }
+              if (dscale) {
+                acc_scale[j] += d * (static_cast<U>(px[j]) - row_mean) * rstd;
+              }
+            }
+          }
+          for (int64_t j = 0; j < end - begin; ++j) {
+            if (dbias) {
+              dbias[begin + j] = static_cast<P>(acc_bias[j]);
+            }
+            if (dscale) {
+              dscale[begin + j] = static_cast<P>(acc_scale[j]);
+            }
+          }
+        });
+  }
+}
+
+// Normalizes one row of RmsNormForwardCPU, the optional inputs are template
+// arguments so that the loops carry no branches.
+template <typename T, bool kResidual, bool kNormBias>
+inline void RmsNormRow(const T* x,
+                       const T* bias,
+                       const T* residual,
+                       const T* weight,
+                       const T* norm_bias,
+                       int64_t cols,
+                       float epsilon,
+                       T* y,
+                       T* residual_out,
+                       float* inv_var) {
+  using U = typename phi::dtype::MPTypeTrait<T>::Type;
+  auto value = [&](int64_t j) {
+    U v = static_cast<U>(x[j]);
+    if constexpr (kResidual) {
+      v += static_cast<U>(residual[j]);
+      if (bias) {
+        v += static_cast<U>(bias[j]);
+      }
+    }
+    return v;
+  };
+  const U sum_square = RowLaneSum<U>(cols, [&](int64_t j) {
+    const U v = value(j);
+    if constexpr (kResidual) {
+      residual_out[j] = static_cast<T>(v);
+    }
+    return v * v;
+  });
+  const U inv =
+      static_cast<U>(1) / std::sqrt(sum_square / static_cast<U>(cols) +
+                                    static_cast<U>(epsilon));
+  if (inv_var) {
+    *inv_var = static_cast<float>(inv);
+  }
+  for (int64_t j = 0; j < cols; ++j) {
+    U out = value(j) * inv * static_cast<U>(weight[j]);
+    if constexpr (kNormBias) {
+      out += static_cast<U>(norm_bias[j]);
+    }
+    y[j] = static_cast<T>(out);
+  }
+}
+
+// y = v / sqrt(mean(v * v) + epsilon) * weight + norm_bias over the rows of
+// a [rows, cols] matrix, with v = x + residual + bias when a residual is
+// given, in which case v is also written to residual_out. inv_var, when not
+// null, receives the per row 1 / sqrt(mean(v * v) + epsilon).
+template <typename T>
+void RmsNormForwardCPU(const CPUContext& dev_ctx,
+                       const T* x,
+                       const T* bias,
+                       const T* residual,
+                       const T* weight,
+                       const T* norm_bias,
+                       int64_t rows,
+                       int64_t cols,
+                       float epsilon,
+                       T* y,
+                       T* residual_out,
+                       float* inv_var) {
+  auto row_func = residual
+                      ? (norm_bias ? &RmsNormRow<T, true, true>
+                                   : &RmsNormRow<T, true, false>)
+                      : (norm_bias ? &RmsNormRow<T, false, true>
+                                   : &RmsNormRow<T, false, false>);
+  dev_ctx.ParallelFor(
+      0, rows, NormRowGrain(cols), [&](int64_t begin, int64_t end) {
+        for (int64_t r = begin; r < end; ++r) {
+          row_func(x + r * cols,
+                   bias,
+                   residual ? residual + r * cols : nullptr,
+                   weight,
+                   norm_bias,
+                   cols,
+                   epsilon,
+                   y + r * cols,
+                   residual ? residual_out + r * cols : nullptr,
+                   inv_var ? inv_var + r : nullptr);
+        }
+      });
+}
+
+// The grad of RmsNormForwardCPU without residual, bias and norm_bias, any
+// of dx and dweight may be null.
+template <typename T>
+void RmsNormBackwardCPU(const CPUContext& dev_ctx,
+                        const T* x,
+                        const T* dy,
+                        const T* weight,
+                        const float* inv_var,
+                        int64_t rows,
+                        int64_t cols,
+                        T* dx,
+                        T* dweight) {
+  using U = typename phi::dtype::MPTypeTrait<T>::Type;
+  if (dx) {
+    const U inv_cols = static_cast<U>(1) / static_cast<U>(cols);
+    dev_ctx.ParallelFor(
+        0, rows, NormRowGrain(cols), [&](int64_t begin, int64_t end) {
+          for (int64_t r = begin; r < end; ++r) {
+            const T* px = x + r * cols;
+            const T* pdy = dy + r * cols;
+            T* pdx = dx + r * cols;
+            const U inv = static_cast<U>(inv_var[r]);
+            const U sum_dyw_x = RowLaneSum<U>(cols, [&](int64_t j) {
+              return static_cast<U>(pdy[j]) * static_cast<U>(weight[j]) *
+                     static_cast<U>(px[j]);
+            });
+            const U coeff = sum_dyw_x * inv * inv * inv_cols;
+            for (int64_t j = 0; j < cols; ++j) {
+              pdx[j] = static_cast<T>(
+                  inv * (static_cast<U>(pdy[j]) * static_cast<U>(weight[j]) -
+                         static_cast<U>(px[j]) * coeff));
+            }
+          }
+        });
+  }
+  if (dweight) {
+    dev_ctx.ParallelFor(
+        0, cols, NormColGrain(rows), [&](int64_t begin, int64_t end) {
+          std::vector<U> acc(end - begin, 0);
+          for (int64_t r = 0; r < rows; ++r) {
+            const T* px = x + r * cols + begin;
+            const T* pdy = dy + r * cols + begin;
+            const U inv = static_cast<U>(inv_var[r]);
+            for (int64_t j = 0; j < end - begin; ++j) {
+              acc[j] += static_cast<U>(pdy[j]) * static_cast<U>(px[j]) * inv;
+            }
+          }
+          for (int64_t j = 0; j < end - begin; ++j) {
+            dweight[begin + j] = static_cast<T>(acc[j]);
+          }
+        });
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -105,30 +105,16 @@ DEFINE_CPU_TRANS(6);
 
 template <typename DeviceContext, typename T>
 void TransposeNormal<DeviceContext, T>::operator()(
-    const DeviceContext& context UNUSED,
+    const DeviceContext& context,
     const phi::DenseTensor& in,
     phi::DenseTensor* out,
     const std::vector<int>& axis) {
-  const int rank = static_cast<const int>(axis.size());
-  auto in_stride = common::stride(in.dims());
-  auto out_stride = common::stride(out->dims());
-  const T* in_ptr = in.data<T>();
-  T* out_ptr = out->data<T>();
-
-  auto transpose_helper = [&](int64_t beg, int64_t end) {
-    for (int64_t out_idx = beg; out_idx < end; ++out_idx) {
-      int64_t in_idx = 0;
-      int64_t tmp_idx = out_idx;
-      // calculate the input index
-      for (int i = 0; i < rank; ++i) {
-        const int64_t coordinate = tmp_idx / out_stride[i];
-        tmp_idx -= coordinate * out_stride[i];
-        in_idx += coordinate * in_stride[axis[i]];
-      }
-      out_ptr[out_idx] = in_ptr[in_idx];
-    }
-  };
-  transpose_helper(0, out->numel());
+  TransposeCPU<T>(context,
+                  in.data<T>(),
+                  in.dims().Get(),
+                  static_cast<int>(axis.size()),
+                  axis.data(),
+                  out->data<T>());
 }
 
 // define transpose normal
@@ -14,11 +14,13 @@ limitations under the License. */
 
 #pragma once
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/transpose_cpu.h"
 
 namespace phi {
 namespace funcs {
@@ -49,6 +51,15 @@ void Transpose<DeviceContext, T, Rank>::operator()(
     const phi::DenseTensor& in,
     phi::DenseTensor* out,
     const std::vector<int>& axis) {
+  if constexpr (std::is_same<DeviceContext, phi::CPUContext>::value) {
+    TransposeCPU<T>(context,
+                    in.data<T>(),
+                    in.dims().Get(),
+                    Rank,
+                    axis.data(),
+                    out->data<T>());
+    return;
+  }
   Eigen::array<int, Rank> permute;
   for (int i = 0; i < Rank; i++) {
     permute[i] = axis[i];
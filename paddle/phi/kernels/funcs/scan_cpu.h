@@ -0,0 +1,240 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+
+namespace phi {
+namespace funcs {
+
+// Number of elements below which a scan runs on one thread, and the length
+// of the blocks a long scan is split into.
+constexpr int64_t kScanGrainSize = 32768;
+// Number of neighbouring inner positions scanned together when the scanned
+// axis is not the last one. Their accumulators are independent, so the
+// loops over them vectorize.
+constexpr int64_t kScanLanes = 64;
+
+// A scan walks a tensor viewed as [outer, mid, inner] along mid. The
+// element (o, j, k) is at the flat offset (o * mid + j) * inner + k. The
+// scan is described by an op with
+//
+//   using State = ...;
+//   State Identity() const;
+//   State Load(int64_t offset, int64_t j) const;  // state of one element
+//   State Merge(const State& a, const State& b) const;  // a comes first
+//   void Store(const State& acc, int64_t offset) const;
+//
+// Merge has to be associative, as long scans are split into blocks that are
+// reduced in parallel and merged afterwards. Every element is loaded before
+// its own result is stored, so the output may alias the input.
+
+// Scans the positions [p_begin, p_end) in scan order of `width` neighbouring
+// inner positions starting at `k0`, starting from and updating `acc`. With
+// kStore false the elements are only reduced into `acc`.
+template <bool kExclusive, bool kReverse, bool kStore, typename Op>
+inline void ScanTile(const Op& op,
+                     int64_t o,
+                     int64_t mid,
+                     int64_t inner,
+                     int64_t k0,
+                     int64_t width,
+                     int64_t p_begin,
+                     int64_t p_end,
+                     typename Op::State* acc) {
+  for (int64_t p = p_begin; p < p_end; ++p) {
+    const int64_t j = kReverse ? mid - 1 - p : p;
+    const int64_t offset = (o * mid + j) * inner + k0;
+    for (int64_t r = 0; r < width; ++r) {
+      const auto value = op.Load(offset + r, j);
+      if (kStore && kExclusive) {
+        op.Store(acc[r], offset + r);
+      }
+      acc[r] = op.Merge(acc[r], value);
+      if (kStore && !kExclusive) {
+        op.Store(acc[r], offset + r);
+      }
+    }
+  }
+}
+
+template <bool kExclusive, bool kReverse, typename Op>
+void ScanCPUImpl(const CPUContext& dev_ctx,
+                 const Op& op,
+                 int64_t outer,
+                 int64_t mid,
+                 int64_t inner) {
+  using State = typename Op::State;
+  const int64_t width = std::min(inner, kScanLanes);
+  const int64_t tiles = (inner + kScanLanes - 1) / kScanLanes;
+  const int64_t units = outer * tiles;
+  auto tile_of = [&](int64_t unit, int64_t* o, int64_t* k0, int64_t* w) {
+    *o = unit / tiles;
+    *k0 = (unit % tiles) * kScanLanes;
+    *w = std::min(kScanLanes, inner - *k0);
+  };
+
+  // Independent rows are enough to keep the threads busy, or the scan is
+  // too short to be split.
+  const int64_t block = std::max<int64_t>(1, kScanGrainSize / width);
+  if (units >= GetIntraOpNumThreads() || mid < 2 * block) {
+    const int64_t grain =
+        std::max<int64_t>(1, kScanGrainSize / (mid * width));
+    dev_ctx.ParallelFor(0, units, grain, [&](int64_t begin, int64_t end) {
+      State acc[kScanLanes];
+      for (int64_t unit = begin; unit < end; ++unit) {
+        int64_t o, k0, w;
+        tile_of(unit, &o, &k0, &w);
+        std::fill(acc, acc + w, op.Identity());
+        ScanTile<kExclusive, kReverse, true>(
+            op, o, mid, inner, k0, w, 0, mid, acc);
+      }
+    });
+    return;
+  }
+
+  // Few long scans take two parallel phases over blocks of the scanned axis:
+  // the first reduces every block, and after the block totals are scanned
+  // serially the second scans every block starting from the total of the
+  // blocks before it.
+  const int64_t blocks = (mid + block - 1) / block;
+  std::vector<State> carry(units * blocks * width);
+  dev_ctx.ParallelFor(0, units * blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      int64_t o, k0, w;
+      tile_of(i / blocks, &o, &k0, &w);
+      const int64_t b = i % blocks;
+      State* acc = carry.data() + i * width;
+      std::fill(acc, acc + w, op.Identity());
+      ScanTile<kExclusive, kReverse, false>(op,
+                                            o,
+                                            mid,
+                                            inner,
+                                            k0,
+                                            w,
+                                            b * block,
+                                            std::min(mid, (b + 1) * block),
+                                            acc);
+    }
+  });
+  for (int64_t unit = 0; unit < units; ++unit) {
+    State* totals = carry.data() + unit * blocks * width;
+    for (int64_t r = 0; r < width; ++r) {
+      State sum = op.Identity();
+      for (int64_t b = 0; b < blocks; ++b) {
+        const State total = totals[b * width + r];
+        totals[b * width + r] = sum;
+        sum = op.Merge(sum, total);
+      }
+    }
+  }
+  dev_ctx.ParallelFor(0, units * blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      int64_t o, k0, w;
+      tile_of(i / blocks, &o, &k0, &w);
+      const int64_t b = i % blocks;
+      ScanTile<kExclusive, kReverse, true>(op,
+                                           o,
+                                           mid,
+                                           inner,
+                                           k0,
+                                           w,
+                                           b * block,
+                                           std::min(mid, (b + 1) * block),
+                                           carry.data() + i * width);
+    }
+  });
+}
+
+// Runs the scan described by `op` along mid of [outer, mid, inner]. With
+// `exclusive` every result leaves out its own element and the first one is
+// the identity, with `reverse` the scan runs from the end of the axis.
+//
+// Rows, or tiles of kScanLanes inner positions, are split over the intra-op
+// threads of dev_ctx. When there are fewer of them than threads, long scans
+// are split into blocks of kScanGrainSize elements scanned in two phases.
+template <typename Op>
+void ScanCPU(const CPUContext& dev_ctx,
+             const Op& op,
+             int64_t outer,
+             int64_t mid,
+             int64_t inner,
+             bool exclusive,
+             bool reverse) {
+  if (outer == 0 || mid == 0 || inner == 0) {
+    return;
+  }
+  if (exclusive) {
+    if (reverse) {
+      ScanCPUImpl<true, true>(dev_ctx, op, outer, mid, inner);
+    } else {
+      ScanCPUImpl<true, false>(dev_ctx, op, outer, mid, inner);
+    }
+  } else {
+    if (reverse) {
+      ScanCPUImpl<false, true>(dev_ctx, op, outer, mid, inner);
+    } else {
+      ScanCPUImpl<false, false>(dev_ctx, op, outer, mid, inner);
+    }
+  }
+}
+
+// The scan op of the element-wise scans like cumsum and cumprod, where the
+// state is the value itself and `Functor` combines two values.
+template <typename T, typename Functor>
+struct ValueScanOp {
+  using State = T;
+
+  ValueScanOp(const T* x, T* out, T identity, Functor functor)
+      : x_(x), out_(out), identity_(identity), functor_(functor) {}
+
+  T Identity() const { return identity_; }
+  T Load(int64_t offset, int64_t) const { return x_[offset]; }
+  T Merge(const T& a, const T& b) const { return functor_(a, b); }
+  void Store(const T& acc, int64_t offset) const { out_[offset] = acc; }
+
+ private:
+  const T* x_;
+  T* out_;
+  T identity_;
+  Functor functor_;
+};
+
+// Scans `x` into `out` with `functor`, whose identity is `identity`.
+template <typename T, typename Functor>
+void ValueScanCPU(const CPUContext& dev_ctx,
+                  const T* x,
+                  T* out,
+                  int64_t outer,
+                  int64_t mid,
+                  int64_t inner,
+                  bool exclusive,
+                  bool reverse,
+                  T identity,
+                  Functor functor) {
+  ScanCPU(dev_ctx,
+          ValueScanOp<T, Functor>(x, out, identity, functor),
+          outer,
+          mid,
+          inner,
+          exclusive,
+          reverse);
+}
+
+}  // namespace funcs
+}  // namespace phi
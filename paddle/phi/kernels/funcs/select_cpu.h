@@ -0,0 +1,440 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/float16.h"
+
+namespace phi {
+namespace funcs {
+
+// Number of elements below which the rows of a selection or a sort run on
+// one thread, and the least length of the chunks a single row is split into.
+constexpr int64_t kSelectGrainSize = 32768;
+// Rows at least this many times longer than k keep the k entries in a heap,
+// which rarely changes after the start of a row. Other rows are selected
+// with introselect on their keys.
+constexpr int64_t kSelectHeapRatio = 64;
+// Least row length that is radix sorted, shorter rows use std::sort.
+constexpr int64_t kRadixSortMinWidth = 512;
+
+// Maps the values of a sort to unsigned keys with the same ascending order,
+// so that rows are compared as integers and can be radix sorted. NaN maps to
+// the largest key, it comes last in ascending and first in descending order
+// like in the comparators the kernels used before, and -0 maps to the key of
+// +0.
+template <typename T, typename Enable = void>
+struct SortKey;
+
+template <typename T>
+struct SortKey<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+  using Type = typename std::make_unsigned<T>::type;
+  static Type Of(T v) {
+    constexpr Type kSignBit = Type(1) << (sizeof(Type) * 8 - 1);
+    return static_cast<Type>(v) ^ kSignBit;
+  }
+};
+
+template <typename T>
+struct SortKey<
+    T,
+    typename std::enable_if<std::is_floating_point<T>::value>::type> {
+  using Type =
+      typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+  static Type Of(T v) {
+    constexpr Type kSignBit = Type(1) << (sizeof(Type) * 8 - 1);
+    if (std::isnan(v)) {
+      return ~Type(0);
+    }
+    if (v == 0) {
+      v = 0;
+    }
+    Type bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return (bits & kSignBit) ? ~bits : bits | kSignBit;
+  }
+};
+
+template <>
+struct SortKey<phi::dtype::float16> {
+  using Type = uint32_t;
+  static Type Of(phi::dtype::float16 v) {
+    return SortKey<float>::Of(static_cast<float>(v));
+  }
+};
+
+// A key and the index of its element in the row. Ties on the key are broken
+// by the index, so every order of the entries is the one of a stable sort.
+template <typename Key>
+struct SortEntry {
+  Key key;
+  int64_t index;
+
+  bool operator<(const SortEntry& other) const {
+    return key < other.key || (key == other.key && index < other.index);
+  }
+};
+
+// The row (o, r) of a tensor viewed as [outer, width, inner] along width,
+// with its keys complemented when the largest values come first.
+template <typename T>
+struct SortRow {
+  using Key = typename SortKey<T>::Type;
+
+  const T* x;
+  int64_t stride;
+  bool descending;
+
+  Key KeyAt(int64_t j) const {
+    const Key key = SortKey<T>::Of(x[j * stride]);
+    return descending ? static_cast<Key>(~key) : key;
+  }
+};
+
+// Keeps the k smallest entries of [begin, end) of the row in a max-heap,
+// which takes a single pass over the row, and appends them to `result`.
+template <typename T>
+void HeapSelect(const SortRow<T>& row,
+                int64_t begin,
+                int64_t end,
+                int64_t k,
+                std::vector<SortEntry<typename SortRow<T>::Key>>* heap,
+                std::vector<SortEntry<typename SortRow<T>::Key>>* result) {
+  heap->resize(k);
+  auto& h = *heap;
+  for (int64_t j = 0; j < k; ++j) {
+    h[j] = {row.KeyAt(begin + j), begin + j};
+  }
+  std::make_heap(h.begin(), h.end());
+  for (int64_t j = begin + k; j < end; ++j) {
+    // Later entries lose the ties, so the key alone decides.
+    const auto key = row.KeyAt(j);
+    if (key < h[0].key) {
+      std::pop_heap(h.begin(), h.end());
+      h[k - 1] = {key, j};
+      std::push_heap(h.begin(), h.end());
+    }
+  }
+  result->insert(result->end(), h.begin(), h.end());
+}
+
+// Finds the k-th smallest key of [begin, end) of the row with introselect
+// on the packed keys, then collects the entries below it and as many equal
+// to it as needed in one branch-light pass, and appends them to `result`.
+template <typename T>
+void IntroSelect(const SortRow<T>& row,
+                 int64_t begin,
+                 int64_t end,
+                 int64_t k,
+                 std::vector<typename SortRow<T>::Key>* keys,
+                 std::vector<typename SortRow<T>::Key>* scratch,
+                 std::vector<SortEntry<typename SortRow<T>::Key>>* result) {
+  using Key = typename SortRow<T>::Key;
+  const int64_t n = end - begin;
+  keys->resize(n);
+  for (int64_t j = 0; j < n; ++j) {
+    (*keys)[j] = row.KeyAt(begin + j);
+  }
+  scratch->assign(keys->begin(), keys->end());
+  std::nth_element(scratch->begin(), scratch->begin() + k - 1, scratch->end());
+  const Key threshold = (*scratch)[k - 1];
+  int64_t num_equal = k;
+  for (int64_t j = 0; j < k - 1; ++j) {
+    num_equal -= (*scratch)[j] < threshold;
+  }
+  for (int64_t j = 0; j < n; ++j) {
+    const Key key = (*keys)[j];
+    if (key < threshold || (key == threshold && num_equal-- > 0)) {
+      result->push_back({key, begin + j});
+    }
+  }
+}
+
+// Buffers of the selection of a row, reused across the rows of a thread.
+template <typename Key>
+struct SelectBuffers {
+  std::vector<Key> keys;
+  std::vector<Key> scratch;
+  std::vector<SortEntry<Key>> heap;
+};
+
+// Appends the k smallest entries of [begin, end) of the row to `result`.
+template <typename T>
+void SelectRange(const SortRow<T>& row,
+                 int64_t begin,
+                 int64_t end,
+                 int64_t k,
+                 SelectBuffers<typename SortRow<T>::Key>* buffers,
+                 std::vector<SortEntry<typename SortRow<T>::Key>>* result) {
+  if (k * kSelectHeapRatio <= end - begin) {
+    HeapSelect(row, begin, end, k, &buffers->heap, result);
+  } else {
+    IntroSelect(
+        row, begin, end, k, &buffers->keys, &buffers->scratch, result);
+  }
+}
+
+// Stable LSD radix sort of the entries by key with 8 bit digits. The passes
+// over digits that all keys share are skipped.
+template <typename Key>
+void RadixSort(std::vector<SortEntry<Key>>* entries,
+               std::vector<SortEntry<Key>>* buffer) {
+  const size_t n = entries->size();
+  buffer->resize(n);
+  std::array<std::array<int64_t, 256>, sizeof(Key)> counts{};
+  for (const auto& e : *entries) {
+    for (size_t d = 0; d < sizeof(Key); ++d) {
+      ++counts[d][(e.key >> (d * 8)) & 0xff];
+    }
+  }
+  auto* src = entries;
+  auto* dst = buffer;
+  for (size_t d = 0; d < sizeof(Key); ++d) {
+    auto& count = counts[d];
+    if (count[(src->front().key >> (d * 8)) & 0xff] ==
+        static_cast<int64_t>(n)) {
+      continue;
+    }
+    int64_t offset = 0;
+    for (auto& c : count) {
+      const int64_t size = c;
+      c = offset;
+      offset += size;
+    }
+    for (const auto& e : *src) {
+      (*dst)[count[(e.key >> (d * 8)) & 0xff]++] = e;
+    }
+    std::swap(src, dst);
+  }
+  if (src != entries) {
+    entries->swap(*buffer);
+  }
+}
+
+// Sorts the entries ascending by key and then by index.
+template <typename Key>
+void SortEntries(std::vector<SortEntry<Key>>* entries,
+                 std::vector<SortEntry<Key>>* buffer) {
+  if (static_cast<int64_t>(entries->size()) < kRadixSortMinWidth) {
+    std::sort(entries->begin(), entries->end());
+  } else {
+    RadixSort(entries, buffer);
+  }
+}
+
+// Number of chunks a single row of `width` elements is split into, 1 when
+// there are enough rows to keep the threads busy.
+inline int64_t SortRowChunks(int64_t rows, int64_t width) {
+  const int64_t num_threads = GetIntraOpNumThreads();
+  if (rows >= num_threads || width < 2 * kSelectGrainSize) {
+    return 1;
+  }
+  return std::min(num_threads, width / kSelectGrainSize);
+}
+
+// Writes the values and the indices of the entries of the row (o, r) to the
+// outputs viewed as [outer, entries.size(), inner].
+template <typename T, typename Key>
+void WriteSortedRow(const SortRow<T>& row,
+                    const SortEntry<Key>* entries,
+                    int64_t n,
+                    T* out,
+                    int64_t* indices) {
+  for (int64_t j = 0; j < n; ++j) {
+    out[j * row.stride] = row.x[entries[j].index * row.stride];
+    indices[j * row.stride] = entries[j].index;
+  }
+}
+
+// Selects the k largest, or smallest, values along the middle dim of `x`
+// viewed as [outer, width, inner], and writes them with their indices to
+// `out` and `indices` viewed as [outer, k, inner]. With `sorted` they come
+// in order, otherwise in any order.
+//
+// Values are compared through unsigned keys, NaN counting as larger than
+// any number. A k much smaller than the row is kept in a heap during one
+// pass over the row, larger ones are selected by introselect on the packed
+// keys.
+// Rows are split over the intra-op threads of dev_ctx. When there are fewer
+// rows than threads, long rows are split into chunks that are selected in
+// parallel before the candidates of the chunks are merged.
+template <typename T>
+void TopKCPU(const CPUContext& dev_ctx,
+             const T* x,
+             int64_t outer,
+             int64_t width,
+             int64_t inner,
+             int64_t k,
+             bool largest,
+             bool sorted,
+             T* out,
+             int64_t* indices) {
+  using Key = typename SortRow<T>::Key;
+  using Entry = SortEntry<Key>;
+  const int64_t rows = outer * inner;
+  if (rows == 0 || k == 0) {
+    return;
+  }
+  auto row_of = [&](int64_t i) {
+    const int64_t o = i / inner;
+    const int64_t r = i % inner;
+    return SortRow<T>{x + o * width * inner + r, inner, largest};
+  };
+  auto finish_row = [&](int64_t i,
+                        const SortRow<T>& row,
+                        std::vector<Entry>* entries) {
+    if (sorted) {
+      std::sort(entries->begin(), entries->end());
+    }
+    const int64_t offset = (i / inner) * k * inner + i % inner;
+    WriteSortedRow(row, entries->data(), k, out + offset, indices + offset);
+  };
+
+  const int64_t chunks = SortRowChunks(rows, width);
+  if (chunks == 1) {
+    const int64_t grain = std::max<int64_t>(1, kSelectGrainSize / width);
+    dev_ctx.ParallelFor(0, rows, grain, [&](int64_t begin, int64_t end) {
+      SelectBuffers<Key> buffers;
+      std::vector<Entry> entries;
+      for (int64_t i = begin; i < end; ++i) {
+        const auto row = row_of(i);
+        entries.clear();
+        SelectRange(row, 0, width, k, &buffers, &entries);
+        finish_row(i, row, &entries);
+      }
+    });
+    return;
+  }
+
+  const int64_t chunk_size = (width + chunks - 1) / chunks;
+  for (int64_t i = 0; i < rows; ++i) {
+    const auto row = row_of(i);
+    std::vector<std::vector<Entry>> candidates(chunks);
+    dev_ctx.ParallelFor(0, chunks, 1, [&](int64_t begin, int64_t end) {
+      SelectBuffers<Key> buffers;
+      for (int64_t c = begin; c < end; ++c) {
+        const int64_t c_begin = c * chunk_size;
+        const int64_t c_end = std::min(width, c_begin + chunk_size);
+        const int64_t c_k = std::min(k, c_end - c_begin);
+        SelectRange(row, c_begin, c_end, c_k, &buffers, &candidates[c]);
+      }
+    });
+    std::vector<Entry> merged;
+    for (auto& c : candidates) {
+      merged.insert(merged.end(), c.begin(), c.end());
+    }
+    std::nth_element(merged.begin(), merged.begin() + k - 1, merged.end());
+    merged.resize(k);
+    finish_row(i, row, &merged);
+  }
+}
+
+// Sorts `x` viewed as [outer, width, inner] along the middle dim, and writes
+// the sorted values and their indices to `out` and `indices` of the same
+// shape. The sort is stable in both directions.
+//
+// Rows of at least kRadixSortMinWidth elements are radix sorted on their
+// keys. Rows are split over the intra-op threads of dev_ctx. When there are
+// fewer rows than threads, long rows are split into chunks that are sorted
+// in parallel and then merged pairwise, the merges of a round in parallel.
+template <typename T>
+void ArgsortCPU(const CPUContext& dev_ctx,
+                const T* x,
+                int64_t outer,
+                int64_t width,
+                int64_t inner,
+                bool descending,
+                T* out,
+                int64_t* indices) {
+  using Key = typename SortRow<T>::Key;
+  using Entry = SortEntry<Key>;
+  const int64_t rows = outer * inner;
+  if (rows == 0 || width == 0) {
+    return;
+  }
+  auto row_of = [&](int64_t i) {
+    const int64_t offset = (i / inner) * width * inner + i % inner;
+    return SortRow<T>{x + offset, inner, descending};
+  };
+  auto write_row = [&](const SortRow<T>& row, const Entry* e) {
+    const int64_t offset = row.x - x;
+    WriteSortedRow(row, e, width, out + offset, indices + offset);
+  };
+
+  const int64_t chunks = SortRowChunks(rows, width);
+  if (chunks == 1) {
+    const int64_t grain = std::max<int64_t>(1, kSelectGrainSize / width);
+    dev_ctx.ParallelFor(0, rows, grain, [&](int64_t begin, int64_t end) {
+      std::vector<Entry> entries, buffer;
+      for (int64_t i = begin; i < end; ++i) {
+        const auto row = row_of(i);
+        entries.resize(width);
+        for (int64_t j = 0; j < width; ++j) {
+          entries[j] = {row.KeyAt(j), j};
+        }
+        SortEntries(&entries, &buffer);
+        write_row(row, entries.data());
+      }
+    });
+    return;
+  }
+
+  const int64_t chunk_size = (width + chunks - 1) / chunks;
+  std::vector<Entry> entries(width), merged(width);
+  for (int64_t i = 0; i < rows; ++i) {
+    const auto row = row_of(i);
+    dev_ctx.ParallelFor(0, chunks, 1, [&](int64_t begin, int64_t end) {
+      std::vector<Entry> part, buffer;
+      for (int64_t c = begin; c < end; ++c) {
+        const int64_t c_begin = c * chunk_size;
+        const int64_t c_end = std::min(width, c_begin + chunk_size);
+        part.resize(c_end - c_begin);
+        for (int64_t j = c_begin; j < c_end; ++j) {
+          part[j - c_begin] = {row.KeyAt(j), j};
+        }
+        SortEntries(&part, &buffer);
+        std::copy(part.begin(), part.end(), entries.begin() + c_begin);
+      }
+    });
+    for (int64_t run = chunk_size; run < width; run *= 2) {
+      const int64_t pairs = (width + 2 * run - 1) / (2 * run);
+      dev_ctx.ParallelFor(0, pairs, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t p = begin; p < end; ++p) {
+          const int64_t first = p * 2 * run;
+          const int64_t middle = std::min(width, first + run);
+          const int64_t last = std::min(width, first + 2 * run);
+          std::merge(entries.begin() + first,
+                     entries.begin() + middle,
+                     entries.begin() + middle,
+                     entries.begin() + last,
+                     merged.begin() + first);
+        }
+      });
+      entries.swap(merged);
+    }
+    write_row(row, entries.data());
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
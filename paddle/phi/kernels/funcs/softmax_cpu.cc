@@ -0,0 +1,254 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/softmax_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+// Number of elements exponentiated at once, small enough for a chunk to stay
+// in the L1 cache between the passes over it.
+constexpr int64_t kSoftmaxChunkSize = 256;
+// Number of elements below which the rows run on the calling thread.
+constexpr int64_t kSoftmaxGrainSize = 16384;
+
+// Shifted logits are clipped at -64 before exp like the Eigen softmax does,
+// so that no probability underflows to zero.
+template <typename T>
+inline T ClipShifted(T x) {
+  const T kThreshold = static_cast<T>(-64.);
+  return x < kThreshold ? kThreshold : x;
+}
+
+// The jit kVExp kernels are generated for a fixed length. The kernels for
+// the full chunks and for the tail of rows of `n` elements are looked up
+// once on the calling thread and shared with the workers.
+template <typename T>
+class ChunkedVExp {
+ public:
+  explicit ChunkedVExp(int64_t n)
+      : full_(std::min(n, kSoftmaxChunkSize)), tail_(n % kSoftmaxChunkSize) {
+    auto& cache = jit::KernelFuncs<jit::VExpTuple<T>, CPUPlace>::Cache();
+    full_func_ = cache.At(static_cast<int>(full_));
+    tail_func_ = tail_ > 0 ? cache.At(static_cast<int>(tail_)) : full_func_;
+  }
+
+  // `len` is either the full chunk or the tail length of the rows.
+  void operator()(const T* x, T* y, int64_t len) const {
+    auto func = len == full_ ? full_func_ : tail_func_;
+    func(x, y, static_cast<int>(len));
+  }
+
+ private:
+  int64_t full_;
+  int64_t tail_;
+  typename jit::VExpTuple<T>::func_type full_func_;
+  typename jit::VExpTuple<T>::func_type tail_func_;
+};
+
+// Softmax of one contiguous row in two passes, the first keeps the running
+// max and rescales the sum of exp whenever a chunk raises the max.
+template <typename T>
+void SoftmaxContiguousRow(const T* x,
+                          int64_t n,
+                          bool log,
+                          const ChunkedVExp<T>& vexp,
+                          T* out,
+                          T* log_sum_exp) {
+  T buf[kSoftmaxChunkSize];
+  T row_max = -std::numeric_limits<T>::infinity();
+  T sum = 0;
+  for (int64_t c0 = 0; c0 < n; c0 += kSoftmaxChunkSize) {
+    const int64_t len = std::min(kSoftmaxChunkSize, n - c0);
+    const T* px = x + c0;
+    T chunk_max = px[0];
+    for (int64_t j = 1; j < len; ++j) {
+      chunk_max = std::max(chunk_max, px[j]);
+    }
+    if (chunk_max > row_max) {
+      sum *= std::exp(row_max - chunk_max);
+      row_max = chunk_max;
+    } else if (std::isnan(chunk_max)) {
+      row_max = chunk_max;
+    }
+    for (int64_t j = 0; j < len; ++j) {
+      buf[j] = ClipShifted(px[j] - row_max);
+    }
+    vexp(buf, buf, len);
+    for (int64_t j = 0; j < len; ++j) {
+      sum += buf[j];
+    }
+  }
+
+  const T log_sum = std::log(sum);
+  if (log_sum_exp) {
+    *log_sum_exp = row_max + log_sum;
+  }
+  if (log) {
+    for (int64_t j = 0; j < n; ++j) {
+      out[j] = ClipShifted(x[j] - row_max) - log_sum;
+    }
+    return;
+  }
+  const T inv_sum = static_cast<T>(1) / sum;
+  for (int64_t c0 = 0; c0 < n; c0 += kSoftmaxChunkSize) {
+    const int64_t len = std::min(kSoftmaxChunkSize, n - c0);
+    T* py = out + c0;
+    for (int64_t j = 0; j < len; ++j) {
+      py[j] = ClipShifted(x[c0 + j] - row_max);
+    }
+    vexp(py, py, len);
+    for (int64_t j = 0; j < len; ++j) {
+      py[j] *= inv_sum;
+    }
+  }
+}
+
+// Softmax along the axis of `width` neighbouring rows of a [axis_dim, inner]
+// slab, where the rows are the columns of the slab. Every pass walks the
+// slab along its contiguous inner dim.
+template <typename T>
+void SoftmaxStridedRows(const T* x,
+                        int64_t axis_dim,
+                        int64_t inner,
+                        int64_t width,
+                        bool log,
+                        const ChunkedVExp<T>& vexp,
+                        T* out,
+                        T* log_sum_exp) {
+  T row_max[kSoftmaxChunkSize];
+  T sum[kSoftmaxChunkSize];
+  T buf[kSoftmaxChunkSize];
+  std::copy(x, x + width, row_max);
+  for (int64_t a = 1; a < axis_dim; ++a) {
+    const T* px = x + a * inner;
+    for (int64_t r = 0; r < width; ++r) {
+      row_max[r] = std::max(row_max[r], px[r]);
+    }
+  }
+  std::fill(sum, sum + width, static_cast<T>(0));
+  for (int64_t a = 0; a < axis_dim; ++a) {
+    const T* px = x + a * inner;
+    // The softmax keeps exp in out and only rescales it afterwards.
+    T* py = log ? buf : out + a * inner;
+    for (int64_t r = 0; r < width; ++r) {
+      py[r] = ClipShifted(px[r] - row_max[r]);
+    }
+    vexp(py, py, width);
+    for (int64_t r = 0; r < width; ++r) {
+      sum[r] += py[r];
+    }
+  }
+  for (int64_t r = 0; r < width; ++r) {
+    // From here on sum holds log(sum) for log-softmax and 1 / sum otherwise.
+    const T log_sum = std::log(sum[r]);
+    if (log_sum_exp) {
+      log_sum_exp[r] = row_max[r] + log_sum;
+    }
+    sum[r] = log ? log_sum : static_cast<T>(1) / sum[r];
+  }
+  for (int64_t a = 0; a < axis_dim; ++a) {
+    const T* px = x + a * inner;
+    T* py = out + a * inner;
+    if (log) {
+      for (int64_t r = 0; r < width; ++r) {
+        py[r] = ClipShifted(px[r] - row_max[r]) - sum[r];
+      }
+    } else {
+      for (int64_t r = 0; r < width; ++r) {
+        py[r] *= sum[r];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void SoftmaxForwardCPU(const CPUContext& dev_ctx,
+                       const T* x,
+                       int64_t outer,
+                       int64_t axis_dim,
+                       int64_t inner,
+                       bool log,
+                       T* out,
+                       T* log_sum_exp) {
+  if (outer == 0 || axis_dim == 0 || inner == 0) {
+    return;
+  }
+  if (inner == 1) {
+    const ChunkedVExp<T> vexp(axis_dim);
+    const int64_t grain = std::max<int64_t>(1, kSoftmaxGrainSize / axis_dim);
+    dev_ctx.ParallelFor(0, outer, grain, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        SoftmaxContiguousRow(x + i * axis_dim,
+                             axis_dim,
+                             log,
+                             vexp,
+                             out + i * axis_dim,
+                             log_sum_exp ? log_sum_exp + i : nullptr);
+      }
+    });
+    return;
+  }
+
+  const ChunkedVExp<T> vexp(inner);
+  const int64_t blocks = (inner + kSoftmaxChunkSize - 1) / kSoftmaxChunkSize;
+  const int64_t block_numel = axis_dim * std::min(inner, kSoftmaxChunkSize);
+  const int64_t grain = std::max<int64_t>(1, kSoftmaxGrainSize / block_numel);
+  auto rows = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const int64_t o = i / blocks;
+      const int64_t r0 = (i % blocks) * kSoftmaxChunkSize;
+      const int64_t offset = o * axis_dim * inner + r0;
+      SoftmaxStridedRows(x + offset,
+                         axis_dim,
+                         inner,
+                         std::min(kSoftmaxChunkSize, inner - r0),
+                         log,
+                         vexp,
+                         out + offset,
+                         log_sum_exp ? log_sum_exp + o * inner + r0 : nullptr);
+    }
+  };
+  dev_ctx.ParallelFor(0, outer * blocks, grain, rows);
+}
+
+template void SoftmaxForwardCPU<float>(const CPUContext& dev_ctx,
+                                       const float* x,
+                                       int64_t outer,
+                                       int64_t axis_dim,
+                                       int64_t inner,
+                                       bool log,
+                                       float* out,
+                                       float* log_sum_exp);
+template void SoftmaxForwardCPU<double>(const CPUContext& dev_ctx,
+                                        const double* x,
+                                        int64_t outer,
+                                        int64_t axis_dim,
+                                        int64_t inner,
+                                        bool log,
+                                        double* out,
+                                        double* log_sum_exp);
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,49 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+
+namespace phi {
+namespace funcs {
+
+// Computes the softmax, or the log-softmax when `log` is true, of `x` viewed
+// as [outer, axis_dim, inner] along the middle dim, so that any axis is
+// handled in place without a transpose. When `log_sum_exp` is not null it
+// receives log(sum(exp(x))) of each of the outer * inner rows, from which
+// the cross entropy of the logits follows without another pass over `out`.
+//
+// Rows along the last axis (inner == 1) take two passes: an online pass that
+// keeps the running max and the rescaled sum of exp over chunks of the row,
+// and a pass that writes the result. Other axes work on blocks of neighbouring
+// rows that are read along the contiguous inner dim. The exp of a chunk runs
+// through the jit kVExp kernel. Rows are split over the intra-op threads of
+// dev_ctx.
+//
+// Only float and double are instantiated.
+template <typename T>
+void SoftmaxForwardCPU(const CPUContext& dev_ctx,
+                       const T* x,
+                       int64_t outer,
+                       int64_t axis_dim,
+                       int64_t inner,
+                       bool log,
+                       T* out,
+                       T* log_sum_exp);
+
+}  // namespace funcs
+}  // namespace phi
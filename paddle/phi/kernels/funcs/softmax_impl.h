@@ -23,6 +23,7 @@ limitations under the License. */
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/funcs/cpu_vec.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
+#include "paddle/phi/kernels/funcs/softmax_cpu.h"
 
 namespace phi {
 namespace funcs {
@@ -245,28 +246,16 @@ class SoftmaxFunctor<DeviceContext, T, enable_if_CPU<DeviceContext>> {
     const int batch_size = in_dims[kBatchDim];
     const int num_remain = num_classes / axis_dim;
 
-    if (num_remain == 1 &&
-        phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
-      const T* in_data = X->data<T>();
-      T* out_data = Y->data<T>();
-      for (int bs = 0; bs < batch_size; ++bs) {
-        T max_val = *std::max_element(in_data, in_data + num_classes);
-        max_val *= static_cast<T>(-1);
-        vec_add_bias<T, phi::backends::cpu::avx>(
-            num_classes, max_val, in_data, out_data);
-        vec_clip<T, phi::backends::cpu::avx>(
-            num_classes, static_cast<T>(-64), out_data, out_data);
-        vec_exp<T>(num_classes, out_data, out_data);
-
-        T sum = 0;
-        vec_sum<T, phi::backends::cpu::avx>(num_classes, out_data, &sum);
-        sum = static_cast<T>(1) / sum;
-        vec_scal<T, phi::backends::cpu::avx>(
-            num_classes, sum, out_data, out_data);
-
-        in_data += num_classes;
-        out_data += num_classes;
-      }
+    if constexpr (std::is_same<T, float>::value ||
+                  std::is_same<T, double>::value) {
+      SoftmaxForwardCPU<T>(context,
+                           X->data<T>(),
+                           batch_size,
+                           axis_dim,
+                           num_remain,
+                           /*log=*/false,
+                           Y->data<T>(),
+                           /*log_sum_exp=*/nullptr);
     } else {
       SoftmaxEigen<DeviceContext, T>()(context, axis_dim, X, Y);
     }
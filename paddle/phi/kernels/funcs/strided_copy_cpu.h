@@ -0,0 +1,254 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+#include "paddle/common/ddim.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+
+namespace phi {
+namespace funcs {
+
+// Number of elements below which a strided copy runs on the calling thread.
+constexpr int64_t kStridedCopyGrainSize = 32768;
+// Edge of the square tiles used when a copy transposes the two innermost
+// dims, 16 elements keep both tiles of a float copy within the L1 cache.
+constexpr int64_t kStridedCopyTileSize = 16;
+
+// The dims of a strided copy after coalescing, outermost first.
+struct StridedCopyDims {
+  int rank = 0;
+  std::array<int64_t, DDim::kMaxRank> sizes;
+  std::array<int64_t, DDim::kMaxRank> src_strides;
+  std::array<int64_t, DDim::kMaxRank> dst_strides;
+  // True when two source elements may land on the same destination element,
+  // such copies keep the row-major order of the original dims and run
+  // serially so the last write wins as before.
+  bool dst_overlap = false;
+};
+
+// Drops the size-1 dims, orders the rest from the largest to the smallest
+// destination stride and merges the neighbours that are contiguous in both
+// the source and the destination. Returns false for an empty copy.
+inline bool CoalesceStridedCopyDims(const int64_t* dims,
+                                    const int64_t* src_strides,
+                                    const int64_t* dst_strides,
+                                    int rank,
+                                    StridedCopyDims* out) {
+  std::array<int, DDim::kMaxRank> order;
+  int kept = 0;
+  for (int i = 0; i < rank; ++i) {
+    if (dims[i] == 0) {
+      return false;
+    }
+    if (dims[i] == 1) {
+      continue;
+    }
+    out->dst_overlap |= dst_strides[i] == 0;
+    order[kept++] = i;
+  }
+  if (!out->dst_overlap) {
+    std::stable_sort(
+        order.begin(), order.begin() + kept, [&](int lhs, int rhs) {
+          return dst_strides[lhs] > dst_strides[rhs];
+        });
+  }
+
+  out->rank = 0;
+  for (int k = 0; k < kept; ++k) {
+    const int i = order[k];
+    const int last = out->rank - 1;
+    if (last >= 0 &&
+        out->src_strides[last] == src_strides[i] * dims[i] &&
+        out->dst_strides[last] == dst_strides[i] * dims[i]) {
+      out->sizes[last] *= dims[i];
+      out->src_strides[last] = src_strides[i];
+      out->dst_strides[last] = dst_strides[i];
+      continue;
+    }
+    out->sizes[out->rank] = dims[i];
+    out->src_strides[out->rank] = src_strides[i];
+    out->dst_strides[out->rank] = dst_strides[i];
+    ++out->rank;
+  }
+  if (out->rank == 0) {
+    out->rank = 1;
+    out->sizes[0] = 1;
+    out->src_strides[0] = 1;
+    out->dst_strides[0] = 1;
+  }
+  return true;
+}
+
+// Copies one row of `size` elements, with memcpy when both sides are dense.
+template <typename T>
+inline void StridedCopyRow(const T* src,
+                           int64_t src_stride,
+                           T* dst,
+                           int64_t dst_stride,
+                           int64_t size) {
+  if (src_stride == 1 && dst_stride == 1) {
+    std::memcpy(dst, src, size * sizeof(T));
+  } else if (src_stride == 0 && dst_stride == 1) {
+    std::fill_n(dst, size, *src);
+  } else {
+    for (int64_t i = 0; i < size; ++i) {
+      dst[i * dst_stride] = src[i * src_stride];
+    }
+  }
+}
+
+// Writes dst[r * dst_stride + c] = src[r + c * src_stride] for the rows in
+// [row_begin, row_end) and all `cols` columns, tile by tile so that the
+// strided side of the copy is read or written within the cache.
+template <typename T>
+inline void StridedCopyTranspose(const T* src,
+                                 int64_t src_stride,
+                                 T* dst,
+                                 int64_t dst_stride,
+                                 int64_t row_begin,
+                                 int64_t row_end,
+                                 int64_t cols) {
+  for (int64_t c0 = 0; c0 < cols; c0 += kStridedCopyTileSize) {
+    const int64_t c1 = std::min(c0 + kStridedCopyTileSize, cols);
+    for (int64_t r = row_begin; r < row_end; ++r) {
+      const T* in = src + r + c0 * src_stride;
+      T* out = dst + r * dst_stride + c0;
+      for (int64_t c = 0; c < c1 - c0; ++c) {
+        out[c] = in[c * src_stride];
+      }
+    }
+  }
+}
+
+// Copies the elements of a `rank`-D view of `src` into a view of `dst` with
+// the same dims, both described by element strides. The dims are coalesced
+// first, so that dense inner runs become a single memcpy and the copy of a
+// transposed view walks square tiles, and the outer dims are then split
+// across the intra-op threads of the CPUContext.
+template <typename T>
+void StridedCopyCPU(const CPUContext& dev_ctx,
+                    const T* src,
+                    const int64_t* src_strides,
+                    T* dst,
+                    const int64_t* dst_strides,
+                    const int64_t* dims,
+                    int rank) {
+  StridedCopyDims d;
+  if (!CoalesceStridedCopyDims(dims, src_strides, dst_strides, rank, &d)) {
+    return;
+  }
+  const int r = d.rank;
+  const int64_t inner = d.sizes[r - 1];
+  const int64_t inner_src = d.src_strides[r - 1];
+  const int64_t inner_dst = d.dst_strides[r - 1];
+
+  if (r == 1) {
+    const int64_t grain = d.dst_overlap ? inner : kStridedCopyGrainSize;
+    dev_ctx.ParallelFor(0, inner, grain, [&](int64_t begin, int64_t end) {
+      StridedCopyRow(src + begin * inner_src,
+                     inner_src,
+                     dst + begin * inner_dst,
+                     inner_dst,
+                     end - begin);
+    });
+    return;
+  }
+
+  const int64_t numel = std::accumulate(d.sizes.begin(),
+                                        d.sizes.begin() + r,
+                                        static_cast<int64_t>(1),
+                                        std::multiplies<int64_t>());
+
+  // The source is dense along the second innermost dim while the destination
+  // is dense along the innermost one, copy the two as a tiled transpose.
+  if (!d.dst_overlap && inner_dst == 1 && inner_src != 1 &&
+      d.src_strides[r - 2] == 1) {
+    const int64_t rows = d.sizes[r - 2];
+    const int64_t row_dst = d.dst_strides[r - 2];
+    const int64_t row_blocks =
+        (rows + kStridedCopyTileSize - 1) / kStridedCopyTileSize;
+    const int64_t outer = numel / (rows * inner);
+    const int64_t block_numel = kStridedCopyTileSize * inner;
+    const int64_t grain =
+        std::max<int64_t>(1, kStridedCopyGrainSize / block_numel);
+    dev_ctx.ParallelFor(
+        0, outer * row_blocks, grain, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            int64_t index = i / row_blocks;
+            int64_t src_offset = 0;
+            int64_t dst_offset = 0;
+            for (int k = r - 3; k >= 0; --k) {
+              const int64_t pos = index % d.sizes[k];
+              index /= d.sizes[k];
+              src_offset += pos * d.src_strides[k];
+              dst_offset += pos * d.dst_strides[k];
+            }
+            const int64_t row_begin = (i % row_blocks) * kStridedCopyTileSize;
+            StridedCopyTranspose(src + src_offset,
+                                 inner_src,
+                                 dst + dst_offset,
+                                 row_dst,
+                                 row_begin,
+                                 std::min(row_begin + kStridedCopyTileSize,
+                                          rows),
+                                 inner);
+          }
+        });
+    return;
+  }
+
+  // Every other pattern copies the innermost dim row by row, the index of
+  // the outer dims is computed once per range and then carried.
+  const int outer_rank = r - 1;
+  const int64_t outer = numel / inner;
+  const int64_t grain =
+      d.dst_overlap ? outer
+                    : std::max<int64_t>(1, kStridedCopyGrainSize / inner);
+  dev_ctx.ParallelFor(0, outer, grain, [&](int64_t begin, int64_t end) {
+    std::array<int64_t, DDim::kMaxRank> index;
+    int64_t src_offset = 0;
+    int64_t dst_offset = 0;
+    int64_t tmp = begin;
+    for (int k = outer_rank - 1; k >= 0; --k) {
+      index[k] = tmp % d.sizes[k];
+      tmp /= d.sizes[k];
+      src_offset += index[k] * d.src_strides[k];
+      dst_offset += index[k] * d.dst_strides[k];
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      StridedCopyRow(
+          src + src_offset, inner_src, dst + dst_offset, inner_dst, inner);
+      for (int k = outer_rank - 1; k >= 0; --k) {
+        src_offset += d.src_strides[k];
+        dst_offset += d.dst_strides[k];
+        if (++index[k] < d.sizes[k]) {
+          break;
+        }
+        src_offset -= d.src_strides[k] * d.sizes[k];
+        dst_offset -= d.dst_strides[k] * d.sizes[k];
+        index[k] = 0;
+      }
+    }
+  });
+}
+
+}  // namespace funcs
+}  // namespace phi
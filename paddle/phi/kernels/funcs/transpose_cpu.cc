@@ -0,0 +1,366 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/transpose_cpu.h"
+
+#include <algorithm>
+#include <array>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/complex.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/common/float8_e4m3fn.h"
+#include "paddle/phi/common/float8_e5m2.h"
+#include "paddle/phi/kernels/funcs/strided_copy_cpu.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+// Number of elements below which a transpose runs on the calling thread.
+constexpr int64_t kTransposeGrainSize = 32768;
+// Edge of the blocks a 2-D transpose is split into, a block of floats and
+// its transpose take 32KB together.
+constexpr int64_t kTransposeBlockSize = 64;
+
+// Edge of the register tiles, a row of a tile fills a SSE2 register for 1-
+// and 2-byte types and an AVX register for 4-byte types.
+template <typename T>
+constexpr int64_t TileSize() {
+  return sizeof(T) == 1 ? 16 : 8;
+}
+
+#ifdef __SSE2__
+template <int kBytes>
+inline __m128i UnpackLo(__m128i a, __m128i b);
+template <int kBytes>
+inline __m128i UnpackHi(__m128i a, __m128i b);
+
+template <>
+inline __m128i UnpackLo<1>(__m128i a, __m128i b) {
+  return _mm_unpacklo_epi8(a, b);
+}
+template <>
+inline __m128i UnpackHi<1>(__m128i a, __m128i b) {
+  return _mm_unpackhi_epi8(a, b);
+}
+template <>
+inline __m128i UnpackLo<2>(__m128i a, __m128i b) {
+  return _mm_unpacklo_epi16(a, b);
+}
+template <>
+inline __m128i UnpackHi<2>(__m128i a, __m128i b) {
+  return _mm_unpackhi_epi16(a, b);
+}
+template <>
+inline __m128i UnpackLo<4>(__m128i a, __m128i b) {
+  return _mm_unpacklo_epi32(a, b);
+}
+template <>
+inline __m128i UnpackHi<4>(__m128i a, __m128i b) {
+  return _mm_unpackhi_epi32(a, b);
+}
+template <>
+inline __m128i UnpackLo<8>(__m128i a, __m128i b) {
+  return _mm_unpacklo_epi64(a, b);
+}
+template <>
+inline __m128i UnpackHi<8>(__m128i a, __m128i b) {
+  return _mm_unpackhi_epi64(a, b);
+}
+
+// Interleaves the pairs of neighbouring rows in units of kBytes, starting
+// with single elements and doubling up to 8 bytes. After the last step row
+// j holds the column whose index is j with its bits reversed.
+template <int kRows, int kBytes>
+inline void InterleaveRows(__m128i* rows) {
+  if constexpr (kBytes < 16) {
+    __m128i next[kRows];
+    for (int j = 0; j < kRows / 2; ++j) {
+      next[j] = UnpackLo<kBytes>(rows[2 * j], rows[2 * j + 1]);
+      next[j + kRows / 2] = UnpackHi<kBytes>(rows[2 * j], rows[2 * j + 1]);
+    }
+    std::copy(next, next + kRows, rows);
+    InterleaveRows<kRows, kBytes * 2>(rows);
+  }
+}
+
+constexpr int BitReverse(int j, int bits) {
+  int r = 0;
+  for (int b = 0; b < bits; ++b) {
+    r |= ((j >> b) & 1) << (bits - 1 - b);
+  }
+  return r;
+}
+
+// Transposes a tile of kRows rows of 16 bytes, the strides are in bytes.
+template <int kRows>
+inline void TransposeTileSSE2(const char* src,
+                              int64_t src_ld,
+                              char* dst,
+                              int64_t dst_ld) {
+  constexpr int kBits = kRows == 16 ? 4 : 3;
+  __m128i rows[kRows];
+  for (int j = 0; j < kRows; ++j) {
+    rows[j] =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j * src_ld));
+  }
+  InterleaveRows<kRows, 16 / kRows>(rows);
+  for (int j = 0; j < kRows; ++j) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + BitReverse(j, kBits) * dst_ld),
+        rows[j]);
+  }
+}
+#endif
+
+#ifdef __AVX__
+// Transposes a tile of 8x8 floats in eight AVX registers.
+inline void TransposeTileAVX(const float* src,
+                             int64_t src_ld,
+                             float* dst,
+                             int64_t dst_ld) {
+  __m256 r[8], t[8], s[8];
+  for (int i = 0; i < 8; ++i) {
+    r[i] = _mm256_loadu_ps(src + i * src_ld);
+  }
+  for (int i = 0; i < 4; ++i) {
+    t[2 * i] = _mm256_unpacklo_ps(r[2 * i], r[2 * i + 1]);
+    t[2 * i + 1] = _mm256_unpackhi_ps(r[2 * i], r[2 * i + 1]);
+  }
+  for (int i = 0; i < 2; ++i) {
+    s[4 * i] = _mm256_shuffle_ps(t[4 * i], t[4 * i + 2], 0x44);
+    s[4 * i + 1] = _mm256_shuffle_ps(t[4 * i], t[4 * i + 2], 0xEE);
+    s[4 * i + 2] = _mm256_shuffle_ps(t[4 * i + 1], t[4 * i + 3], 0x44);
+    s[4 * i + 3] = _mm256_shuffle_ps(t[4 * i + 1], t[4 * i + 3], 0xEE);
+  }
+  for (int i = 0; i < 4; ++i) {
+    _mm256_storeu_ps(dst + i * dst_ld,
+                     _mm256_permute2f128_ps(s[i], s[i + 4], 0x20));
+    _mm256_storeu_ps(dst + (i + 4) * dst_ld,
+                     _mm256_permute2f128_ps(s[i], s[i + 4], 0x31));
+  }
+}
+#endif
+
+// Writes dst[a * dst_ld + b] = src[a + b * src_ld] for a full tile, the
+// rows of the tile are read along a and written along b.
+template <typename T>
+inline void TransposeTile(const T* src,
+                          int64_t src_ld,
+                          T* dst,
+                          int64_t dst_ld) {
+#ifdef __AVX__
+  if constexpr (sizeof(T) == 4) {
+    TransposeTileAVX(reinterpret_cast<const float*>(src),
+                     src_ld,
+                     reinterpret_cast<float*>(dst),
+                     dst_ld);
+    return;
+  }
+#endif
+#ifdef __SSE2__
+  if constexpr (sizeof(T) <= 2) {
+    TransposeTileSSE2<TileSize<T>()>(reinterpret_cast<const char*>(src),
+                                     src_ld * sizeof(T),
+                                     reinterpret_cast<char*>(dst),
+                                     dst_ld * sizeof(T));
+    return;
+  }
+#endif
+  constexpr int64_t kTile = TileSize<T>();
+  for (int64_t a = 0; a < kTile; ++a) {
+    for (int64_t b = 0; b < kTile; ++b) {
+      dst[a * dst_ld + b] = src[a + b * src_ld];
+    }
+  }
+}
+
+// Transposes the block [a_begin, a_end) x [b_begin, b_end) tile by tile,
+// the edges narrower than a tile are copied element by element.
+template <typename T>
+void TransposeBlock(const T* src,
+                    int64_t src_ld,
+                    T* dst,
+                    int64_t dst_ld,
+                    int64_t a_begin,
+                    int64_t a_end,
+                    int64_t b_begin,
+                    int64_t b_end) {
+  constexpr int64_t kTile = TileSize<T>();
+  const int64_t a_full = a_begin + (a_end - a_begin) / kTile * kTile;
+  const int64_t b_full = b_begin + (b_end - b_begin) / kTile * kTile;
+  for (int64_t b = b_begin; b < b_full; b += kTile) {
+    for (int64_t a = a_begin; a < a_full; a += kTile) {
+      TransposeTile(src + a + b * src_ld, src_ld, dst + a * dst_ld + b, dst_ld);
+    }
+  }
+  for (int64_t a = a_begin; a < a_end; ++a) {
+    for (int64_t b = a < a_full ? b_full : b_begin; b < b_end; ++b) {
+      dst[a * dst_ld + b] = src[a + b * src_ld];
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void TransposeCPU(const CPUContext& dev_ctx,
+                  const T* x,
+                  const int64_t* dims,
+                  int rank,
+                  const int* axis,
+                  T* out) {
+  // The transpose is the copy of x, read with its strides permuted, into the
+  // dense out.
+  std::array<int64_t, DDim::kMaxRank> x_strides;
+  std::array<int64_t, DDim::kMaxRank> out_dims;
+  std::array<int64_t, DDim::kMaxRank> src_strides;
+  std::array<int64_t, DDim::kMaxRank> dst_strides;
+  int64_t stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    x_strides[i] = stride;
+    stride *= dims[i];
+  }
+  stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    out_dims[i] = dims[axis[i]];
+    src_strides[i] = x_strides[axis[i]];
+    dst_strides[i] = stride;
+    stride *= out_dims[i];
+  }
+  StridedCopyDims d;
+  if (!CoalesceStridedCopyDims(out_dims.data(),
+                               src_strides.data(),
+                               dst_strides.data(),
+                               rank,
+                               &d)) {
+    return;
+  }
+
+  // Dims of size 1 are dropped, so the dim contiguous in x is the only one
+  // of stride 1. When it is also the innermost dim of out every row is a
+  // dense copy.
+  const int r = d.rank;
+  int k = 0;
+  while (k < r - 1 && d.src_strides[k] != 1) {
+    ++k;
+  }
+  if (k == r - 1) {
+    StridedCopyCPU(dev_ctx,
+                   x,
+                   d.src_strides.data(),
+                   out,
+                   d.dst_strides.data(),
+                   d.sizes.data(),
+                   r);
+    return;
+  }
+
+  // A batch of 2-D transposes from dim k, dense in x, to the innermost dim,
+  // dense in out. Every other dim is part of the batch.
+  const int64_t rows = d.sizes[k];
+  const int64_t cols = d.sizes[r - 1];
+  const int64_t src_ld = d.src_strides[r - 1];
+  const int64_t dst_ld = d.dst_strides[k];
+  std::array<int, DDim::kMaxRank> batch_dims;
+  int batch_rank = 0;
+  int64_t batch = 1;
+  for (int i = 0; i < r - 1; ++i) {
+    if (i != k) {
+      batch_dims[batch_rank++] = i;
+      batch *= d.sizes[i];
+    }
+  }
+
+  // Blocks are square unless one side is narrower than a block, then they
+  // stretch along the other side to keep their number of elements.
+  int64_t block_a = std::min(rows, kTransposeBlockSize);
+  int64_t block_b = std::min(cols, kTransposeBlockSize);
+  constexpr int64_t kBlockNumel = kTransposeBlockSize * kTransposeBlockSize;
+  if (block_a < kTransposeBlockSize) {
+    block_b = std::min(cols,
+                       kBlockNumel / block_a / kTransposeBlockSize *
+                           kTransposeBlockSize);
+  } else if (block_b < kTransposeBlockSize) {
+    block_a = std::min(rows,
+                       kBlockNumel / block_b / kTransposeBlockSize *
+                           kTransposeBlockSize);
+  }
+  const int64_t a_blocks = (rows + block_a - 1) / block_a;
+  const int64_t b_blocks = (cols + block_b - 1) / block_b;
+  const int64_t grain =
+      std::max<int64_t>(1, kTransposeGrainSize / (block_a * block_b));
+  dev_ctx.ParallelFor(
+      0, batch * a_blocks * b_blocks, grain, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          int64_t index = i / (a_blocks * b_blocks);
+          int64_t src_offset = 0;
+          int64_t dst_offset = 0;
+          for (int j = batch_rank - 1; j >= 0; --j) {
+            const int dim = batch_dims[j];
+            const int64_t pos = index % d.sizes[dim];
+            index /= d.sizes[dim];
+            src_offset += pos * d.src_strides[dim];
+            dst_offset += pos * d.dst_strides[dim];
+          }
+          const int64_t a_begin = i / b_blocks % a_blocks * block_a;
+          const int64_t b_begin = i % b_blocks * block_b;
+          TransposeBlock(x + src_offset,
+                         src_ld,
+                         out + dst_offset,
+                         dst_ld,
+                         a_begin,
+                         std::min(rows, a_begin + block_a),
+                         b_begin,
+                         std::min(cols, b_begin + block_b));
+        }
+      });
+}
+
+#define INSTANTIATE_TRANSPOSE_CPU(T)                      \
+  template void TransposeCPU<T>(const CPUContext& dev_ctx, \
+                                const T* x,                \
+                                const int64_t* dims,       \
+                                int rank,                  \
+                                const int* axis,           \
+                                T* out)
+
+INSTANTIATE_TRANSPOSE_CPU(phi::dtype::float8_e4m3fn);
+INSTANTIATE_TRANSPOSE_CPU(phi::dtype::float8_e5m2);
+INSTANTIATE_TRANSPOSE_CPU(phi::dtype::float16);
+INSTANTIATE_TRANSPOSE_CPU(phi::dtype::bfloat16);
+INSTANTIATE_TRANSPOSE_CPU(float);
+INSTANTIATE_TRANSPOSE_CPU(double);
+INSTANTIATE_TRANSPOSE_CPU(int);
+INSTANTIATE_TRANSPOSE_CPU(int64_t);
+INSTANTIATE_TRANSPOSE_CPU(bool);
+INSTANTIATE_TRANSPOSE_CPU(int16_t);
+INSTANTIATE_TRANSPOSE_CPU(uint8_t);
+INSTANTIATE_TRANSPOSE_CPU(int8_t);
+INSTANTIATE_TRANSPOSE_CPU(phi::dtype::complex<float>);
+INSTANTIATE_TRANSPOSE_CPU(phi::dtype::complex<double>);
+
+#undef INSTANTIATE_TRANSPOSE_CPU
+
+}  // namespace funcs
+}  // namespace phi
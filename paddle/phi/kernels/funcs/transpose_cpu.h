@@ -0,0 +1,43 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+
+namespace phi {
+namespace funcs {
+
+// Writes into the dense `out` the dense `x` of `rank` dims `dims` with its
+// dims permuted by `axis`, so that dim i of `out` is dim axis[i] of `x`.
+//
+// The dims are coalesced first, which turns any permutation into a batch of
+// 2-D transposes between the dim that is contiguous in `x` and the one that
+// is contiguous in `out`, or into a copy of dense rows when they are the
+// same. The 2-D transposes walk blocks that fit in the cache, split over the
+// intra-op threads of dev_ctx, and move the elements of a block through
+// square register tiles: 8x8 with AVX for 4-byte types, 8x8 and 16x16 with
+// SSE2 for 2-byte and 1-byte types.
+template <typename T>
+void TransposeCPU(const CPUContext& dev_ctx,
+                  const T* x,
+                  const int64_t* dims,
+                  int rank,
+                  const int* axis,
+                  T* out);
+
+}  // namespace funcs
+}  // namespace phi
@@ -13,7 +13,14 @@
 // limitations under the License.
 
 #pragma once
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <numeric>
 #include <set>
+#include <type_traits>
 
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/utils/data_type.h"
@@ -23,6 +30,183 @@
 namespace phi {
 namespace funcs {
 
+// The integer inputs are uniqued by a radix sort, and by an open addressing
+// hash table if the unique values keep the order of their first appearance.
+template <typename T>
+struct IsRadixUniqueType
+    : std::integral_constant<bool,
+                             std::is_integral<T>::value &&
+                                 !std::is_same<T, bool>::value> {};
+
+// Inputs with fewer elements are uniqued by one thread.
+constexpr int64_t kParallelUniqueNumel = 1 << 16;
+
+// Calls func(chunk_id, begin, end) for the num_chunks chunks of [0, numel).
+// The chunks are distributed by an omp for loop, so all of them run even if
+// OpenMP provides fewer threads than requested, e.g. when nested.
+template <typename Func>
+inline void UniqueParallelFor(int num_chunks, int64_t numel, Func func) {
+  int64_t chunk_size = (numel + num_chunks - 1) / num_chunks;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+#endif
+  for (int chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
+    int64_t begin = std::min(numel, chunk_id * chunk_size);
+    int64_t end = std::min(numel, begin + chunk_size);
+    func(chunk_id, begin, end);
+  }
+}
+
+// Sorts the integers in_data[0, numel) with their positions by a stable LSD
+// radix sort of 8 bits digits. The histograms and the scatters of each pass
+// run on the chunks of the threads, and the passes of a digit equal for all
+// the values are skipped, e.g. the high bytes of small ids.
+template <typename T, typename IndexT>
+void RadixSortWithPositions(const T* in_data,
+                            int64_t numel,
+                            std::vector<T>* values,
+                            std::vector<IndexT>* positions) {
+  using KeyT = typename std::make_unsigned<T>::type;
+  constexpr int kRadixBits = 8;
+  constexpr int kRadixSize = 1 << kRadixBits;
+  // flips the sign bit so that the unsigned keys keep the order
+  const KeyT sign_flip =
+      std::is_signed<T>::value
+          ? static_cast<KeyT>(KeyT(1) << (sizeof(KeyT) * 8 - 1))
+          : KeyT(0);
+
+  values->assign(in_data, in_data + numel);
+  positions->resize(numel);
+  std::iota(positions->begin(), positions->end(), 0);
+  std::vector<T> values_buffer(numel);
+  std::vector<IndexT> positions_buffer(numel);
+  T* src = values->data();
+  T* dst = values_buffer.data();
+  IndexT* src_pos = positions->data();
+  IndexT* dst_pos = positions_buffer.data();
+
+  int num_threads = 1;
+#ifdef PADDLE_WITH_MKLML
+  if (numel >= kParallelUniqueNumel) {
+    num_threads = std::max(omp_get_max_threads(), 1);
+  }
+#endif
+  std::vector<int64_t> histograms(num_threads * kRadixSize);
+  for (size_t pass = 0; pass < sizeof(T); ++pass) {
+    int shift = static_cast<int>(pass) * kRadixBits;
+    auto digit = [=](T value) {
+      return static_cast<int>(
+          ((static_cast<KeyT>(value) ^ sign_flip) >> shift) &
+          (kRadixSize - 1));
+    };
+    std::fill(histograms.begin(), histograms.end(), 0);
+    UniqueParallelFor(num_threads, numel, [&](int chunk, int64_t b, int64_t e) {
+      int64_t* histogram = histograms.data() + chunk * kRadixSize;
+      for (int64_t i = b; i < e; ++i) {
+        ++histogram[digit(src[i])];
+      }
+    });
+
+    // The offsets of a digit are ordered by the chunks to keep stable
+    int64_t offset = 0;
+    bool same_digit = false;
+    for (int d = 0; d < kRadixSize; ++d) {
+      int64_t begin = offset;
+      for (int t = 0; t < num_threads; ++t) {
+        int64_t count = histograms[t * kRadixSize + d];
+        histograms[t * kRadixSize + d] = offset;
+        offset += count;
+      }
+      same_digit = same_digit || (offset - begin == numel);
+    }
+    if (same_digit) {
+      continue;
+    }
+
+    UniqueParallelFor(num_threads, numel, [&](int chunk, int64_t b, int64_t e) {
+      int64_t* offsets = histograms.data() + chunk * kRadixSize;
+      for (int64_t i = b; i < e; ++i) {
+        int64_t o = offsets[digit(src[i])]++;
+        dst[o] = src[i];
+        dst_pos[o] = src_pos[i];
+      }
+    });
+    std::swap(src, dst);
+    std::swap(src_pos, dst_pos);
+  }
+  if (src != values->data()) {
+    values->swap(values_buffer);
+    positions->swap(positions_buffer);
+  }
+}
+
+// Open addressing hash table from the integers to their ids in the order of
+// the first appearance, the table grows to keep the load under 1/2.
+template <typename T>
+class UniqueHashTable {
+ public:
+  explicit UniqueHashTable(int64_t expected_size) {
+    int64_t capacity = 16;
+    while (capacity < 2 * expected_size && capacity < (1LL << 20)) {
+      capacity <<= 1;
+    }
+    Rehash(capacity);
+  }
+
+  // Returns the id of value, which is size() before the call if value is new.
+  int64_t Insert(T value) {
+    int64_t slot = Find(value);
+    if (ids_[slot] >= 0) {
+      return ids_[slot];
+    }
+    int64_t id = size_++;
+    keys_[slot] = value;
+    ids_[slot] = id;
+    if (2 * size_ > static_cast<int64_t>(ids_.size())) {
+      Rehash(ids_.size() * 2);
+    }
+    return id;
+  }
+
+  int64_t size() const { return size_; }
+
+ private:
+  int64_t Find(T value) const {
+    // Fibonacci hashing spreads the sequential ids over the slots
+    uint64_t hash = static_cast<uint64_t>(value) * 0x9E3779B97F4A7C15ULL;
+    int64_t slot = static_cast<int64_t>(hash >> shift_);
+    while (ids_[slot] >= 0 && keys_[slot] != value) {
+      slot = (slot + 1) & mask_;
+    }
+    return slot;
+  }
+
+  void Rehash(int64_t capacity) {
+    std::vector<T> keys(capacity);
+    std::vector<int64_t> ids(capacity, -1);
+    keys_.swap(keys);
+    ids_.swap(ids);
+    mask_ = capacity - 1;
+    shift_ = 64;
+    for (int64_t c = capacity; c > 1; c >>= 1) {
+      --shift_;
+    }
+    for (size_t i = 0; i < ids.size(); ++i) {
+      if (ids[i] >= 0) {
+        int64_t slot = Find(keys[i]);
+        keys_[slot] = keys[i];
+        ids_[slot] = ids[i];
+      }
+    }
+  }
+
+  std::vector<T> keys_;
+  std::vector<int64_t> ids_;
+  int64_t mask_ = 0;
+  int shift_ = 64;
+  int64_t size_ = 0;
+};
+
 template <typename Context, typename InT>
 struct UniqueOpFunctor {
   const Context& context_;
@@ -43,11 +227,8 @@ struct UniqueOpFunctor {
     auto* in_data = in_->data<InT>();
     auto* index_data = context_.template Alloc<IndexT>(index_);
 
-    int64_t j = 0;
-
-    // TODO(fangzeyang): Should optimize performance here.
-    std::unordered_map<InT, int64_t> dict;
     std::vector<InT> uniq;
+    std::vector<int64_t> counts;
 
     PADDLE_ENFORCE_LT(
         in_->numel(),
@@ -57,24 +238,12 @@ struct UniqueOpFunctor {
             "but received num is %d.",
             in_->numel()));
 
-    for (auto i = 0; i < in_->numel(); i++) {
-      auto it = dict.find(in_data[i]);
-      if (it == dict.end()) {
-        dict.emplace(std::make_pair(in_data[i], j));
-        uniq.emplace_back(in_data[i]);
-        index_data[i] = static_cast<IndexT>(j);
-        j++;
-      } else {
-        index_data[i] = static_cast<IndexT>(it->second);
-      }
-    }
+    UniqueInOrder(in_data, in_->numel(), index_data, &uniq, &counts);
 
     if (count_ != nullptr) {
       // Resize the count tensor dims to allocate the memory
       count_->Resize(common::make_ddim({static_cast<int64_t>(uniq.size())}));
       IndexT* count_data = context_.template Alloc<IndexT>(count_);
-      // init count_data to 0
-      memset(count_data, 0, uniq.size() * sizeof(IndexT));
 
       const auto& index_type = index_->dtype();
       bool index_type_match =
@@ -88,16 +257,8 @@ struct UniqueOpFunctor {
                             DataTypeToString(DataType::INT32),
                             DataTypeToString(DataType::INT64)));
 
-      if (index_type == DataType::INT32) {
-        for (auto i = 0; i < in_->numel(); ++i) {
-          const IndexT& index = index_data[i];
-          count_data[static_cast<int32_t>(index)] += static_cast<IndexT>(1);
-        }
-      } else {
-        for (auto i = 0; i < in_->numel(); ++i) {
-          const IndexT& index = index_data[i];
-          count_data[static_cast<int64_t>(index)] += static_cast<IndexT>(1);
-        }
+      for (size_t i = 0; i < uniq.size(); ++i) {
+        count_data[i] = static_cast<IndexT>(counts[i]);
       }
     }
 
@@ -105,6 +266,52 @@ struct UniqueOpFunctor {
     auto* out_data = context_.template Alloc<InT>(out_);
     std::memcpy(out_data, uniq.data(), uniq.size() * sizeof(InT));
   }
+
+ private:
+  // Unique in the order of the first appearance, index_data is the id of
+  // each element in uniq, and counts is the number of each unique value.
+  template <typename IndexT, typename T = InT>
+  static typename std::enable_if<IsRadixUniqueType<T>::value>::type
+  UniqueInOrder(const T* in_data,
+                int64_t numel,
+                IndexT* index_data,
+                std::vector<T>* uniq,
+                std::vector<int64_t>* counts) {
+    UniqueHashTable<T> table(numel);
+    for (int64_t i = 0; i < numel; ++i) {
+      int64_t id = table.Insert(in_data[i]);
+      if (id == static_cast<int64_t>(uniq->size())) {
+        uniq->emplace_back(in_data[i]);
+        counts->emplace_back(0);
+      }
+      index_data[i] = static_cast<IndexT>(id);
+      ++(*counts)[id];
+    }
+  }
+
+  template <typename IndexT, typename T = InT>
+  static typename std::enable_if<!IsRadixUniqueType<T>::value>::type
+  UniqueInOrder(const T* in_data,
+                int64_t numel,
+                IndexT* index_data,
+                std::vector<T>* uniq,
+                std::vector<int64_t>* counts) {
+    int64_t j = 0;
+    std::unordered_map<T, int64_t> dict;
+    for (int64_t i = 0; i < numel; i++) {
+      auto it = dict.find(in_data[i]);
+      if (it == dict.end()) {
+        dict.emplace(std::make_pair(in_data[i], j));
+        uniq->emplace_back(in_data[i]);
+        counts->emplace_back(1);
+        index_data[i] = static_cast<IndexT>(j);
+        j++;
+      } else {
+        index_data[i] = static_cast<IndexT>(it->second);
+        ++(*counts)[it->second];
+      }
+    }
+  }
 };
 
 static std::vector<DenseTensor> Unbind(const DenseTensor& in) {
@@ -130,15 +337,16 @@ static bool Equal(const DenseTensor& a, const DenseTensor& b) {
 }
 
 template <typename Context, typename InT, typename IndexT>
-static void UniqueFlattendTensor(const Context& context,
-                                 const DenseTensor& in,
-                                 DenseTensor* out,
-                                 DenseTensor* indices,
-                                 DenseTensor* index,
-                                 DenseTensor* count,
-                                 bool return_index,
-                                 bool return_inverse,
-                                 bool return_counts) {
+static typename std::enable_if<!IsRadixUniqueType<InT>::value>::type
+UniqueFlattendTensor(const Context& context,
+                     const DenseTensor& in,
+                     DenseTensor* out,
+                     DenseTensor* indices,
+                     DenseTensor* index,
+                     DenseTensor* count,
+                     bool return_index,
+                     bool return_inverse,
+                     bool return_counts) {
   const InT* in_data = in.data<InT>();
   std::set<InT> unique(in_data, in_data + in.numel());
   out->Resize(common::make_ddim({static_cast<int64_t>(unique.size())}));
@@ -189,6 +397,71 @@ static void UniqueFlattendTensor(const Context& context,
   }
 }
 
+// The integers are sorted with their positions, then all the outputs are
+// produced in one pass over the sorted values. As the sort is stable, the
+// first position of a unique value is the index of its first appearance.
+template <typename Context, typename InT, typename IndexT>
+static typename std::enable_if<IsRadixUniqueType<InT>::value>::type
+UniqueFlattendTensor(const Context& context,
+                     const DenseTensor& in,
+                     DenseTensor* out,
+                     DenseTensor* indices,
+                     DenseTensor* index,
+                     DenseTensor* count,
+                     bool return_index,
+                     bool return_inverse,
+                     bool return_counts) {
+  int64_t numel = in.numel();
+  std::vector<InT> sorted;
+  std::vector<IndexT> positions;
+  RadixSortWithPositions(in.data<InT>(), numel, &sorted, &positions);
+
+  int64_t num_unique = 0;
+  for (int64_t i = 0; i < numel; ++i) {
+    if (i == 0 || sorted[i] != sorted[i - 1]) {
+      ++num_unique;
+    }
+  }
+
+  out->Resize(common::make_ddim({num_unique}));
+  auto* out_data = context.template Alloc<InT>(out);
+  IndexT* indices_data = nullptr;
+  IndexT* inverse_data = nullptr;
+  IndexT* count_data = nullptr;
+  if (return_index) {
+    indices->Resize(common::make_ddim({num_unique}));
+    indices_data = context.template Alloc<IndexT>(indices);
+  }
+  if (return_inverse) {
+    index->Resize(common::make_ddim({numel}));
+    inverse_data = context.template Alloc<IndexT>(index);
+  }
+  if (return_counts) {
+    count->Resize(common::make_ddim({num_unique}));
+    count_data = context.template Alloc<IndexT>(count);
+  }
+
+  int64_t j = -1;
+  for (int64_t i = 0; i < numel; ++i) {
+    if (i == 0 || sorted[i] != sorted[i - 1]) {
+      ++j;
+      out_data[j] = sorted[i];
+      if (return_index) {
+        indices_data[j] = positions[i];
+      }
+      if (return_counts) {
+        count_data[j] = 0;
+      }
+    }
+    if (return_inverse) {
+      inverse_data[static_cast<int64_t>(positions[i])] = static_cast<IndexT>(j);
+    }
+    if (return_counts) {
+      ++count_data[j];
+    }
+  }
+}
+
 template <typename Context, typename ForwardIt, typename InT, typename IndexT>
 static ForwardIt UniqueDimImpl(const Context& context UNUSED,
                                ForwardIt first,
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "paddle/phi/backends/all_context.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/funcs/activation_functor.h"
@@ -23,6 +25,9 @@ namespace phi {
 
 #define ToString(x) #x
 
+// elements of a range of the intra-op thread pool for the CPU activations
+constexpr int64_t kActivationGrainSize = 16384;
+
 template <typename T, typename U, typename Context, typename Functor>
 void ActivationImpl(const Context& dev_ctx,
                     const DenseTensor& X,
@@ -36,6 +41,16 @@ void ActivationImpl(const Context& dev_ctx,
   auto out = phi::EigenVector<U>::Flatten(
       GET_DATA_SAFELY(Out, "Output", "Out", "Activation"));
   auto* place = dev_ctx.eigen_device();
+  if constexpr (std::is_same<Context, phi::CPUContext>::value) {
+    // the functors are elementwise, each range of the pool maps a slice
+    dev_ctx.ParallelFor(
+        0, out.size(), kActivationGrainSize, [&](int64_t b, int64_t e) {
+          typename EigenVector<T>::ConstType x_slice(x.data() + b, e - b);
+          typename EigenVector<U>::Type out_slice(out.data() + b, e - b);
+          functor(*place, x_slice, out_slice);
+        });
+    return;
+  }
   // use 32bit index to speed up computation
   bool use_32bit_index = out.size() < Eigen::NumTraits<int>::highest();
   bool is_gpu_place = dev_ctx.GetPlace().GetType() == phi::AllocationType::GPU;
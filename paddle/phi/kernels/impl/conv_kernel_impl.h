@@ -14,10 +14,14 @@
 
 #pragma once
 
+#include <type_traits>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/kernels/conv_kernel.h"
 #include "paddle/phi/kernels/cpu/conv_util.h"
 #include "paddle/phi/kernels/funcs/batch_norm_utils.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/direct_conv.h"
 #include "paddle/phi/kernels/funcs/im2col.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/funcs/vol2col.h"
@@ -105,6 +109,24 @@ void ConvKernelImpl(const Context& dev_ctx,
 
   bool is_expand = IsExpand(filter_shape_vec, strides, paddings, dilations);
 
+  if constexpr (std::is_same<Context, phi::CPUContext>::value) {
+    if (data_dim == 2U &&
+        phi::funcs::UseDirectConv2D(filter_shape_vec, groups, is_expand)) {
+      phi::funcs::DirectConv2D<T>(dev_ctx,
+                                  transformed_input,
+                                  filter,
+                                  strides,
+                                  paddings,
+                                  dilations,
+                                  groups,
+                                  &transformed_output);
+      if (channel_last) {
+        TransToChannelLast<Context, T>(dev_ctx, &transformed_output, output);
+      }
+      return;
+    }
+  }
+
   DenseTensor col;
   // col_matrix shares the same piece of data with col,
   // but will be reshaped into a two-dimensional matrix shape
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "paddle/pir/include/core/dll_decl.h"
 #include "paddle/pir/include/core/region.h"
 
@@ -62,6 +64,15 @@ class IR_API GreedyRewriteConfig {
   // Hook function for replacing the value.
   VALUE_REPLACED_HOOK_FUNC value_replaced_hook = nullptr;
 
+  /// Number of threads used when applying patterns to the regions of one or
+  /// several ops. If greater than 1, regions that use no common value defined
+  /// outside of them are rewritten concurrently, regions sharing such values
+  /// are rewritten in order on the same thread. Patterns must only modify the
+  /// IR inside the region they are applied on and must not mutate other
+  /// shared state (e.g. a Scope or the shape analysis) when this is enabled.
+  /// The regions are rewritten sequentially if `region` is set.
+  int num_threads = 1;
+
   static constexpr int64_t kNoLimit = -1;
 };
 
@@ -83,4 +94,12 @@ IR_API std::pair<bool, int64_t> ApplyPatternsGreedily(
     const FrozenRewritePatternSet& patterns,
     GreedyRewriteConfig config = GreedyRewriteConfig());
 
+/// Perform a match and rewrite process for all regions of the given ops,
+/// e.g. the FusionOps of a program, in the given order. Independent regions
+/// are rewritten concurrently when `config.num_threads` is greater than 1.
+IR_API std::pair<bool, int64_t> ApplyPatternsGreedily(
+    const std::vector<Operation*>& ops,
+    const FrozenRewritePatternSet& patterns,
+    GreedyRewriteConfig config = GreedyRewriteConfig());
+
 }  // namespace pir
@@ -18,12 +18,17 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <atomic>
+#include <exception>
 #include <iterator>
+#include <mutex>
 #include <numeric>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "paddle/pir/include/core/block.h"
+#include "paddle/pir/include/core/block_argument.h"
 #include "paddle/pir/include/core/ir_context.h"
 #include "paddle/pir/include/core/operation.h"
 #include "paddle/pir/include/core/region.h"
@@ -39,16 +44,17 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   explicit GreedyPatternRewriteDriver(
       pir::IrContext* ctx,
       const pir::FrozenRewritePatternSet& patterns,
-      const pir::GreedyRewriteConfig& config)
+      const pir::GreedyRewriteConfig& config,
+      const std::vector<pir::Block*>& blocks)
       : pir::PatternRewriter(ctx),
         config_(config),
-        region_(*config.region),
+        blocks_(blocks),
         matcher_(patterns) {
     worklist_.reserve(128);
     matcher_.ApplyDefaultCostModel();
     if (config.strict_mode != pir::GreedyRewriteStrictness::AnyOp) {
-      for (auto& block : region_) {
-        for (auto& op_item : block) {
+      for (auto* block : blocks_) {
+        for (auto& op_item : *block) {
           strict_mode_filtered_ops_.insert(&op_item);
         }
       }
@@ -71,8 +77,8 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       worklist_.clear();
       worklist_map_.clear();
 
-      for (auto& block_item : region_) {
-        for (auto& op_item : block_item) {
+      for (auto* block_item : blocks_) {
+        for (auto& op_item : *block_item) {
           worklist_.push_back(&op_item);
         }
       }
@@ -214,11 +220,166 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   std::unordered_map<pir::Operation*, unsigned> worklist_map_;
   pir::GreedyRewriteConfig config_;
   std::unordered_set<pir::Operation*> strict_mode_filtered_ops_;
-  pir::Region& region_;
+  std::vector<pir::Block*> blocks_;
   pir::PatternApplicator matcher_;
   pir::VALUE_REPLACED_HOOK_FUNC value_replaced_hook_fn_ = nullptr;
 };
 
+std::vector<pir::Block*> CollectBlocks(pir::Region& region) {  // NOLINT
+  std::vector<pir::Block*> blocks;
+  for (auto& block : region) {
+    blocks.push_back(&block);
+  }
+  return blocks;
+}
+
+/// Return true if `block` is nested in `region`.
+bool IsNestedIn(const pir::Block* block, const pir::Region* region) {
+  while (block) {
+    if (block->GetParent() == region) return true;
+    auto* parent_op = block->GetParentOp();
+    block = parent_op ? parent_op->GetParent() : nullptr;
+  }
+  return false;
+}
+
+/// Collect the values used by the ops nested in `region` but defined outside
+/// of it. Rewrites confined to the region only modify its own op lists and
+/// the use lists of its own values and of these external values.
+std::vector<pir::Value> CollectExternalValues(pir::Region* region) {
+  std::vector<pir::Value> values;
+  for (auto& block : *region) {
+    block.Walk([&](pir::Operation* op) {
+      for (uint32_t i = 0; i < op->num_operands(); ++i) {
+        auto value = op->operand_source(i);
+        if (!value) continue;
+        const pir::Block* owner = nullptr;
+        if (auto* def_op = value.defining_op()) {
+          owner = def_op->GetParent();
+        } else if (auto arg = value.dyn_cast<pir::BlockArgument>()) {
+          owner = arg.owner();
+        }
+        if (!IsNestedIn(owner, region)) values.push_back(value);
+      }
+    });
+  }
+  return values;
+}
+
+/// Partition `regions` into groups that can be rewritten concurrently. Two
+/// regions fall into the same group if they use a common external value or
+/// if one is nested in the other. Each group keeps the input order.
+std::vector<std::vector<pir::Region*>> PartitionRegions(
+    const std::vector<pir::Region*>& regions) {
+  std::vector<size_t> parent(regions.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto Find = [&](size_t i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+  auto Union = [&](size_t i, size_t j) { parent[Find(i)] = Find(j); };
+
+  std::unordered_map<const pir::Region*, size_t> region_index;
+  for (size_t i = 0; i < regions.size(); ++i) {
+    region_index.emplace(regions[i], i);
+  }
+  std::unordered_map<pir::Value, size_t> value_user;
+  for (size_t i = 0; i < regions.size(); ++i) {
+    for (auto& value : CollectExternalValues(regions[i])) {
+      auto [it, inserted] = value_user.emplace(value, i);
+      if (!inserted) Union(i, it->second);
+    }
+    for (auto* op = regions[i]->GetParent(); op && op->GetParent();
+         op = op->GetParentOp()) {
+      auto it = region_index.find(op->GetParent()->GetParent());
+      if (it != region_index.end()) Union(i, it->second);
+    }
+  }
+
+  std::vector<std::vector<pir::Region*>> groups;
+  std::unordered_map<size_t, size_t> group_index;
+  for (size_t i = 0; i < regions.size(); ++i) {
+    auto [it, inserted] = group_index.emplace(Find(i), groups.size());
+    if (inserted) groups.emplace_back();
+    groups[it->second].push_back(regions[i]);
+  }
+  return groups;
+}
+
+/// Rewrite `regions` on `config.num_threads` threads. The groups returned by
+/// PartitionRegions are distributed over the threads, the regions of a group
+/// are rewritten in order on one thread, one driver per region as in the
+/// sequential path.
+std::pair<bool, int64_t> ApplyPatternsGreedilyInParallel(
+    const std::vector<pir::Region*>& regions,
+    const pir::FrozenRewritePatternSet& patterns,
+    pir::GreedyRewriteConfig config) {
+  auto groups = PartitionRegions(regions);
+  VLOG(6) << "Parallel PatternRewrite on " << regions.size()
+          << " regions in " << groups.size() << " independent groups.";
+
+  // The value replaced hook is provided by the pass, serialize it so that it
+  // does not have to be thread safe.
+  std::mutex hook_mutex;
+  if (config.value_replaced_hook) {
+    auto hook = config.value_replaced_hook;
+    config.value_replaced_hook = [hook, &hook_mutex](pir::Value from,
+                                                     pir::Value to) {
+      std::lock_guard<std::mutex> guard(hook_mutex);
+      hook(from, to);
+    };
+  }
+
+  std::atomic<bool> sum_converged{true};
+  std::atomic<int64_t> sum_num_rewrites{0};
+  auto ApplyOnRegion = [&](pir::Region* region) {
+    // Each driver owns a copy of the config since `region` differs.
+    auto region_config = config;
+    region_config.region = region;
+    GreedyPatternRewriteDriver driver(
+        region->ir_context(), patterns, region_config, CollectBlocks(*region));
+    auto [converged, num_rewrites] = driver.Simplify();
+    if (!converged) sum_converged = false;
+    sum_num_rewrites += num_rewrites;
+  };
+
+  size_t num_threads =
+      std::min(static_cast<size_t>(config.num_threads), groups.size());
+  std::atomic<size_t> next_group{0};
+  std::vector<std::exception_ptr> exceptions(num_threads);
+  auto Worker = [&](size_t thread_id) {
+    try {
+      for (size_t i = next_group++; i < groups.size(); i = next_group++) {
+        for (auto* region : groups[i]) {
+          ApplyOnRegion(region);
+        }
+      }
+    } catch (...) {
+      exceptions[thread_id] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < num_threads; ++i) {
+    workers.emplace_back(Worker, i);
+  }
+  if (num_threads > 0) Worker(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (auto& exception : exceptions) {
+    if (exception) std::rethrow_exception(exception);
+  }
+
+  if (!sum_converged) {
+    LOG(WARNING) << "The pattern rewrite did not converge after scanning "
+                 << config.max_iterations << " times";
+  }
+  return std::make_pair(sum_converged.load(), sum_num_rewrites.load());
+}
+
 }  // namespace
 
 namespace pir {
@@ -229,7 +390,8 @@ std::pair<bool, int64_t> ApplyPatternsGreedily(
     GreedyRewriteConfig config) {
   if (!config.region) config.region = &region;
 
-  GreedyPatternRewriteDriver driver(region.ir_context(), patterns, config);
+  GreedyPatternRewriteDriver driver(
+      region.ir_context(), patterns, config, CollectBlocks(*config.region));
   auto [converged, num_rewrites] = driver.Simplify();
   if (!converged) {
     LOG(WARNING) << "The pattern rewrite did not converge after scanning "
@@ -242,14 +404,33 @@ IR_API std::pair<bool, int64_t> ApplyPatternsGreedily(
     Operation* op,
     const FrozenRewritePatternSet& patterns,
     GreedyRewriteConfig config) {
+  return ApplyPatternsGreedily(std::vector<Operation*>{op}, patterns, config);
+}
+
+IR_API std::pair<bool, int64_t> ApplyPatternsGreedily(
+    const std::vector<Operation*>& ops,
+    const FrozenRewritePatternSet& patterns,
+    GreedyRewriteConfig config) {
+  // All the drivers would rewrite config.region, so it is done sequentially.
+  if (config.num_threads > 1 && !config.region) {
+    std::vector<Region*> regions;
+    for (auto* op : ops) {
+      for (uint32_t i = 0; i < op->num_regions(); ++i) {
+        regions.push_back(&op->region(i));
+      }
+    }
+    return ApplyPatternsGreedilyInParallel(regions, patterns, config);
+  }
   bool sum_converged = true;
   int64_t sum_num_rewrites = 0;
-  for (uint32_t i = 0; i < op->num_regions(); ++i) {
-    Region& region = op->region(i);
-    auto [converged, num_rewrites] =
-        ApplyPatternsGreedily(region, patterns, config);
-    sum_converged &= converged;
-    sum_num_rewrites += num_rewrites;
+  for (auto* op : ops) {
+    for (uint32_t i = 0; i < op->num_regions(); ++i) {
+      Region& region = op->region(i);
+      auto [converged, num_rewrites] =
+          ApplyPatternsGreedily(region, patterns, config);
+      sum_converged &= converged;
+      sum_num_rewrites += num_rewrites;
+    }
   }
   return std::make_pair(sum_converged, sum_num_rewrites);
 }
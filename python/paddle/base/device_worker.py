@@ -466,6 +466,10 @@ class DownpourSGD(DeviceWorker):
         if opt_info["stat_var_names"]:
             for i in opt_info["stat_var_names"]:
                 downpour.stat_var_names.extend([i])
+        if opt_info.get("pull_sparse_prefetch_depth", 0) > 0:
+            downpour.pull_sparse_prefetch_depth = opt_info[
+                "pull_sparse_prefetch_depth"
+            ]
 
         for i in worker.get_desc().dense_table:
             if i.table_id in dense_table_set:
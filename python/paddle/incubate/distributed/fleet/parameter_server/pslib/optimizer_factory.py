@@ -1008,6 +1008,9 @@ class DistributedAdam(DistributedOptimizerImplBase):
             "worker_class", "DownpourWorker"
         )
         opt_info["stat_var_names"] = strategy.get("stat_var_names", [])
+        opt_info["pull_sparse_prefetch_depth"] = strategy.get(
+            "pull_sparse_prefetch_depth", 0
+        )
         opt_info["local_tables"] = strategy.get("local_tables", [])
         opt_info["async_tables"] = strategy.get("async_tables", [])
         opt_info["async_tables"] = strategy.get("async_tables", [])
@@ -0,0 +1,102 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+ALGOS = ['gloo', 'ring', 'halving_doubling', 'auto']
+REDUCES = [(core.ReduceOp.SUM, np.sum), (core.ReduceOp.MAX, np.max)]
+
+
+class TestProcessGroupGlooAllreduce(unittest.TestCase):
+    def setUp(self):
+        paddle.device.set_device('cpu')
+        self.nranks = paddle.distributed.ParallelEnv().nranks
+        self.rank = paddle.distributed.ParallelEnv().local_rank
+        # the endpoints of the trainers are free ports picked by the launcher
+        master_endpoint = os.environ["PADDLE_TRAINER_ENDPOINTS"].split(",")[0]
+        store = core.TCPStore(
+            "127.0.0.1",
+            int(master_endpoint.split(":")[1]),
+            self.rank == 0,
+            self.nranks,
+            30,
+        )
+        self.pg = core.ProcessGroupGloo.create(store, self.rank, self.nranks)
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_gloo_allreduce_algo': 'auto'})
+
+    def make_inputs(self, numel, dtype, seed=0):
+        # the inputs of all ranks, each generated from the seed of the rank
+        return np.stack(
+            [
+                np.random.RandomState(seed * 64 + rank)
+                .uniform(-10, 10, numel)
+                .astype(dtype)
+                for rank in range(self.nranks)
+            ]
+        )
+
+    def check_allreduce(self, numel, dtype):
+        inputs = self.make_inputs(numel, dtype)
+        for op, reduce in REDUCES:
+            tensor = paddle.to_tensor(inputs[self.rank])
+            task = self.pg.allreduce(tensor, op)
+            task.wait()
+            np.testing.assert_allclose(
+                tensor.numpy(), reduce(inputs, axis=0), rtol=1e-5, atol=1e-5
+            )
+
+    def test_allreduce_algos(self):
+        # odd sizes which do not split evenly into segments and chunks, and
+        # a large tensor which runs the ring in several chunks
+        for algo in ALGOS:
+            paddle.set_flags({'FLAGS_gloo_allreduce_algo': algo})
+            for numel in [1, 7, 1023, 100003, 3 * (1 << 20) + 5]:
+                self.check_allreduce(numel, "float32")
+            self.check_allreduce(100003, "float64")
+            self.check_allreduce(100003, "int64")
+
+    def test_allreduce_coalesced(self):
+        # five 4MB tensors, the last one starts a second 16MB bucket, a
+        # change of dtype ends a bucket, and a tensor larger than a bucket
+        # is reduced on its own
+        specs = [(1 << 20, "float32")] * 5
+        specs += [(7, "float64"), (1023, "float64"), (100003, "int64")]
+        specs += [(5 * (1 << 20), "float32"), (3, "float32"), (1, "float32")]
+        for algo in ALGOS:
+            paddle.set_flags({'FLAGS_gloo_allreduce_algo': algo})
+            inputs = [
+                self.make_inputs(numel, dtype, seed)
+                for seed, (numel, dtype) in enumerate(specs)
+            ]
+            for op, reduce in REDUCES:
+                tensors = [paddle.to_tensor(x[self.rank]) for x in inputs]
+                task = self.pg.allreduce_coalesced(tensors, op)
+                task.wait()
+                for tensor, x in zip(tensors, inputs):
+                    np.testing.assert_allclose(
+                        tensor.numpy(), reduce(x, axis=0), rtol=1e-5, atol=1e-5
+                    )
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -16,6 +16,7 @@ import unittest
 
 from legacy_test.test_parallel_dygraph_dataparallel import (
     TestMultipleAccelerators,
+    TestMultipleWithGloo,
 )
 
 
@@ -30,5 +31,13 @@ class TestProcessGroup(TestMultipleAccelerators):
         self.run_mnist_2accelerators('init_process_group.py')
 
 
+class TestProcessGroupGlooAllreduce(TestMultipleWithGloo):
+    def test_process_group_gloo_allreduce(self):
+        # ring and halving-doubling only differ for more than 2 ranks, and 3
+        # ranks fold the extra rank of a non power of two world
+        for nranks in [2, 3, 4]:
+            self.run_mnist_cpu('process_group_gloo_allreduce.py', nranks)
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -240,3 +240,91 @@ TEST(Benchmark, EagerIntermediateMLPCPU) {
     }
   }
 }
+
+TEST(Benchmark, EagerBackwardCPU) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(phi::CPUPlace());
+
+  for (const std::string mode : {"Accuracy", "Performance"}) {
+    phi::DDim ddim = common::make_ddim({1});
+    paddle::Tensor tensor =
+        eager_test::CreateTensorWithValue(ddim,
+                                          phi::CPUPlace(),
+                                          phi::DataType::FLOAT32,
+                                          phi::DataLayout::NCHW,
+                                          1.0,
+                                          true);
+    RetainGradForTensor(tensor);
+
+    if (mode == "Accuracy") {
+      benchmark_eager_backward(tensor, true /* accuracy_check */);
+
+    } else if (mode == "Performance") {
+      auto t_start = std::chrono::high_resolution_clock::now();
+#ifdef WITH_GPERFTOOLS
+      ProfilerStart("eager_backward_cpu.out");
+#endif
+      benchmark_eager_backward(tensor);
+
+#ifdef WITH_GPERFTOOLS
+      ProfilerStop();
+#endif
+      auto t_end = std::chrono::high_resolution_clock::now();
+      double elapsed_time_ms =
+          std::chrono::duration<double, std::milli>(t_end - t_start).count();
+
+      std::cout << "Duration: " << elapsed_time_ms << " ms" << std::endl;
+
+    } else {
+      PADDLE_THROW(common::errors::Fatal("Unknown benchmark mode"));
+    }
+  }
+}
+
+TEST(Benchmark, EagerElementwiseCPU) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(phi::CPUPlace());
+
+  for (const std::string mode : {"Accuracy", "Performance"}) {
+    phi::DDim ddimX = common::make_ddim({2, 2});
+    paddle::Tensor X = eager_test::CreateTensorWithValue(ddimX,
+                                                         phi::CPUPlace(),
+                                                         phi::DataType::FLOAT32,
+                                                         phi::DataLayout::NCHW,
+                                                         1.0,
+                                                         false);
+
+    phi::DDim ddimY = common::make_ddim({2, 2});
+    paddle::Tensor Y = eager_test::CreateTensorWithValue(ddimY,
+                                                         phi::CPUPlace(),
+                                                         phi::DataType::FLOAT32,
+                                                         phi::DataLayout::NCHW,
+                                                         2.0,
+                                                         false);
+
+    if (mode == "Accuracy") {
+      benchmark_eager_elementwise(X, Y, true /* accuracy_check */);
+
+    } else if (mode == "Performance") {
+      auto t_start = std::chrono::high_resolution_clock::now();
+#ifdef WITH_GPERFTOOLS
+      ProfilerStart("eager_elementwise_cpu.out");
+#endif
+      benchmark_eager_elementwise(X, Y);
+
+#ifdef WITH_GPERFTOOLS
+      ProfilerStop();
+#endif
+      auto t_end = std::chrono::high_resolution_clock::now();
+      double elapsed_time_ms =
+          std::chrono::duration<double, std::milli>(t_end - t_start).count();
+
+      std::cout << "Duration: " << elapsed_time_ms << " ms, "
+                << elapsed_time_ms * 1000 / ELEMENTWISE_NUM_RUNS
+                << " us per op" << std::endl;
+
+    } else {
+      PADDLE_THROW(common::errors::Fatal("Unknown benchmark mode"));
+    }
+  }
+}
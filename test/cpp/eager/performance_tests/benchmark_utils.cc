@@ -152,6 +152,53 @@ void benchmark_eager_intermediate_mlp(const paddle::Tensor& X,
   }
 }
 
+/* ------------------------ */
+/* ---- Eager Backward ---- */
+/* ------------------------ */
+void benchmark_eager_backward(const paddle::Tensor& tensor,
+                              bool accuracy_check) {
+  paddle::Tensor input_tensor = tensor;
+  for (size_t i = 0; i < BACKWARD_NUM_NODES; i++) {
+    input_tensor = egr::scale(input_tensor,
+                              1.0 /*scale*/,
+                              0.0 /*bias*/,
+                              true /*bias_after_scale*/,
+                              true /*trace_backward*/);
+  }
+
+  // The kernels of the scalar tensor are cheap, so that the duration is
+  // dominated by the overhead of the backward engine
+  std::vector<paddle::Tensor> target_tensors = {input_tensor};
+  size_t max_num_runs = accuracy_check ? 1 : BACKWARD_NUM_RUNS;
+  for (size_t i = 0; i < max_num_runs; i++) {
+    Backward(target_tensors, {}, true /*retain_graph*/);
+  }
+
+  if (accuracy_check) {
+    // Examine Backward Grad (w.r.t max_num_runs = 1)
+    eager_test::CompareGradTensorWithValue<float>(tensor, 1.0);
+  }
+}
+
+/* --------------------------- */
+/* ---- Eager Elementwise ---- */
+/* --------------------------- */
+void benchmark_eager_elementwise(const paddle::Tensor& X,
+                                 const paddle::Tensor& Y,
+                                 bool accuracy_check) {
+  paddle::Tensor input_tensor0 = X;
+
+  size_t max_num_runs = accuracy_check ? 10 : ELEMENTWISE_NUM_RUNS;
+  for (size_t i = 0; i < max_num_runs; i++) {
+    input_tensor0 = add_ad_func(input_tensor0, Y);
+  }
+
+  if (accuracy_check) {
+    // Examine Forward Output (w.r.t max_num_runs = 10)
+    eager_test::CompareTensorWithValue<float>(input_tensor0, 21.0);
+  }
+}
+
 }  // namespace egr
 
 namespace paddle {
@@ -32,6 +32,17 @@
 #define MLP_B_VAL 3.0
 #define MLP_NUM_LINEAR 1000
 
+/* Backward Configurations */
+// Out = Scale(...Scale(X)) with BACKWARD_NUM_NODES scale ops, whose backward
+// runs BACKWARD_NUM_RUNS times with retain_graph
+#define BACKWARD_NUM_NODES 1000
+#define BACKWARD_NUM_RUNS 100
+
+/* Elementwise Configurations */
+// Out = X + Y + ... + Y with ELEMENTWISE_NUM_RUNS adds of small tensors
+// without grads, which measures the dispatch overhead of an op
+#define ELEMENTWISE_NUM_RUNS 100000
+
 namespace egr {
 
 inline std::unordered_map<std::string, float> compute_mlp_expected_results() {
@@ -65,6 +76,15 @@ void benchmark_eager_intermediate_mlp(const paddle::Tensor& X,
                                       const std::vector<paddle::Tensor>& Bs,
                                       bool accuracy_check = false);
 
+/* ---- Eager Backward ---- */
+void benchmark_eager_backward(const paddle::Tensor& tensor,
+                              bool accuracy_check = false);
+
+/* ---- Eager Elementwise ---- */
+void benchmark_eager_elementwise(const paddle::Tensor& X,
+                                 const paddle::Tensor& Y,
+                                 bool accuracy_check = false);
+
 }  // namespace egr
 
 namespace paddle {
@@ -18,6 +18,7 @@
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
 #include "paddle/fluid/eager/api/all.h"
 #include "paddle/fluid/eager/api/generated/eager_generated/backwards/scale_node.h"
@@ -31,6 +32,8 @@
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
 
+COMMON_DECLARE_int32(eager_backward_num_threads);
+
 namespace egr {
 
 TEST(Backward, SingleNodeEmptyGrad) {
@@ -342,4 +345,188 @@ TEST(Backward, WithAccumulation) {
   eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 2500.0);
 }
 
+// Sets FLAGS_eager_backward_num_threads and restores it when the test ends,
+// also if an ASSERT returns early.
+class BackwardNumThreadsGuard {
+ public:
+  explicit BackwardNumThreadsGuard(int num_threads)
+      : num_threads_(FLAGS_eager_backward_num_threads) {
+    FLAGS_eager_backward_num_threads = num_threads;
+  }
+  ~BackwardNumThreadsGuard() {
+    FLAGS_eager_backward_num_threads = num_threads_;
+  }
+
+ private:
+  int num_threads_;
+};
+
+TEST(Backward, ParallelBranches) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(phi::CPUPlace());
+  BackwardNumThreadsGuard num_threads_guard(4);
+
+  // Prepare Inputs
+  phi::DDim ddim = common::make_ddim({4, 16, 16, 32});
+
+  // Target tensor i -> Node i (scale i + 1) -> Node2 (scale 20) -> leaf
+  constexpr int kBranchNum = 8;
+  std::vector<paddle::Tensor> target_tensors;
+  for (int i = 0; i < kBranchNum; ++i) {
+    target_tensors.emplace_back(
+        eager_test::CreateTensorWithValue(ddim,
+                                          phi::CPUPlace(),
+                                          phi::DataType::FLOAT32,
+                                          phi::DataLayout::NCHW,
+                                          1.0 /*value*/,
+                                          false /*is_leaf*/));
+  }
+
+  paddle::Tensor leaf_tensor;
+  {
+    auto node2_ptr = std::make_shared<GradNodeScale>(1, 1);
+    node2_ptr->SetAttributes_scale(20.0 /*scale*/);
+    node2_ptr->SetDefaultGradInOutMeta();
+
+    for (int i = 0; i < kBranchNum; ++i) {
+      auto node_ptr = std::make_shared<GradNodeScale>(1, 1);
+      node_ptr->SetAttributes_scale(static_cast<float>(i + 1) /*scale*/);
+      node_ptr->SetDefaultGradInOutMeta();
+      AutogradMeta* auto_grad_meta =
+          EagerUtils::autograd_meta(&(target_tensors[i]));
+      auto_grad_meta->SetGradNode(
+          std::dynamic_pointer_cast<GradNodeBase>(node_ptr));
+      auto_grad_meta->SetSingleOutRankWithSlot(0, 0);
+      auto_grad_meta->SetStopGradient(false);
+
+      auto tmp_tensor = paddle::Tensor();
+      auto* meta = EagerUtils::autograd_meta(&tmp_tensor);
+      meta->SetStopGradient(false);
+      meta->SetSingleOutRankWithSlot(0, 0);
+      meta->SetGradNode(node2_ptr);
+      node_ptr->SetGradOutMeta(tmp_tensor, 0);
+    }
+
+    AutogradMeta* auto_grad_meta2 = EagerUtils::autograd_meta(&leaf_tensor);
+    auto acc_node_ptr =
+        std::make_shared<egr::GradNodeAccumulation>(auto_grad_meta2);
+    auto_grad_meta2->SetGradNode(
+        std::dynamic_pointer_cast<GradNodeBase>(acc_node_ptr));
+    auto_grad_meta2->SetSingleOutRankWithSlot(0, 0);
+    auto_grad_meta2->SetStopGradient(false);
+    node2_ptr->SetGradOutMeta(leaf_tensor, 0);
+  }
+
+  Backward(target_tensors, {});
+
+  // (1 + 2 + ... + 8) * 20
+  eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 720.0);
+}
+
+// A scale grad node running the backward of inner_targets before its own
+// computation, like a PyLayer calling backward in its backward function.
+class NestedBackwardGradNode : public GradNodeScale {
+ public:
+  NestedBackwardGradNode(size_t bwd_in_slot_num,
+                         size_t bwd_out_slot_num,
+                         const std::vector<paddle::Tensor>& inner_targets)
+      : GradNodeScale(bwd_in_slot_num, bwd_out_slot_num),
+        inner_targets_(inner_targets) {}
+
+  paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
+  operator()(paddle::small_vector<std::vector<paddle::Tensor>,
+                                  kSlotSmallVectorSize>& grads,  // NOLINT
+             bool create_graph = false,
+             bool is_new_grad = false) override {
+    Backward(inner_targets_, {});
+    return GradNodeScale::operator()(grads, create_graph, is_new_grad);
+  }
+
+  std::string name() override { return "nested backward node"; }
+
+ private:
+  std::vector<paddle::Tensor> inner_targets_;
+};
+
+/*
+   Outer backward:                    Inner backward:
+   target0 -> Node0 (scale 2) -\
+                                Node2 (scale 20) -> leaf
+   target1 -> Node1 (scale 1) -/   ^
+              runs the inner       |
+              backward        inner_target -> Node3 (scale 3)
+
+   Node2 waits for the grad of Node1 in the outer backward when the inner
+   backward reaches it.
+*/
+TEST(Backward, NestedBackward) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(phi::CPUPlace());
+
+  for (int num_threads : {0, 4}) {
+    BackwardNumThreadsGuard num_threads_guard(num_threads);
+    phi::DDim ddim = common::make_ddim({4, 16, 16, 32});
+    auto CreateTarget = [&]() {
+      return eager_test::CreateTensorWithValue(ddim,
+                                               phi::CPUPlace(),
+                                               phi::DataType::FLOAT32,
+                                               phi::DataLayout::NCHW,
+                                               1.0 /*value*/,
+                                               false /*is_leaf*/);
+    };
+    std::vector<paddle::Tensor> target_tensors{CreateTarget(),
+                                               CreateTarget()};
+    std::vector<paddle::Tensor> inner_target_tensors{CreateTarget()};
+
+    paddle::Tensor leaf_tensor;
+    {
+      auto node2_ptr = std::make_shared<GradNodeScale>(1, 1);
+      node2_ptr->SetAttributes_scale(20.0 /*scale*/);
+      node2_ptr->SetDefaultGradInOutMeta();
+
+      auto ConnectToNode2 = [&](paddle::Tensor* target,
+                                std::shared_ptr<GradNodeScale> node_ptr,
+                                float scale) {
+        node_ptr->SetAttributes_scale(scale);
+        node_ptr->SetDefaultGradInOutMeta();
+        AutogradMeta* auto_grad_meta = EagerUtils::autograd_meta(target);
+        auto_grad_meta->SetGradNode(
+            std::dynamic_pointer_cast<GradNodeBase>(node_ptr));
+        auto_grad_meta->SetSingleOutRankWithSlot(0, 0);
+        auto_grad_meta->SetStopGradient(false);
+
+        auto tmp_tensor = paddle::Tensor();
+        auto* meta = EagerUtils::autograd_meta(&tmp_tensor);
+        meta->SetStopGradient(false);
+        meta->SetSingleOutRankWithSlot(0, 0);
+        meta->SetGradNode(node2_ptr);
+        node_ptr->SetGradOutMeta(tmp_tensor, 0);
+      };
+      ConnectToNode2(
+          &target_tensors[0], std::make_shared<GradNodeScale>(1, 1), 2.0);
+      ConnectToNode2(&target_tensors[1],
+                     std::make_shared<NestedBackwardGradNode>(
+                         1, 1, inner_target_tensors),
+                     1.0);
+      ConnectToNode2(&inner_target_tensors[0],
+                     std::make_shared<GradNodeScale>(1, 1),
+                     3.0);
+
+      AutogradMeta* auto_grad_meta2 = EagerUtils::autograd_meta(&leaf_tensor);
+      auto acc_node_ptr =
+          std::make_shared<egr::GradNodeAccumulation>(auto_grad_meta2);
+      auto_grad_meta2->SetGradNode(
+          std::dynamic_pointer_cast<GradNodeBase>(acc_node_ptr));
+      auto_grad_meta2->SetSingleOutRankWithSlot(0, 0);
+      auto_grad_meta2->SetStopGradient(false);
+      node2_ptr->SetGradOutMeta(leaf_tensor, 0);
+    }
+
+    Backward(target_tensors, {});
+
+    // The inner backward sends 3 * 20 and the outer one (2 + 1) * 20
+    eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 120.0);
+  }
+}
+
 }  // namespace egr
@@ -368,4 +368,86 @@ TEST(Grad, WithAccumulation) {
   eager_test::CompareTensorWithValue<float>(result[0], 2500.0);
 }
 
+// Grad with inputs runs on the grad nodes copied by GeneralGrad, which are
+// freed when the results are collected. The backward states of the copied
+// nodes have to be released before that, which ASAN checks here.
+TEST(Grad, ReleaseStatesOfCopiedNodes) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(phi::CPUPlace());
+
+  // Prepare Target Tensor
+  std::vector<paddle::Tensor> target_tensors;
+  phi::DDim ddim = common::make_ddim({4, 16, 16, 32});
+
+  // Create Target Tensor
+  paddle::Tensor tensor =
+      eager_test::CreateTensorWithValue(ddim,
+                                        phi::CPUPlace(),
+                                        phi::DataType::FLOAT32,
+                                        phi::DataLayout::NCHW,
+                                        1.0 /*value*/,
+                                        false /*is_leaf*/);
+  target_tensors.emplace_back(std::move(tensor));
+
+  paddle::Tensor leaf_tensor =
+      eager_test::CreateTensorWithValue(ddim,
+                                        phi::CPUPlace(),
+                                        phi::DataType::FLOAT32,
+                                        phi::DataLayout::NCHW,
+                                        1.0 /*value*/,
+                                        true /*is_leaf*/);
+  {
+    // Create Node0
+    auto node0_ptr = std::make_shared<GradNodeScale>(1, 1);
+    node0_ptr->SetAttributes_scale(5.0 /*scale*/);
+
+    // Set grad in/out meta for node0
+    node0_ptr->SetDefaultGradInOutMeta();
+
+    // Create Node1
+    auto node1_ptr = std::make_shared<GradNodeScale>(1, 1);
+    node1_ptr->SetAttributes_scale(10.0 /*scale*/);
+
+    // Set grad in/out meta for node1
+    node1_ptr->SetDefaultGradInOutMeta();
+
+    // Connect Input Tensor and Node0 via AutoGradMeta
+    AutogradMeta* auto_grad_meta =
+        EagerUtils::autograd_meta(&(target_tensors[0]));
+    auto_grad_meta->SetGradNode(
+        std::dynamic_pointer_cast<GradNodeBase>(node0_ptr));
+    auto_grad_meta->SetSingleOutRankWithSlot(0, 0);
+    auto_grad_meta->SetStopGradient(false);
+    // Connect Node0 -> Node1 via Edge
+    auto tmp_tensor = paddle::Tensor();
+    auto* meta0 = EagerUtils::autograd_meta(&tmp_tensor);
+    meta0->SetStopGradient(false);
+    meta0->SetSingleOutRankWithSlot(0, 0);
+    meta0->SetGradNode(node1_ptr);
+    node0_ptr->SetGradOutMeta(tmp_tensor, 0);
+
+    AutogradMeta* auto_grad_meta1 = EagerUtils::autograd_meta(&leaf_tensor);
+    // Connect Tensor and AccumulationNode via AutoGradMeta
+    auto acc_node_ptr =
+        std::make_shared<egr::GradNodeAccumulation>(auto_grad_meta1);
+
+    auto_grad_meta1->SetGradNode(
+        std::dynamic_pointer_cast<GradNodeBase>(acc_node_ptr));
+    auto_grad_meta1->SetSingleOutRankWithSlot(0, 0);
+
+    auto_grad_meta1->SetStopGradient(false);
+    node1_ptr->SetGradOutMeta(leaf_tensor, 0);
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    auto result =
+        Grad(target_tensors, {leaf_tensor}, {}, /*retain_graph=*/true);
+    eager_test::CompareTensorWithValue<float>(result[0], 50.0);
+  }
+
+  // The original nodes can still run a backward afterwards
+  Backward(target_tensors, {});
+  eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 50.0);
+}
+
 }  // namespace egr
@@ -0,0 +1,189 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/data_feed.h"
+#include "paddle/fluid/framework/device_worker.h"
+#include "paddle/fluid/framework/fleet/fleet_wrapper.h"
+#include "paddle/fluid/framework/scope.h"
+
+namespace paddle {
+namespace framework {
+
+using SlotIds = std::vector<std::vector<int64_t>>;
+
+// Feeds the given batches of ids, one tensor per slot.
+class BatchListDataFeed : public DataFeed {
+ public:
+  BatchListDataFeed(const std::vector<std::string>& slots,
+                    const std::vector<SlotIds>& batches)
+      : batches_(batches) {
+    use_slots_ = slots;
+    feed_vec_.resize(slots.size());
+    finish_init_ = true;
+  }
+
+  void Init(const DataFeedDesc& data_feed_desc UNUSED) override {}
+
+  bool Start() override {
+    cursor_ = 0;
+    return true;
+  }
+
+  int Next() override {
+    if (cursor_ == batches_.size()) {
+      return 0;
+    }
+    const auto& batch = batches_[cursor_++];
+    for (size_t i = 0; i < feed_vec_.size(); ++i) {
+      auto* tensor = feed_vec_[i];
+      tensor->Resize({static_cast<int64_t>(batch[i].size()), 1});
+      auto* data = tensor->mutable_data<int64_t>(phi::CPUPlace());
+      std::copy(batch[i].begin(), batch[i].end(), data);
+      tensor->set_lod({{0, batch[i].size()}});
+    }
+    return static_cast<int>(cursor_);
+  }
+
+ private:
+  std::vector<SlotIds> batches_;
+  size_t cursor_ = 0;
+};
+
+// Exposes the batches DownpourWorker trains, without running a program.
+class PrefetchTestWorker : public DownpourWorker {
+ public:
+  PrefetchTestWorker(DataFeed* reader, Scope* scope, int depth) {
+    device_reader_ = reader;
+    thread_scope_ = scope;
+    fleet_ptr_ = FleetWrapper::GetInstance();
+    pull_sparse_prefetch_depth_ = depth;
+    param_.add_program_config()->add_pull_sparse_table_id(0);
+    auto* table = param_.add_sparse_table();
+    table->set_table_id(0);
+    table->set_fea_dim(3);
+    // only slot0 has an embedding, so only its keys are pulled
+    sparse_key_names_[0] = {"slot0", "slot1"};
+    sparse_value_names_[0] = {"emb0", "emb1"};
+  }
+
+  int Next() { return NextBatch(); }
+
+  std::vector<int64_t> SlotData(const std::string& name) const {
+    const auto& dense = thread_scope_->FindVar(name)->Get<phi::DenseTensor>();
+    return std::vector<int64_t>(dense.data<int64_t>(),
+                                dense.data<int64_t>() + dense.numel());
+  }
+
+  const std::vector<uint64_t>& features() { return features_[0]; }
+  const std::vector<std::vector<float>>& feature_values() {
+    return feature_values_[0];
+  }
+  // the unique keys pulled for the batch returned by the last Next
+  const std::vector<uint64_t>& pulled_keys() {
+    size_t capacity = prefetch_batches_.size();
+    return prefetch_batches_[(prefetch_head_ + capacity - 1) % capacity]
+        .unique_keys[0];
+  }
+};
+
+struct TrainedBatch {
+  int batch_size;
+  std::vector<int64_t> slot0;
+  std::vector<int64_t> slot1;
+};
+
+std::vector<SlotIds> MakeBatches(size_t num_batches) {
+  std::vector<SlotIds> batches;
+  for (size_t i = 0; i < num_batches; ++i) {
+    int64_t base = static_cast<int64_t>(i) * 10;
+    // duplicated keys, and 0 which is never pulled
+    batches.push_back({{base + 1, base + 2, base + 1, 0, base + 2, base + 3},
+                       {base + 5, base + 5}});
+  }
+  return batches;
+}
+
+std::vector<TrainedBatch> TrainPasses(const std::vector<SlotIds>& batches,
+                                      int depth,
+                                      int num_passes) {
+  Scope scope;
+  for (auto name : {"slot0", "slot1", "emb0"}) {
+    scope.Var(name)->GetMutable<phi::DenseTensor>();
+  }
+  BatchListDataFeed reader({"slot0", "slot1"}, batches);
+  reader.AssignFeedVar(scope);
+  PrefetchTestWorker worker(&reader, &scope, depth);
+
+  std::vector<TrainedBatch> trained;
+  for (int pass = 0; pass < num_passes; ++pass) {
+    reader.Start();
+    int batch_size = 0;
+    while ((batch_size = worker.Next()) > 0) {
+      trained.push_back(
+          {batch_size, worker.SlotData("slot0"), worker.SlotData("slot1")});
+      if (depth == 0) {
+        continue;
+      }
+      std::vector<uint64_t> expected_features;
+      std::vector<uint64_t> expected_keys;
+      std::set<uint64_t> seen;
+      for (auto id : trained.back().slot0) {
+        if (id == 0) continue;
+        expected_features.push_back(id);
+        if (seen.insert(id).second) expected_keys.push_back(id);
+      }
+      EXPECT_EQ(worker.features(), expected_features);
+      EXPECT_EQ(worker.pulled_keys(), expected_keys);
+      ASSERT_EQ(worker.feature_values().size(), expected_features.size() + 1);
+      for (auto& value : worker.feature_values()) {
+        EXPECT_EQ(value.size(), 3u);
+      }
+    }
+  }
+  // the reader feeds thread_scope_ again after the pipeline is drained
+  reader.Start();
+  reader.Next();
+  EXPECT_EQ(worker.SlotData("slot0"), batches[0][0]);
+  return trained;
+}
+
+// The pulls are not sent without pslib, which keeps the test local.
+#ifndef PADDLE_WITH_PSLIB
+TEST(DownpourWorker, PrefetchDepth) {
+  auto batches = MakeBatches(5);
+  auto expected = TrainPasses(batches, /*depth=*/0, /*num_passes=*/2);
+  ASSERT_EQ(expected.size(), 10u);
+  // 1 reuses each slot of the ring buffer every other batch, 3 keeps the
+  // pipeline full for most of the pass, and 8 is deeper than the pass
+  for (int depth : {1, 3, 8}) {
+    auto trained = TrainPasses(batches, depth, /*num_passes=*/2);
+    ASSERT_EQ(trained.size(), expected.size()) << "depth " << depth;
+    for (size_t i = 0; i < trained.size(); ++i) {
+      EXPECT_EQ(trained[i].batch_size, expected[i].batch_size);
+      EXPECT_EQ(trained[i].slot0, expected[i].slot0);
+      EXPECT_EQ(trained[i].slot1, expected[i].slot1);
+    }
+  }
+}
+#endif
+
+}  // namespace framework
+}  // namespace paddle
@@ -72,6 +72,37 @@ TEST(KernelRegistry, SetFP32Input) {
   EXPECT_EQ(output_defs.at(0).dtype, phi::DataType::FLOAT16);
 }
 
+TEST(KernelSelectionCache, SelectKernel) {
+  auto& factory = phi::KernelFactory::Instance();
+  phi::KernelKey fp32_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  phi::KernelKey fp64_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT64);
+  phi::KernelSelectionCache cache;
+  for (int i = 0; i < 2; ++i) {
+    auto result = cache.SelectKernelOrThrowError("test", fp32_key);
+    EXPECT_EQ(&result.kernel, &factory.SelectKernel("test", fp32_key));
+    EXPECT_FALSE(result.has_fallback_cpu);
+  }
+  // the cached kernel is replaced for another kernel key
+  auto fp64_result = cache.SelectKernelOrThrowError("test", fp64_key);
+  EXPECT_EQ(&fp64_result.kernel, &factory.SelectKernel("test", fp64_key));
+
+  // and is selected again once the kernels may be changed
+  uint64_t generation = factory.Generation();
+  factory.kernels();
+  EXPECT_EQ(factory.Generation(), generation);
+  factory.MutableKernels();
+  EXPECT_NE(factory.Generation(), generation);
+  auto reselected_result = cache.SelectKernelOrThrowError("test", fp64_key);
+  EXPECT_EQ(&reselected_result.kernel,
+            &factory.SelectKernel("test", fp64_key));
+
+  phi::KernelKey int8_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::INT8);
+  EXPECT_ANY_THROW(cache.SelectKernelOrThrowError("test", int8_key));
+}
+
 TEST(AttributeType, OStream) {
   std::ostringstream oss;
   oss << phi::AttributeType::UNDEFINED;
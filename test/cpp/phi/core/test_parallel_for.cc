@@ -0,0 +1,77 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+
+namespace phi {
+namespace tests {
+
+TEST(CPUContext, parallel_for) {
+  phi::CPUContext dev_ctx;
+  for (int num_threads : {1, 2, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (int64_t numel : {0, 1, 7, 1000, 12345}) {
+      std::vector<std::atomic<int>> visits(numel);
+      std::atomic<int> num_ranges{0};
+      dev_ctx.ParallelFor(0, numel, 100, [&](int64_t begin, int64_t end) {
+        EXPECT_LT(begin, end);
+        ++num_ranges;
+        for (int64_t i = begin; i < end; ++i) {
+          ++visits[i];
+        }
+      });
+      for (auto& visit : visits) {
+        EXPECT_EQ(visit.load(), 1);
+      }
+      EXPECT_LE(num_ranges.load(), num_threads);
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+TEST(CPUContext, parallel_for_nested_and_error) {
+  phi::CPUContext dev_ctx;
+  phi::SetIntraOpNumThreads(4);
+  EXPECT_NE(dev_ctx.eigen_pool_device(), nullptr);
+  // the nested loops run inline
+  std::atomic<int> num_inner_ranges{0};
+  dev_ctx.ParallelFor(0, 4, 1, [&](int64_t, int64_t) {
+    EXPECT_EQ(phi::GetIntraOpNumThreads(), 1);
+    dev_ctx.ParallelFor(
+        0, 100, 1, [&](int64_t, int64_t) { ++num_inner_ranges; });
+  });
+  EXPECT_EQ(num_inner_ranges.load(), 4);
+  EXPECT_EQ(phi::GetIntraOpNumThreads(), 4);
+
+  EXPECT_THROW(dev_ctx.ParallelFor(0,
+                                   100,
+                                   1,
+                                   [](int64_t begin, int64_t) {
+                                     if (begin > 0) {
+                                       throw std::runtime_error("error");
+                                     }
+                                   }),
+               std::runtime_error);
+  phi::SetIntraOpNumThreads(1);
+  EXPECT_EQ(dev_ctx.eigen_pool_device(), nullptr);
+}
+
+}  // namespace tests
+}  // namespace phi
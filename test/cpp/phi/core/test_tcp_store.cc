@@ -12,17 +12,45 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 #include "paddle/phi/core/distributed/store/tcp_utils.h"
 
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <arpa/inet.h>
+#include <sys/resource.h>
 #endif
 
 namespace phi {
 namespace distributed {
 
+#ifndef _WIN32
+// Starts a MasterDaemon on a free port and returns the port.
+std::unique_ptr<detail::MasterDaemon> StartMasterDaemon(uint16_t* port) {
+  int socket = tcputils::tcp_listen("", std::to_string(0), AF_INET);
+  ::sockaddr_in addr{};
+  ::socklen_t addr_len = sizeof(addr);
+  ::getsockname(socket, reinterpret_cast<::sockaddr*>(&addr), &addr_len);
+  *port = ntohs(addr.sin_port);
+  return detail::MasterDaemon::start(socket, 1, 100);
+}
+
+std::vector<uint8_t> ToBytes(const std::string& s) {
+  return std::vector<uint8_t>(s.begin(), s.end());
+}
+#endif
+
 TEST(MasterDaemon, init) {
   int socket = tcputils::tcp_listen("", std::to_string(0), AF_INET);
   auto d = detail::MasterDaemon::start(socket, 1, 100);
@@ -37,6 +65,124 @@ TEST(MasterDaemon, init) {
   d.reset();
 }
 
+#ifndef _WIN32
+TEST(TCPStore, multi_key) {
+  uint16_t port = 0;
+  auto daemon = StartMasterDaemon(&port);
+  TCPStore store("127.0.0.1", port, false, 0);
+  TCPStore other("127.0.0.1", port, false, 0);
+
+  store.multi_set({"a", "b"}, {ToBytes("1"), ToBytes("23")});
+  auto values = other.multi_get({"b", "a"});
+  ASSERT_EQ(values.size(), 2UL);
+  EXPECT_EQ(values[0], ToBytes("23"));
+  EXPECT_EQ(values[1], ToBytes("1"));
+  EXPECT_EQ(store.add("c", 3), 3);
+  EXPECT_EQ(other.add("c", 2), 5);
+
+  // not set as the key is not set and expected is not empty
+  EXPECT_TRUE(store.compare_set("d", ToBytes("1"), ToBytes("2")).empty());
+  EXPECT_FALSE(store.check("d"));
+  EXPECT_EQ(store.compare_set("d", {}, ToBytes("2")), ToBytes("2"));
+  EXPECT_EQ(other.compare_set("d", ToBytes("1"), ToBytes("3")), ToBytes("2"));
+  EXPECT_EQ(other.compare_set("d", ToBytes("2"), ToBytes("3")), ToBytes("3"));
+
+  // multi_get waits for the keys set by another client
+  std::thread setter([port] {
+    TCPStore store("127.0.0.1", port, false, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    store.set("e", ToBytes("4"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    store.multi_set({"f"}, {ToBytes("5")});
+  });
+  values = store.multi_get({"e", "a", "f"});
+  setter.join();
+  ASSERT_EQ(values.size(), 3UL);
+  EXPECT_EQ(values[0], ToBytes("4"));
+  EXPECT_EQ(values[1], ToBytes("1"));
+  EXPECT_EQ(values[2], ToBytes("5"));
+}
+
+// The rendezvous of many ranks on loopback: every rank sets its address,
+// waits on a barrier and gets the addresses of its peers, by one get per
+// peer and by one multi_get. Run with GLOG_v=3 to see the timings.
+TEST(TCPStore, many_clients) {
+  const int kNumPeers = 8;
+  const int kNumThreads = 16;
+  int num_clients = 2048;
+  // a client and its connection on the server take 2 fds
+  ::rlimit limit{};
+  ::getrlimit(RLIMIT_NOFILE, &limit);
+  limit.rlim_cur = std::max<rlim_t>(
+      limit.rlim_cur, std::min<rlim_t>(limit.rlim_max, 2 * num_clients + 256));
+  ::setrlimit(RLIMIT_NOFILE, &limit);
+  num_clients = std::min<int>(
+      num_clients, (static_cast<int64_t>(limit.rlim_cur) - 256) / 2);
+  ASSERT_GE(num_clients, kNumThreads);
+
+  uint16_t port = 0;
+  auto daemon = StartMasterDaemon(&port);
+  std::vector<std::unique_ptr<TCPStore>> stores(num_clients);
+  for (auto& store : stores) {
+    store = std::make_unique<TCPStore>("127.0.0.1", port, false, 0);
+  }
+
+  // Runs func on the ranks of each thread, then returns the time in ms.
+  auto run = [&](const std::function<void(int)>& func) {
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&, t] {
+        for (int rank = t; rank < num_clients; rank += kNumThreads) {
+          func(rank);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - begin)
+        .count();
+  };
+  auto addr_key = [](int rank) { return "addr/" + std::to_string(rank); };
+
+  double set_time = run([&](int rank) {
+    stores[rank]->set(addr_key(rank), ToBytes(std::to_string(rank)));
+  });
+  // Every rank adds before any waits in its thread, so that the barrier is
+  // released by the last add.
+  double barrier_time = run([&](int rank) {
+    if (stores[rank]->add("barrier", 1) == num_clients) {
+      stores[rank]->set("barrier/done", ToBytes("1"));
+    }
+  });
+  barrier_time += run([&](int rank) { stores[rank]->wait("barrier/done"); });
+
+  std::vector<std::vector<std::string>> peer_keys(num_clients);
+  for (int rank = 0; rank < num_clients; ++rank) {
+    for (int i = 1; i <= kNumPeers; ++i) {
+      peer_keys[rank].emplace_back(addr_key((rank + i) % num_clients));
+    }
+  }
+  double get_time = run([&](int rank) {
+    for (const auto& key : peer_keys[rank]) {
+      stores[rank]->get(key);
+    }
+  });
+  double multi_get_time = run([&](int rank) {
+    auto values = stores[rank]->multi_get(peer_keys[rank]);
+    EXPECT_EQ(values[0], ToBytes(std::to_string((rank + 1) % num_clients)));
+  });
+
+  VLOG(3) << num_clients << " clients, set takes: " << set_time
+          << " ms, barrier takes: " << barrier_time << " ms, get of "
+          << kNumPeers << " peers takes: " << get_time
+          << " ms, multi_get takes: " << multi_get_time << " ms";
+  stores.clear();
+}
+#endif
+
 /* now for only c compile test
 TEST(TCPStore, init) {
   TCPStore store("127.0.0.1", 6170, true, 1);
@@ -0,0 +1,171 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/funcs/direct_conv.h"
+
+namespace phi {
+namespace tests {
+
+struct ConvParam {
+  int batch;
+  int in_c;
+  int in_h;
+  int in_w;
+  int out_c;
+  int k_h;
+  int k_w;
+  int groups;
+  std::vector<int> strides;
+  std::vector<int> paddings;  // up, down, left, right
+  std::vector<int> dilations;
+};
+
+int OutSize(int in, int k, int stride, int pad0, int pad1, int dilation) {
+  return (in + pad0 + pad1 - (dilation * (k - 1) + 1)) / stride + 1;
+}
+
+template <typename T>
+std::vector<T> RefConv2D(const ConvParam& p,
+                         const std::vector<T>& input,
+                         const std::vector<T>& filter,
+                         int out_h,
+                         int out_w) {
+  int in_c_g = p.in_c / p.groups;
+  int out_c_g = p.out_c / p.groups;
+  std::vector<T> out(p.batch * p.out_c * out_h * out_w, 0);
+  for (int n = 0; n < p.batch; ++n) {
+    for (int oc = 0; oc < p.out_c; ++oc) {
+      int g = oc / out_c_g;
+      for (int oh = 0; oh < out_h; ++oh) {
+        for (int ow = 0; ow < out_w; ++ow) {
+          T sum = 0;
+          for (int ic = 0; ic < in_c_g; ++ic) {
+            for (int kh = 0; kh < p.k_h; ++kh) {
+              for (int kw = 0; kw < p.k_w; ++kw) {
+                int ih =
+                    oh * p.strides[0] - p.paddings[0] + kh * p.dilations[0];
+                int iw =
+                    ow * p.strides[1] - p.paddings[2] + kw * p.dilations[1];
+                if (ih < 0 || ih >= p.in_h || iw < 0 || iw >= p.in_w) {
+                  continue;
+                }
+                int c = g * in_c_g + ic;
+                sum += input[((n * p.in_c + c) * p.in_h + ih) * p.in_w + iw] *
+                       filter[((oc * in_c_g + ic) * p.k_h + kh) * p.k_w + kw];
+              }
+            }
+          }
+          out[((n * p.out_c + oc) * out_h + oh) * out_w + ow] = sum;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+template <typename T>
+void TestDirectConv2D(const ConvParam& p) {
+  auto* dev_ctx = static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  int out_h = OutSize(p.in_h,
+                      p.k_h,
+                      p.strides[0],
+                      p.paddings[0],
+                      p.paddings[1],
+                      p.dilations[0]);
+  int out_w = OutSize(p.in_w,
+                      p.k_w,
+                      p.strides[1],
+                      p.paddings[2],
+                      p.paddings[3],
+                      p.dilations[1]);
+
+  phi::DenseTensor input, filter, output;
+  input.Resize({p.batch, p.in_c, p.in_h, p.in_w});
+  filter.Resize({p.out_c, p.in_c / p.groups, p.k_h, p.k_w});
+  output.Resize({p.batch, p.out_c, out_h, out_w});
+  T* input_data = dev_ctx->template Alloc<T>(&input);
+  T* filter_data = dev_ctx->template Alloc<T>(&filter);
+
+  std::mt19937 rng(2024);
+  std::uniform_real_distribution<T> dist(-1, 1);
+  std::vector<T> input_vec(input.numel());
+  std::vector<T> filter_vec(filter.numel());
+  for (auto& v : input_vec) v = dist(rng);
+  for (auto& v : filter_vec) v = dist(rng);
+  std::copy(input_vec.begin(), input_vec.end(), input_data);
+  std::copy(filter_vec.begin(), filter_vec.end(), filter_data);
+
+  phi::funcs::DirectConv2D<T>(*dev_ctx,
+                              input,
+                              filter,
+                              p.strides,
+                              p.paddings,
+                              p.dilations,
+                              p.groups,
+                              &output);
+
+  auto ref = RefConv2D<T>(p, input_vec, filter_vec, out_h, out_w);
+  const T* out_data = output.data<T>();
+  ASSERT_EQ(output.numel(), static_cast<int64_t>(ref.size()));
+  for (size_t i = 0; i < ref.size(); ++i) {
+    EXPECT_NEAR(out_data[i], ref[i], 1e-4);
+  }
+}
+
+TEST(DirectConv2D, small_channels) {
+  // The first layer of vision models.
+  TestDirectConv2D<float>(
+      {2, 3, 17, 19, 16, 3, 3, 1, {1, 1}, {1, 1, 1, 1}, {1, 1}});
+  // Output channels not divisible by the block size, strided and asymmetric
+  // padding.
+  TestDirectConv2D<float>(
+      {1, 3, 15, 13, 13, 3, 3, 1, {2, 2}, {0, 1, 1, 0}, {1, 1}});
+  // Grouped and dilated.
+  TestDirectConv2D<double>(
+      {2, 8, 11, 12, 12, 3, 3, 4, {1, 2}, {2, 2, 2, 2}, {2, 2}});
+  // Depthwise with channel multiplier.
+  TestDirectConv2D<float>(
+      {1, 4, 9, 10, 8, 5, 5, 4, {1, 1}, {2, 2, 2, 2}, {1, 1}});
+}
+
+TEST(DirectConv2D, depthwise) {
+  TestDirectConv2D<float>(
+      {2, 6, 14, 15, 6, 3, 3, 6, {1, 1}, {1, 1, 1, 1}, {1, 1}});
+  TestDirectConv2D<float>(
+      {1, 5, 16, 16, 5, 3, 3, 5, {2, 2}, {1, 1, 1, 1}, {1, 1}});
+  TestDirectConv2D<double>(
+      {1, 3, 12, 9, 3, 3, 5, 3, {1, 3}, {0, 0, 3, 1}, {2, 1}});
+}
+
+TEST(DirectConv2D, dispatch) {
+  // Depthwise.
+  EXPECT_TRUE(phi::funcs::UseDirectConv2D({32, 1, 3, 3}, 32, true));
+  // Small reduction size.
+  EXPECT_TRUE(phi::funcs::UseDirectConv2D({64, 3, 3, 3}, 1, true));
+  // Plain gemm.
+  EXPECT_FALSE(phi::funcs::UseDirectConv2D({64, 64, 1, 1}, 1, false));
+  // Large reduction size.
+  EXPECT_FALSE(phi::funcs::UseDirectConv2D({64, 64, 3, 3}, 1, true));
+}
+
+}  // namespace tests
+}  // namespace phi
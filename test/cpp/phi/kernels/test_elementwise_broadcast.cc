@@ -0,0 +1,141 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/funcs/elementwise_base.h"
+#include "paddle/phi/kernels/funcs/elementwise_grad_base.h"
+
+namespace phi {
+namespace tests {
+
+const phi::CPUContext& GetCPUContext() {
+  return *static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+}
+
+DenseTensor MakeTensor(const std::vector<int64_t>& dims) {
+  DenseTensor t;
+  t.Resize(common::make_ddim(dims));
+  float* data = GetCPUContext().template Alloc<float>(&t);
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    data[i] = static_cast<float>((i * 7) % 13);
+  }
+  return t;
+}
+
+// The index of an element of the output in an input of rank out_rank, with
+// its dims aligned to the trailing output dims.
+int64_t InputIndex(const DDim& in_dims,
+                   const DDim& out_dims,
+                   int64_t out_index) {
+  int64_t index = 0, stride = 1;
+  int offset = out_dims.size() - in_dims.size();
+  for (int i = out_dims.size() - 1; i >= 0; --i) {
+    int64_t idx = out_index % out_dims[i];
+    out_index /= out_dims[i];
+    if (i >= offset) {
+      int64_t dim = in_dims[i - offset];
+      index += (dim == 1 ? 0 : idx) * stride;
+      stride *= dim;
+    }
+  }
+  return index;
+}
+
+struct SubFunctor {
+  float operator()(float a, float b) const { return a - b; }
+};
+
+struct SubGradDX {
+  float operator()(float x, float y, float out, float dout) const {
+    return dout * 2 + y;
+  }
+};
+
+struct SubGradDY {
+  float operator()(float x, float y, float out, float dout) const {
+    return -dout + x;
+  }
+};
+
+void CheckBroadcast(const std::vector<int64_t>& x_shape,
+                    const std::vector<int64_t>& y_shape,
+                    const std::vector<int64_t>& out_shape) {
+  const auto& dev_ctx = GetCPUContext();
+  auto x = MakeTensor(x_shape);
+  auto y = MakeTensor(y_shape);
+  DenseTensor out;
+  out.Resize(common::make_ddim(out_shape));
+  funcs::ElementwiseCompute<SubFunctor, float>(
+      dev_ctx, x, y, SubFunctor(), &out);
+  auto dout = MakeTensor(out_shape);
+  DenseTensor dx, dy;
+  dx.Resize(x.dims());
+  dy.Resize(y.dims());
+  funcs::ElemwiseGradComputeWithBroadcast<float, SubGradDX, SubGradDY>(
+      dev_ctx,
+      x.dims(),
+      y.dims(),
+      x,
+      y,
+      out,
+      dout,
+      -1,
+      &dx,
+      &dy,
+      SubGradDX(),
+      SubGradDY());
+
+  std::vector<float> ref_dx(x.numel(), 0), ref_dy(y.numel(), 0);
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    int64_t xi = InputIndex(x.dims(), out.dims(), i);
+    int64_t yi = InputIndex(y.dims(), out.dims(), i);
+    float xv = x.data<float>()[xi], yv = y.data<float>()[yi];
+    float dv = dout.data<float>()[i];
+    // x - y when x is the larger one, and y - x otherwise as the CPU
+    // elementwise compute is called with the inverse functor
+    float expected = x.dims().size() >= y.dims().size() ? xv - yv : yv - xv;
+    ASSERT_EQ(out.data<float>()[i], expected) << "at " << i;
+    ref_dx[xi] += SubGradDX()(xv, yv, 0, dv);
+    ref_dy[yi] += SubGradDY()(xv, yv, 0, dv);
+  }
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    ASSERT_NEAR(dx.data<float>()[i], ref_dx[i], 1e-3) << "at " << i;
+  }
+  for (int64_t i = 0; i < y.numel(); ++i) {
+    ASSERT_NEAR(dy.data<float>()[i], ref_dy[i], 1e-3) << "at " << i;
+  }
+}
+
+TEST(ElementwiseBroadcast, patterns) {
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    // scalar, row, column, mid and general
+    CheckBroadcast({3, 1000, 17}, {1}, {3, 1000, 17});
+    CheckBroadcast({4096, 64}, {64}, {4096, 64});
+    CheckBroadcast({4096, 64}, {4096, 1}, {4096, 64});
+    CheckBroadcast({8, 300, 50}, {1, 300, 1}, {8, 300, 50});
+    CheckBroadcast({2, 3, 1, 5}, {2, 1, 4, 1}, {2, 3, 4, 5});
+    CheckBroadcast({1, 5000, 3}, {4, 1, 3}, {4, 5000, 3});
+    CheckBroadcast({64}, {4096, 64}, {4096, 64});
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+}  // namespace tests
+}  // namespace phi
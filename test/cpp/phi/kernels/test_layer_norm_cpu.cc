@@ -0,0 +1,315 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/kernels/funcs/layer_norm_cpu.h"
+
+namespace phi {
+namespace tests {
+
+const phi::CPUContext& GetCPUContext() {
+  return *static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+}
+
+std::vector<double> RandomVector(int64_t n, double shift, int seed) {
+  std::mt19937 engine(seed);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<double> v(n);
+  for (auto& e : v) {
+    e = dist(engine) + shift;
+  }
+  return v;
+}
+
+template <typename T>
+std::vector<T> Cast(const std::vector<double>& v) {
+  std::vector<T> out(v.size());
+  for (size_t i = 0; i < v.size(); ++i) {
+    out[i] = static_cast<T>(v[i]);
+  }
+  return out;
+}
+
+// Two-pass layer norm in double.
+void RefLayerNorm(const std::vector<double>& x,
+                  const std::vector<double>& scale,
+                  const std::vector<double>& bias,
+                  int64_t rows,
+                  int64_t cols,
+                  double epsilon,
+                  std::vector<double>* y,
+                  std::vector<double>* mean,
+                  std::vector<double>* var) {
+  y->resize(rows * cols);
+  mean->resize(rows);
+  var->resize(rows);
+  for (int64_t r = 0; r < rows; ++r) {
+    double m = 0, v = 0;
+    for (int64_t j = 0; j < cols; ++j) m += x[r * cols + j];
+    m /= cols;
+    for (int64_t j = 0; j < cols; ++j) {
+      v += (x[r * cols + j] - m) * (x[r * cols + j] - m);
+    }
+    v /= cols;
+    (*mean)[r] = m;
+    (*var)[r] = v;
+    for (int64_t j = 0; j < cols; ++j) {
+      (*y)[r * cols + j] =
+          (x[r * cols + j] - m) / std::sqrt(v + epsilon) * scale[j] + bias[j];
+    }
+  }
+}
+
+TEST(LayerNormCPU, forward) {
+  const auto& ctx = GetCPUContext();
+  const double epsilon = 1e-5;
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (int64_t cols : {1, 15, 16, 33, 768, 4099}) {
+      const int64_t rows = 37;
+      // A large shift makes the sum of squares formula lose the variance.
+      auto x = RandomVector(rows * cols, 1000.0, 1);
+      auto scale = RandomVector(cols, 0.0, 2);
+      auto bias = RandomVector(cols, 0.0, 3);
+      std::vector<double> ref_y, ref_mean, ref_var;
+      RefLayerNorm(
+          x, scale, bias, rows, cols, epsilon, &ref_y, &ref_mean, &ref_var);
+
+      auto xf = Cast<float>(x);
+      auto scalef = Cast<float>(scale);
+      auto biasf = Cast<float>(bias);
+      std::vector<float> y(rows * cols), mean(rows), var(rows);
+      phi::funcs::LayerNormForwardCPU<float, float>(ctx,
+                                                    xf.data(),
+                                                    scalef.data(),
+                                                    biasf.data(),
+                                                    rows,
+                                                    cols,
+                                                    epsilon,
+                                                    y.data(),
+                                                    mean.data(),
+                                                    var.data());
+      for (int64_t r = 0; r < rows; ++r) {
+        EXPECT_NEAR(mean[r], ref_mean[r], 1e-3);
+        EXPECT_NEAR(var[r], ref_var[r], 1e-3 * (ref_var[r] + 1e-3));
+      }
+      for (int64_t i = 0; i < rows * cols; ++i) {
+        EXPECT_NEAR(y[i], ref_y[i], 2e-2) << "cols " << cols;
+      }
+
+      // float16 inputs with float scale and bias accumulate in float.
+      auto xh = Cast<phi::dtype::float16>(RandomVector(rows * cols, 0.5, 4));
+      std::vector<double> xd(rows * cols);
+      for (int64_t i = 0; i < rows * cols; ++i) {
+        xd[i] = static_cast<float>(xh[i]);
+      }
+      RefLayerNorm(
+          xd, scale, bias, rows, cols, epsilon, &ref_y, &ref_mean, &ref_var);
+      std::vector<phi::dtype::float16> yh(rows * cols);
+      phi::funcs::LayerNormForwardCPU<phi::dtype::float16, float>(
+          ctx,
+          xh.data(),
+          scalef.data(),
+          biasf.data(),
+          rows,
+          cols,
+          epsilon,
+          yh.data(),
+          mean.data(),
+          var.data());
+      for (int64_t i = 0; i < rows * cols; ++i) {
+        EXPECT_NEAR(static_cast<float>(yh[i]), ref_y[i], 1e-2);
+      }
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+// Checks the grads against central differences of sum(y * w).
+TEST(LayerNormCPU, backward) {
+  const auto& ctx = GetCPUContext();
+  const double epsilon = 1e-5;
+  const int64_t rows = 5;
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (int64_t cols : {3, 17, 40}) {
+      auto x = RandomVector(rows * cols, 0.3, 5);
+      auto scale = RandomVector(cols, 0.0, 6);
+      auto bias = RandomVector(cols, 0.0, 7);
+      auto w = RandomVector(rows * cols, 0.0, 8);
+      std::vector<double> y(rows * cols), mean(rows), var(rows);
+      auto loss = [&](const std::vector<double>& xs,
+                      const std::vector<double>& ss,
+                      const std::vector<double>& bs) {
+        phi::funcs::LayerNormForwardCPU<double, double>(ctx,
+                                                        xs.data(),
+                                                        ss.data(),
+                                                        bs.data(),
+                                                        rows,
+                                                        cols,
+                                                        epsilon,
+                                                        y.data(),
+                                                        mean.data(),
+                                                        var.data());
+        double l = 0;
+        for (int64_t i = 0; i < rows * cols; ++i) l += y[i] * w[i];
+        return l;
+      };
+      loss(x, scale, bias);
+      std::vector<double> dx(rows * cols), dscale(cols), dbias(cols);
+      phi::funcs::LayerNormBackwardCPU<double, double>(ctx,
+                                                       x.data(),
+                                                       w.data(),
+                                                       scale.data(),
+                                                       mean.data(),
+                                                       var.data(),
+                                                       rows,
+                                                       cols,
+                                                       epsilon,
+                                                       dx.data(),
+                                                       dscale.data(),
+                                                       dbias.data());
+      const double h = 1e-6;
+      for (int64_t i = 0; i < rows * cols; ++i) {
+        auto xp = x, xm = x;
+        xp[i] += h;
+        xm[i] -= h;
+        double num = (loss(xp, scale, bias) - loss(xm, scale, bias)) / (2 * h);
+        EXPECT_NEAR(dx[i], num, 1e-5);
+      }
+      for (int64_t j = 0; j < cols; ++j) {
+        auto sp = scale, sm = scale, bp = bias, bm = bias;
+        sp[j] += h;
+        sm[j] -= h;
+        bp[j] += h;
+        bm[j] -= h;
+        double num_dscale = (loss(x, sp, bias) - loss(x, sm, bias)) / (2 * h);
+        double num_dbias = (loss(x, scale, bp) - loss(x, scale, bm)) / (2 * h);
+        EXPECT_NEAR(dscale[j], num_dscale, 1e-5);
+        EXPECT_NEAR(dbias[j], num_dbias, 1e-5);
+      }
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+TEST(RmsNormCPU, forward_and_backward) {
+  const auto& ctx = GetCPUContext();
+  const double epsilon = 1e-6;
+  const int64_t rows = 6;
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (int64_t cols : {5, 16, 50}) {
+      auto x = RandomVector(rows * cols, 0.1, 9);
+      auto residual = RandomVector(rows * cols, 0.0, 10);
+      auto bias = RandomVector(cols, 0.0, 11);
+      auto weight = RandomVector(cols, 0.0, 12);
+      auto norm_bias = RandomVector(cols, 0.0, 13);
+
+      std::vector<double> y(rows * cols), residual_out(rows * cols);
+      std::vector<float> inv_var(rows);
+      phi::funcs::RmsNormForwardCPU<double>(ctx,
+                                            x.data(),
+                                            bias.data(),
+                                            residual.data(),
+                                            weight.data(),
+                                            norm_bias.data(),
+                                            rows,
+                                            cols,
+                                            epsilon,
+                                            y.data(),
+                                            residual_out.data(),
+                                            inv_var.data());
+      for (int64_t r = 0; r < rows; ++r) {
+        double sum_square = 0;
+        for (int64_t j = 0; j < cols; ++j) {
+          double v = x[r * cols + j] + residual[r * cols + j] + bias[j];
+          EXPECT_DOUBLE_EQ(residual_out[r * cols + j], v);
+          sum_square += v * v;
+        }
+        double inv = 1.0 / std::sqrt(sum_square / cols + epsilon);
+        EXPECT_NEAR(inv_var[r], inv, 1e-5 * inv);
+        for (int64_t j = 0; j < cols; ++j) {
+          double v = residual_out[r * cols + j];
+          EXPECT_NEAR(
+              y[r * cols + j], v * inv * weight[j] + norm_bias[j], 1e-9);
+        }
+      }
+
+      // The grad is checked without residual, as the kernel supports it.
+      auto w = RandomVector(rows * cols, 0.0, 14);
+      auto loss = [&](const std::vector<double>& xs,
+                      const std::vector<double>& ws) {
+        phi::funcs::RmsNormForwardCPU<double>(ctx,
+                                              xs.data(),
+                                              nullptr,
+                                              nullptr,
+                                              ws.data(),
+                                              nullptr,
+                                              rows,
+                                              cols,
+                                              epsilon,
+                                              y.data(),
+                                              nullptr,
+                                              nullptr);
+        double l = 0;
+        for (int64_t i = 0; i < rows * cols; ++i) l += y[i] * w[i];
+        return l;
+      };
+      std::vector<float> inv_varf(rows);
+      for (int64_t r = 0; r < rows; ++r) {
+        double sum_square = 0;
+        for (int64_t j = 0; j < cols; ++j) {
+          sum_square += x[r * cols + j] * x[r * cols + j];
+        }
+        inv_varf[r] = 1.0 / std::sqrt(sum_square / cols + epsilon);
+      }
+      std::vector<double> dx(rows * cols), dweight(cols);
+      phi::funcs::RmsNormBackwardCPU<double>(ctx,
+                                             x.data(),
+                                             w.data(),
+                                             weight.data(),
+                                             inv_varf.data(),
+                                             rows,
+                                             cols,
+                                             dx.data(),
+                                             dweight.data());
+      const double h = 1e-6;
+      for (int64_t i = 0; i < rows * cols; ++i) {
+        auto xp = x, xm = x;
+        xp[i] += h;
+        xm[i] -= h;
+        EXPECT_NEAR(
+            dx[i], (loss(xp, weight) - loss(xm, weight)) / (2 * h), 1e-4);
+      }
+      for (int64_t j = 0; j < cols; ++j) {
+        auto wp = weight, wm = weight;
+        wp[j] += h;
+        wm[j] -= h;
+        EXPECT_NEAR(dweight[j], (loss(x, wp) - loss(x, wm)) / (2 * h), 1e-4);
+      }
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,250 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <functional>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/kernels/funcs/scan_cpu.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+const phi::CPUContext& GetCPUContext() {
+  return *static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+}
+
+// The serial loop of [outer, mid, inner] the CPU kernels used before.
+template <typename T, typename Functor>
+void RefScan(const std::vector<T>& x,
+             int64_t outer,
+             int64_t mid,
+             int64_t inner,
+             bool exclusive,
+             bool reverse,
+             T identity,
+             Functor functor,
+             std::vector<T>* out) {
+  out->resize(x.size());
+  for (int64_t o = 0; o < outer; ++o) {
+    for (int64_t k = 0; k < inner; ++k) {
+      T acc = identity;
+      for (int64_t p = 0; p < mid; ++p) {
+        const int64_t j = reverse ? mid - 1 - p : p;
+        const int64_t offset = (o * mid + j) * inner + k;
+        if (exclusive) {
+          (*out)[offset] = acc;
+          acc = functor(acc, x[offset]);
+        } else {
+          acc = functor(acc, x[offset]);
+          (*out)[offset] = acc;
+        }
+      }
+    }
+  }
+}
+
+struct Shape {
+  int64_t outer;
+  int64_t mid;
+  int64_t inner;
+};
+
+TEST(ScanCPU, cumsum_and_cumprod) {
+  // The long single rows take the two-phase scan with 4 threads.
+  const std::vector<Shape> shapes = {{1, 1, 1},
+                                     {7, 33, 1},
+                                     {3, 17, 5},
+                                     {2, 9, 130},
+                                     {1, 100000, 1},
+                                     {1, 3000, 70}};
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& s : shapes) {
+      const int64_t numel = s.outer * s.mid * s.inner;
+      std::vector<int64_t> x(numel);
+      for (int64_t i = 0; i < numel; ++i) {
+        x[i] = i % 7 - 3;
+      }
+      for (bool exclusive : {false, true}) {
+        for (bool reverse : {false, true}) {
+          std::vector<int64_t> ref;
+          RefScan<int64_t>(x,
+                           s.outer,
+                           s.mid,
+                           s.inner,
+                           exclusive,
+                           reverse,
+                           0,
+                           std::plus<int64_t>(),
+                           &ref);
+          std::vector<int64_t> out(numel);
+          phi::funcs::ValueScanCPU<int64_t>(GetCPUContext(),
+                                            x.data(),
+                                            out.data(),
+                                            s.outer,
+                                            s.mid,
+                                            s.inner,
+                                            exclusive,
+                                            reverse,
+                                            0,
+                                            std::plus<int64_t>());
+          EXPECT_EQ(out, ref) << "cumsum " << s.outer << " " << s.mid << " "
+                              << s.inner << " " << exclusive << reverse;
+
+          // The products wrap around but stay exact, and the scan runs in
+          // place.
+          RefScan<int64_t>(x,
+                           s.outer,
+                           s.mid,
+                           s.inner,
+                           exclusive,
+                           reverse,
+                           1,
+                           std::multiplies<int64_t>(),
+                           &ref);
+          out = x;
+          phi::funcs::ValueScanCPU<int64_t>(GetCPUContext(),
+                                            out.data(),
+                                            out.data(),
+                                            s.outer,
+                                            s.mid,
+                                            s.inner,
+                                            exclusive,
+                                            reverse,
+                                            1,
+                                            std::multiplies<int64_t>());
+          EXPECT_EQ(out, ref) << "cumprod " << s.outer << " " << s.mid << " "
+                              << s.inner << " " << exclusive << reverse;
+        }
+      }
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+// A scan whose state is not the value, the running max and its first index.
+struct ArgMaxScanOp {
+  struct State {
+    float value;
+    int64_t index;
+  };
+
+  ArgMaxScanOp(const float* x, int64_t* indices) : x_(x), indices_(indices) {}
+
+  State Identity() const { return {-1e30f, -1}; }
+  State Load(int64_t offset, int64_t j) const { return {x_[offset], j}; }
+  State Merge(const State& a, const State& b) const {
+    return b.value > a.value ? b : a;
+  }
+  void Store(const State& acc, int64_t offset) const {
+    indices_[offset] = acc.index;
+  }
+
+ private:
+  const float* x_;
+  int64_t* indices_;
+};
+
+TEST(ScanCPU, index_state) {
+  const std::vector<Shape> shapes = {{5, 40, 3}, {1, 200000, 1}};
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& s : shapes) {
+      const int64_t numel = s.outer * s.mid * s.inner;
+      std::vector<float> x(numel);
+      for (int64_t i = 0; i < numel; ++i) {
+        x[i] = static_cast<float>((i * 7919) % 10007);
+      }
+      std::vector<int64_t> indices(numel);
+      phi::funcs::ScanCPU(GetCPUContext(),
+                          ArgMaxScanOp(x.data(), indices.data()),
+                          s.outer,
+                          s.mid,
+                          s.inner,
+                          false,
+                          false);
+      for (int64_t o = 0; o < s.outer; ++o) {
+        for (int64_t k = 0; k < s.inner; ++k) {
+          int64_t best = 0;
+          for (int64_t j = 0; j < s.mid; ++j) {
+            const int64_t offset = (o * s.mid + j) * s.inner + k;
+            if (x[offset] > x[(o * s.mid + best) * s.inner + k]) {
+              best = j;
+            }
+            ASSERT_EQ(indices[offset], best);
+          }
+        }
+      }
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+// Compares the scan engine with the serial loop on a long cumsum and a
+// cumsum over a non-last axis, run with GLOG_v=3 to see the timings.
+TEST(ScanCPU, benchmark) {
+  const std::vector<Shape> shapes = {{1, 1 << 24, 1}, {64, 256, 1024}};
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& s : shapes) {
+      std::vector<float> x(s.outer * s.mid * s.inner, 1.0f);
+      std::vector<float> out(x.size()), ref;
+
+      auto st = GetCurrentUS();
+      phi::funcs::ValueScanCPU<float>(GetCPUContext(),
+                                      x.data(),
+                                      out.data(),
+                                      s.outer,
+                                      s.mid,
+                                      s.inner,
+                                      false,
+                                      false,
+                                      0.0f,
+                                      std::plus<float>());
+      auto mt = GetCurrentUS();
+      RefScan<float>(x,
+                     s.outer,
+                     s.mid,
+                     s.inner,
+                     false,
+                     false,
+                     0.0f,
+                     std::plus<float>(),
+                     &ref);
+      auto et = GetCurrentUS();
+
+      VLOG(3) << "[" << s.outer << ", " << s.mid << ", " << s.inner
+              << "] with " << num_threads
+              << " threads: serial loop takes: " << (et - mt) / 1000
+              << " ms, scan engine takes: " << (mt - st) / 1000 << " ms";
+      // Sums of ones stay exact in float up to 2^24.
+      EXPECT_EQ(out, ref);
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+}  // namespace tests
+}  // namespace phi
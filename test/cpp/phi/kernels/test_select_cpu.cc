@@ -0,0 +1,257 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/kernels/funcs/select_cpu.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+const phi::CPUContext& GetCPUContext() {
+  return *static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+}
+
+struct Shape {
+  int64_t outer;
+  int64_t width;
+  int64_t inner;
+};
+
+// Values with many ties, signed zeros and NaN.
+template <typename T>
+std::vector<T> RandomValues(int64_t n, int seed) {
+  std::mt19937 engine(seed);
+  std::uniform_int_distribution<int> dist(-50, 50);
+  std::vector<T> v(n);
+  for (auto& e : v) {
+    const int r = dist(engine);
+    if (std::is_floating_point<T>::value && r == 50) {
+      e = std::numeric_limits<T>::quiet_NaN();
+    } else if (std::is_floating_point<T>::value && r == -50) {
+      e = static_cast<T>(-0.0);
+    } else {
+      e = static_cast<T>(r);
+    }
+  }
+  return v;
+}
+
+// The stable sort of a row with the comparators the kernels used before,
+// NaN is larger than any number.
+template <typename T>
+std::vector<int64_t> RefSortedIndices(const std::vector<T>& x,
+                                      const Shape& s,
+                                      int64_t o,
+                                      int64_t r,
+                                      bool descending) {
+  std::vector<int64_t> ids(s.width);
+  for (int64_t j = 0; j < s.width; ++j) {
+    ids[j] = j;
+  }
+  auto at = [&](int64_t j) {
+    return static_cast<double>(x[(o * s.width + j) * s.inner + r]);
+  };
+  std::stable_sort(ids.begin(), ids.end(), [&](int64_t a, int64_t b) {
+    if (descending) {
+      return (std::isnan(at(a)) && !std::isnan(at(b))) || at(a) > at(b);
+    }
+    return (!std::isnan(at(a)) && std::isnan(at(b))) || at(a) < at(b);
+  });
+  return ids;
+}
+
+template <typename T>
+void TestTopK(const Shape& s, int64_t k, bool largest) {
+  auto x = RandomValues<T>(s.outer * s.width * s.inner, 1);
+  std::vector<T> out(s.outer * k * s.inner);
+  std::vector<int64_t> indices(out.size());
+  phi::funcs::TopKCPU<T>(GetCPUContext(),
+                         x.data(),
+                         s.outer,
+                         s.width,
+                         s.inner,
+                         k,
+                         largest,
+                         true,
+                         out.data(),
+                         indices.data());
+  for (int64_t o = 0; o < s.outer; ++o) {
+    for (int64_t r = 0; r < s.inner; ++r) {
+      auto ref = RefSortedIndices(x, s, o, r, largest);
+      for (int64_t j = 0; j < k; ++j) {
+        const int64_t offset = (o * k + j) * s.inner + r;
+        ASSERT_EQ(indices[offset], ref[j])
+            << "width " << s.width << " k " << k << " largest " << largest;
+        const T expected = x[(o * s.width + ref[j]) * s.inner + r];
+        ASSERT_TRUE(out[offset] == expected ||
+                    (std::isnan(static_cast<double>(out[offset])) &&
+                     std::isnan(static_cast<double>(expected))));
+      }
+    }
+  }
+}
+
+template <typename T>
+void TestArgsort(const Shape& s, bool descending) {
+  auto x = RandomValues<T>(s.outer * s.width * s.inner, 2);
+  std::vector<T> out(x.size());
+  std::vector<int64_t> indices(x.size());
+  phi::funcs::ArgsortCPU<T>(GetCPUContext(),
+                            x.data(),
+                            s.outer,
+                            s.width,
+                            s.inner,
+                            descending,
+                            out.data(),
+                            indices.data());
+  for (int64_t o = 0; o < s.outer; ++o) {
+    for (int64_t r = 0; r < s.inner; ++r) {
+      auto ref = RefSortedIndices(x, s, o, r, descending);
+      for (int64_t j = 0; j < s.width; ++j) {
+        const int64_t offset = (o * s.width + j) * s.inner + r;
+        ASSERT_EQ(indices[offset], ref[j])
+            << "width " << s.width << " descending " << descending;
+      }
+    }
+  }
+}
+
+TEST(SelectCPU, topk) {
+  // The long single row is split into chunks with 4 threads.
+  const std::vector<Shape> shapes = {
+      {5, 1, 1}, {7, 40, 1}, {3, 300, 4}, {1, 100000, 1}};
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& s : shapes) {
+      for (int64_t k : {1, 5, 16, 17, 40, 100}) {
+        if (k > s.width) continue;
+        for (bool largest : {true, false}) {
+          TestTopK<float>(s, k, largest);
+          TestTopK<int64_t>(s, k, largest);
+        }
+      }
+    }
+    TestTopK<phi::dtype::float16>({4, 1000, 2}, 10, true);
+    TestTopK<double>({4, 1000, 2}, 1000, false);
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+TEST(SelectCPU, argsort) {
+  const std::vector<Shape> shapes = {
+      {5, 1, 1}, {7, 40, 1}, {3, 600, 4}, {2, 5000, 1}, {1, 100000, 1}};
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& s : shapes) {
+      for (bool descending : {false, true}) {
+        TestArgsort<float>(s, descending);
+        TestArgsort<double>(s, descending);
+        TestArgsort<int>(s, descending);
+        TestArgsort<int64_t>(s, descending);
+      }
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+// Compares the engine with the partial sort of pairs the kernels used
+// before on a retrieval sized row, run with GLOG_v=3 to see the timings.
+TEST(SelectCPU, benchmark) {
+  const int64_t width = 1 << 22;
+  std::mt19937 engine(3);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> x(width);
+  for (auto& e : x) {
+    e = dist(engine);
+  }
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (int64_t k : {10, 1000}) {
+      std::vector<float> out(k);
+      std::vector<int64_t> indices(k);
+
+      auto st = GetCurrentUS();
+      phi::funcs::TopKCPU<float>(GetCPUContext(),
+                                 x.data(),
+                                 1,
+                                 width,
+                                 1,
+                                 k,
+                                 true,
+                                 true,
+                                 out.data(),
+                                 indices.data());
+      auto mt = GetCurrentUS();
+      std::vector<std::pair<float, int64_t>> pairs(width);
+      for (int64_t j = 0; j < width; ++j) {
+        pairs[j] = {x[j], j};
+      }
+      std::partial_sort(pairs.begin(),
+                        pairs.begin() + k,
+                        pairs.end(),
+                        [](const std::pair<float, int64_t>& l,
+                           const std::pair<float, int64_t>& r) {
+                          return l.first > r.first;
+                        });
+      auto et = GetCurrentUS();
+
+      VLOG(3) << "topk " << k << " of " << width << " with " << num_threads
+              << " threads: partial sort takes: " << (et - mt) / 1000
+              << " ms, select engine takes: " << (mt - st) / 1000 << " ms";
+      for (int64_t j = 0; j < k; ++j) {
+        ASSERT_EQ(out[j], pairs[j].first);
+      }
+    }
+
+    std::vector<float> out(width);
+    std::vector<int64_t> indices(width);
+    auto st = GetCurrentUS();
+    phi::funcs::ArgsortCPU<float>(GetCPUContext(),
+                                  x.data(),
+                                  1,
+                                  width,
+                                  1,
+                                  false,
+                                  out.data(),
+                                  indices.data());
+    auto mt = GetCurrentUS();
+    std::vector<float> ref(x);
+    std::stable_sort(ref.begin(), ref.end());
+    auto et = GetCurrentUS();
+    VLOG(3) << "argsort of " << width << " with " << num_threads
+            << " threads: stable sort takes: " << (et - mt) / 1000
+            << " ms, select engine takes: " << (mt - st) / 1000 << " ms";
+    ASSERT_EQ(out, ref);
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,198 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/blas/small_gemm.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+constexpr int repeat = 100;
+
+template <typename T>
+void RandomVec(const int n, T* a) {
+  static unsigned int seed = 100;
+  std::mt19937 rng(seed++);
+  std::uniform_real_distribution<double> uniform_dist(-1, 1);
+  for (int i = 0; i < n; ++i) {
+    a[i] = static_cast<T>(uniform_dist(rng));
+  }
+}
+
+template <typename T>
+void RefBatchedGEMM(bool trans_a,
+                    bool trans_b,
+                    int M,
+                    int N,
+                    int K,
+                    T alpha,
+                    const T* A,
+                    const T* B,
+                    T beta,
+                    T* C,
+                    int batch_count) {
+  for (int b = 0; b < batch_count; ++b) {
+    const T* a = A + b * M * K;
+    const T* bm = B + b * K * N;
+    T* c = C + b * M * N;
+    for (int i = 0; i < M; ++i) {
+      for (int j = 0; j < N; ++j) {
+        T sum = 0;
+        for (int k = 0; k < K; ++k) {
+          T a_ik = trans_a ? a[k * M + i] : a[i * K + k];
+          T b_kj = trans_b ? bm[j * K + k] : bm[k * N + j];
+          sum += a_ik * b_kj;
+        }
+        c[i * N + j] = alpha * sum + beta * c[i * N + j];
+      }
+    }
+  }
+}
+
+template <typename T>
+void TestSmallBatchedGEMM(
+    bool trans_a, bool trans_b, int M, int N, int K, T beta, int batch_count) {
+  std::vector<T> a(batch_count * M * K), b(batch_count * K * N);
+  std::vector<T> c(batch_count * M * N), c_ref;
+  RandomVec<T>(a.size(), a.data());
+  RandomVec<T>(b.size(), b.data());
+  RandomVec<T>(c.size(), c.data());
+  c_ref = c;
+
+  const T alpha = static_cast<T>(0.5);
+  phi::funcs::SmallBatchedGEMM<T>(
+      trans_a,
+      trans_b,
+      M,
+      N,
+      K,
+      alpha,
+      [&](int i) { return a.data() + i * M * K; },
+      [&](int i) { return b.data() + i * K * N; },
+      beta,
+      [&](int i) { return c.data() + i * M * N; },
+      batch_count);
+  RefBatchedGEMM<T>(trans_a,
+                    trans_b,
+                    M,
+                    N,
+                    K,
+                    alpha,
+                    a.data(),
+                    b.data(),
+                    beta,
+                    c_ref.data(),
+                    batch_count);
+  for (size_t i = 0; i < c.size(); ++i) {
+    EXPECT_NEAR(c[i], c_ref[i], 1e-4);
+  }
+}
+
+TEST(SmallGemmTest, shapes) {
+  for (int M : {1, 3, 4, 7, 16}) {
+    for (int N : {1, 5, 8, 17, 64}) {
+      for (int K : {1, 6, 32}) {
+        for (bool trans_a : {false, true}) {
+          for (bool trans_b : {false, true}) {
+            TestSmallBatchedGEMM<float>(trans_a, trans_b, M, N, K, 0.f, 3);
+            TestSmallBatchedGEMM<double>(trans_a, trans_b, M, N, K, 1.5, 2);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(SmallGemmTest, dispatch) {
+  using phi::funcs::UseSmallBatchedGEMM;
+  EXPECT_TRUE(UseSmallBatchedGEMM<float>(16, 16, 64, 8));
+  EXPECT_FALSE(UseSmallBatchedGEMM<float>(16, 16, 64, 1));
+  EXPECT_FALSE(UseSmallBatchedGEMM<float>(128, 16, 64, 8));
+  EXPECT_FALSE(UseSmallBatchedGEMM<phi::dtype::float16>(16, 16, 16, 8));
+}
+
+// Compares Blas::BatchedGEMM with a blas gemm per matrix over a sweep of
+// attention-like shapes, run with GLOG_v=3 to see the timings.
+TEST(SmallGemmTest, benchmark) {
+  auto* dev_ctx = static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  auto blas = phi::funcs::GetBlas<phi::CPUContext, float>(*dev_ctx);
+  const int batch_count = 64;
+  for (int seq_len : {4, 8, 16, 32, 64}) {
+    for (int head_dim : {16, 32, 64}) {
+      const int M = seq_len, N = seq_len, K = head_dim;
+      std::vector<float> a(batch_count * M * K), b(batch_count * K * N);
+      std::vector<float> c(batch_count * M * N), c_ref(batch_count * M * N);
+      RandomVec<float>(a.size(), a.data());
+      RandomVec<float>(b.size(), b.data());
+
+      auto st = GetCurrentUS();
+      for (int r = 0; r < repeat; ++r) {
+        blas.BatchedGEMM(CblasNoTrans,
+                         CblasTrans,
+                         M,
+                         N,
+                         K,
+                         1.f,
+                         a.data(),
+                         b.data(),
+                         0.f,
+                         c.data(),
+                         batch_count,
+                         M * K,
+                         K * N);
+      }
+      auto mt = GetCurrentUS();
+      for (int r = 0; r < repeat; ++r) {
+        for (int i = 0; i < batch_count; ++i) {
+          blas.GEMM(CblasNoTrans,
+                    CblasTrans,
+                    M,
+                    N,
+                    K,
+                    1.f,
+                    a.data() + i * M * K,
+                    b.data() + i * K * N,
+                    0.f,
+                    c_ref.data() + i * M * N);
+        }
+      }
+      auto et = GetCurrentUS();
+
+      VLOG(3) << "BatchedGEMM " << batch_count << "x[" << M << "x" << K
+              << "] * [" << K << "x" << N
+              << "]^T: gemm loop takes: " << (et - mt) / repeat
+              << " us, batched takes: " << (mt - st) / repeat << " us";
+      for (size_t i = 0; i < c.size(); ++i) {
+        EXPECT_NEAR(c[i], c_ref[i], 1e-3);
+      }
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
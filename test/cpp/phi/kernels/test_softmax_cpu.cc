@@ -0,0 +1,196 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/kernels/funcs/softmax_cpu.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+const phi::CPUContext& GetCPUContext() {
+  return *static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+}
+
+template <typename T>
+std::vector<T> RandomVector(int64_t n, T scale, int seed) {
+  std::mt19937 engine(seed);
+  std::uniform_real_distribution<T> dist(-scale, scale);
+  std::vector<T> v(n);
+  for (auto& e : v) {
+    e = dist(engine);
+  }
+  return v;
+}
+
+// Softmax along the middle dim of [outer, axis_dim, inner] in double.
+template <typename T>
+void RefSoftmax(const std::vector<T>& x,
+                int64_t outer,
+                int64_t axis_dim,
+                int64_t inner,
+                bool log,
+                std::vector<T>* out,
+                std::vector<T>* log_sum_exp) {
+  out->resize(x.size());
+  log_sum_exp->resize(outer * inner);
+  for (int64_t o = 0; o < outer; ++o) {
+    for (int64_t r = 0; r < inner; ++r) {
+      const T* px = x.data() + o * axis_dim * inner + r;
+      T* py = out->data() + o * axis_dim * inner + r;
+      double max_val = px[0];
+      for (int64_t a = 1; a < axis_dim; ++a) {
+        max_val = std::max<double>(max_val, px[a * inner]);
+      }
+      double sum = 0;
+      for (int64_t a = 0; a < axis_dim; ++a) {
+        sum += std::exp(px[a * inner] - max_val);
+      }
+      for (int64_t a = 0; a < axis_dim; ++a) {
+        double shifted = px[a * inner] - max_val;
+        py[a * inner] =
+            log ? shifted - std::log(sum) : std::exp(shifted) / sum;
+      }
+      (*log_sum_exp)[o * inner + r] = max_val + std::log(sum);
+    }
+  }
+}
+
+template <typename T>
+void TestSoftmax(
+    int64_t outer, int64_t axis_dim, int64_t inner, bool log, T scale) {
+  auto x = RandomVector<T>(outer * axis_dim * inner, scale, 1);
+  // A large logit late in the row makes the online pass rescale its sum.
+  x[x.size() - 1] = 4 * scale;
+  std::vector<T> ref, ref_lse;
+  RefSoftmax(x, outer, axis_dim, inner, log, &ref, &ref_lse);
+
+  std::vector<T> out(x.size()), lse(outer * inner);
+  phi::funcs::SoftmaxForwardCPU<T>(GetCPUContext(),
+                                   x.data(),
+                                   outer,
+                                   axis_dim,
+                                   inner,
+                                   log,
+                                   out.data(),
+                                   lse.data());
+  const double tol = std::is_same<T, float>::value ? 1e-5 : 1e-12;
+  for (size_t i = 0; i < x.size(); ++i) {
+    ASSERT_NEAR(out[i], ref[i], tol * (1 + std::abs(ref[i])))
+        << "outer " << outer << " axis_dim " << axis_dim << " inner " << inner
+        << " log " << log << " at " << i;
+  }
+  for (size_t i = 0; i < lse.size(); ++i) {
+    ASSERT_NEAR(lse[i], ref_lse[i], tol * (1 + std::abs(ref_lse[i])));
+  }
+}
+
+TEST(SoftmaxCPU, last_axis) {
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (int64_t axis_dim : {1, 7, 256, 257, 1000, 4099}) {
+      for (bool log : {false, true}) {
+        TestSoftmax<float>(33, axis_dim, 1, log, 10.0f);
+        TestSoftmax<double>(33, axis_dim, 1, log, 10.0);
+      }
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+TEST(SoftmaxCPU, other_axis) {
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (int64_t inner : {2, 31, 256, 300, 600}) {
+      for (int64_t axis_dim : {1, 5, 40}) {
+        for (bool log : {false, true}) {
+          TestSoftmax<float>(6, axis_dim, inner, log, 10.0f);
+          TestSoftmax<double>(6, axis_dim, inner, log, 10.0);
+        }
+      }
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+TEST(SoftmaxCPU, shifted_logits_are_clipped) {
+  // exp(-100) underflows in float, the clip keeps it at exp(-64) like the
+  // Eigen softmax.
+  std::vector<float> x = {0.0f, -100.0f};
+  std::vector<float> out(2), lse(1);
+  phi::funcs::SoftmaxForwardCPU<float>(
+      GetCPUContext(), x.data(), 1, 2, 1, false, out.data(), lse.data());
+  EXPECT_GT(out[1], 0.0f);
+  phi::funcs::SoftmaxForwardCPU<float>(
+      GetCPUContext(), x.data(), 1, 2, 1, true, out.data(), nullptr);
+  EXPECT_NEAR(out[1], -64.0f, 1e-4);
+}
+
+// Compares the engine with the double reference on the shapes of attention
+// scores and of a channel softmax, run with GLOG_v=3 to see the timings.
+TEST(SoftmaxCPU, benchmark) {
+  struct Shape {
+    int64_t outer;
+    int64_t axis_dim;
+    int64_t inner;
+  };
+  const std::vector<Shape> shapes = {{4096, 1024, 1}, {32, 64, 3136}};
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& s : shapes) {
+      auto x = RandomVector<float>(s.outer * s.axis_dim * s.inner, 5.0f, 2);
+      std::vector<float> out(x.size()), ref, ref_lse;
+
+      auto st = GetCurrentUS();
+      phi::funcs::SoftmaxForwardCPU<float>(GetCPUContext(),
+                                           x.data(),
+                                           s.outer,
+                                           s.axis_dim,
+                                           s.inner,
+                                           false,
+                                           out.data(),
+                                           nullptr);
+      auto mt = GetCurrentUS();
+      RefSoftmax(x, s.outer, s.axis_dim, s.inner, false, &ref, &ref_lse);
+      auto et = GetCurrentUS();
+
+      VLOG(3) << "[" << s.outer << ", " << s.axis_dim << ", " << s.inner
+              << "] with " << num_threads
+              << " threads: reference takes: " << (et - mt) / 1000
+              << " ms, softmax engine takes: " << (mt - st) / 1000 << " ms";
+      for (size_t i = 0; i < out.size(); ++i) {
+        ASSERT_NEAR(out[i], ref[i], 1e-5);
+      }
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+}  // namespace tests
+}  // namespace phi
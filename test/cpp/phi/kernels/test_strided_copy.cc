@@ -0,0 +1,214 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/kernels/funcs/strided_copy_cpu.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+const phi::CPUContext& GetCPUContext() {
+  return *static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+}
+
+// A copy from a view of the source into a view of the destination, both
+// strides are in elements.
+struct ViewCase {
+  std::string name;
+  std::vector<int64_t> dims;
+  std::vector<int64_t> src_strides;
+  std::vector<int64_t> dst_strides;
+};
+
+std::vector<int64_t> ContiguousStrides(const std::vector<int64_t>& dims) {
+  std::vector<int64_t> strides(dims.size(), 1);
+  for (int i = static_cast<int>(dims.size()) - 2; i >= 0; --i) {
+    strides[i] = strides[i + 1] * dims[i + 1];
+  }
+  return strides;
+}
+
+int64_t SpanOf(const std::vector<int64_t>& dims,
+               const std::vector<int64_t>& strides) {
+  int64_t span = 1;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    span += (dims[i] - 1) * strides[i];
+  }
+  return span;
+}
+
+// The element-wise div/mod loop the CPU kernels used before.
+template <typename T>
+void RefStridedCopy(const T* src, T* dst, const ViewCase& c) {
+  const int rank = static_cast<int>(c.dims.size());
+  int64_t numel = 1;
+  for (auto d : c.dims) numel *= d;
+  for (int64_t i = 0; i < numel; ++i) {
+    int64_t src_offset = 0;
+    int64_t dst_offset = 0;
+    int64_t index = i;
+    for (int k = rank - 1; k >= 0; --k) {
+      src_offset += (index % c.dims[k]) * c.src_strides[k];
+      dst_offset += (index % c.dims[k]) * c.dst_strides[k];
+      index /= c.dims[k];
+    }
+    dst[dst_offset] = src[src_offset];
+  }
+}
+
+template <typename T>
+void TestViewCase(const ViewCase& c) {
+  std::vector<T> src(SpanOf(c.dims, c.src_strides));
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<T>(i % 251);
+  }
+  const size_t dst_size = SpanOf(c.dims, c.dst_strides);
+  std::vector<T> out(dst_size, static_cast<T>(-1));
+  std::vector<T> ref(dst_size, static_cast<T>(-1));
+  RefStridedCopy(src.data(), ref.data(), c);
+  phi::funcs::StridedCopyCPU<T>(GetCPUContext(),
+                                src.data(),
+                                c.src_strides.data(),
+                                out.data(),
+                                c.dst_strides.data(),
+                                c.dims.data(),
+                                static_cast<int>(c.dims.size()));
+  EXPECT_EQ(out, ref) << c.name;
+}
+
+std::vector<ViewCase> CommonViewCases() {
+  std::vector<ViewCase> cases;
+  auto to_contiguous = [&](const std::string& name,
+                           const std::vector<int64_t>& dims,
+                           const std::vector<int64_t>& src_strides) {
+    cases.push_back({name, dims, src_strides, ContiguousStrides(dims)});
+  };
+  to_contiguous("scalar", {}, {});
+  to_contiguous("contiguous", {8, 33, 65}, {2145, 65, 1});
+  to_contiguous("transpose", {257, 129}, {1, 257});
+  to_contiguous("batched transpose", {3, 70, 45}, {3150, 1, 70});
+  to_contiguous("nchw to nhwc", {2, 17, 19, 24}, {7752, 19, 1, 323});
+  to_contiguous("permute", {5, 6, 7, 8}, {8, 1, 240, 48});
+  to_contiguous("slice", {10, 20, 30}, {1800, 60, 1});
+  to_contiguous("step slice", {10, 20, 15}, {1800, 60, 2});
+  to_contiguous("expand", {4, 1000, 3}, {3, 0, 1});
+  to_contiguous("expand inner", {40, 1000}, {1, 0});
+  to_contiguous("unfold", {100, 16}, {4, 1});
+  to_contiguous("diagonal", {64}, {65});
+  to_contiguous("size one dims", {1, 31, 1, 17}, {99, 17, 5, 1});
+  // strided_copy writes into views of the destination as well.
+  cases.push_back({"into transpose", {40, 50}, {50, 1}, {1, 40}});
+  cases.push_back({"into slice", {12, 10}, {10, 1}, {30, 2}});
+  cases.push_back({"into permute", {6, 7, 8}, {56, 8, 1}, {1, 48, 6}});
+  cases.push_back({"into broadcast", {5, 6}, {6, 1}, {0, 1}});
+  return cases;
+}
+
+TEST(StridedCopyCPU, common_views) {
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& c : CommonViewCases()) {
+      TestViewCase<float>(c);
+      TestViewCase<double>(c);
+      TestViewCase<int8_t>(c);
+      TestViewCase<int64_t>(c);
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+TEST(StridedCopyCPU, coalesce_dims) {
+  phi::funcs::StridedCopyDims d;
+  std::vector<int64_t> dims = {2, 1, 3, 4};
+  std::vector<int64_t> src_strides = {12, 7, 4, 1};
+  std::vector<int64_t> dst_strides = {12, 12, 4, 1};
+  ASSERT_TRUE(phi::funcs::CoalesceStridedCopyDims(
+      dims.data(), src_strides.data(), dst_strides.data(), 4, &d));
+  EXPECT_EQ(d.rank, 1);
+  EXPECT_EQ(d.sizes[0], 24);
+
+  phi::funcs::StridedCopyDims t;
+  dims = {3, 4, 5};
+  src_strides = {1, 15, 3};
+  dst_strides = {20, 5, 1};
+  ASSERT_TRUE(phi::funcs::CoalesceStridedCopyDims(
+      dims.data(), src_strides.data(), dst_strides.data(), 3, &t));
+  EXPECT_EQ(t.rank, 2);
+  EXPECT_EQ(t.sizes[0], 3);
+  EXPECT_EQ(t.sizes[1], 20);
+  EXPECT_EQ(t.src_strides[1], 3);
+
+  dims = {3, 0, 5};
+  EXPECT_FALSE(phi::funcs::CoalesceStridedCopyDims(
+      dims.data(), src_strides.data(), dst_strides.data(), 3, &t));
+}
+
+// Compares the copy engine with the element-wise loop on the view patterns
+// that dominate the contiguous kernel, run with GLOG_v=3 to see the timings.
+TEST(StridedCopyCPU, benchmark) {
+  const std::vector<ViewCase> cases = {
+      {"transpose", {2048, 2048}, {1, 2048}, ContiguousStrides({2048, 2048})},
+      {"nchw to nhwc",
+       {16, 56, 56, 64},
+       {200704, 56, 1, 3136},
+       ContiguousStrides({16, 56, 56, 64})},
+      {"slice",
+       {16, 512, 512},
+       {524288, 1024, 1},
+       ContiguousStrides({16, 512, 512})},
+      {"expand", {1024, 4096}, {0, 1}, ContiguousStrides({1024, 4096})},
+  };
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& c : cases) {
+      std::vector<float> src(SpanOf(c.dims, c.src_strides), 1.0f);
+      std::vector<float> out(SpanOf(c.dims, c.dst_strides));
+      std::vector<float> ref(out.size());
+
+      auto st = GetCurrentUS();
+      phi::funcs::StridedCopyCPU<float>(GetCPUContext(),
+                                        src.data(),
+                                        c.src_strides.data(),
+                                        out.data(),
+                                        c.dst_strides.data(),
+                                        c.dims.data(),
+                                        static_cast<int>(c.dims.size()));
+      auto mt = GetCurrentUS();
+      RefStridedCopy(src.data(), ref.data(), c);
+      auto et = GetCurrentUS();
+
+      VLOG(3) << c.name << " with " << num_threads
+              << " threads: element-wise takes: " << (et - mt) / 1000
+              << " ms, copy engine takes: " << (mt - st) / 1000 << " ms";
+      EXPECT_EQ(out, ref) << c.name;
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+}  // namespace tests
+}  // namespace phi
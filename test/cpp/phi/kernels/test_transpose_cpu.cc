@@ -0,0 +1,168 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/complex.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/kernels/funcs/transpose_cpu.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+const phi::CPUContext& GetCPUContext() {
+  return *static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+}
+
+// The element-wise loop over the output the rank >= 7 transpose used before.
+template <typename T>
+void RefTranspose(const std::vector<T>& x,
+                  const std::vector<int64_t>& dims,
+                  const std::vector<int>& axis,
+                  std::vector<T>* out) {
+  const int rank = static_cast<int>(dims.size());
+  std::vector<int64_t> x_strides(rank), out_strides(rank);
+  int64_t x_stride = 1, out_stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    x_strides[i] = x_stride;
+    x_stride *= dims[i];
+    out_strides[i] = out_stride;
+    out_stride *= dims[axis[i]];
+  }
+  out->resize(x.size());
+  for (int64_t out_idx = 0; out_idx < static_cast<int64_t>(x.size());
+       ++out_idx) {
+    int64_t in_idx = 0;
+    int64_t tmp_idx = out_idx;
+    for (int i = 0; i < rank; ++i) {
+      const int64_t coordinate = tmp_idx / out_strides[i];
+      tmp_idx -= coordinate * out_strides[i];
+      in_idx += coordinate * x_strides[axis[i]];
+    }
+    (*out)[out_idx] = x[in_idx];
+  }
+}
+
+template <typename T>
+void TestTranspose(const std::vector<int64_t>& dims,
+                   const std::vector<int>& axis) {
+  const int64_t numel = std::accumulate(
+      dims.begin(), dims.end(), int64_t(1), std::multiplies<int64_t>());
+  std::vector<T> x(numel);
+  for (int64_t i = 0; i < numel; ++i) {
+    x[i] = static_cast<T>(static_cast<float>(i % 97));
+  }
+  std::vector<T> ref, out(numel);
+  RefTranspose(x, dims, axis, &ref);
+  phi::funcs::TransposeCPU<T>(GetCPUContext(),
+                              x.data(),
+                              dims.data(),
+                              static_cast<int>(dims.size()),
+                              axis.data(),
+                              out.data());
+  for (int64_t i = 0; i < numel; ++i) {
+    ASSERT_TRUE(out[i] == ref[i]) << "element " << i << " of rank "
+                                  << dims.size() << " with " << numel;
+  }
+}
+
+template <typename T>
+void TestAllPermutations(const std::vector<int64_t>& dims) {
+  std::vector<int> axis(dims.size());
+  std::iota(axis.begin(), axis.end(), 0);
+  do {
+    TestTranspose<T>(dims, axis);
+  } while (std::next_permutation(axis.begin(), axis.end()));
+}
+
+TEST(TransposeCPU, permutations) {
+  // Uneven sizes leave edges narrower than a register tile and than a
+  // block, the size-1 dims are dropped before the dims are merged.
+  const std::vector<std::vector<int64_t>> shapes = {
+      {}, {5}, {2, 3}, {1000, 3}, {3, 1000}, {67, 129, 35}, {2, 1, 17, 1, 33}};
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& dims : shapes) {
+      TestAllPermutations<float>(dims);
+      TestAllPermutations<int8_t>(dims);
+      TestAllPermutations<phi::dtype::bfloat16>(dims);
+      TestAllPermutations<int64_t>(dims);
+      TestAllPermutations<phi::dtype::complex<double>>(dims);
+    }
+    // NCHW to NHWC and back, and a rank 7 permutation.
+    TestTranspose<float>({2, 19, 23, 29}, {0, 2, 3, 1});
+    TestTranspose<uint8_t>({2, 23, 29, 19}, {0, 3, 1, 2});
+    TestTranspose<double>({2, 3, 4, 5, 6, 7, 8}, {6, 1, 0, 3, 5, 4, 2});
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+// Compares the engine with the element-wise loop on a large matrix, the
+// NCHW to NHWC layout transform and the head split of attention, run with
+// GLOG_v=3 to see the timings.
+TEST(TransposeCPU, benchmark) {
+  struct Case {
+    std::vector<int64_t> dims;
+    std::vector<int> axis;
+  };
+  const std::vector<Case> cases = {{{4096, 4096}, {1, 0}},
+                                   {{32, 64, 56, 56}, {0, 2, 3, 1}},
+                                   {{8, 512, 16, 64}, {0, 2, 1, 3}}};
+  for (int num_threads : {1, 4}) {
+    phi::SetIntraOpNumThreads(num_threads);
+    for (const auto& c : cases) {
+      const int64_t numel = std::accumulate(c.dims.begin(),
+                                            c.dims.end(),
+                                            int64_t(1),
+                                            std::multiplies<int64_t>());
+      std::vector<float> x(numel);
+      std::iota(x.begin(), x.end(), 0.0f);
+      std::vector<float> out(numel), ref;
+
+      auto st = GetCurrentUS();
+      phi::funcs::TransposeCPU<float>(GetCPUContext(),
+                                      x.data(),
+                                      c.dims.data(),
+                                      static_cast<int>(c.dims.size()),
+                                      c.axis.data(),
+                                      out.data());
+      auto mt = GetCurrentUS();
+      RefTranspose(x, c.dims, c.axis, &ref);
+      auto et = GetCurrentUS();
+
+      VLOG(3) << "rank " << c.dims.size() << " transpose of " << numel
+              << " with " << num_threads
+              << " threads: element-wise loop takes: " << (et - mt) / 1000
+              << " ms, transpose engine takes: " << (mt - st) / 1000 << " ms";
+      EXPECT_EQ(out, ref);
+    }
+  }
+  phi::SetIntraOpNumThreads(1);
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,177 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <map>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/kernels/funcs/unique_functor.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+const phi::CPUContext& GetCPUContext() {
+  return *static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+}
+
+template <typename T>
+DenseTensor RandomIds(int64_t numel, int64_t max_id, bool negative) {
+  static unsigned int seed = 100;
+  std::mt19937_64 rng(seed++);
+  DenseTensor x;
+  x.Resize(common::make_ddim({numel}));
+  T* data = GetCPUContext().template Alloc<T>(&x);
+  for (int64_t i = 0; i < numel; ++i) {
+    int64_t id = static_cast<int64_t>(rng() % max_id);
+    data[i] = static_cast<T>(negative ? id - max_id / 2 : id);
+  }
+  return x;
+}
+
+template <typename IndexT>
+std::vector<IndexT> ToVector(const DenseTensor& t) {
+  return std::vector<IndexT>(t.data<IndexT>(), t.data<IndexT>() + t.numel());
+}
+
+// The implementation of std::set and std::unordered_map replaced by the radix
+// sort, which is the reference of the outputs and of the timings.
+template <typename T, typename IndexT>
+void RefUniqueSorted(const std::vector<T>& in,
+                     std::vector<T>* out,
+                     std::vector<IndexT>* indices,
+                     std::vector<IndexT>* inverse,
+                     std::vector<IndexT>* counts) {
+  std::set<T> unique(in.begin(), in.end());
+  out->assign(unique.begin(), unique.end());
+  std::unordered_map<T, IndexT> ids;
+  for (size_t i = 0; i < out->size(); ++i) {
+    ids[(*out)[i]] = i;
+  }
+  indices->assign(out->size(), -1);
+  counts->assign(out->size(), 0);
+  inverse->resize(in.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    IndexT id = ids[in[i]];
+    if ((*indices)[id] < 0) {
+      (*indices)[id] = i;
+    }
+    (*inverse)[i] = id;
+    ++(*counts)[id];
+  }
+}
+
+template <typename T, typename IndexT>
+void TestUniqueSorted(int64_t numel, int64_t max_id, bool negative) {
+  const auto& ctx = GetCPUContext();
+  DenseTensor x = RandomIds<T>(numel, max_id, negative);
+  DenseTensor out, indices, inverse, counts;
+  phi::funcs::UniqueFlattendTensorFunctor<phi::CPUContext, T>(
+      ctx, x, &out, &indices, &inverse, &counts, true, true, true)
+      .template apply<IndexT>();
+
+  std::vector<T> in(x.data<T>(), x.data<T>() + numel);
+  std::vector<T> ref_out;
+  std::vector<IndexT> ref_indices, ref_inverse, ref_counts;
+  RefUniqueSorted(in, &ref_out, &ref_indices, &ref_inverse, &ref_counts);
+  EXPECT_EQ(ToVector<T>(out), ref_out);
+  EXPECT_EQ(ToVector<IndexT>(indices), ref_indices);
+  EXPECT_EQ(ToVector<IndexT>(inverse), ref_inverse);
+  EXPECT_EQ(ToVector<IndexT>(counts), ref_counts);
+}
+
+TEST(UniqueFunctor, sorted) {
+  for (int64_t numel : {0, 1, 17, 1000, 100000}) {
+    TestUniqueSorted<int64_t, int64_t>(numel, 100, true);
+    TestUniqueSorted<int64_t, int>(numel, 1LL << 40, false);
+    TestUniqueSorted<int, int64_t>(numel, 1LL << 31, true);
+    TestUniqueSorted<float, int64_t>(numel, 100, true);
+  }
+}
+
+template <typename T>
+void TestUniqueInOrder(int64_t numel, int64_t max_id) {
+  const auto& ctx = GetCPUContext();
+  DenseTensor x = RandomIds<T>(numel, max_id, true);
+  DenseTensor out, index, count;
+  phi::funcs::UniqueOpFunctor<phi::CPUContext, T>(ctx, &out, &index, &x, &count)
+      .template apply<int64_t>();
+
+  const T* in = x.data<T>();
+  std::map<T, int64_t> ids;
+  std::vector<T> ref_out;
+  std::vector<int64_t> ref_index(numel), ref_count;
+  for (int64_t i = 0; i < numel; ++i) {
+    auto iter = ids.find(in[i]);
+    if (iter == ids.end()) {
+      iter = ids.emplace(in[i], ref_out.size()).first;
+      ref_out.push_back(in[i]);
+      ref_count.push_back(0);
+    }
+    ref_index[i] = iter->second;
+    ++ref_count[iter->second];
+  }
+  EXPECT_EQ(ToVector<T>(out), ref_out);
+  EXPECT_EQ(ToVector<int64_t>(index), ref_index);
+  EXPECT_EQ(ToVector<int64_t>(count), ref_count);
+}
+
+TEST(UniqueFunctor, in_order) {
+  for (int64_t numel : {0, 1, 17, 1000, 100000}) {
+    TestUniqueInOrder<int64_t>(numel, 1000);
+    TestUniqueInOrder<int>(numel, 1LL << 31);
+    TestUniqueInOrder<double>(numel, 1000);
+  }
+}
+
+// Compares the radix sort with the std::set implementation on the ids of a
+// sparse feature, run with GLOG_v=3 to see the timings.
+TEST(UniqueFunctor, benchmark) {
+  const auto& ctx = GetCPUContext();
+  const int64_t numel = 4000000;
+  for (int64_t max_id : {1000LL, 1000000LL, 1LL << 40}) {
+    DenseTensor x = RandomIds<int64_t>(numel, max_id, false);
+    std::vector<int64_t> in(x.data<int64_t>(), x.data<int64_t>() + numel);
+    DenseTensor out, indices, inverse, counts;
+
+    auto st = GetCurrentUS();
+    phi::funcs::UniqueFlattendTensorFunctor<phi::CPUContext, int64_t>(
+        ctx, x, &out, &indices, &inverse, &counts, true, true, true)
+        .template apply<int64_t>();
+    auto mt = GetCurrentUS();
+    std::vector<int64_t> ref_out, ref_indices, ref_inverse, ref_counts;
+    RefUniqueSorted(in, &ref_out, &ref_indices, &ref_inverse, &ref_counts);
+    auto et = GetCurrentUS();
+
+    VLOG(3) << "unique " << numel << " ids in [0, " << max_id
+            << "): std::set takes: " << (et - mt) / 1000
+            << " ms, radix sort takes: " << (mt - st) / 1000 << " ms";
+    EXPECT_EQ(out.numel(), static_cast<int64_t>(ref_out.size()));
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,284 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/utils/general_functions.h"
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_attribute.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/core/ir_context.h"
+#include "paddle/pir/include/core/program.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_dialect.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_manager.h"
+#include "paddle/pir/include/pattern_rewrite/frozen_rewrite_pattern_set.h"
+#include "paddle/pir/include/pattern_rewrite/pattern_match.h"
+#include "paddle/pir/include/pattern_rewrite/pattern_rewrite_driver.h"
+
+#include "paddle/phi/common/place.h"
+
+// Fuse transpose(transpose(x, perm1), perm2) into transpose(x, perm1 * perm2).
+class FoldTransposePattern
+    : public pir::OpRewritePattern<paddle::dialect::TransposeOp> {
+ public:
+  using pir::OpRewritePattern<paddle::dialect::TransposeOp>::OpRewritePattern;
+
+  bool MatchAndRewrite(paddle::dialect::TransposeOp op,
+                       pir::PatternRewriter &rewriter) const override {
+    auto prev_trans_op = pir::GetDefiningOpForInput(op, 0)
+                             ->dyn_cast<paddle::dialect::TransposeOp>();
+    if (!prev_trans_op) return false;
+
+    std::vector<int> perm1 = GetPerm(prev_trans_op);
+    std::vector<int> perm2 = GetPerm(op);
+    std::vector<int> new_perm(perm2.size());
+    for (size_t i = 0; i < perm2.size(); ++i) {
+      new_perm[i] = perm1[perm2[i]];
+    }
+    auto new_transpose_op = rewriter.Build<paddle::dialect::TransposeOp>(
+        prev_trans_op->operand_source(0), new_perm);
+    rewriter.ReplaceOp(op, {new_transpose_op.out()});
+    return true;
+  }
+
+ private:
+  std::vector<int> GetPerm(paddle::dialect::TransposeOp op) const {
+    auto array_attr = op.attribute<pir::ArrayAttribute>("perm").AsVector();
+    std::vector<int> perm(array_attr.size());
+    for (size_t i = 0; i < array_attr.size(); ++i) {
+      perm[i] = array_attr[i].dyn_cast<pir::Int32Attribute>().data();
+    }
+    return perm;
+  }
+};
+
+// Apply FoldTransposePattern to the blocks of the IfOps of the module.
+class FoldTransposeInIfPass : public pir::Pass {
+ public:
+  FoldTransposeInIfPass(const std::string &name, int num_threads)
+      : pir::Pass(name, 1), num_threads_(num_threads) {}
+
+  bool Initialize(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add<FoldTransposePattern>(context);
+    patterns_ = pir::FrozenRewritePatternSet(std::move(ps));
+    return true;
+  }
+
+  void Run(pir::Operation *op) override {
+    pir::GreedyRewriteConfig config;
+    config.use_top_down_traversal = true;
+    config.num_threads = num_threads_;
+    std::vector<pir::Operation *> if_ops;
+    for (uint32_t i = 0; i < op->num_regions(); ++i) {
+      for (auto &block : op->region(i)) {
+        for (auto &nested_op : block) {
+          if (nested_op.isa<paddle::dialect::IfOp>()) {
+            if_ops.push_back(&nested_op);
+          }
+        }
+      }
+    }
+    auto [_, num_rewrites] =
+        pir::ApplyPatternsGreedily(if_ops, patterns_, config);
+    AddStatistics(num_rewrites);
+  }
+
+ private:
+  int num_threads_;
+  pir::FrozenRewritePatternSet patterns_;
+};
+
+// Build `num_if_ops` IfOps whose blocks hold a chain of `chain_len`
+// transposes. The true block of every `shared_stride`-th IfOp reads a value
+// defined in the main block, these blocks depend on each other and are
+// rewritten on the same thread.
+void BuildIfProgram(pir::Program *program,
+                    pir::IrContext *ctx,
+                    size_t num_if_ops,
+                    size_t chain_len,
+                    size_t shared_stride = 4) {
+  pir::Block *block = program->block();
+  pir::Builder builder(ctx, block);
+  auto cond = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{1}, true, phi::DataType::BOOL);
+  auto outer = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{4, 3, 16, 16}, 1.5, phi::DataType::FLOAT32);
+
+  auto BuildChain = [&](pir::Block *sub_block, pir::Value input) {
+    builder.SetInsertionPointToStart(sub_block);
+    if (!input) {
+      input = builder
+                  .Build<paddle::dialect::FullOp>(
+                      std::vector<int64_t>{4, 3, 16, 16},
+                      1.5,
+                      phi::DataType::FLOAT32)
+                  .out();
+    }
+    for (size_t i = 0; i < chain_len; ++i) {
+      std::vector<int> perm = i % 2 == 0 ? std::vector<int>{0, 2, 3, 1}
+                                         : std::vector<int>{0, 3, 1, 2};
+      input = builder.Build<paddle::dialect::TransposeOp>(input, perm).out();
+    }
+    builder.Build<pir::YieldOp>(std::vector<pir::Value>{input});
+  };
+
+  for (size_t i = 0; i < num_if_ops; ++i) {
+    builder.SetInsertionPointToBlockEnd(block);
+    auto if_op = builder.Build<paddle::dialect::IfOp>(
+        cond.out(), std::vector<pir::Type>{outer.out().type()});
+    BuildChain(&if_op.true_block(),
+               i % shared_stride == 0 ? outer.out() : pir::Value());
+    BuildChain(&if_op.false_block(), pir::Value());
+  }
+}
+
+// Every chain should be folded into a single transpose fed by a full op.
+void CheckFolded(pir::Program *program) {
+  for (auto &op : *program->block()) {
+    auto if_op = op.dyn_cast<paddle::dialect::IfOp>();
+    if (!if_op) continue;
+    for (auto &block : if_op->blocks()) {
+      auto yield_input = block.back().operand_source(0);
+      auto transpose_op =
+          yield_input.defining_op()->dyn_cast<paddle::dialect::TransposeOp>();
+      ASSERT_TRUE(transpose_op);
+      EXPECT_TRUE(transpose_op->operand_source(0)
+                      .defining_op()
+                      ->isa<paddle::dialect::FullOp>());
+    }
+  }
+}
+
+std::pair<bool, int64_t> FoldFirstIfOp(pir::Program *program,
+                                       pir::IrContext *ctx,
+                                       int num_threads) {
+  pir::RewritePatternSet ps(ctx);
+  ps.Add<FoldTransposePattern>(ctx);
+  pir::FrozenRewritePatternSet patterns(std::move(ps));
+
+  pir::GreedyRewriteConfig config;
+  config.use_top_down_traversal = true;
+  config.num_threads = num_threads;
+  for (auto &op : *program->block()) {
+    if (op.isa<paddle::dialect::IfOp>()) {
+      return pir::ApplyPatternsGreedily(&op, patterns, config);
+    }
+  }
+  return std::make_pair(false, 0);
+}
+
+TEST(parallel_pattern_rewrite, SingleIfOp) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<pir::ControlFlowDialect>();
+
+  constexpr size_t kChainLen = 16;
+  pir::Program sequential_program(ctx);
+  BuildIfProgram(&sequential_program, ctx, 1, kChainLen);
+  auto [sequential_converged, sequential_num_rewrites] =
+      FoldFirstIfOp(&sequential_program, ctx, 1);
+  EXPECT_TRUE(sequential_converged);
+  CheckFolded(&sequential_program);
+
+  // The true block reads a value of the main block, the false block is
+  // independent of it.
+  pir::Program parallel_program(ctx);
+  BuildIfProgram(&parallel_program, ctx, 1, kChainLen);
+  auto [parallel_converged, parallel_num_rewrites] =
+      FoldFirstIfOp(&parallel_program, ctx, 4);
+  EXPECT_TRUE(parallel_converged);
+  CheckFolded(&parallel_program);
+
+  EXPECT_GT(parallel_num_rewrites, 0);
+  EXPECT_EQ(sequential_num_rewrites, parallel_num_rewrites);
+}
+
+std::string PrintProgram(const pir::Program &program) {
+  std::ostringstream os;
+  program.Print(os);
+  return os.str();
+}
+
+TEST(parallel_pattern_rewrite, ModuleProgram) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<pir::ControlFlowDialect>();
+
+  constexpr size_t kNumIfOps = 64;
+  constexpr size_t kChainLen = 32;
+
+  // The time of both passes is printed for comparison, it is not checked
+  // since it depends on the machine running the test.
+  pir::Program sequential_program(ctx);
+  BuildIfProgram(&sequential_program, ctx, kNumIfOps, kChainLen);
+  pir::PassManager sequential_pm(ctx);
+  sequential_pm.AddPass(
+      std::make_unique<FoldTransposeInIfPass>("sequential_fold_pass", 1));
+  sequential_pm.EnablePassTiming();
+  EXPECT_TRUE(sequential_pm.Run(&sequential_program));
+  CheckFolded(&sequential_program);
+
+  pir::Program parallel_program(ctx);
+  BuildIfProgram(&parallel_program, ctx, kNumIfOps, kChainLen);
+  pir::PassManager parallel_pm(ctx);
+  parallel_pm.AddPass(
+      std::make_unique<FoldTransposeInIfPass>("parallel_fold_pass", 4));
+  parallel_pm.EnablePassTiming();
+  EXPECT_TRUE(parallel_pm.Run(&parallel_program));
+  CheckFolded(&parallel_program);
+
+  EXPECT_EQ(PrintProgram(sequential_program), PrintProgram(parallel_program));
+}
+
+TEST(parallel_pattern_rewrite, AllRegionsShared) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<pir::ControlFlowDialect>();
+
+  // Every true block reads the same outer value, so all of them form a
+  // single group and only the false blocks run concurrently.
+  constexpr size_t kNumIfOps = 16;
+  constexpr size_t kChainLen = 8;
+  pir::Program sequential_program(ctx);
+  BuildIfProgram(&sequential_program, ctx, kNumIfOps, kChainLen, 1);
+  pir::PassManager sequential_pm(ctx);
+  sequential_pm.AddPass(
+      std::make_unique<FoldTransposeInIfPass>("sequential_fold_pass", 1));
+  EXPECT_TRUE(sequential_pm.Run(&sequential_program));
+
+  pir::Program parallel_program(ctx);
+  BuildIfProgram(&parallel_program, ctx, kNumIfOps, kChainLen, 1);
+  pir::PassManager parallel_pm(ctx);
+  parallel_pm.AddPass(
+      std::make_unique<FoldTransposeInIfPass>("parallel_fold_pass", 4));
+  EXPECT_TRUE(parallel_pm.Run(&parallel_program));
+  CheckFolded(&parallel_program);
+
+  EXPECT_EQ(PrintProgram(sequential_program), PrintProgram(parallel_program));
+}
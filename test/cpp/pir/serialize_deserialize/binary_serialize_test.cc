@@ -0,0 +1,163 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <memory>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_serialize.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/ir_deserialize.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/ir_serialize.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/core/operation.h"
+#include "paddle/pir/include/core/program.h"
+
+void BuildAddChainProgram(pir::Program* program,
+                          pir::IrContext* ctx,
+                          size_t num_adds) {
+  pir::Builder builder = pir::Builder(ctx, program->block());
+  auto x = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{64, 64}, 1.5, phi::DataType::FLOAT32);
+  pir::Value out = x.out();
+  for (size_t i = 0; i < num_adds; ++i) {
+    auto y = builder.Build<paddle::dialect::FullOp>(
+        std::vector<int64_t>{64, 64}, 0.5 * i, phi::DataType::FLOAT32);
+    out = builder.Build<paddle::dialect::AddOp>(out, y.out()).out();
+  }
+}
+
+TEST(BinarySerializeTest, round_trip) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  BuildAddChainProgram(&program, ctx, 100);
+
+  pir::WriteModule(program,
+                   "./test_binary_program.json",
+                   /*pir_version*/ 1,
+                   true,
+                   false,
+                   true);
+  pir::WriteModule(program,
+                   "./test_binary_program.pdmodel",
+                   /*pir_version*/ 1,
+                   true,
+                   false,
+                   true,
+                   /*binary*/ true);
+  EXPECT_FALSE(
+      pir::BinaryProgramReader::IsBinaryProgram("./test_binary_program.json"));
+  EXPECT_TRUE(pir::BinaryProgramReader::IsBinaryProgram(
+      "./test_binary_program.pdmodel"));
+  EXPECT_LT(std::filesystem::file_size("./test_binary_program.pdmodel"),
+            std::filesystem::file_size("./test_binary_program.json"));
+
+  pir::Program json_program(ctx);
+  EXPECT_TRUE(pir::ReadModule(
+      "./test_binary_program.json", &json_program, /*pir_version*/ 1));
+  pir::Program binary_program(ctx);
+  EXPECT_TRUE(pir::ReadModule(
+      "./test_binary_program.pdmodel", &binary_program, /*pir_version*/ 1));
+
+  ASSERT_EQ(json_program.block()->size(), binary_program.block()->size());
+  auto json_it = json_program.block()->begin();
+  auto binary_it = binary_program.block()->begin();
+  for (; json_it != json_program.block()->end(); ++json_it, ++binary_it) {
+    EXPECT_EQ(json_it->name(), binary_it->name());
+    EXPECT_EQ(json_it->attributes(), binary_it->attributes());
+    ASSERT_EQ(json_it->num_results(), binary_it->num_results());
+    for (uint32_t i = 0; i < json_it->num_results(); ++i) {
+      EXPECT_EQ(json_it->result_type(i), binary_it->result_type(i));
+    }
+  }
+}
+
+TEST(BinarySerializeTest, lazy_sections) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  BuildAddChainProgram(&program, ctx, 50);
+  size_t num_ops = program.block()->size();
+
+  pir::ProgramWriter writer(/*pir_version*/ 1, /*trainable*/ true);
+  Json program_json = writer.GetProgramJson(&program);
+  Json expected_json = program_json;
+
+  pir::BinaryProgramWriter binary_writer(/*pir_version*/ 1,
+                                         /*trainable*/ false,
+                                         /*compress*/ true,
+                                         /*ops_per_section*/ 16);
+  std::string buffer = binary_writer.Encode(&program_json);
+  EXPECT_EQ(program_json, expected_json);
+
+  pir::BinaryProgramReader reader(buffer);
+  EXPECT_EQ(reader.pir_version(), 1u);
+  EXPECT_FALSE(reader.trainable());
+  EXPECT_EQ(reader.num_op_sections(), (num_ops + 15) / 16);
+
+  auto& ops_json = expected_json["regions"][0]["blocks"][0]["ops"];
+  Json last_section = reader.ReadOpSection(reader.num_op_sections() - 1);
+  EXPECT_EQ(last_section.size(), num_ops - (reader.num_op_sections() - 1) * 16);
+  EXPECT_EQ(last_section.back(), ops_json.back());
+  EXPECT_EQ(reader.ReadProgramJson(), expected_json);
+
+  // Truncated buffers are rejected instead of read out of bounds.
+  EXPECT_ANY_THROW(
+      pir::BinaryProgramReader(buffer.substr(0, buffer.size() - 8))
+          .ReadProgramJson());
+}
+
+TEST(BinarySerializeTest, recover_from_sections) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  BuildAddChainProgram(&program, ctx, 50);
+
+  pir::ProgramWriter writer(/*pir_version*/ 1, /*trainable*/ true);
+  Json program_json = writer.GetProgramJson(&program);
+  pir::BinaryProgramWriter binary_writer(/*pir_version*/ 1,
+                                         /*trainable*/ true,
+                                         /*compress*/ true,
+                                         /*ops_per_section*/ 16);
+  pir::BinaryProgramReader binary_reader(binary_writer.Encode(&program_json));
+  EXPECT_GT(binary_reader.num_op_sections(), 1u);
+
+  // The values used across sections are connected in the recovered program.
+  pir::Program recover_program(ctx);
+  pir::PatchBuilder builder(/*pir_version*/ 1);
+  pir::ProgramReader reader(/*pir_version*/ 1);
+  reader.RecoverProgram(&binary_reader, &recover_program, &builder);
+
+  ASSERT_EQ(program.block()->size(), recover_program.block()->size());
+  auto it = program.block()->begin();
+  auto recover_it = recover_program.block()->begin();
+  for (; it != program.block()->end(); ++it, ++recover_it) {
+    EXPECT_EQ(it->name(), recover_it->name());
+    EXPECT_EQ(it->attributes(), recover_it->attributes());
+    ASSERT_EQ(it->num_operands(), recover_it->num_operands());
+    for (uint32_t i = 0; i < it->num_operands(); ++i) {
+      EXPECT_EQ(it->operand_source(i).defining_op()->name(),
+                recover_it->operand_source(i).defining_op()->name());
+    }
+  }
+  auto& last_add = recover_program.block()->back();
+  EXPECT_EQ(last_add.operand_source(0).defining_op()->name(), "pd_op.add");
+}
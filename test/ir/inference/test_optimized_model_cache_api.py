@@ -0,0 +1,114 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.inference import Config, create_predictor
+
+
+class TestNet(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self.conv1 = paddle.nn.Conv2D(3, 6, kernel_size=3, bias_attr=False)
+        self.bn1 = paddle.nn.BatchNorm2D(6)
+        self.relu = paddle.nn.ReLU()
+
+    def forward(self, x):
+        x = self.conv1(x)
+        x = self.bn1(x)
+        return self.relu(x)
+
+
+class TestOptimizedModelCache(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.path_prefix = os.path.join(
+            self.temp_dir.name, "optimized_model_cache_test"
+        )
+        self.cache_dir = os.path.join(self.temp_dir.name, "cache")
+        self.input_data = np.ones([1, 3, 32, 32]).astype('float32')
+        paddle.jit.save(
+            TestNet(),
+            self.path_prefix,
+            input_spec=[
+                paddle.static.InputSpec(shape=[1, 3, 32, 32], dtype='float32')
+            ],
+        )
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def cache_entries(self):
+        return sorted(os.listdir(self.cache_dir))
+
+    def inference(self):
+        config = Config(
+            self.path_prefix + ".json", self.path_prefix + ".pdiparams"
+        )
+        config.disable_gpu()
+        config.set_optim_cache_dir(self.cache_dir)
+        config.enable_optimized_model_cache()
+        predictor = create_predictor(config)
+
+        input_tensor = predictor.get_input_handle(
+            predictor.get_input_names()[0]
+        )
+        input_tensor.reshape(self.input_data.shape)
+        input_tensor.copy_from_cpu(self.input_data.copy())
+        predictor.run()
+        output_tensor = predictor.get_output_handle(
+            predictor.get_output_names()[0]
+        )
+        return output_tensor.copy_to_cpu()
+
+    def test_reuse(self):
+        out_origin_model = self.inference()
+        entries = self.cache_entries()
+        self.assertEqual(len(entries), 1)
+        self.assertNotIn(".tmp.", entries[0])
+
+        out_cached_model = self.inference()
+        self.assertEqual(self.cache_entries(), entries)
+        np.testing.assert_allclose(
+            out_origin_model, out_cached_model, rtol=1e-5, atol=1e-5
+        )
+
+    def test_invalidate(self):
+        self.inference()
+        entries = self.cache_entries()
+
+        # Saving a new model to the same path gets a new entry.
+        paddle.seed(2024)
+        paddle.jit.save(
+            TestNet(),
+            self.path_prefix,
+            input_spec=[
+                paddle.static.InputSpec(shape=[1, 3, 32, 32], dtype='float32')
+            ],
+        )
+        self.inference()
+        new_entries = self.cache_entries()
+        self.assertEqual(len(new_entries), len(entries) + 1)
+        for entry in new_entries:
+            self.assertNotIn(".tmp.", entry)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -212,8 +212,11 @@ class TestMultipleAccelerators(unittest.TestCase):
 
 class TestMultipleWithGloo(unittest.TestCase):
     def run_mnist_2cpu(self, target_file_name):
+        self.run_mnist_cpu(target_file_name, 2)
+
+    def run_mnist_cpu(self, target_file_name, nranks):
         cluster, pod = get_cluster_from_args(
-            [0, 1]
+            list(range(nranks))
         )  # tmp use. for getting trainer_nranks()
 
         procs = start_local_trainers_cpu(
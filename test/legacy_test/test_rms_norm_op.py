@@ -582,10 +582,6 @@ class TestRMSNormStaticOp(unittest.TestCase):
         )
 
 
-@unittest.skipIf(
-    not core.supports_avx512f() or not core.is_compiled_with_avx(),
-    "machine is not support AVX or is not compiled with AVX",
-)
 class TestRMSNormOpCPU(unittest.TestCase):
     def setUp(self):
         import os
@@ -686,10 +682,6 @@ class TestRMSNormOpCPU(unittest.TestCase):
         )
 
 
-@unittest.skipIf(
-    not core.supports_avx512f() or not core.is_compiled_with_avx(),
-    "machine is not support AVX or is not compiled with AVX",
-)
 class TestRMSNormStaticOpCPU(unittest.TestCase):
     def setUp(self):
         import os